@@ -5,8 +5,10 @@
 
 // Function declarations for app discovery
 Napi::Array ScanRegistry(const Napi::CallbackInfo& info);
-Napi::Array ScanProgramFiles(const Napi::CallbackInfo& info);
+Napi::Array ScanRegisteredApps(const Napi::CallbackInfo& info);
+Napi::Value ScanProgramFiles(const Napi::CallbackInfo& info);
 Napi::Array ScanSystemApps(const Napi::CallbackInfo& info);
+Napi::Value ScanUserApps(const Napi::CallbackInfo& info);
 Napi::String ExtractAppIcon(const Napi::CallbackInfo& info);
 
 #endif
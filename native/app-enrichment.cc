@@ -0,0 +1,240 @@
+#include <windows.h>
+#include <shellapi.h>
+#include <softpub.h>
+#include <wintrust.h>
+#include <cstdint>
+#include <cstdio>
+#include <cwchar>
+#include <vector>
+#include "app-enrichment.h"
+#include "discovery-backend.h"
+
+namespace {
+
+std::string Base64Encode(const std::vector<uint8_t>& data) {
+  static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  encoded.reserve((data.size() + 2) / 3 * 4);
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t chunk = (uint32_t)data[i] << 16;
+    if (i + 1 < data.size()) chunk |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < data.size()) chunk |= data[i + 2];
+    encoded += kAlphabet[(chunk >> 18) & 63];
+    encoded += kAlphabet[(chunk >> 12) & 63];
+    encoded += i + 1 < data.size() ? kAlphabet[(chunk >> 6) & 63] : '=';
+    encoded += i + 2 < data.size() ? kAlphabet[chunk & 63] : '=';
+  }
+  return encoded;
+}
+
+void Append16(std::vector<uint8_t>* out, uint16_t value) {
+  out->push_back((uint8_t)value);
+  out->push_back((uint8_t)(value >> 8));
+}
+
+void Append32(std::vector<uint8_t>* out, uint32_t value) {
+  Append16(out, (uint16_t)value);
+  Append16(out, (uint16_t)(value >> 16));
+}
+
+// Bottom-up BGRA rows of a bitmap, or false
+bool ReadBitmapPixels(HBITMAP bitmap, int width, int height, std::vector<uint8_t>* pixels) {
+  BITMAPINFO info = {};
+  info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+  info.bmiHeader.biWidth = width;
+  info.bmiHeader.biHeight = height;
+  info.bmiHeader.biPlanes = 1;
+  info.bmiHeader.biBitCount = 32;
+  info.bmiHeader.biCompression = BI_RGB;
+
+  pixels->assign((size_t)width * height * 4, 0);
+  HDC dc = GetDC(NULL);
+  int lines = GetDIBits(dc, bitmap, 0, height, pixels->data(), &info, DIB_RGB_COLORS);
+  ReleaseDC(NULL, dc);
+  return lines == height;
+}
+
+// Single-image .ico holding a 32-bit DIB; Chromium renders these with alpha
+std::vector<uint8_t> EncodeIco(const std::vector<uint8_t>& pixels, int width, int height) {
+  uint32_t maskRowBytes = ((width + 31) / 32) * 4;
+  uint32_t imageBytes = sizeof(BITMAPINFOHEADER) + (uint32_t)pixels.size() + maskRowBytes * height;
+
+  std::vector<uint8_t> ico;
+  ico.reserve(6 + 16 + imageBytes);
+
+  // ICONDIR
+  Append16(&ico, 0);
+  Append16(&ico, 1);
+  Append16(&ico, 1);
+  // ICONDIRENTRY; a 256 dimension is stored as 0
+  ico.push_back((uint8_t)(width >= 256 ? 0 : width));
+  ico.push_back((uint8_t)(height >= 256 ? 0 : height));
+  ico.push_back(0);
+  ico.push_back(0);
+  Append16(&ico, 1);
+  Append16(&ico, 32);
+  Append32(&ico, imageBytes);
+  Append32(&ico, 6 + 16);
+  // BITMAPINFOHEADER; the height covers the color and AND-mask planes
+  Append32(&ico, sizeof(BITMAPINFOHEADER));
+  Append32(&ico, (uint32_t)width);
+  Append32(&ico, (uint32_t)(height * 2));
+  Append16(&ico, 1);
+  Append16(&ico, 32);
+  Append32(&ico, BI_RGB);
+  Append32(&ico, 0);
+  Append32(&ico, 0);
+  Append32(&ico, 0);
+  Append32(&ico, 0);
+  Append32(&ico, 0);
+
+  ico.insert(ico.end(), pixels.begin(), pixels.end());
+  // Transparency comes from the alpha channel, so the AND mask is empty
+  ico.insert(ico.end(), (size_t)maskRowBytes * height, 0);
+  return ico;
+}
+
+std::string QueryVersionString(const std::vector<uint8_t>& block, const wchar_t* translation,
+                               const wchar_t* name) {
+  wchar_t query[128];
+  swprintf(query, 128, L"\\StringFileInfo\\%ls\\%ls", translation, name);
+  wchar_t* value = nullptr;
+  UINT length = 0;
+  if (!VerQueryValueW(block.data(), query, (LPVOID*)&value, &length) || !value || length == 0) {
+    return "";
+  }
+  return WideToUtf8(std::wstring(value, wcsnlen(value, length)));
+}
+
+}  // namespace
+
+bool ExtractIconDataUrl(const std::string& exePath, std::string* dataUrl, std::string* error) {
+  std::wstring widePath = Utf8ToWide(exePath);
+  HICON icon = NULL;
+  if (ExtractIconExW(widePath.c_str(), 0, &icon, NULL, 1) == 0 || icon == NULL) {
+    // No embedded icon; fall back to the shell's icon for the file type
+    SHFILEINFOW fileInfo = {};
+    if (!SHGetFileInfoW(widePath.c_str(), 0, &fileInfo, sizeof(fileInfo), SHGFI_ICON | SHGFI_LARGEICON) ||
+        fileInfo.hIcon == NULL) {
+      *error = "No icon";
+      return false;
+    }
+    icon = fileInfo.hIcon;
+  }
+
+  ICONINFO iconInfo = {};
+  if (!GetIconInfo(icon, &iconInfo)) {
+    DestroyIcon(icon);
+    *error = "GetIconInfo failed";
+    return false;
+  }
+
+  bool ok = false;
+  if (iconInfo.hbmColor == NULL) {
+    *error = "Monochrome icon";
+  } else {
+    BITMAP bitmap = {};
+    GetObjectW(iconInfo.hbmColor, sizeof(bitmap), &bitmap);
+    int width = bitmap.bmWidth;
+    int height = bitmap.bmHeight;
+
+    std::vector<uint8_t> pixels;
+    if (width <= 0 || height <= 0 || !ReadBitmapPixels(iconInfo.hbmColor, width, height, &pixels)) {
+      *error = "GetDIBits failed";
+    } else {
+      // Icons from before alpha channels leave it zero; derive it from the mask
+      bool hasAlpha = false;
+      for (size_t i = 3; i < pixels.size() && !hasAlpha; i += 4) hasAlpha = pixels[i] != 0;
+      std::vector<uint8_t> mask;
+      if (!hasAlpha && ReadBitmapPixels(iconInfo.hbmMask, width, height, &mask)) {
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+          pixels[i + 3] = mask[i] ? 0 : 255;
+        }
+      }
+
+      *dataUrl = "data:image/x-icon;base64," + Base64Encode(EncodeIco(pixels, width, height));
+      ok = true;
+    }
+  }
+
+  if (iconInfo.hbmColor) DeleteObject(iconInfo.hbmColor);
+  if (iconInfo.hbmMask) DeleteObject(iconInfo.hbmMask);
+  DestroyIcon(icon);
+  return ok;
+}
+
+bool ReadVersionMetadata(const std::string& exePath, AppMetadata* metadata, std::string* error) {
+  std::wstring widePath = Utf8ToWide(exePath);
+  DWORD size = GetFileVersionInfoSizeW(widePath.c_str(), NULL);
+  if (size == 0) {
+    *error = "No version resource";
+    return false;
+  }
+
+  std::vector<uint8_t> block(size);
+  if (!GetFileVersionInfoW(widePath.c_str(), 0, size, block.data())) {
+    *error = "GetFileVersionInfo failed";
+    return false;
+  }
+
+  // First declared language/codepage, else US English Unicode
+  wchar_t translation[16] = L"040904B0";
+  struct LanguageCodePage { WORD language; WORD codePage; };
+  LanguageCodePage* languages = nullptr;
+  UINT languagesBytes = 0;
+  if (VerQueryValueW(block.data(), L"\\VarFileInfo\\Translation", (LPVOID*)&languages, &languagesBytes) &&
+      languagesBytes >= sizeof(LanguageCodePage)) {
+    swprintf(translation, 16, L"%04x%04x", languages[0].language, languages[0].codePage);
+  }
+
+  metadata->companyName = QueryVersionString(block, translation, L"CompanyName");
+  metadata->productName = QueryVersionString(block, translation, L"ProductName");
+  metadata->fileDescription = QueryVersionString(block, translation, L"FileDescription");
+
+  VS_FIXEDFILEINFO* fixed = nullptr;
+  UINT fixedBytes = 0;
+  if (VerQueryValueW(block.data(), L"\\", (LPVOID*)&fixed, &fixedBytes) && fixed &&
+      fixedBytes >= sizeof(VS_FIXEDFILEINFO)) {
+    char version[64];
+    snprintf(version, sizeof(version), "%u.%u.%u.%u",
+             HIWORD(fixed->dwFileVersionMS), LOWORD(fixed->dwFileVersionMS),
+             HIWORD(fixed->dwFileVersionLS), LOWORD(fixed->dwFileVersionLS));
+    metadata->fileVersion = version;
+  } else {
+    metadata->fileVersion = QueryVersionString(block, translation, L"FileVersion");
+  }
+  return true;
+}
+
+bool VerifyAuthenticode(const std::string& exePath, bool* trusted, std::string* error) {
+  std::wstring widePath = Utf8ToWide(exePath);
+  WINTRUST_FILE_INFO fileInfo = {};
+  fileInfo.cbStruct = sizeof(fileInfo);
+  fileInfo.pcwszFilePath = widePath.c_str();
+
+  // No UI, and no revocation fetches: a verdict should not wait on the network
+  GUID action = WINTRUST_ACTION_GENERIC_VERIFY_V2;
+  WINTRUST_DATA data = {};
+  data.cbStruct = sizeof(data);
+  data.dwUIChoice = WTD_UI_NONE;
+  data.fdwRevocationChecks = WTD_REVOKE_NONE;
+  data.dwUnionChoice = WTD_CHOICE_FILE;
+  data.pFile = &fileInfo;
+  data.dwStateAction = WTD_STATEACTION_VERIFY;
+  data.dwProvFlags = WTD_CACHE_ONLY_URL_RETRIEVAL;
+
+  LONG status = WinVerifyTrust((HWND)INVALID_HANDLE_VALUE, &action, &data);
+  data.dwStateAction = WTD_STATEACTION_CLOSE;
+  WinVerifyTrust((HWND)INVALID_HANDLE_VALUE, &action, &data);
+
+  // Anything else is a verdict: unsigned, tampered, untrusted root, ...
+  if (status == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) || status == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND) ||
+      status == HRESULT_FROM_WIN32(ERROR_ACCESS_DENIED)) {
+    char message[64];
+    snprintf(message, sizeof(message), "WinVerifyTrust failed (0x%08lX)", (unsigned long)status);
+    *error = message;
+    return false;
+  }
+  *trusted = status == ERROR_SUCCESS;
+  return true;
+}
@@ -0,0 +1,26 @@
+#ifndef APP_ENRICHMENT_H
+#define APP_ENRICHMENT_H
+
+#include <string>
+
+// Per-executable details that are too slow to gather during a scan and are
+// filled in later by the idle scheduler (Windows only, app-enrichment.cc)
+
+struct AppMetadata {
+  std::string companyName;
+  std::string productName;
+  std::string fileDescription;
+  std::string fileVersion;
+};
+
+// The executable's first large icon as a 32-bit "data:image/x-icon;base64,..." URL
+bool ExtractIconDataUrl(const std::string& exePath, std::string* dataUrl, std::string* error);
+
+// VERSIONINFO strings, in the file's first declared language
+bool ReadVersionMetadata(const std::string& exePath, AppMetadata* metadata, std::string* error);
+
+// WinVerifyTrust's verdict on the file's Authenticode signature, without
+// revocation checks. False only when the file could not be checked.
+bool VerifyAuthenticode(const std::string& exePath, bool* trusted, std::string* error);
+
+#endif
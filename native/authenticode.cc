@@ -0,0 +1,679 @@
+#include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "authenticode.h"
+#include "fake-discovery-backend.h"
+#include "pe-image.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Signatures per executor task. Each costs a stat, an identify and two
+// reads on a miss, so batches are smaller than stat batches.
+constexpr size_t kSignatureBatchSize = 8;
+
+constexpr uint16_t kCertificateRevision = 0x0200;  // WIN_CERT_REVISION_2_0
+constexpr uint16_t kCertificateTypePkcs7 = 0x0002; // WIN_CERT_TYPE_PKCS_SIGNED_DATA
+constexpr size_t kCertificateHeaderBytes = 8;
+
+constexpr uint8_t kDerInteger = 0x02;
+constexpr uint8_t kDerOid = 0x06;
+constexpr uint8_t kDerSequence = 0x30;
+constexpr uint8_t kDerSet = 0x31;
+constexpr uint8_t kDerContext0 = 0xA0;
+
+const char* const kSignedDataOid = "1.2.840.113549.1.7.2";
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint32_t ReadU32(const std::string& bytes, size_t offset) {
+  return (uint32_t)(uint8_t)bytes[offset] | ((uint32_t)(uint8_t)bytes[offset + 1] << 8) |
+         ((uint32_t)(uint8_t)bytes[offset + 2] << 16) | ((uint32_t)(uint8_t)bytes[offset + 3] << 24);
+}
+
+struct Der {
+  uint8_t tag = 0;
+  size_t start = 0;   // Tag byte
+  size_t offset = 0;  // First content byte
+  size_t length = 0;
+
+  size_t End() const { return offset + length; }
+};
+
+// Walks the elements of one constructed value in order. Definite lengths
+// only: Authenticode signatures are DER.
+class DerReader {
+ public:
+  DerReader(const std::string& bytes, size_t begin, size_t end) : bytes_(bytes), pos_(begin), end_(end) {}
+  DerReader(const std::string& bytes, const Der& parent) : DerReader(bytes, parent.offset, parent.End()) {}
+
+  bool AtEnd() const { return pos_ >= end_; }
+  uint8_t PeekTag() const { return AtEnd() ? 0 : (uint8_t)bytes_[pos_]; }
+
+  bool Next(Der* element) {
+    if (AtEnd() || end_ - pos_ < 2) return false;
+    element->tag = (uint8_t)bytes_[pos_];
+    if ((element->tag & 0x1F) == 0x1F) return false;  // Multi-byte tags do not occur here
+    element->start = pos_;
+
+    size_t offset = pos_ + 2;
+    size_t length = (uint8_t)bytes_[pos_ + 1];
+    if (length & 0x80) {
+      size_t count = length & 0x7F;
+      if (count == 0 || count > 4 || count > end_ - offset) return false;
+      length = 0;
+      for (size_t i = 0; i < count; i++) length = (length << 8) | (uint8_t)bytes_[offset++];
+    }
+    if (length > end_ - offset) return false;
+    element->offset = offset;
+    element->length = length;
+    pos_ = offset + length;
+    return true;
+  }
+
+  // Next element, which must carry tag
+  bool Expect(uint8_t tag, Der* element) { return Next(element) && element->tag == tag; }
+
+ private:
+  const std::string& bytes_;
+  size_t pos_;
+  size_t end_;
+};
+
+bool SameContents(const std::string& bytes, const Der& a, const Der& b) {
+  return a.length == b.length && bytes.compare(a.offset, a.length, bytes, b.offset, b.length) == 0;
+}
+
+std::string OidToString(const std::string& bytes, const Der& oid) {
+  std::string dotted;
+  uint64_t value = 0;
+  bool first = true;
+  for (size_t i = oid.offset; i < oid.End(); i++) {
+    value = (value << 7) | ((uint8_t)bytes[i] & 0x7F);
+    if ((uint8_t)bytes[i] & 0x80) continue;
+    if (first) {
+      // The first subidentifier packs two arcs: 40 * first + second
+      uint64_t arc = value < 80 ? value / 40 : 2;
+      dotted = std::to_string(arc) + "." + std::to_string(value - arc * 40);
+      first = false;
+    } else {
+      dotted += "." + std::to_string(value);
+    }
+    value = 0;
+  }
+  return dotted;
+}
+
+const char* DigestAlgorithmName(const std::string& oid) {
+  if (oid == "2.16.840.1.101.3.4.2.1") return "sha256";
+  if (oid == "2.16.840.1.101.3.4.2.2") return "sha384";
+  if (oid == "2.16.840.1.101.3.4.2.3") return "sha512";
+  if (oid == "1.3.14.3.2.26") return "sha1";
+  if (oid == "1.2.840.113549.2.5") return "md5";
+  return nullptr;
+}
+
+// Short names as CertNameToStr writes them
+const char* AttributeName(const std::string& oid) {
+  if (oid == "2.5.4.3") return "CN";
+  if (oid == "2.5.4.10") return "O";
+  if (oid == "2.5.4.11") return "OU";
+  if (oid == "2.5.4.7") return "L";
+  if (oid == "2.5.4.8") return "S";
+  if (oid == "2.5.4.6") return "C";
+  if (oid == "2.5.4.9") return "STREET";
+  if (oid == "2.5.4.5") return "SERIALNUMBER";
+  if (oid == "1.2.840.113549.1.9.1") return "E";
+  return nullptr;
+}
+
+void AppendUtf8(std::string* out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    *out += (char)codePoint;
+  } else if (codePoint < 0x800) {
+    *out += (char)(0xC0 | (codePoint >> 6));
+    *out += (char)(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    *out += (char)(0xE0 | (codePoint >> 12));
+    *out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    *out += (char)(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x110000) {
+    *out += (char)(0xF0 | (codePoint >> 18));
+    *out += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+    *out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    *out += (char)(0x80 | (codePoint & 0x3F));
+  }
+}
+
+// A DirectoryString as UTF-8; false for types that are not text
+bool DecodeString(const std::string& bytes, const Der& value, std::string* text) {
+  text->clear();
+  switch (value.tag) {
+    case 0x0C:  // UTF8String
+    case 0x12:  // NumericString
+    case 0x13:  // PrintableString
+    case 0x16:  // IA5String
+    case 0x1A:  // VisibleString
+      text->assign(bytes, value.offset, value.length);
+      return true;
+    case 0x14:  // TeletexString, in practice Latin-1
+      for (size_t i = value.offset; i < value.End(); i++) AppendUtf8(text, (uint8_t)bytes[i]);
+      return true;
+    case 0x1E:  // BMPString: UTF-16BE
+      for (size_t i = value.offset; i + 1 < value.End(); i += 2) {
+        uint32_t unit = ((uint8_t)bytes[i] << 8) | (uint8_t)bytes[i + 1];
+        if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < value.End()) {
+          uint32_t low = ((uint8_t)bytes[i + 2] << 8) | (uint8_t)bytes[i + 3];
+          if (low >= 0xDC00 && low < 0xE000) {
+            unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+            i += 2;
+          }
+        }
+        AppendUtf8(text, unit);
+      }
+      return true;
+    case 0x1C:  // UniversalString: UTF-32BE
+      for (size_t i = value.offset; i + 3 < value.End(); i += 4) {
+        AppendUtf8(text, ((uint32_t)(uint8_t)bytes[i] << 24) | ((uint32_t)(uint8_t)bytes[i + 1] << 16) |
+                         ((uint32_t)(uint8_t)bytes[i + 2] << 8) | (uint8_t)bytes[i + 3]);
+      }
+      return true;
+  }
+  return false;
+}
+
+// Quoted, with quotes doubled, when it holds a separator or edge spaces
+std::string QuoteNameValue(const std::string& value) {
+  bool quote = !value.empty() && (value.front() == ' ' || value.back() == ' ');
+  quote = quote || value.find_first_of(",+=\"\n<>#;") != std::string::npos;
+  if (!quote) return value;
+  std::string quoted = "\"";
+  for (char c : value) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// Visits each attribute of an X.501 Name in encoding order (least specific
+// first); stops early when visit returns false
+bool ForEachNameAttribute(const std::string& bytes, const Der& name,
+                          const std::function<bool(const std::string&, const Der&, bool)>& visit) {
+  DerReader rdns(bytes, name);
+  Der rdn;
+  while (rdns.Next(&rdn)) {
+    if (rdn.tag != kDerSet) return false;
+    DerReader attributes(bytes, rdn);
+    Der attribute;
+    bool firstInRdn = true;
+    while (attributes.Next(&attribute)) {
+      DerReader fields(bytes, attribute);
+      Der type, value;
+      if (attribute.tag != kDerSequence || !fields.Expect(kDerOid, &type) || !fields.Next(&value)) return false;
+      if (!visit(OidToString(bytes, type), value, firstInRdn)) return true;
+      firstInRdn = false;
+    }
+  }
+  return rdns.AtEnd();
+}
+
+// "CN=..., O=..., C=US": relative names most specific first, as Windows
+// shows them; multi-valued ones joined with " + "
+std::string FormatName(const std::string& bytes, const Der& name) {
+  std::vector<std::string> rdns;
+  ForEachNameAttribute(bytes, name, [&](const std::string& oid, const Der& value, bool firstInRdn) {
+    const char* shortName = AttributeName(oid);
+    std::string text;
+    std::string part = shortName ? shortName : "OID." + oid;
+    if (DecodeString(bytes, value, &text)) {
+      part += "=" + QuoteNameValue(text);
+    } else {
+      // RFC 4514 hex form for values that are not strings
+      static const char kHex[] = "0123456789ABCDEF";
+      part += "=#";
+      for (size_t i = value.start; i < value.End(); i++) {
+        part += kHex[(uint8_t)bytes[i] >> 4];
+        part += kHex[(uint8_t)bytes[i] & 15];
+      }
+    }
+    if (firstInRdn || rdns.empty()) {
+      rdns.push_back(part);
+    } else {
+      rdns.back() += " + " + part;
+    }
+    return true;
+  });
+
+  std::string formatted;
+  for (auto it = rdns.rbegin(); it != rdns.rend(); ++it) {
+    if (!formatted.empty()) formatted += ", ";
+    formatted += *it;
+  }
+  return formatted;
+}
+
+// Most specific value of an attribute, or ""
+std::string NameAttribute(const std::string& bytes, const Der& name, const char* oid) {
+  std::string found;
+  ForEachNameAttribute(bytes, name, [&](const std::string& type, const Der& value, bool) {
+    std::string text;
+    if (type == oid && DecodeString(bytes, value, &text)) found = text;
+    return true;
+  });
+  return found;
+}
+
+// Serial number, issuer and subject of an X.509 certificate
+bool ReadCertificateNames(const std::string& bytes, const Der& certificate, Der* serial, Der* issuer,
+                          Der* subject) {
+  DerReader outer(bytes, certificate);
+  Der tbs, element;
+  if (!outer.Expect(kDerSequence, &tbs)) return false;
+  DerReader fields(bytes, tbs);
+  if (fields.PeekTag() == kDerContext0 && !fields.Next(&element)) return false;  // [0] version
+  return fields.Expect(kDerInteger, serial) && fields.Expect(kDerSequence, &element) &&  // signature
+         fields.Expect(kDerSequence, issuer) && fields.Expect(kDerSequence, &element) &&  // validity
+         fields.Expect(kDerSequence, subject);
+}
+
+bool Fail(std::string* error, const char* message) {
+  *error = message;
+  return false;
+}
+
+Napi::Object SignatureCacheStatsToNapi(Napi::Env env, const SignatureCacheStats& stats) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("entries", Napi::Number::New(env, (double)stats.entries));
+  result.Set("hits", Napi::Number::New(env, (double)stats.hits));
+  result.Set("reads", Napi::Number::New(env, (double)stats.reads));
+  result.Set("verdicts", Napi::Number::New(env, (double)stats.verdicts));
+  return result;
+}
+
+// Reads signers on the background lane through a signature cache: the
+// shared live one, or one over a fixture
+class ReadSignersWorker : public ExecutorWorker {
+ public:
+  ReadSignersWorker(Napi::Env env, std::vector<std::string> paths)
+    : ExecutorWorker(env, TaskLane::Background),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      paths_(std::move(paths)) {}
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    Napi::Value filesystem = options.Get("filesystem");
+    useFixtures_ = !filesystem.IsUndefined();
+    if (!useFixtures_) return true;
+    return ReadFakeFileSystem(filesystem, &fileSystem_, error);
+  }
+
+  bool UsesFixtures() const { return useFixtures_; }
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    Clock::time_point start = Clock::now();
+    if (useFixtures_) {
+      SignatureCache cache;
+      ReadSignatures(fileSystem_, cache, paths_, TaskLane::Background, &statuses_, &infos_);
+      stats_ = cache.GetStats();
+    } else {
+#ifdef _WIN32
+      ReadSignatures(LiveFileSystem(), SharedSignatureCache(), paths_, TaskLane::Background,
+                     &statuses_, &infos_);
+      stats_ = SharedSignatureCache().GetStats();
+#endif
+    }
+    elapsedMs_ = MillisecondsSince(start);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Array results = Napi::Array::New(env, paths_.size());
+    for (size_t i = 0; i < paths_.size(); i++) {
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("path", Napi::String::New(env, paths_[i]));
+      if (statuses_[i] != BackendStatus::Ok) {
+        entry.Set("error", Napi::String::New(env, BackendStatusName(statuses_[i])));
+        results.Set((uint32_t)i, entry);
+        continue;
+      }
+
+      const SignatureInfo& signature = infos_[i];
+      entry.Set("state", Napi::String::New(env, SignatureStateName(signature.state)));
+      if (signature.state == SignatureState::Signed) {
+        entry.Set("subject", Napi::String::New(env, signature.signer.subject));
+        entry.Set("issuer", Napi::String::New(env, signature.signer.issuer));
+        entry.Set("publisher", Napi::String::New(env, signature.signer.publisher));
+        entry.Set("digestAlgorithm", Napi::String::New(env, signature.signer.digestAlgorithm));
+      } else if (signature.state == SignatureState::Malformed) {
+        entry.Set("error", Napi::String::New(env, signature.error));
+      }
+      entry.Set("trust", Napi::String::New(env, TrustStateName(signature.trust)));
+      results.Set((uint32_t)i, entry);
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("results", results);
+    result.Set("cache", SignatureCacheStatsToNapi(env, stats_));
+    result.Set("elapsedMs", Napi::Number::New(env, elapsedMs_));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::vector<std::string> paths_;
+  bool useFixtures_ = false;
+  FakeFileSystem fileSystem_;
+  std::vector<BackendStatus> statuses_;
+  std::vector<SignatureInfo> infos_;
+  SignatureCacheStats stats_;
+  double elapsedMs_ = 0;
+};
+
+}  // namespace
+
+bool ParseCertificateTable(const std::string& table, std::string* pkcs7) {
+  // WIN_CERTIFICATE entries (length, revision, type, data), each padded to
+  // 8 bytes; the length includes the header
+  size_t offset = 0;
+  while (offset + kCertificateHeaderBytes <= table.size()) {
+    uint32_t length = ReadU32(table, offset);
+    uint16_t revision = (uint16_t)((uint8_t)table[offset + 4] | ((uint8_t)table[offset + 5] << 8));
+    uint16_t type = (uint16_t)((uint8_t)table[offset + 6] | ((uint8_t)table[offset + 7] << 8));
+    if (length <= kCertificateHeaderBytes || length > table.size() - offset) return false;
+    if (revision == kCertificateRevision && type == kCertificateTypePkcs7) {
+      pkcs7->assign(table, offset + kCertificateHeaderBytes, length - kCertificateHeaderBytes);
+      return true;
+    }
+    offset += (length + 7) & ~(size_t)7;
+  }
+  return false;
+}
+
+bool ParseAuthenticodeSigner(const std::string& pkcs7, AuthenticodeSigner* signer, std::string* error) {
+  // ContentInfo { contentType, [0] EXPLICIT SignedData }
+  DerReader top(pkcs7, 0, pkcs7.size());
+  Der contentInfo, contentType, explicitContent, signedData;
+  if (!top.Expect(kDerSequence, &contentInfo)) return Fail(error, "Not a PKCS#7 ContentInfo");
+  DerReader content(pkcs7, contentInfo);
+  if (!content.Expect(kDerOid, &contentType) || OidToString(pkcs7, contentType) != kSignedDataOid) {
+    return Fail(error, "Not PKCS#7 SignedData");
+  }
+  if (!content.Expect(kDerContext0, &explicitContent) ||
+      !DerReader(pkcs7, explicitContent).Expect(kDerSequence, &signedData)) {
+    return Fail(error, "Malformed SignedData");
+  }
+
+  // SignedData { version, digestAlgorithms, contentInfo, [0] certificates,
+  // [1] crls, signerInfos }
+  DerReader fields(pkcs7, signedData);
+  Der version, digestAlgorithms, spcContent, element, certificates, signerInfos;
+  if (!fields.Expect(kDerInteger, &version) || !fields.Expect(kDerSet, &digestAlgorithms) ||
+      !fields.Expect(kDerSequence, &spcContent)) {
+    return Fail(error, "Malformed SignedData");
+  }
+  bool hasCertificates = false;
+  bool hasSigners = false;
+  while (!hasSigners && fields.Next(&element)) {
+    if (element.tag == kDerContext0) {
+      certificates = element;
+      hasCertificates = true;
+    } else if (element.tag == kDerSet) {
+      signerInfos = element;
+      hasSigners = true;
+    }
+  }
+  if (!hasSigners) return Fail(error, "No SignerInfo");
+
+  // SignerInfo { version, issuerAndSerialNumber, digestAlgorithm, ... }.
+  // Version 3 names the signer by key identifier, which Authenticode does
+  // not use.
+  Der signerInfo, signerVersion, signerId, digestAlgorithm, signerIssuer, signerSerial, algorithm;
+  if (!DerReader(pkcs7, signerInfos).Expect(kDerSequence, &signerInfo)) return Fail(error, "No SignerInfo");
+  DerReader signerFields(pkcs7, signerInfo);
+  if (!signerFields.Expect(kDerInteger, &signerVersion) || !signerFields.Expect(kDerSequence, &signerId) ||
+      !signerFields.Expect(kDerSequence, &digestAlgorithm)) {
+    return Fail(error, "Unsupported SignerInfo");
+  }
+  DerReader idFields(pkcs7, signerId);
+  if (!idFields.Expect(kDerSequence, &signerIssuer) || !idFields.Expect(kDerInteger, &signerSerial)) {
+    return Fail(error, "Unsupported SignerInfo");
+  }
+  if (DerReader(pkcs7, digestAlgorithm).Expect(kDerOid, &algorithm)) {
+    std::string oid = OidToString(pkcs7, algorithm);
+    const char* name = DigestAlgorithmName(oid);
+    signer->digestAlgorithm = name ? name : oid;
+  }
+
+  if (!hasCertificates) return Fail(error, "Signature carries no certificates");
+  DerReader certificateList(pkcs7, certificates);
+  Der certificate, serial, issuer, subject;
+  while (certificateList.Next(&certificate)) {
+    if (certificate.tag != kDerSequence || !ReadCertificateNames(pkcs7, certificate, &serial, &issuer, &subject)) {
+      continue;
+    }
+    if (!SameContents(pkcs7, serial, signerSerial) || !SameContents(pkcs7, issuer, signerIssuer)) continue;
+
+    signer->subject = FormatName(pkcs7, subject);
+    signer->issuer = FormatName(pkcs7, issuer);
+    signer->publisher = NameAttribute(pkcs7, subject, "2.5.4.3");
+    if (signer->publisher.empty()) signer->publisher = NameAttribute(pkcs7, subject, "2.5.4.10");
+    return true;
+  }
+  return Fail(error, "Signing certificate missing from the signature");
+}
+
+BackendStatus ReadSignature(FileSystemBackend& fileSystem, const std::string& path, SignatureInfo* info) {
+  *info = SignatureInfo();
+  std::string header;
+  BackendStatus status = fileSystem.ReadFile(path, kPeHeaderBytes, &header);
+  if (status != BackendStatus::Ok) return status;
+
+  PeImageInfo image;
+  if (!ParsePeHeaders(header, &image)) {
+    info->state = SignatureState::Malformed;
+    info->error = "Not a PE image";
+    return BackendStatus::Ok;
+  }
+  if (image.certificateOffset == 0 || image.certificateSize == 0) return BackendStatus::Ok;
+  if (image.certificateSize > kMaxCertificateTableBytes) {
+    info->state = SignatureState::Malformed;
+    info->error = "Certificate table too large";
+    return BackendStatus::Ok;
+  }
+
+  std::string table;
+  status = fileSystem.ReadFileAt(path, image.certificateOffset, image.certificateSize, &table);
+  if (status != BackendStatus::Ok) return status;
+  std::string pkcs7;
+  if (table.size() < image.certificateSize || !ParseCertificateTable(table, &pkcs7)) {
+    info->state = SignatureState::Malformed;
+    info->error = "No PKCS#7 signature in the certificate table";
+    return BackendStatus::Ok;
+  }
+  info->state = ParseAuthenticodeSigner(pkcs7, &info->signer, &info->error)
+    ? SignatureState::Signed : SignatureState::Malformed;
+  return BackendStatus::Ok;
+}
+
+BackendStatus SignatureCache::LookupEntry(FileSystemBackend& fileSystem, const std::string& path,
+                                          FileIdentity* identity, DirEntry* version, SignatureInfo* info) {
+  BackendStatus status = fileSystem.Stat(path, version);
+  if (status == BackendStatus::Ok) status = fileSystem.Identify(path, identity);
+  if (status != BackendStatus::Ok) return status;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(*identity);
+    if (it != entries_.end() && it->second.size == version->size && it->second.mtimeMs == version->mtimeMs) {
+      stats_.hits++;
+      *info = it->second.info;
+      return BackendStatus::Ok;
+    }
+  }
+
+  // Read outside the lock; concurrent misses on one file both read it
+  status = ReadSignature(fileSystem, path, info);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.reads++;
+  // Full of live entries: start over rather than track recency
+  if (entries_.size() >= maxEntries_ && entries_.find(*identity) == entries_.end()) entries_.clear();
+  Entry& entry = entries_[*identity];
+  entry.size = version->size;
+  entry.mtimeMs = version->mtimeMs;
+  entry.info = *info;
+  return BackendStatus::Ok;
+}
+
+BackendStatus SignatureCache::Lookup(FileSystemBackend& fileSystem, const std::string& path, SignatureInfo* info) {
+  FileIdentity identity;
+  DirEntry version;
+  return LookupEntry(fileSystem, path, &identity, &version, info);
+}
+
+BackendStatus SignatureCache::RecordTrust(FileSystemBackend& fileSystem, const std::string& path, bool trusted) {
+  FileIdentity identity;
+  DirEntry version;
+  SignatureInfo info;
+  BackendStatus status = LookupEntry(fileSystem, path, &identity, &version, &info);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(identity);
+  if (it != entries_.end() && it->second.size == version.size && it->second.mtimeMs == version.mtimeMs) {
+    it->second.info.trust = trusted ? TrustState::Trusted : TrustState::Untrusted;
+    stats_.verdicts++;
+  }
+  return BackendStatus::Ok;
+}
+
+void SignatureCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+SignatureCacheStats SignatureCache::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  SignatureCacheStats stats = stats_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+void ReadSignatures(FileSystemBackend& fileSystem, SignatureCache& cache, const std::vector<std::string>& paths,
+                    TaskLane lane, std::vector<BackendStatus>* statuses, std::vector<SignatureInfo>* infos) {
+  std::unordered_map<std::string, size_t> indexByPath;
+  std::vector<size_t> distinct;  // Index into paths of each distinct path's first occurrence
+  std::vector<size_t> slot(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    auto inserted = indexByPath.emplace(LowerAscii(paths[i]), distinct.size());
+    if (inserted.second) distinct.push_back(i);
+    slot[i] = inserted.first->second;
+  }
+
+  std::vector<BackendStatus> distinctStatuses(distinct.size(), BackendStatus::NotFound);
+  std::vector<SignatureInfo> distinctInfos(distinct.size());
+  std::vector<std::function<void()>> tasks;
+  for (size_t begin = 0; begin < distinct.size(); begin += kSignatureBatchSize) {
+    size_t end = std::min(begin + kSignatureBatchSize, distinct.size());
+    tasks.push_back([&, begin, end]() {
+      for (size_t i = begin; i < end; i++) {
+        distinctStatuses[i] = cache.Lookup(fileSystem, paths[distinct[i]], &distinctInfos[i]);
+      }
+    });
+  }
+  RunParallel(std::move(tasks), lane);
+
+  statuses->resize(paths.size());
+  infos->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    (*statuses)[i] = distinctStatuses[slot[i]];
+    (*infos)[i] = distinctInfos[slot[i]];
+  }
+}
+
+SignatureCache& SharedSignatureCache() {
+  static SignatureCache* cache = new SignatureCache();
+  return *cache;
+}
+
+const char* SignatureStateName(SignatureState state) {
+  switch (state) {
+    case SignatureState::Unsigned: return "unsigned";
+    case SignatureState::Signed: return "signed";
+    case SignatureState::Malformed: return "malformed";
+  }
+  return "unsigned";
+}
+
+const char* TrustStateName(TrustState trust) {
+  switch (trust) {
+    case TrustState::Unverified: return "unverified";
+    case TrustState::Trusted: return "trusted";
+    case TrustState::Untrusted: return "untrusted";
+  }
+  return "unverified";
+}
+
+// ReadSigners: Signer subject and issuer of many executables, parsed from
+// their certificate tables on the background lane and cached by file
+// identity and mtime. Resolves { success, results: [{ path, state?,
+// subject?, issuer?, publisher?, digestAlgorithm?, trust?, error? }], cache,
+// elapsedMs }. trust stays "unverified" until an idle verify job has run.
+Napi::Value ReadSigners(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* usage = "Expected (paths: string[], options?: { filesystem?: object })";
+
+  if (info.Length() < 1 || !info[0].IsArray() ||
+      (info.Length() > 1 && !info[1].IsObject() && !info[1].IsUndefined())) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Array array = info[0].As<Napi::Array>();
+  std::vector<std::string> paths;
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value value = array.Get(i);
+    if (!value.IsString()) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    paths.push_back(value.As<Napi::String>().Utf8Value());
+  }
+  Napi::Object options = info.Length() > 1 && info[1].IsObject()
+    ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+
+  auto* worker = new ReadSignersWorker(env, std::move(paths));
+  std::string error;
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifndef _WIN32
+  if (!worker->UsesFixtures()) {
+    delete worker;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("error", Napi::String::New(env, "Live signer reads need Windows; pass a filesystem fixture"));
+    deferred.Resolve(result);
+    return deferred.Promise();
+  }
+#endif
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
@@ -0,0 +1,116 @@
+#ifndef AUTHENTICODE_H
+#define AUTHENTICODE_H
+
+#include <napi.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "discovery-backend.h"
+#include "executor.h"
+
+// Who signed an executable, read from the Authenticode signature in its PE
+// certificate table (a WIN_CERTIFICATE holding a PKCS#7 SignedData) rather
+// than through WinVerifyTrust, which hashes the whole file and can take
+// tens of milliseconds per binary. Parsing names the signer; it does not
+// prove the signature holds. Verdicts come from the idle scheduler's verify
+// jobs (VerifyAuthenticode in app-enrichment.cc) and are attached to the
+// cached entry.
+
+// Tables are usually a few KB; nested signatures with long chains stay
+// well under this
+constexpr size_t kMaxCertificateTableBytes = 1024 * 1024;
+
+struct AuthenticodeSigner {
+  std::string subject;          // "CN=Contoso Ltd, O=Contoso Ltd, C=US", most specific first
+  std::string issuer;
+  std::string publisher;        // Subject CN, else O
+  std::string digestAlgorithm;  // "sha256", "sha1", ... or the dotted OID
+};
+
+// The first PKCS#7 signature in a PE certificate table
+bool ParseCertificateTable(const std::string& table, std::string* pkcs7);
+
+// Signer of a DER PKCS#7 SignedData: the certificate its first SignerInfo
+// names by issuer and serial number. False with error set when malformed.
+bool ParseAuthenticodeSigner(const std::string& pkcs7, AuthenticodeSigner* signer, std::string* error);
+
+enum class SignatureState {
+  Unsigned,
+  Signed,
+  Malformed  // Not a PE, or a certificate table that does not parse
+};
+
+enum class TrustState {
+  Unverified,
+  Trusted,
+  Untrusted
+};
+
+struct SignatureInfo {
+  SignatureState state = SignatureState::Unsigned;
+  AuthenticodeSigner signer;  // When Signed
+  std::string error;          // When Malformed
+  TrustState trust = TrustState::Unverified;
+};
+
+// Headers, then the certificate table, through fileSystem
+BackendStatus ReadSignature(FileSystemBackend& fileSystem, const std::string& path, SignatureInfo* info);
+
+struct SignatureCacheStats {
+  size_t entries = 0;
+  uint64_t hits = 0;
+  uint64_t reads = 0;     // Signatures read from files
+  uint64_t verdicts = 0;  // Trust verdicts recorded
+};
+
+// Signatures keyed by file identity, so links and renames share an entry,
+// and re-read once a file's size or mtime changes (an update or reinstall).
+// That check is only as fresh as fileSystem's Stat, so pass an uncached
+// backend (LiveFileSystem(), not CachedLiveFileSystem()). Thread-safe.
+class SignatureCache {
+ public:
+  explicit SignatureCache(size_t maxEntries = 16384) : maxEntries_(maxEntries) {}
+
+  BackendStatus Lookup(FileSystemBackend& fileSystem, const std::string& path, SignatureInfo* info);
+  // Attach a WinVerifyTrust verdict to path's current entry, reading the
+  // signature first if it is not cached
+  BackendStatus RecordTrust(FileSystemBackend& fileSystem, const std::string& path, bool trusted);
+
+  void Clear();
+  SignatureCacheStats GetStats();
+
+ private:
+  struct Entry {
+    uint64_t size = 0;
+    int64_t mtimeMs = 0;
+    SignatureInfo info;
+  };
+
+  BackendStatus LookupEntry(FileSystemBackend& fileSystem, const std::string& path, FileIdentity* identity,
+                            DirEntry* version, SignatureInfo* info);
+
+  size_t maxEntries_;
+  std::mutex mutex_;
+  std::unordered_map<FileIdentity, Entry, FileIdentityHash> entries_;
+  SignatureCacheStats stats_;
+};
+
+// Lookup for every path, in parallel batches on the executor. Duplicates
+// are looked up once.
+void ReadSignatures(FileSystemBackend& fileSystem, SignatureCache& cache, const std::vector<std::string>& paths,
+                    TaskLane lane, std::vector<BackendStatus>* statuses, std::vector<SignatureInfo>* infos);
+
+// The cache live lookups and idle verify jobs share
+SignatureCache& SharedSignatureCache();
+
+// "unsigned", "signed" or "malformed"
+const char* SignatureStateName(SignatureState state);
+// "unverified", "trusted" or "untrusted"
+const char* TrustStateName(TrustState trust);
+
+// Function declarations for signer extraction
+Napi::Value ReadSigners(const Napi::CallbackInfo& info);
+
+#endif
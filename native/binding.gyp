@@ -4,7 +4,38 @@
       "target_name": "window-manager",
       "sources": [
         "window-manager.cc",
-        "app-discovery.cc"
+        "window-ops.cc",
+        "window-model.cc",
+        "window-trace.cc",
+        "window-trace-replay.cc",
+        "sim-window-system.cc",
+        "latency-stats.cc",
+        "window-stress.cc",
+        "fault-injection.cc",
+        "discovery-backend.cc",
+        "fake-discovery-backend.cc",
+        "discovery-scan.cc",
+        "discovery-benchmark.cc",
+        "process-priority.cc",
+        "system-activity.cc",
+        "idle-scheduler.cc",
+        "executor.cc",
+        "napi-coro.cc",
+        "window-command-buffer.cc",
+        "helper-executables.cc",
+        "pe-image.cc",
+        "user-profile-scan.cc",
+        "json-reader.cc",
+        "package-manager-scan.cc",
+        "game-library-scan.cc",
+        "discovery-sources.cc",
+        "discovery-pipeline.cc",
+        "catalog.cc",
+        "stat-cache.cc",
+        "authenticode.cc",
+        "roaring-bitmap.cc",
+        "facet-index.cc",
+        "user-assist.cc"
       ],
       "include_dirs": [
         "."
@@ -17,25 +48,49 @@
       ],
       "cflags!": [ "-fno-exceptions" ],
       "cflags_cc!": [ "-fno-exceptions" ],
+      "cflags_cc": [ "-std=c++20" ],
       "xcode_settings": {
         "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+        "CLANG_CXX_LANGUAGE_STANDARD": "c++20",
         "CLANG_CXX_LIBRARY": "libc++",
         "MACOSX_DEPLOYMENT_TARGET": "10.7"
       },
       "msvs_settings": {
         "VCCLCompilerTool": {
-          "ExceptionHandling": 1
+          "ExceptionHandling": 1,
+          "AdditionalOptions": [ "/std:c++20" ]
         }
       },
       "conditions": [
         [
           "OS=='win'",
           {
+            "sources": [
+              "hang-watchdog.cc",
+              "window-readiness.cc",
+              "app-discovery.cc",
+              "discovery-backend-win.cc",
+              "app-enrichment.cc",
+              "window-commands.cc"
+            ],
             "libraries": [
               "-luser32.lib",
               "-lkernel32.lib",
               "-lshell32.lib",
-              "-ladvapi32.lib"
+              "-ladvapi32.lib",
+              "-ldwmapi.lib",
+              "-lgdi32.lib",
+              "-lversion.lib",
+              "-lole32.lib",
+              "-lwintrust.lib"
+            ]
+          }
+        ],
+        [
+          "OS=='linux'",
+          {
+            "libraries": [
+              "-ldl"
             ]
           }
         ]
@@ -0,0 +1,93 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Fixed-capacity multi-producer/multi-consumer ring without locks (Vyukov's
+// bounded queue): each slot carries a sequence number saying whose turn it
+// is, so a push or pop claims its slot with one CAS on the shared position.
+// TryPush/TryPop fail instead of waiting; callers choose how to back off.
+template <typename T>
+class BoundedQueue {
+ public:
+  // Capacity is rounded up to a power of two
+  explicit BoundedQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    mask_ = size - 1;
+    slots_.reset(new Slot[size]);
+    for (size_t i = 0; i < size; i++) slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  // Moves from value only on success
+  bool TryPush(T& value) {
+    size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots_[position & mask_];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      intptr_t turn = (intptr_t)sequence - (intptr_t)position;
+      if (turn == 0) {
+        if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (turn < 0) {
+        return false;  // Full
+      } else {
+        position = enqueuePosition_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool TryPop(T* value) {
+    size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots_[position & mask_];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      intptr_t turn = (intptr_t)sequence - (intptr_t)(position + 1);
+      if (turn == 0) {
+        if (dequeuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          *value = std::move(slot.value);
+          slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (turn < 0) {
+        return false;  // Empty
+      } else {
+        position = dequeuePosition_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t Capacity() const { return mask_ + 1; }
+
+  // Racy snapshot, for occupancy stats only
+  size_t SizeApprox() const {
+    size_t enqueued = enqueuePosition_.load(std::memory_order_relaxed);
+    size_t dequeued = dequeuePosition_.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_ = 0;
+  // Producers and consumers each hammer one position; keep them on
+  // separate cache lines
+  alignas(64) std::atomic<size_t> enqueuePosition_{0};
+  alignas(64) std::atomic<size_t> dequeuePosition_{0};
+};
+
+#endif
@@ -0,0 +1,441 @@
+#include <napi.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "catalog.h"
+#include "discovery-sources.h"
+#include "fake-discovery-backend.h"
+#include "json-reader.h"
+#include "pe-image.h"
+#include "stat-cache.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const char kCatalogFormat[] = "app-catalog";
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool IsSeparator(char c) {
+  return c == '\\' || c == '/';
+}
+
+// "C:\Program Files\" and "C:\Program Files" name the same root
+std::string TrimTrailingSeparators(std::string folder) {
+  while (!folder.empty() && IsSeparator(folder.back())) folder.pop_back();
+  return folder;
+}
+
+void AppendJsonString(std::string* out, const std::string& text) {
+  out->push_back('"');
+  for (char c : text) {
+    switch (c) {
+      case '"': *out += "\\\""; break;
+      case '\\': *out += "\\\\"; break;
+      case '\n': *out += "\\n"; break;
+      case '\r': *out += "\\r"; break;
+      case '\t': *out += "\\t"; break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+          *out += escaped;
+        } else {
+          out->push_back(c);
+        }
+    }
+  }
+  out->push_back('"');
+}
+
+void AppendJsonMember(std::string* out, const char* name, const std::string& value) {
+  AppendJsonString(out, name);
+  *out += ": ";
+  AppendJsonString(out, value);
+}
+
+PeSubsystem SubsystemFromName(const std::string& name) {
+  const PeSubsystem known[] = { PeSubsystem::WindowsGui, PeSubsystem::WindowsConsole, PeSubsystem::Native };
+  for (PeSubsystem subsystem : known) {
+    if (name == PeSubsystemName(subsystem)) return subsystem;
+  }
+  return PeSubsystem::Unknown;
+}
+
+// Serializes the shared discovery cache on the executor, since a snapshot
+// waits for any discovery run in progress
+class ExportWorker : public ExecutorWorker {
+ public:
+  ExportWorker(Napi::Env env, CatalogRoots roots)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      roots_(std::move(roots)) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    std::vector<std::vector<DiscoveredApp>> snapshot = SharedDiscoverySourceCache().Snapshot();
+    const std::vector<DiscoverySource>& discoverySources = DiscoverySources();
+    std::vector<CatalogSource> sources;
+    for (size_t i = 0; i < snapshot.size(); i++) {
+      if (snapshot[i].empty()) continue;
+      appCount_ += snapshot[i].size();
+      sources.push_back({ discoverySources[i].name, std::move(snapshot[i]) });
+    }
+    catalog_ = WriteCatalog(sources, roots_);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("catalog", Napi::String::New(env, catalog_));
+    result.Set("apps", Napi::Number::New(env, (double)appCount_));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  CatalogRoots roots_;
+  std::string catalog_;
+  size_t appCount_ = 0;
+};
+
+// Parses, validates and (for live imports) seeds the shared discovery cache
+class ImportWorker : public ExecutorWorker {
+ public:
+  ImportWorker(Napi::Env env, std::string catalog)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      catalog_(std::move(catalog)) {}
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    if (!ReadCatalogRoots(options.Get("roots"), &roots_, error)) return false;
+    Napi::Value filesystem = options.Get("filesystem");
+    useFixtures_ = !filesystem.IsUndefined();
+    return !useFixtures_ || ReadFakeFileSystem(filesystem, &fileSystem_, error);
+  }
+
+  bool UsesFixtures() const { return useFixtures_; }
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    Clock::time_point start = Clock::now();
+    if (!ReadCatalog(catalog_, roots_, &sources_, &unresolved_, &error_)) return;
+
+    if (useFixtures_) {
+      ValidateCatalog(fileSystem_, TaskLane::Normal, &sources_, &stats_);
+    } else {
+#ifdef _WIN32
+      ValidateCatalog(CachedLiveFileSystem(), TaskLane::Normal, &sources_, &stats_);
+      // Fixture imports only validate; live ones become discovery results
+      const std::vector<DiscoverySource>& discoverySources = DiscoverySources();
+      for (const CatalogSource& source : sources_) {
+        for (size_t i = 0; i < discoverySources.size(); i++) {
+          if (source.name == discoverySources[i].name) SharedDiscoverySourceCache().Seed(i, source.apps);
+        }
+      }
+#endif
+    }
+    elapsedMs_ = MillisecondsSince(start);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    if (!error_.empty()) {
+      result.Set("success", Napi::Boolean::New(env, false));
+      result.Set("error", Napi::String::New(env, error_));
+      deferred_.Resolve(result);
+      return;
+    }
+
+    // One entry per path, first source wins, as in discovery
+    std::vector<DiscoveredApp> apps;
+    std::unordered_set<std::string> seenPaths;
+    size_t imported = 0;
+    size_t missing = 0;
+    for (const CatalogSource& source : sources_) {
+      for (const DiscoveredApp& app : source.apps) {
+        if (seenPaths.insert(LowerAscii(app.path)).second) apps.push_back(app);
+      }
+    }
+    Napi::Array sources = Napi::Array::New(env, stats_.size());
+    for (size_t i = 0; i < stats_.size(); i++) {
+      imported += stats_[i].imported;
+      missing += stats_[i].missing;
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("name", Napi::String::New(env, stats_[i].name));
+      entry.Set("imported", Napi::Number::New(env, (double)stats_[i].imported));
+      entry.Set("missing", Napi::Number::New(env, (double)stats_[i].missing));
+      sources.Set((uint32_t)i, entry);
+    }
+
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("apps", AppsToNapi(env, apps));
+    result.Set("imported", Napi::Number::New(env, (double)imported));
+    result.Set("missing", Napi::Number::New(env, (double)missing));
+    result.Set("unresolved", Napi::Number::New(env, (double)unresolved_));
+    result.Set("sources", sources);
+    result.Set("elapsedMs", Napi::Number::New(env, elapsedMs_));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::string catalog_;
+  CatalogRoots roots_;
+  bool useFixtures_ = false;
+  FakeFileSystem fileSystem_;
+  std::vector<CatalogSource> sources_;
+  std::vector<CatalogSourceStats> stats_;
+  size_t unresolved_ = 0;
+  std::string error_;
+  double elapsedMs_ = 0;
+};
+
+}  // namespace
+
+std::string RelativizeCatalogPath(const std::string& path, const CatalogRoots& roots) {
+  const std::string* bestToken = nullptr;
+  size_t bestLength = 0;
+  std::string lowerPath = LowerAscii(path);
+  for (const auto& root : roots) {
+    std::string folder = LowerAscii(TrimTrailingSeparators(root.second));
+    if (folder.empty() || folder.size() > path.size() || folder.size() <= bestLength) continue;
+    if (lowerPath.compare(0, folder.size(), folder) != 0) continue;
+    if (path.size() > folder.size() && !IsSeparator(path[folder.size()])) continue;
+    bestToken = &root.first;
+    bestLength = folder.size();
+  }
+  if (!bestToken) return path;
+  return "%" + *bestToken + "%" + path.substr(bestLength);
+}
+
+bool ExpandCatalogPath(const std::string& path, const CatalogRoots& roots, std::string* expanded) {
+  if (path.empty() || path[0] != '%') {
+    *expanded = path;
+    return true;
+  }
+  size_t end = path.find('%', 1);
+  if (end == std::string::npos) return false;
+  std::string token = LowerAscii(path.substr(1, end - 1));
+  for (const auto& root : roots) {
+    std::string folder = TrimTrailingSeparators(root.second);
+    if (LowerAscii(root.first) == token && !folder.empty()) {
+      *expanded = folder + path.substr(end + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadCatalogRoots(const Napi::Value& value, CatalogRoots* roots, std::string* error) {
+  if (value.IsUndefined()) {
+#ifdef _WIN32
+    *roots = DefaultCatalogRoots();
+#endif
+    return true;
+  }
+  if (!value.IsObject()) {
+    *error = "roots must be an object of token -> folder";
+    return false;
+  }
+  Napi::Object object = value.As<Napi::Object>();
+  Napi::Array names = object.GetPropertyNames();
+  for (uint32_t i = 0; i < names.Length(); i++) {
+    std::string name = names.Get(i).As<Napi::String>().Utf8Value();
+    Napi::Value folder = object.Get(name);
+    if (!folder.IsString()) {
+      *error = "roots." + name + " must be a string";
+      return false;
+    }
+    roots->push_back({ name, folder.As<Napi::String>().Utf8Value() });
+  }
+  return true;
+}
+
+std::string WriteCatalog(const std::vector<CatalogSource>& sources, const CatalogRoots& roots) {
+  std::string out = "{\n  \"format\": \"" + std::string(kCatalogFormat) + "\",\n  \"version\": " +
+                    std::to_string(kCatalogVersion) + ",\n  \"sources\": {";
+  for (size_t i = 0; i < sources.size(); i++) {
+    out += i == 0 ? "\n    " : ",\n    ";
+    AppendJsonString(&out, sources[i].name);
+    out += ": [";
+    const std::vector<DiscoveredApp>& apps = sources[i].apps;
+    for (size_t j = 0; j < apps.size(); j++) {
+      const DiscoveredApp& app = apps[j];
+      out += j == 0 ? "\n      {" : ",\n      {";
+      AppendJsonMember(&out, "id", app.id);
+      out += ", ";
+      AppendJsonMember(&out, "name", app.name);
+      out += ", ";
+      AppendJsonMember(&out, "path", RelativizeCatalogPath(app.path, roots));
+      out += ", ";
+      AppendJsonMember(&out, "icon", RelativizeCatalogPath(app.icon, roots));
+      if (!app.arch.empty()) {
+        out += ", ";
+        AppendJsonMember(&out, "arch", app.arch);
+      }
+      if (app.subsystem != PeSubsystem::Unknown) {
+        out += ", ";
+        AppendJsonMember(&out, "subsystem", PeSubsystemName(app.subsystem));
+      }
+      out += "}";
+    }
+    out += apps.empty() ? "]" : "\n    ]";
+  }
+  out += sources.empty() ? "}\n}\n" : "\n  }\n}\n";
+  return out;
+}
+
+bool ReadCatalog(const std::string& text, const CatalogRoots& roots,
+                 std::vector<CatalogSource>* sources, size_t* unresolved, std::string* error) {
+  JsonValue document;
+  if (!ParseJson(text, &document, error)) return false;
+  const JsonValue* version = document.Find("version");
+  if (document.GetString("format") != kCatalogFormat || !version || version->type != JsonType::Number) {
+    *error = "Not an app catalog";
+    return false;
+  }
+  if (version->number > kCatalogVersion) {
+    *error = "Catalog version " + std::to_string((int)version->number) + " is newer than this build reads";
+    return false;
+  }
+
+  const JsonValue* members = document.Find("sources");
+  if (!members || !members->IsObject()) {
+    *error = "Catalog has no sources object";
+    return false;
+  }
+
+  *unresolved = 0;
+  for (const auto& member : members->members) {
+    if (!member.second.IsArray()) continue;
+    CatalogSource source;
+    source.name = member.first;
+    for (const JsonValue& entry : member.second.items) {
+      if (!entry.IsObject()) continue;
+      DiscoveredApp app(entry.GetString("id"), entry.GetString("name"), "", "");
+      if (!ExpandCatalogPath(entry.GetString("path"), roots, &app.path) || app.path.empty()) {
+        (*unresolved)++;
+        continue;
+      }
+      // An icon under an unknown root just falls back to the exe's own
+      if (!ExpandCatalogPath(entry.GetString("icon"), roots, &app.icon)) app.icon.clear();
+      app.arch = entry.GetString("arch");
+      app.subsystem = SubsystemFromName(entry.GetString("subsystem"));
+      source.apps.push_back(std::move(app));
+    }
+    sources->push_back(std::move(source));
+  }
+  return true;
+}
+
+void ValidateCatalog(FileSystemBackend& fileSystem, TaskLane lane, std::vector<CatalogSource>* sources,
+                     std::vector<CatalogSourceStats>* stats) {
+  // Sources often share exes; each distinct path is checked once
+  std::unordered_map<std::string, size_t> indexByPath;
+  std::vector<std::string> paths;
+  for (const CatalogSource& source : *sources) {
+    for (const DiscoveredApp& app : source.apps) {
+      if (indexByPath.emplace(LowerAscii(app.path), paths.size()).second) paths.push_back(app.path);
+    }
+  }
+
+  std::vector<char> exists;
+  ExistsBatch(fileSystem, paths, lane, &exists);
+
+  stats->clear();
+  for (CatalogSource& source : *sources) {
+    CatalogSourceStats sourceStats;
+    sourceStats.name = source.name;
+    std::vector<DiscoveredApp> kept;
+    for (DiscoveredApp& app : source.apps) {
+      if (exists[indexByPath[LowerAscii(app.path)]]) {
+        kept.push_back(std::move(app));
+      } else {
+        sourceStats.missing++;
+      }
+    }
+    sourceStats.imported = kept.size();
+    source.apps = std::move(kept);
+    stats->push_back(sourceStats);
+  }
+}
+
+// ExportCatalog: Write the current discovery results as a portable catalog,
+// paths relative to well-known folders. Resolves { success, catalog, apps }.
+Napi::Value ExportCatalog(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* usage = "Expected (options?: { roots?: { [token]: folder } })";
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  CatalogRoots roots;
+  std::string error;
+  if (!ReadCatalogRoots(options.Get("roots"), &roots, &error)) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto* worker = new ExportWorker(env, std::move(roots));
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
+
+// ImportCatalog: Read a catalog, keep the entries whose exe exists here and
+// merge them into discovery's results, so the next discovery skips walks the
+// catalog already covers. With a filesystem fixture it only validates.
+Napi::Value ImportCatalog(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString() ||
+      (info.Length() > 1 && !info[1].IsObject() && !info[1].IsUndefined())) {
+    Napi::TypeError::New(env, "Expected (catalog: string, options?: { roots?, filesystem? })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object options = info.Length() > 1 && info[1].IsObject()
+    ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+
+  auto* worker = new ImportWorker(env, info[0].As<Napi::String>().Utf8Value());
+  std::string error;
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifndef _WIN32
+  if (!worker->UsesFixtures()) {
+    delete worker;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("error", Napi::String::New(env, "Live catalog import needs Windows; pass a filesystem fixture"));
+    deferred.Resolve(result);
+    return deferred.Promise();
+  }
+#endif
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
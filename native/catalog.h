@@ -0,0 +1,66 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <napi.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+#include "executor.h"
+
+// Discovery results as a portable JSON file, so machines imaged from the
+// same golden image start from its catalog instead of a cold discovery.
+// Paths under well-known folders are written relative to them
+// ("%ProgramFiles%\App\app.exe") and re-rooted on import, so a catalog
+// still applies where those folders live elsewhere. Import checks each
+// entry exists rather than rediscovering it.
+//
+//   { "format": "app-catalog", "version": 1,
+//     "sources": { "<source name>": [ { id, name, path, icon, arch?, subsystem? } ] } }
+
+constexpr int kCatalogVersion = 1;
+
+// Token -> this machine's folder, e.g. { "ProgramFiles", "C:\\Program Files" }
+using CatalogRoots = std::vector<std::pair<std::string, std::string>>;
+
+// Longest matching root wins; paths under no root are kept absolute
+std::string RelativizeCatalogPath(const std::string& path, const CatalogRoots& roots);
+// False when the path starts with a token roots does not define
+bool ExpandCatalogPath(const std::string& path, const CatalogRoots& roots, std::string* expanded);
+// Roots from a JS { token: folder } object; undefined means
+// DefaultCatalogRoots() on Windows and none elsewhere
+bool ReadCatalogRoots(const Napi::Value& value, CatalogRoots* roots, std::string* error);
+
+struct CatalogSource {
+  std::string name;  // DiscoverySource name
+  std::vector<DiscoveredApp> apps;
+};
+
+std::string WriteCatalog(const std::vector<CatalogSource>& sources, const CatalogRoots& roots);
+
+// Paths come back expanded; entries with unknown tokens are dropped and
+// counted in unresolved
+bool ReadCatalog(const std::string& text, const CatalogRoots& roots,
+                 std::vector<CatalogSource>* sources, size_t* unresolved, std::string* error);
+
+struct CatalogSourceStats {
+  std::string name;
+  size_t imported = 0;
+  size_t missing = 0;
+};
+
+// Drops entries whose exe does not exist here. Each distinct path is
+// checked once, in parallel batches on the executor.
+void ValidateCatalog(FileSystemBackend& fileSystem, TaskLane lane, std::vector<CatalogSource>* sources,
+                     std::vector<CatalogSourceStats>* stats);
+
+// %ProgramFiles%, %ProgramFiles(x86)%, %ProgramData%, %SystemRoot%,
+// %LOCALAPPDATA%, %APPDATA% and %USERPROFILE% (Windows only, app-discovery.cc)
+CatalogRoots DefaultCatalogRoots();
+
+// Function declarations for catalog export/import
+Napi::Value ExportCatalog(const Napi::CallbackInfo& info);
+Napi::Value ImportCatalog(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,341 @@
+#include <windows.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "discovery-backend.h"
+
+namespace {
+
+// 100ns intervals between 1601-01-01 and 1970-01-01
+constexpr uint64_t kFileTimeUnixEpoch = 116444736000000000ULL;
+
+int64_t FileTimeToUnixMs(const FILETIME& fileTime) {
+  uint64_t ticks = ((uint64_t)fileTime.dwHighDateTime << 32) | fileTime.dwLowDateTime;
+  if (ticks < kFileTimeUnixEpoch) return 0;
+  return (int64_t)((ticks - kFileTimeUnixEpoch) / 10000);
+}
+
+// FindFirstFile reports a reparse point's tag in dwReserved0
+LinkKind LinkKindFromTag(DWORD tag) {
+  if (tag == IO_REPARSE_TAG_MOUNT_POINT) return LinkKind::Junction;
+  if (tag == IO_REPARSE_TAG_SYMLINK) return LinkKind::Symlink;
+  return IsReparseTagNameSurrogate(tag) ? LinkKind::OtherLink : LinkKind::None;
+}
+
+BackendStatus StatusFromError(DWORD error) {
+  switch (error) {
+    case ERROR_SUCCESS:
+      return BackendStatus::Ok;
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_PATH_NOT_FOUND:
+    case ERROR_INVALID_NAME:
+    case ERROR_BAD_NETPATH:
+      return BackendStatus::NotFound;
+    case ERROR_ACCESS_DENIED:
+    case ERROR_SHARING_VIOLATION:
+      return BackendStatus::AccessDenied;
+    case ERROR_SEM_TIMEOUT:
+    case ERROR_TIMEOUT:
+      return BackendStatus::Timeout;
+    default:
+      return BackendStatus::IoError;
+  }
+}
+
+class LiveFileSystemBackend : public FileSystemBackend {
+ public:
+  BackendStatus ListDirectory(const std::string& path, std::vector<DirEntry>* entries) override {
+    // Basic info skips the 8.3 name lookup and LARGE_FETCH asks for bigger
+    // directory buffers, which matters most on network-redirected folders
+    WIN32_FIND_DATAW findData;
+    HANDLE hFind = FindFirstFileExW(Utf8ToWide(JoinPath(path, "*")).c_str(), FindExInfoBasic,
+                                    &findData, FindExSearchNameMatch, NULL,
+                                    FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE) {
+      return StatusFromError(GetLastError());
+    }
+
+    do {
+      if (wcscmp(findData.cFileName, L".") == 0 || wcscmp(findData.cFileName, L"..") == 0) {
+        continue;
+      }
+      DirEntry entry;
+      entry.name = WideToUtf8(findData.cFileName);
+      entry.isDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+      entry.isReparsePoint = (findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+      if (entry.isReparsePoint) entry.link = LinkKindFromTag(findData.dwReserved0);
+      entry.size = ((uint64_t)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+      entry.mtimeMs = FileTimeToUnixMs(findData.ftLastWriteTime);
+      entries->push_back(std::move(entry));
+    } while (FindNextFileW(hFind, &findData));
+
+    FindClose(hFind);
+    return BackendStatus::Ok;
+  }
+
+  BackendStatus Stat(const std::string& path, DirEntry* entry) override {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(Utf8ToWide(path).c_str(), GetFileExInfoStandard, &data)) {
+      return StatusFromError(GetLastError());
+    }
+    entry->name = FileNameOf(path);
+    entry->isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    entry->isReparsePoint = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+    entry->size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    entry->mtimeMs = FileTimeToUnixMs(data.ftLastWriteTime);
+    return BackendStatus::Ok;
+  }
+
+  BackendStatus ReadFile(const std::string& path, size_t maxBytes, std::string* contents) override {
+    return ReadFileAt(path, 0, maxBytes, contents);
+  }
+
+  BackendStatus ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                           std::string* contents) override {
+    HANDLE hFile = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+      return StatusFromError(GetLastError());
+    }
+
+    contents->clear();
+    LARGE_INTEGER position;
+    position.QuadPart = (LONGLONG)offset;
+    if (offset != 0 && !SetFilePointerEx(hFile, position, NULL, FILE_BEGIN)) {
+      BackendStatus status = StatusFromError(GetLastError());
+      CloseHandle(hFile);
+      return status;
+    }
+    char buffer[64 * 1024];
+    BackendStatus status = BackendStatus::Ok;
+    while (contents->size() < maxBytes) {
+      size_t remaining = maxBytes - contents->size();
+      DWORD toRead = (DWORD)(remaining < sizeof(buffer) ? remaining : sizeof(buffer));
+      DWORD bytesRead = 0;
+      if (!::ReadFile(hFile, buffer, toRead, &bytesRead, NULL)) {
+        status = StatusFromError(GetLastError());
+        break;
+      }
+      if (bytesRead == 0) break;
+      contents->append(buffer, bytesRead);
+    }
+
+    CloseHandle(hFile);
+    return status;
+  }
+
+  BackendStatus Identify(const std::string& path, FileIdentity* identity) override {
+    // Attributes-only access opens without reading data; backup semantics
+    // is what lets CreateFile open a directory, and without
+    // FILE_FLAG_OPEN_REPARSE_POINT the open follows links to their target
+    HANDLE hFile = CreateFileW(Utf8ToWide(path).c_str(), FILE_READ_ATTRIBUTES,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                               OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+      return StatusFromError(GetLastError());
+    }
+
+    // 128-bit IDs (ReFS) where available, else the NTFS 64-bit file index
+    BackendStatus status = BackendStatus::Ok;
+    FILE_ID_INFO idInfo;
+    BY_HANDLE_FILE_INFORMATION info;
+    if (GetFileInformationByHandleEx(hFile, FileIdInfo, &idInfo, sizeof(idInfo))) {
+      identity->volume = idInfo.VolumeSerialNumber;
+      memcpy(&identity->fileIdHigh, idInfo.FileId.Identifier + 8, 8);
+      memcpy(&identity->fileIdLow, idInfo.FileId.Identifier, 8);
+    } else if (GetFileInformationByHandle(hFile, &info)) {
+      identity->volume = info.dwVolumeSerialNumber;
+      identity->fileIdHigh = 0;
+      identity->fileIdLow = ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+    } else {
+      status = StatusFromError(GetLastError());
+    }
+
+    CloseHandle(hFile);
+    return status;
+  }
+};
+
+HKEY RootKey(RegistryRoot root) {
+  switch (root) {
+    case RegistryRoot::LocalMachine: return HKEY_LOCAL_MACHINE;
+    case RegistryRoot::CurrentUser: return HKEY_CURRENT_USER;
+    case RegistryRoot::ClassesRoot: return HKEY_CLASSES_ROOT;
+  }
+  return HKEY_LOCAL_MACHINE;
+}
+
+class LiveRegistryBackend : public RegistryBackend {
+ public:
+  BackendStatus EnumerateSubKeys(RegistryRoot root, const std::string& keyPath,
+                                 std::vector<std::string>* names) override {
+    HKEY hKey;
+    LONG error = RegOpenKeyExW(RootKey(root), Utf8ToWide(keyPath).c_str(), 0, KEY_READ, &hKey);
+    if (error != ERROR_SUCCESS) {
+      return StatusFromError(error);
+    }
+
+    wchar_t subKeyName[256];  // Registry key names are limited to 255 characters
+    for (DWORD index = 0;; index++) {
+      DWORD subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
+      if (RegEnumKeyExW(hKey, index, subKeyName, &subKeyNameSize, NULL, NULL, NULL, NULL) != ERROR_SUCCESS) {
+        break;
+      }
+      names->push_back(WideToUtf8(std::wstring(subKeyName, subKeyNameSize)));
+    }
+
+    RegCloseKey(hKey);
+    return BackendStatus::Ok;
+  }
+
+  BackendStatus ReadString(RegistryRoot root, const std::string& keyPath,
+                           const std::string& valueName, std::string* data) override {
+    HKEY hKey;
+    LONG error = RegOpenKeyExW(RootKey(root), Utf8ToWide(keyPath).c_str(), 0, KEY_READ, &hKey);
+    if (error != ERROR_SUCCESS) {
+      return StatusFromError(error);
+    }
+
+    std::wstring name = Utf8ToWide(valueName);
+    DWORD dataSize = 0;
+    DWORD type = REG_SZ;
+    error = RegQueryValueExW(hKey, name.c_str(), NULL, &type, NULL, &dataSize);
+    if (error == ERROR_SUCCESS && type != REG_SZ && type != REG_EXPAND_SZ) {
+      error = ERROR_FILE_NOT_FOUND;
+    }
+
+    std::vector<wchar_t> buffer(dataSize / sizeof(wchar_t) + 1);
+    if (error == ERROR_SUCCESS) {
+      error = RegQueryValueExW(hKey, name.c_str(), NULL, &type, (LPBYTE)buffer.data(), &dataSize);
+    }
+    RegCloseKey(hKey);
+    if (error != ERROR_SUCCESS) {
+      return StatusFromError(error);
+    }
+
+    buffer.back() = L'\0';
+    *data = WideToUtf8(std::wstring(buffer.data()));
+    return BackendStatus::Ok;
+  }
+
+  BackendStatus ReadValues(RegistryRoot root, const std::string& keyPath,
+                           std::vector<RegistryValue>* values) override {
+    HKEY hKey;
+    LONG error = RegOpenKeyExW(RootKey(root), Utf8ToWide(keyPath).c_str(), 0, KEY_READ, &hKey);
+    if (error != ERROR_SUCCESS) {
+      return StatusFromError(error);
+    }
+
+    // Size the buffers once from the key's largest name and value
+    DWORD maxNameLength = 0;
+    DWORD maxDataSize = 0;
+    error = RegQueryInfoKeyW(hKey, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                             &maxNameLength, &maxDataSize, NULL, NULL);
+    if (error != ERROR_SUCCESS) {
+      RegCloseKey(hKey);
+      return StatusFromError(error);
+    }
+
+    std::vector<wchar_t> name(maxNameLength + 1);
+    std::vector<wchar_t> data(maxDataSize / sizeof(wchar_t) + 1);
+    for (DWORD index = 0;; index++) {
+      DWORD nameLength = (DWORD)name.size();
+      DWORD dataSize = (DWORD)(data.size() * sizeof(wchar_t));
+      DWORD type = 0;
+      error = RegEnumValueW(hKey, index, name.data(), &nameLength, NULL, &type,
+                            (LPBYTE)data.data(), &dataSize);
+      if (error == ERROR_MORE_DATA) {
+        // A value grew since RegQueryInfoKey; retry the same index
+        name.resize(name.size() * 2);
+        data.resize(data.size() * 2);
+        index--;
+        continue;
+      }
+      if (error != ERROR_SUCCESS) break;
+      if (type != REG_SZ && type != REG_EXPAND_SZ) continue;
+
+      std::wstring text(data.data(), dataSize / sizeof(wchar_t));
+      while (!text.empty() && text.back() == L'\0') text.pop_back();
+      if (type == REG_EXPAND_SZ) {
+        DWORD expandedSize = ExpandEnvironmentStringsW(text.c_str(), NULL, 0);
+        std::vector<wchar_t> expanded(expandedSize + 1);
+        if (expandedSize && ExpandEnvironmentStringsW(text.c_str(), expanded.data(), expandedSize)) {
+          text = expanded.data();
+        }
+      }
+      values->push_back({ WideToUtf8(std::wstring(name.data(), nameLength)), WideToUtf8(text) });
+    }
+
+    RegCloseKey(hKey);
+    return BackendStatus::Ok;
+  }
+
+  BackendStatus ReadBinaryValues(RegistryRoot root, const std::string& keyPath,
+                                 std::vector<RegistryValue>* values) override {
+    HKEY hKey;
+    LONG error = RegOpenKeyExW(RootKey(root), Utf8ToWide(keyPath).c_str(), 0, KEY_READ, &hKey);
+    if (error != ERROR_SUCCESS) {
+      return StatusFromError(error);
+    }
+
+    DWORD maxNameLength = 0;
+    DWORD maxDataSize = 0;
+    error = RegQueryInfoKeyW(hKey, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                             &maxNameLength, &maxDataSize, NULL, NULL);
+    if (error != ERROR_SUCCESS) {
+      RegCloseKey(hKey);
+      return StatusFromError(error);
+    }
+
+    std::vector<wchar_t> name(maxNameLength + 1);
+    std::vector<BYTE> data(maxDataSize + 1);
+    for (DWORD index = 0;; index++) {
+      DWORD nameLength = (DWORD)name.size();
+      DWORD dataSize = (DWORD)data.size();
+      DWORD type = 0;
+      error = RegEnumValueW(hKey, index, name.data(), &nameLength, NULL, &type, data.data(), &dataSize);
+      if (error == ERROR_MORE_DATA) {
+        name.resize(name.size() * 2);
+        data.resize(data.size() * 2);
+        index--;
+        continue;
+      }
+      if (error != ERROR_SUCCESS) break;
+      if (type != REG_BINARY) continue;
+      values->push_back({ WideToUtf8(std::wstring(name.data(), nameLength)),
+                          std::string((const char*)data.data(), dataSize) });
+    }
+
+    RegCloseKey(hKey);
+    return BackendStatus::Ok;
+  }
+};
+
+}  // namespace
+
+std::string WideToUtf8(const std::wstring& wstr) {
+  if (wstr.empty()) return std::string();
+  int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
+  std::string strTo(size_needed, 0);
+  WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
+  return strTo;
+}
+
+std::wstring Utf8ToWide(const std::string& str) {
+  if (str.empty()) return std::wstring();
+  int size_needed = MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), NULL, 0);
+  std::wstring wstrTo(size_needed, 0);
+  MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), &wstrTo[0], size_needed);
+  return wstrTo;
+}
+
+FileSystemBackend& LiveFileSystem() {
+  static LiveFileSystemBackend backend;
+  return backend;
+}
+
+RegistryBackend& LiveRegistry() {
+  static LiveRegistryBackend backend;
+  return backend;
+}
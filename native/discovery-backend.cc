@@ -0,0 +1,64 @@
+#include <algorithm>
+#include "discovery-backend.h"
+
+const char* BackendStatusName(BackendStatus status) {
+  switch (status) {
+    case BackendStatus::Ok: return "ok";
+    case BackendStatus::NotFound: return "notFound";
+    case BackendStatus::AccessDenied: return "accessDenied";
+    case BackendStatus::IoError: return "ioError";
+    case BackendStatus::Timeout: return "timeout";
+  }
+  return "ioError";
+}
+
+const char* LinkKindName(LinkKind kind) {
+  switch (kind) {
+    case LinkKind::None: return "none";
+    case LinkKind::Junction: return "junction";
+    case LinkKind::Symlink: return "symlink";
+    case LinkKind::OtherLink: return "otherLink";
+  }
+  return "none";
+}
+
+const char* RegistryRootName(RegistryRoot root) {
+  switch (root) {
+    case RegistryRoot::LocalMachine: return "HKLM";
+    case RegistryRoot::CurrentUser: return "HKCU";
+    case RegistryRoot::ClassesRoot: return "HKCR";
+  }
+  return "HKLM";
+}
+
+std::string FindRegistryValue(const std::vector<RegistryValue>& values, const std::string& name) {
+  std::string lowerName = LowerAscii(name);
+  for (const RegistryValue& value : values) {
+    if (LowerAscii(value.name) == lowerName) return value.data;
+  }
+  return "";
+}
+
+std::string JoinPath(const std::string& directory, const std::string& name) {
+  if (directory.empty()) return name;
+  char last = directory.back();
+  if (last == '\\' || last == '/') return directory + name;
+  return directory + "\\" + name;
+}
+
+std::string FileNameOf(const std::string& path) {
+  size_t lastSlash = path.find_last_of("\\/");
+  return lastSlash != std::string::npos ? path.substr(lastSlash + 1) : path;
+}
+
+std::string LowerAscii(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+    return (char)(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+  });
+  return text;
+}
+
+bool EndsWithNoCase(const std::string& text, const std::string& suffix) {
+  if (suffix.size() > text.size()) return false;
+  return LowerAscii(text.substr(text.size() - suffix.size())) == LowerAscii(suffix);
+}
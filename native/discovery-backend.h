@@ -0,0 +1,136 @@
+#ifndef DISCOVERY_BACKEND_H
+#define DISCOVERY_BACKEND_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Filesystem and registry access used by app discovery. Scans are written
+// against these interfaces so they run unchanged over the live system
+// (discovery-backend-win.cc) and over in-memory fakes with injected latency
+// and faults (fake-discovery-backend.h). Paths and names are UTF-8 and use
+// Windows separators.
+
+enum class BackendStatus {
+  Ok,
+  NotFound,
+  AccessDenied,
+  IoError,
+  Timeout
+};
+
+// Reparse points that stand in for another path. Other reparse points
+// (OneDrive placeholders, deduplicated files) are ordinary entries to a walk.
+enum class LinkKind {
+  None,
+  Junction,
+  Symlink,
+  OtherLink  // Any other name-surrogate tag
+};
+
+struct DirEntry {
+  std::string name;
+  bool isDirectory = false;
+  bool isReparsePoint = false;
+  LinkKind link = LinkKind::None;  // Set by ListDirectory
+  uint64_t size = 0;
+  int64_t mtimeMs = 0;  // Unix epoch milliseconds
+};
+
+// The physical file or directory a path resolves to, however it was
+// reached: two paths with equal identities name the same object
+struct FileIdentity {
+  uint64_t volume = 0;
+  uint64_t fileIdHigh = 0;
+  uint64_t fileIdLow = 0;
+
+  bool operator==(const FileIdentity& other) const {
+    return volume == other.volume && fileIdHigh == other.fileIdHigh && fileIdLow == other.fileIdLow;
+  }
+};
+
+struct FileIdentityHash {
+  size_t operator()(const FileIdentity& identity) const {
+    uint64_t hash = identity.volume * 0x9e3779b97f4a7c15ull;
+    hash ^= identity.fileIdHigh + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    hash ^= identity.fileIdLow + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    return (size_t)hash;
+  }
+};
+
+class FileSystemBackend {
+ public:
+  virtual ~FileSystemBackend() = default;
+
+  // List a directory's entries (without "." and "..") in one pass
+  virtual BackendStatus ListDirectory(const std::string& path, std::vector<DirEntry>* entries) = 0;
+  virtual BackendStatus Stat(const std::string& path, DirEntry* entry) = 0;
+  // Read up to maxBytes from the start of a file
+  virtual BackendStatus ReadFile(const std::string& path, size_t maxBytes, std::string* contents) = 0;
+  // Read up to maxBytes starting offset bytes in, e.g. a PE's certificate
+  // table at the end of the file; past the end reads nothing
+  virtual BackendStatus ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                                   std::string* contents) = 0;
+  // Identity of what path resolves to, following links; a dangling or
+  // looping link fails
+  virtual BackendStatus Identify(const std::string& path, FileIdentity* identity) = 0;
+
+  bool Exists(const std::string& path) {
+    DirEntry entry;
+    return Stat(path, &entry) == BackendStatus::Ok;
+  }
+};
+
+enum class RegistryRoot {
+  LocalMachine,
+  CurrentUser,
+  ClassesRoot
+};
+
+struct RegistryValue {
+  std::string name;  // Empty for the default value
+  std::string data;  // UTF-8 text, or the raw bytes of a REG_BINARY value
+};
+
+class RegistryBackend {
+ public:
+  virtual ~RegistryBackend() = default;
+
+  virtual BackendStatus EnumerateSubKeys(RegistryRoot root, const std::string& keyPath,
+                                         std::vector<std::string>* names) = 0;
+  // Read a REG_SZ/REG_EXPAND_SZ value; an empty valueName reads the default value
+  virtual BackendStatus ReadString(RegistryRoot root, const std::string& keyPath,
+                                   const std::string& valueName, std::string* data) = 0;
+  // Every REG_SZ/REG_EXPAND_SZ value of a key from one open, in enumeration
+  // order, with REG_EXPAND_SZ data expanded. Scans that need several values
+  // of a key use this instead of one ReadString (one open) per value.
+  virtual BackendStatus ReadValues(RegistryRoot root, const std::string& keyPath,
+                                   std::vector<RegistryValue>* values) = 0;
+  // Every REG_BINARY value of a key from one open, in enumeration order
+  virtual BackendStatus ReadBinaryValues(RegistryRoot root, const std::string& keyPath,
+                                         std::vector<RegistryValue>* values) = 0;
+};
+
+// Data of the named value (case-insensitive), or "" when absent
+std::string FindRegistryValue(const std::vector<RegistryValue>& values, const std::string& name);
+
+// Live system backends (Windows only, discovery-backend-win.cc)
+FileSystemBackend& LiveFileSystem();
+RegistryBackend& LiveRegistry();
+
+const char* BackendStatusName(BackendStatus status);
+const char* LinkKindName(LinkKind kind);
+const char* RegistryRootName(RegistryRoot root);
+
+// Path helpers shared by the scanners and the fake backends
+std::string JoinPath(const std::string& directory, const std::string& name);
+std::string FileNameOf(const std::string& path);
+std::string LowerAscii(std::string text);
+bool EndsWithNoCase(const std::string& text, const std::string& suffix);
+
+#ifdef _WIN32
+std::string WideToUtf8(const std::wstring& wstr);
+std::wstring Utf8ToWide(const std::string& str);
+#endif
+
+#endif
@@ -0,0 +1,256 @@
+#include <napi.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "discovery-benchmark.h"
+#include "executor.h"
+#include "discovery-scan.h"
+#include "fake-discovery-backend.h"
+#include "fault-injection.h"
+#include "latency-stats.h"
+#include "sim-window-system.h"
+#include "window-model.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+enum BenchmarkStage {
+  kStageRegistry,
+  kStageProgramFiles,
+  kStageSystemApps,
+  kStageLaunch,
+  kStageFindMainWindow,
+  kStageEmbed,
+  kStageResize,
+  kStageCount
+};
+
+const char* const kStageNames[kStageCount] = {
+  "registry", "programFiles", "systemApps", "launch", "findMainWindow", "embed", "resize"
+};
+
+constexpr uint32_t kDefaultIterations = 100;
+constexpr uint32_t kDefaultRegistryApps = 100;
+constexpr uint32_t kDefaultProgramFilesApps = 200;
+constexpr uint32_t kBenchmarkProcessId = 0x50000000;
+constexpr uint64_t kBenchmarkHostWindow = 0x1000;
+
+struct StageStats {
+  LatencyRecorder latency;
+  uint64_t failures = 0;
+};
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Registry uninstall entries with install folders, plus loose tools under
+// Program Files (x86) and a few built-in apps, shaped like a typical machine
+void AddSyntheticFixture(FakeFileSystem* fileSystem, FakeRegistry* registry,
+                         uint32_t registryApps, uint32_t programFilesApps) {
+  const std::string uninstallKey = "SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall\\";
+  for (uint32_t i = 0; i < registryApps; i++) {
+    std::string name = "Synthetic App " + std::to_string(i);
+    std::string installDir = "C:\\Program Files\\" + name;
+    std::string exePath = installDir + "\\app" + std::to_string(i) + ".exe";
+    fileSystem->AddFileEntry(exePath, 4 * 1024 * 1024);
+    fileSystem->AddFileEntry(installDir + "\\unins000.exe", 1024 * 1024);
+
+    std::string key = uninstallKey + "{Synthetic-" + std::to_string(i) + "}";
+    registry->SetString(RegistryRoot::LocalMachine, key, "DisplayName", name);
+    registry->SetString(RegistryRoot::LocalMachine, key, "InstallLocation", installDir);
+    registry->SetString(RegistryRoot::LocalMachine, key, "UninstallString",
+                        "\"" + installDir + "\\unins000.exe\"");
+    registry->SetString(RegistryRoot::LocalMachine, key, "DisplayIcon", exePath + ",0");
+  }
+
+  for (uint32_t i = 0; i < programFilesApps; i++) {
+    std::string dir = "C:\\Program Files (x86)\\Tool " + std::to_string(i);
+    fileSystem->AddFileEntry(dir + "\\tool" + std::to_string(i) + ".exe", 512 * 1024);
+  }
+
+  fileSystem->AddFileEntry("C:\\Windows\\System32\\notepad.exe", 200 * 1024);
+  fileSystem->AddFileEntry("C:\\Windows\\System32\\cmd.exe", 300 * 1024);
+  fileSystem->AddFileEntry("C:\\Windows\\System32\\calc.exe", 30 * 1024);
+}
+
+// Runs every discovery and embed stage `iterations` times on an executor
+// worker against fault-injected fakes and reports per-stage percentiles
+class DiscoveryBenchmarkWorker : public ExecutorWorker {
+ public:
+  DiscoveryBenchmarkWorker(Napi::Env env, uint32_t seed)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      faults_(seed),
+      fileSystem_(&faults_),
+      registry_(&faults_) {
+    sim_.SetFaultInjector(&faults_);
+  }
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    Napi::Value iterations = options.Get("iterations");
+    if (iterations.IsNumber()) iterations_ = iterations.As<Napi::Number>().Uint32Value();
+    if (iterations_ == 0) iterations_ = 1;
+
+    if (!ReadFaultRules(options.Get("faults"), &faults_, error)) return false;
+
+    Napi::Value filesystem = options.Get("filesystem");
+    Napi::Value registry = options.Get("registry");
+    if (!ReadFakeFileSystem(filesystem, &fileSystem_, error)) return false;
+    if (!ReadFakeRegistry(registry, &registry_, error)) return false;
+
+    // Without explicit fixtures, benchmark a synthetic machine
+    if (filesystem.IsUndefined() && registry.IsUndefined()) {
+      uint32_t registryApps = kDefaultRegistryApps;
+      uint32_t programFilesApps = kDefaultProgramFilesApps;
+      Napi::Value synthetic = options.Get("synthetic");
+      if (synthetic.IsObject()) {
+        Napi::Object object = synthetic.As<Napi::Object>();
+        Napi::Value value = object.Get("registryApps");
+        if (value.IsNumber()) registryApps = value.As<Napi::Number>().Uint32Value();
+        value = object.Get("programFilesApps");
+        if (value.IsNumber()) programFilesApps = value.As<Napi::Number>().Uint32Value();
+      }
+      AddSyntheticFixture(&fileSystem_, &registry_, registryApps, programFilesApps);
+    }
+    return true;
+  }
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    for (uint32_t i = 0; i < iterations_; i++) {
+      RunDiscovery();
+      RunEmbed(kBenchmarkProcessId + i);
+    }
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("iterations", Napi::Number::New(env, iterations_));
+
+    Napi::Object stages = Napi::Object::New(env);
+    for (int i = 0; i < kStageCount; i++) {
+      Napi::Object stage = LatencySummaryToObject(env, stages_[i].latency.Summarize());
+      stage.Set("failures", Napi::Number::New(env, (double)stages_[i].failures));
+      stages.Set(kStageNames[i], stage);
+    }
+    result.Set("stages", stages);
+
+    Napi::Object apps = Napi::Object::New(env);
+    apps.Set("registry", Napi::Number::New(env, (double)appCounts_[kStageRegistry]));
+    apps.Set("programFiles", Napi::Number::New(env, (double)appCounts_[kStageProgramFiles]));
+    apps.Set("systemApps", Napi::Number::New(env, (double)appCounts_[kStageSystemApps]));
+    result.Set("apps", apps);
+
+    result.Set("faults", FaultStatsToObject(env, faults_.GetStats()));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  template <typename Scan>
+  void TimeScan(BenchmarkStage stage, Scan scan) {
+    std::vector<DiscoveredApp> apps;
+    Clock::time_point start = Clock::now();
+    scan(&apps);
+    stages_[stage].latency.Add(MillisecondsSince(start));
+    appCounts_[stage] = apps.size();
+  }
+
+  void RunDiscovery() {
+    TimeScan(kStageRegistry, [&](std::vector<DiscoveredApp>* apps) {
+      ScanUninstallEntries(registry_, fileSystem_, apps);
+    });
+    TimeScan(kStageProgramFiles, [&](std::vector<DiscoveredApp>* apps) {
+      ScanProgramFilesRoots(fileSystem_, DefaultProgramFilesRoots(), ProgramFilesScanOptions(), apps, nullptr);
+    });
+    TimeScan(kStageSystemApps, [&](std::vector<DiscoveredApp>* apps) {
+      ScanSystemAppList(fileSystem_, apps);
+    });
+  }
+
+  // launch -> find main window -> embed -> first resize, as launchAndEmbed does
+  void RunEmbed(uint32_t processId) {
+    Clock::time_point start = Clock::now();
+    BackendStatus launched = faults_.Inject("window:launch");
+    uint64_t handle = 0;
+    if (launched == BackendStatus::Ok) {
+      handle = sim_.AddWindow(processId, "BenchmarkWindow", "Benchmark", true);
+    }
+    stages_[kStageLaunch].latency.Add(MillisecondsSince(start));
+    if (!handle) {
+      stages_[kStageLaunch].failures++;
+      return;
+    }
+
+    start = Clock::now();
+    uint64_t found = 0;
+    if (faults_.Inject("window:enumerate") == BackendStatus::Ok) {
+      found = SelectMainWindow(sim_.EnumerateProcessWindows(processId));
+    }
+    stages_[kStageFindMainWindow].latency.Add(MillisecondsSince(start));
+    if (found != handle) {
+      stages_[kStageFindMainWindow].failures++;
+      sim_.RemoveWindow(handle);
+      return;
+    }
+
+    start = Clock::now();
+    WindowOpStatus status = sim_.Embed(handle, kBenchmarkHostWindow, 0, 40, 1280, 720);
+    stages_[kStageEmbed].latency.Add(MillisecondsSince(start));
+    if (status != WindowOpStatus::Ok) {
+      stages_[kStageEmbed].failures++;
+    } else {
+      start = Clock::now();
+      status = sim_.SetGeometry(handle, 0, 40, 1366, 768);
+      stages_[kStageResize].latency.Add(MillisecondsSince(start));
+      if (status != WindowOpStatus::Ok) stages_[kStageResize].failures++;
+    }
+
+    sim_.RemoveWindow(handle);
+  }
+
+  Napi::Promise::Deferred deferred_;
+  uint32_t iterations_ = kDefaultIterations;
+  FaultInjector faults_;
+  FakeFileSystem fileSystem_;
+  FakeRegistry registry_;
+  SimWindowSystem sim_;
+  StageStats stages_[kStageCount];
+  size_t appCounts_[kStageCount] = {};
+};
+
+}  // namespace
+
+// RunDiscoveryBenchmark: Time each discovery and embed stage over fake
+// registry/filesystem/window backends with injected latency, errors and hangs
+Napi::Value RunDiscoveryBenchmark(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { iterations, seed, faults, filesystem, registry, synthetic })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+  Napi::Value seed = options.Get("seed");
+
+  auto* worker = new DiscoveryBenchmarkWorker(env, seed.IsNumber() ? seed.As<Napi::Number>().Uint32Value() : 1);
+  std::string error;
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
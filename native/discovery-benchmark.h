@@ -0,0 +1,9 @@
+#ifndef DISCOVERY_BENCHMARK_H
+#define DISCOVERY_BENCHMARK_H
+
+#include <napi.h>
+
+// Function declarations for the discovery/embed benchmark over fake backends
+Napi::Value RunDiscoveryBenchmark(const Napi::CallbackInfo& info);
+
+#endif
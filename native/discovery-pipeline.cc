@@ -0,0 +1,434 @@
+#include <napi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "bounded-queue.h"
+#include "discovery-pipeline.h"
+#include "fake-discovery-backend.h"
+#include "pe-image.h"
+#include "stat-cache.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const char* const kParallelismOptionNames[kPipelineStageCount] = {
+  nullptr, "classify", "resolve", "validate", "enrich", nullptr
+};
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <typename T>
+void AtomicMin(std::atomic<T>& target, T value) {
+  T current = target.load();
+  while (value < current && !target.compare_exchange_weak(current, value)) {}
+}
+
+template <typename T>
+void AtomicMax(std::atomic<T>& target, T value) {
+  T current = target.load();
+  while (value > current && !target.compare_exchange_weak(current, value)) {}
+}
+
+// Spin briefly, then yield, then sleep while other threads hold the work
+void Backoff(uint32_t* idleRounds) {
+  uint32_t rounds = ++*idleRounds;
+  if (rounds < 16) return;
+  if (rounds < 64) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+}
+
+// Stages run `fn` on one item at a time and pass results on with `emit`.
+// Shared with the helper tasks, which may start after Run has returned and
+// then find nothing left to do.
+template <typename Item>
+class StagedPipeline : public std::enable_shared_from_this<StagedPipeline<Item>> {
+ public:
+  using Emit = std::function<void(Item&)>;
+  using StageFn = std::function<void(Item&, const Emit&)>;
+
+  explicit StagedPipeline(size_t queueCapacity) : queueCapacity_(queueCapacity) {}
+
+  void AddStage(uint32_t parallelism, StageFn fn) {
+    stages_.push_back(std::make_unique<Stage>(queueCapacity_, parallelism, std::move(fn)));
+  }
+
+  // Before Run; the first stage's input
+  void Seed(Item& item) {
+    stages_[0]->queue.TryPush(item);
+    stages_[0]->enqueued.fetch_add(1);
+  }
+
+  // Returns once every stage has drained. `threads` counts the caller.
+  void Run(TaskLane lane, uint32_t threads) {
+    start_ = Clock::now();
+    auto self = this->shared_from_this();
+    for (uint32_t i = 1; i < threads; i++) {
+      SharedExecutor().Submit(lane, [self](const CancellationToken&) { self->WorkLoop(); });
+    }
+    WorkLoop();
+  }
+
+  void CollectStats(std::vector<PipelineStageStats>* stats) const {
+    stats->clear();
+    for (size_t i = 0; i < stages_.size(); i++) {
+      const Stage& stage = *stages_[i];
+      PipelineStageStats entry;
+      entry.stage = (PipelineStage)i;
+      entry.parallelism = stage.parallelism;
+      entry.processed = stage.dequeued.load();
+      entry.emitted = stage.emitted.load();
+      entry.busyMs = stage.busyNs.load() / 1e6;
+      int64_t spanNs = stage.lastEndNs.load() - stage.firstStartNs.load();
+      if (entry.processed > 0 && spanNs > 0) entry.itemsPerSecond = entry.processed * 1e9 / spanNs;
+      entry.queueCapacity = (uint32_t)stage.queue.Capacity();
+      entry.queuePeak = stage.queuePeak.load();
+      uint64_t samples = stage.occupancySamples.load();
+      if (samples > 0) entry.queueMean = (double)stage.occupancySum.load() / samples;
+      stats->push_back(entry);
+    }
+  }
+
+ private:
+  struct Stage {
+    Stage(size_t capacity, uint32_t parallelism, StageFn fn)
+      : queue(capacity), parallelism(parallelism), fn(std::move(fn)) {}
+
+    BoundedQueue<Item> queue;  // Input
+    uint32_t parallelism;
+    StageFn fn;
+    std::atomic<uint32_t> active{0};
+    std::atomic<uint64_t> enqueued{0};
+    std::atomic<uint64_t> dequeued{0};
+    std::atomic<uint64_t> emitted{0};
+    std::atomic<int64_t> busyNs{0};  // Includes time blocked on a full output queue
+    std::atomic<int64_t> firstStartNs{INT64_MAX};
+    std::atomic<int64_t> lastEndNs{0};
+    std::atomic<uint32_t> queuePeak{0};
+    std::atomic<uint64_t> occupancySum{0};
+    std::atomic<uint64_t> occupancySamples{0};
+    std::atomic<bool> finished{false};
+  };
+
+  int64_t NanosecondsSinceStart() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count();
+  }
+
+  void WorkLoop() {
+    uint32_t idleRounds = 0;
+    while (!stages_.back()->finished.load()) {
+      // Downstream first, so items in flight drain before new ones enter
+      bool worked = false;
+      for (size_t i = stages_.size(); i-- > 0 && !worked;) worked = TryRunStage(i);
+      if (worked) {
+        idleRounds = 0;
+        continue;
+      }
+      UpdateFinished();
+      Backoff(&idleRounds);
+    }
+  }
+
+  // A stage is done once its upstream is done, every item pushed to it was
+  // taken, and no worker is still inside it. Workers count themselves active
+  // before taking an item, so reading the counts before `active` cannot miss
+  // one mid-item.
+  void UpdateFinished() {
+    for (size_t i = 0; i < stages_.size(); i++) {
+      Stage& stage = *stages_[i];
+      if (stage.finished.load()) continue;
+      if (i > 0 && !stages_[i - 1]->finished.load()) return;
+      if (stage.enqueued.load() != stage.dequeued.load() || stage.active.load() != 0) return;
+      stage.finished.store(true);
+    }
+  }
+
+  bool TryRunStage(size_t index) {
+    Stage& stage = *stages_[index];
+    uint32_t active = stage.active.load();
+    do {
+      if (active >= stage.parallelism) return false;
+    } while (!stage.active.compare_exchange_weak(active, active + 1));
+
+    Item item;
+    if (!stage.queue.TryPop(&item)) {
+      stage.active.fetch_sub(1);
+      return false;
+    }
+    stage.dequeued.fetch_add(1);
+
+    int64_t startNs = NanosecondsSinceStart();
+    AtomicMin(stage.firstStartNs, startNs);
+    stage.fn(item, [this, index](Item& output) { Push(index + 1, output); });
+    int64_t endNs = NanosecondsSinceStart();
+    stage.busyNs.fetch_add(endNs - startNs);
+    AtomicMax(stage.lastEndNs, endNs);
+    stage.active.fetch_sub(1);
+    return true;
+  }
+
+  void Push(size_t index, Item& item) {
+    if (index >= stages_.size()) return;
+    Stage& next = *stages_[index];
+
+    // Back-pressure: work the full queue's stage (or later ones) until it
+    // has room. The last stage never pushes, so this always ends.
+    uint32_t idleRounds = 0;
+    while (!next.queue.TryPush(item)) {
+      bool helped = false;
+      for (size_t i = stages_.size(); i-- > index && !helped;) helped = TryRunStage(i);
+      if (!helped) Backoff(&idleRounds);
+    }
+    next.enqueued.fetch_add(1);
+    stages_[index - 1]->emitted.fetch_add(1);
+
+    uint32_t occupancy = (uint32_t)next.queue.SizeApprox();
+    AtomicMax(next.queuePeak, occupancy);
+    next.occupancySum.fetch_add(occupancy);
+    next.occupancySamples.fetch_add(1);
+  }
+
+  size_t queueCapacity_;
+  std::vector<std::unique_ptr<Stage>> stages_;
+  Clock::time_point start_;
+};
+
+struct PipelineItem {
+  uint64_t sequence = 0;  // Enumeration order
+  UninstallEntry entry;
+  DiscoveredApp app;
+};
+
+Napi::Array PipelineStatsToNapi(Napi::Env env, const std::vector<PipelineStageStats>& stats) {
+  Napi::Array result = Napi::Array::New(env, stats.size());
+  for (size_t i = 0; i < stats.size(); i++) {
+    const PipelineStageStats& stage = stats[i];
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("name", Napi::String::New(env, PipelineStageName(stage.stage)));
+    entry.Set("parallelism", Napi::Number::New(env, stage.parallelism));
+    entry.Set("processed", Napi::Number::New(env, (double)stage.processed));
+    entry.Set("emitted", Napi::Number::New(env, (double)stage.emitted));
+    entry.Set("busyMs", Napi::Number::New(env, stage.busyMs));
+    entry.Set("itemsPerSecond", Napi::Number::New(env, stage.itemsPerSecond));
+    Napi::Object queue = Napi::Object::New(env);
+    queue.Set("capacity", Napi::Number::New(env, stage.queueCapacity));
+    queue.Set("peak", Napi::Number::New(env, stage.queuePeak));
+    queue.Set("mean", Napi::Number::New(env, stage.queueMean));
+    entry.Set("queue", queue);
+    result.Set((uint32_t)i, entry);
+  }
+  return result;
+}
+
+// Runs the pipeline on the executor, over fakes when fixtures are given
+class PipelineWorker : public ExecutorWorker {
+ public:
+  explicit PipelineWorker(Napi::Env env)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)) {}
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    Napi::Value parallelism = options.Get("parallelism");
+    if (parallelism.IsObject()) {
+      Napi::Object object = parallelism.As<Napi::Object>();
+      for (int i = 0; i < kPipelineStageCount; i++) {
+        if (!kParallelismOptionNames[i]) continue;
+        Napi::Value value = object.Get(kParallelismOptionNames[i]);
+        if (value.IsNumber()) options_.parallelism[i] = value.As<Napi::Number>().Uint32Value();
+      }
+    }
+    Napi::Value queueCapacity = options.Get("queueCapacity");
+    if (queueCapacity.IsNumber()) options_.queueCapacity = queueCapacity.As<Napi::Number>().Uint32Value();
+
+    Napi::Value filesystem = options.Get("filesystem");
+    Napi::Value registry = options.Get("registry");
+    useFixtures_ = !filesystem.IsUndefined() || !registry.IsUndefined();
+    if (!useFixtures_) return true;
+    return ReadFakeFileSystem(filesystem, &fileSystem_, error) &&
+           ReadFakeRegistry(registry, &registry_, error);
+  }
+
+  bool UsesFixtures() const { return useFixtures_; }
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    Clock::time_point start = Clock::now();
+    if (useFixtures_) {
+      RunUninstallPipeline(registry_, fileSystem_, options_, &apps_, &stats_);
+    } else {
+#ifdef _WIN32
+      RunUninstallPipeline(LiveRegistry(), CachedLiveFileSystem(), options_, &apps_, &stats_);
+#endif
+    }
+    elapsedMs_ = MillisecondsSince(start);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("apps", AppsToNapi(env, apps_));
+    result.Set("stages", PipelineStatsToNapi(env, stats_));
+    result.Set("elapsedMs", Napi::Number::New(env, elapsedMs_));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  DiscoveryPipelineOptions options_;
+  bool useFixtures_ = false;
+  FakeFileSystem fileSystem_;
+  FakeRegistry registry_;
+  std::vector<DiscoveredApp> apps_;
+  std::vector<PipelineStageStats> stats_;
+  double elapsedMs_ = 0;
+};
+
+}  // namespace
+
+const char* PipelineStageName(PipelineStage stage) {
+  switch (stage) {
+    case kPipelineEnumerate: return "enumerate";
+    case kPipelineClassify: return "classify";
+    case kPipelineResolve: return "resolve";
+    case kPipelineValidate: return "validate";
+    case kPipelineEnrich: return "enrich";
+    case kPipelineIndex: return "index";
+    case kPipelineStageCount: break;
+  }
+  return "unknown";
+}
+
+void RunUninstallPipeline(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                          const DiscoveryPipelineOptions& options, std::vector<DiscoveredApp>* apps,
+                          std::vector<PipelineStageStats>* stats) {
+  using Pipeline = StagedPipeline<PipelineItem>;
+  auto pipeline = std::make_shared<Pipeline>(std::max<uint32_t>(options.queueCapacity, 2));
+
+  uint32_t parallelism[kPipelineStageCount];
+  uint32_t totalWorkers = 0;
+  for (int i = 0; i < kPipelineStageCount; i++) {
+    bool serial = i == kPipelineEnumerate || i == kPipelineIndex;
+    parallelism[i] = serial ? 1 : std::max<uint32_t>(options.parallelism[i], 1);
+    totalWorkers += parallelism[i];
+  }
+
+  pipeline->AddStage(parallelism[kPipelineEnumerate], [&registry](PipelineItem&, const Pipeline::Emit& emit) {
+    std::vector<std::string> subKeyNames;
+    if (ListUninstallEntries(registry, &subKeyNames) != BackendStatus::Ok) return;
+    for (size_t i = 0; i < subKeyNames.size(); i++) {
+      PipelineItem item;
+      item.sequence = i;
+      item.entry.subKeyName = subKeyNames[i];
+      emit(item);
+    }
+  });
+
+  pipeline->AddStage(parallelism[kPipelineClassify], [&registry](PipelineItem& item, const Pipeline::Emit& emit) {
+    if (ReadUninstallEntry(registry, item.entry.subKeyName, &item.entry)) emit(item);
+  });
+
+  pipeline->AddStage(parallelism[kPipelineResolve], [&fileSystem](PipelineItem& item, const Pipeline::Emit& emit) {
+    item.app.path = ResolveUninstallExe(fileSystem, item.entry);
+    if (!item.app.path.empty()) emit(item);
+  });
+
+  pipeline->AddStage(parallelism[kPipelineValidate], [&fileSystem](PipelineItem& item, const Pipeline::Emit& emit) {
+    if (fileSystem.Exists(item.app.path)) emit(item);
+  });
+
+  pipeline->AddStage(parallelism[kPipelineEnrich], [&fileSystem](PipelineItem& item, const Pipeline::Emit& emit) {
+    std::string header;
+    PeImageInfo image;
+    if (fileSystem.ReadFile(item.app.path, kPeHeaderBytes, &header) == BackendStatus::Ok &&
+        ParsePeHeaders(header, &image)) {
+      item.app.arch = PeMachineName(image.machine);
+      item.app.subsystem = image.subsystem;
+    }
+    emit(item);
+  });
+
+  // Entries resolving to the same exe keep the first in registry order
+  std::vector<PipelineItem> indexed;
+  std::unordered_map<std::string, size_t> indexByPath;
+  pipeline->AddStage(parallelism[kPipelineIndex], [&indexed, &indexByPath](PipelineItem& item, const Pipeline::Emit&) {
+    auto inserted = indexByPath.emplace(LowerAscii(item.app.path), indexed.size());
+    if (inserted.second) {
+      indexed.push_back(std::move(item));
+    } else if (item.sequence < indexed[inserted.first->second].sequence) {
+      indexed[inserted.first->second] = std::move(item);
+    }
+  });
+
+  PipelineItem seed;
+  pipeline->Seed(seed);
+  pipeline->Run(options.lane, std::min(totalWorkers, std::max<uint32_t>(SharedExecutor().WorkerCount(), 1)));
+
+  std::sort(indexed.begin(), indexed.end(), [](const PipelineItem& a, const PipelineItem& b) {
+    return a.sequence < b.sequence;
+  });
+  for (PipelineItem& item : indexed) {
+    DiscoveredApp app = std::move(item.app);
+    app.id = item.entry.subKeyName;
+    app.name = item.entry.displayName;
+    app.icon = item.entry.displayIcon;
+    apps->push_back(std::move(app));
+  }
+  if (stats) pipeline->CollectStats(stats);
+}
+
+// RunDiscoveryPipeline: Discover HKLM Uninstall apps through the staged
+// pipeline and report each stage's throughput and input-queue occupancy.
+// With filesystem/registry fixtures it runs over fake backends on any
+// platform.
+Napi::Value RunDiscoveryPipeline(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { parallelism?: { classify, resolve, validate, enrich }, queueCapacity?, filesystem?, registry? })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  auto* worker = new PipelineWorker(env);
+  std::string error;
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifndef _WIN32
+  if (!worker->UsesFixtures()) {
+    delete worker;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("apps", Napi::Array::New(env));
+    result.Set("error", Napi::String::New(env, "Live discovery needs Windows; pass filesystem/registry fixtures"));
+    deferred.Resolve(result);
+    return deferred.Promise();
+  }
+#endif
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
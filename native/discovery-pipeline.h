@@ -0,0 +1,60 @@
+#ifndef DISCOVERY_PIPELINE_H
+#define DISCOVERY_PIPELINE_H
+
+#include <napi.h>
+#include <cstdint>
+#include <vector>
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+#include "executor.h"
+
+// HKLM Uninstall discovery as a staged pipeline, so registry reads,
+// directory listings, stats and header reads for different entries overlap
+// instead of each step finishing for every entry before the next starts:
+//
+//   enumerate -> classify -> resolve -> validate -> enrich -> index
+//
+// Stages are joined by bounded lock-free queues and each has its own
+// worker limit. Any thread in the run can work any stage, downstream first,
+// and a producer facing a full queue helps drain it, so a run never depends
+// on the executor starting more than the calling thread.
+
+enum PipelineStage {
+  kPipelineEnumerate,  // Uninstall subkey names
+  kPipelineClassify,   // One ReadValues per entry; drops updates and unnamed entries
+  kPipelineResolve,    // Exe under InstallLocation, UninstallString or DisplayIcon
+  kPipelineValidate,   // Exe exists
+  kPipelineEnrich,     // PE header: machine and subsystem
+  kPipelineIndex,      // Dedupe by path, in registry order
+  kPipelineStageCount
+};
+
+const char* PipelineStageName(PipelineStage stage);
+
+struct DiscoveryPipelineOptions {
+  // Workers per stage; enumerate and index always run one at a time
+  uint32_t parallelism[kPipelineStageCount] = { 1, 2, 4, 4, 2, 1 };
+  uint32_t queueCapacity = 64;  // Per stage input queue
+  TaskLane lane = TaskLane::Normal;
+};
+
+struct PipelineStageStats {
+  PipelineStage stage = kPipelineEnumerate;
+  uint32_t parallelism = 0;
+  uint64_t processed = 0;   // Items taken from the input queue
+  uint64_t emitted = 0;     // Items passed to the next stage
+  double busyMs = 0;        // Summed over the stage's workers
+  double itemsPerSecond = 0;  // Processed over the stage's first-start to last-finish span
+  uint32_t queueCapacity = 0;
+  uint32_t queuePeak = 0;
+  double queueMean = 0;     // Sampled at each push
+};
+
+void RunUninstallPipeline(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                          const DiscoveryPipelineOptions& options, std::vector<DiscoveredApp>* apps,
+                          std::vector<PipelineStageStats>* stats);
+
+// Function declarations for the staged discovery pipeline
+Napi::Value RunDiscoveryPipeline(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,603 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include "discovery-scan.h"
+#include "helper-executables.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const char kUninstallKey[] = "SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall";
+const char kAppPathsKey[] = "SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\App Paths";
+const char kRegisteredApplicationsKey[] = "SOFTWARE\\RegisteredApplications";
+const char kApplicationsKey[] = "Applications";  // Under HKCR
+
+// How long past its deadline a root stuck in one call is waited for before
+// the scan returns without it
+constexpr uint32_t kHungCallGraceMs = 250;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool ContainsUninstall(const std::string& name) {
+  return name.find("uninstall") != std::string::npos ||
+         name.find("Uninstall") != std::string::npos;
+}
+
+// First *.exe entry of a listing, in FindFirstFile(dir\*.exe) order, that is
+// not a known helper (crash handler, updater, ...)
+const DirEntry* FirstExe(const std::vector<DirEntry>& entries) {
+  for (const DirEntry& entry : entries) {
+    if (!entry.isDirectory && EndsWithNoCase(entry.name, ".exe") && !IsHelperExecutable(entry.name)) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// Helper function to find executable path from install location or uninstall string
+std::string FindExePath(FileSystemBackend& fileSystem, const std::string& installLocation,
+                        const std::string& uninstallString) {
+  // Try install location first
+  if (!installLocation.empty()) {
+    std::vector<DirEntry> entries;
+    if (fileSystem.ListDirectory(installLocation, &entries) == BackendStatus::Ok) {
+      // Prefer main executable (not uninstaller)
+      const DirEntry* exe = FirstExe(entries);
+      if (exe && !ContainsUninstall(exe->name)) {
+        return JoinPath(installLocation, exe->name);
+      }
+
+      // Search one level down
+      for (const DirEntry& entry : entries) {
+        if (!entry.isDirectory) continue;
+        std::string subPath = JoinPath(installLocation, entry.name);
+        std::vector<DirEntry> subEntries;
+        if (fileSystem.ListDirectory(subPath, &subEntries) != BackendStatus::Ok) continue;
+        const DirEntry* subExe = FirstExe(subEntries);
+        if (subExe && !ContainsUninstall(subExe->name)) {
+          return JoinPath(subPath, subExe->name);
+        }
+      }
+    }
+  }
+
+  // Try extracting from uninstall string
+  if (uninstallString.find(".exe") != std::string::npos) {
+    size_t start = uninstallString.find('"');
+    if (start != std::string::npos) {
+      size_t end = uninstallString.find('"', start + 1);
+      if (end != std::string::npos) {
+        std::string path = uninstallString.substr(start + 1, end - start - 1);
+        if (fileSystem.Exists(path)) {
+          return path;
+        }
+      }
+    }
+  }
+
+  return "";
+}
+
+// Executable of a shell command line: "C:\x\app.exe" "%1", C:\x\app.exe %1 or
+// an icon reference "C:\x\app.exe,0"
+std::string ExePathFromCommand(const std::string& command) {
+  size_t start = command.find_first_not_of(" \t");
+  if (start == std::string::npos) return "";
+  if (command[start] == '"') {
+    size_t end = command.find('"', start + 1);
+    return end == std::string::npos ? "" : command.substr(start + 1, end - start - 1);
+  }
+  size_t exe = LowerAscii(command).find(".exe", start);
+  return exe == std::string::npos ? "" : command.substr(start, exe + 4 - start);
+}
+
+std::string StemOf(const std::string& fileName) {
+  size_t dotPos = fileName.find_last_of('.');
+  return dotPos != std::string::npos ? fileName.substr(0, dotPos) : fileName;
+}
+
+// "@shell32.dll,-22" style names need SHLoadIndirectString; callers fall back
+bool IsIndirectString(const std::string& text) {
+  return !text.empty() && text[0] == '@';
+}
+
+std::string ShellOpenCommand(RegistryBackend& registry, RegistryRoot root, const std::string& keyPath) {
+  std::vector<RegistryValue> values;
+  registry.ReadValues(root, keyPath + "\\shell\\open\\command", &values);
+  return FindRegistryValue(values, "");
+}
+
+// Collects apps with one entry per executable path, first source wins
+class RegisteredAppCollector {
+ public:
+  RegisteredAppCollector(FileSystemBackend& fileSystem, std::vector<DiscoveredApp>* apps)
+    : fileSystem_(fileSystem), apps_(apps) {}
+
+  void Add(const std::string& id, const std::string& name, const std::string& exePath,
+           const std::string& icon) {
+    if (exePath.empty() || !EndsWithNoCase(exePath, ".exe")) return;
+    std::string fileName = FileNameOf(exePath);
+    if (IsHelperExecutable(fileName)) return;
+    if (!seen_.insert(LowerAscii(exePath)).second || !fileSystem_.Exists(exePath)) return;
+    apps_->push_back({ id, name.empty() || IsIndirectString(name) ? StemOf(fileName) : name,
+                       exePath, icon });
+  }
+
+ private:
+  FileSystemBackend& fileSystem_;
+  std::vector<DiscoveredApp>* apps_;
+  std::unordered_set<std::string> seen_;
+};
+
+// A Program Files scan's shared state. Root walks run as executor tasks
+// and may outlive the scan when hung roots are abandoned, so they hold it by
+// shared_ptr and stop at their next step once the scan has returned.
+struct ProgramFilesScan {
+  ProgramFilesScan(FileSystemBackend& fileSystem, const ProgramFilesScanOptions& options)
+    : fileSystem(fileSystem), options(options) {}
+
+  struct Root {
+    std::vector<std::string> exePaths;
+    ProgramFilesRootStats stats;
+    bool started = false;
+    bool identified = false;  // Identify has returned
+    bool hasIdentity = false;
+    bool finished = false;
+    Clock::time_point startedAt;
+    FileIdentity identity;
+  };
+
+  FileSystemBackend& fileSystem;
+  const ProgramFilesScanOptions options;
+  std::atomic<bool> returned{false};
+  std::mutex mutex;  // Guards everything below
+  std::condition_variable changed;  // A root was identified or finished
+  std::unordered_set<FileIdentity, FileIdentityHash> visited;
+  std::vector<Root> roots;
+};
+
+// One root's walk. Links are skipped unless followed, and the scan's visited
+// set, keyed by file identity, keeps any physical directory from being
+// listed twice, whichever root, link or alias reaches it. Past the root's
+// deadline the walk stops before its next call and reports what it found.
+class ExecutableWalk {
+ public:
+  ExecutableWalk(std::shared_ptr<ProgramFilesScan> scan, size_t rootIndex)
+    : scan_(std::move(scan)), rootIndex_(rootIndex), options_(scan_->options) {}
+
+  void Run() {
+    Clock::time_point start = Clock::now();
+    std::string root;
+    {
+      std::lock_guard<std::mutex> lock(scan_->mutex);
+      // Abandoned before anyone got to it, or already claimed by the caller
+      // or a worker
+      if (scan_->returned) return;
+      ProgramFilesScan::Root& state = scan_->roots[rootIndex_];
+      if (state.started) return;
+      state.started = true;
+      state.startedAt = start;
+      root = state.stats.root;
+    }
+    deadline_ = options_.rootTimeoutMs > 0 ? start + std::chrono::milliseconds(options_.rootTimeoutMs)
+                                           : Clock::time_point::max();
+    stats_.root = root;
+
+    stats_.status = WalkRoot(root);
+    if (degraded_) stats_.status = RootScanStatus::Degraded;
+    stats_.elapsedMs = MillisecondsSince(start);
+    Publish(true);
+  }
+
+ private:
+  RootScanStatus WalkRoot(const std::string& root) {
+    if (Stopping()) return RootScanStatus::Degraded;
+    // Roots are entered even when they are links, so the identity check is
+    // what catches one root aliasing another
+    FileIdentity identity;
+    BackendStatus status = scan_->fileSystem.Identify(root, &identity);
+    bool alias = IsAliasOfEarlierRoot(status == BackendStatus::Ok ? &identity : nullptr);
+    if (status == BackendStatus::NotFound) return RootScanStatus::Unavailable;
+    if (alias) {
+      stats_.revisitsSkipped++;
+      return RootScanStatus::Complete;
+    }
+    return Walk(root, 0) || degraded_ ? RootScanStatus::Complete : RootScanStatus::Unavailable;
+  }
+
+  // Of two aliased roots the one listed first is walked, whichever starts
+  // first, so paths do not flip between scans. Waits, within the deadline,
+  // for the earlier roots to be identified. identity is null when Identify
+  // failed.
+  bool IsAliasOfEarlierRoot(const FileIdentity* identity) {
+    std::unique_lock<std::mutex> lock(scan_->mutex);
+    ProgramFilesScan::Root& state = scan_->roots[rootIndex_];
+    state.identified = true;
+    state.hasIdentity = identity != nullptr;
+    if (identity) state.identity = *identity;
+    scan_->changed.notify_all();
+    if (!identity) return false;
+
+    auto earlierIdentified = [this]() {
+      if (scan_->returned) return true;
+      for (size_t i = 0; i < rootIndex_; i++) {
+        if (!scan_->roots[i].identified && !scan_->roots[i].finished) return false;
+      }
+      return true;
+    };
+    if (deadline_ == Clock::time_point::max()) {
+      scan_->changed.wait(lock, earlierIdentified);
+    } else {
+      scan_->changed.wait_until(lock, deadline_, earlierIdentified);
+    }
+    for (size_t i = 0; i < rootIndex_; i++) {
+      const ProgramFilesScan::Root& earlier = scan_->roots[i];
+      if (earlier.hasIdentity && earlier.identity == *identity) return true;
+    }
+    return !scan_->visited.insert(*identity).second;
+  }
+
+  // False past the deadline, and once the scan has returned without this root
+  bool Stopping() {
+    if (scan_->returned) return true;
+    if (Clock::now() >= deadline_) degraded_ = true;
+    return degraded_;
+  }
+
+  // False when the scan already listed this directory
+  bool Visit(const FileIdentity& identity) {
+    std::lock_guard<std::mutex> lock(scan_->mutex);
+    return scan_->visited.insert(identity).second;
+  }
+
+  // False when the directory at fullPath should not be listed
+  bool Enter(const std::string& fullPath, const DirEntry& entry) {
+    FileIdentity identity;
+    if (entry.link != LinkKind::None) {
+      if (!options_.followLinks) {
+        stats_.linksSkipped++;
+        return false;
+      }
+      if (Stopping()) return false;
+      if (scan_->fileSystem.Identify(fullPath, &identity) != BackendStatus::Ok) {
+        stats_.brokenLinks++;
+        return false;
+      }
+      if (!Visit(identity)) {
+        stats_.revisitsSkipped++;
+        return false;
+      }
+      stats_.linksFollowed++;
+      return true;
+    }
+
+    // Without followed links a tree cannot reach a directory twice, so
+    // plain directories only need an identity when links are followed
+    if (options_.followLinks && !Stopping() &&
+        scan_->fileSystem.Identify(fullPath, &identity) == BackendStatus::Ok && !Visit(identity)) {
+      stats_.revisitsSkipped++;
+      return false;
+    }
+    return true;
+  }
+
+  // False when the directory could not be listed
+  bool Walk(const std::string& dirPath, uint32_t depth) {
+    if (depth >= options_.maxDepth || Stopping()) return false;
+
+    std::vector<DirEntry> entries;
+    if (scan_->fileSystem.ListDirectory(dirPath, &entries) != BackendStatus::Ok) return false;
+    stats_.directoriesListed++;
+
+    for (const DirEntry& entry : entries) {
+      std::string fullPath = JoinPath(dirPath, entry.name);
+
+      if (entry.isDirectory) {
+        // Skip common system directories
+        if (entry.name.find("Windows") != std::string::npos ||
+            entry.name.find("ProgramData") != std::string::npos ||
+            entry.name.find('$') != std::string::npos) {
+          continue;
+        }
+        if (Enter(fullPath, entry)) {
+          Publish(false);
+          Walk(fullPath, depth + 1);
+        }
+      } else if (entry.name.find(".exe") != std::string::npos) {
+        // Skip uninstallers, known helpers and common system files
+        if (IsHelperExecutable(entry.name)) continue;
+        std::string lowerName = LowerAscii(entry.name);
+        if (lowerName.find("uninstall") == std::string::npos &&
+            lowerName.find("setup") == std::string::npos &&
+            lowerName.find("install") == std::string::npos) {
+          pending_.push_back(fullPath);
+        }
+      }
+    }
+    Publish(false);
+    return true;
+  }
+
+  // Hands results over as they accumulate, so an abandoned root still
+  // contributes everything up to its last completed listing
+  void Publish(bool finished) {
+    {
+      std::lock_guard<std::mutex> lock(scan_->mutex);
+      ProgramFilesScan::Root& state = scan_->roots[rootIndex_];
+      state.exePaths.insert(state.exePaths.end(), pending_.begin(), pending_.end());
+      state.stats = stats_;
+      state.finished = finished;
+    }
+    pending_.clear();
+    if (finished) scan_->changed.notify_all();
+  }
+
+  std::shared_ptr<ProgramFilesScan> scan_;
+  size_t rootIndex_;
+  const ProgramFilesScanOptions& options_;
+  Clock::time_point deadline_;
+  bool degraded_ = false;
+  ProgramFilesRootStats stats_;
+  std::vector<std::string> pending_;
+};
+
+// Waits for every root to finish, or to overrun its deadline by
+// kHungCallGraceMs while stuck in one call. Each root is timed from when its
+// walk began; the caller has claimed any root no worker had started.
+void WaitForRoots(ProgramFilesScan& scan) {
+  std::chrono::milliseconds limit(scan.options.rootTimeoutMs + kHungCallGraceMs);
+  std::unique_lock<std::mutex> lock(scan.mutex);
+  while (true) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point next = Clock::time_point::max();
+    for (const ProgramFilesScan::Root& root : scan.roots) {
+      if (root.finished || !root.started) continue;
+      Clock::time_point abandonAt = root.startedAt + limit;
+      if (now < abandonAt && abandonAt < next) next = abandonAt;
+    }
+    if (next == Clock::time_point::max()) return;
+    scan.changed.wait_until(lock, next);
+  }
+}
+
+}  // namespace
+
+BackendStatus ListUninstallEntries(RegistryBackend& registry, std::vector<std::string>* subKeyNames) {
+  return registry.EnumerateSubKeys(RegistryRoot::LocalMachine, kUninstallKey, subKeyNames);
+}
+
+bool ReadUninstallEntry(RegistryBackend& registry, const std::string& subKeyName, UninstallEntry* entry) {
+  std::string subKey = std::string(kUninstallKey) + "\\" + subKeyName;
+
+  // One open per entry instead of one per value
+  std::vector<RegistryValue> values;
+  registry.ReadValues(RegistryRoot::LocalMachine, subKey, &values);
+  std::string displayName = FindRegistryValue(values, "DisplayName");
+  if (displayName.empty()) return false;
+
+  // Filter out system updates
+  std::string lowerName = LowerAscii(displayName);
+  if (lowerName.find("update") != std::string::npos ||
+      lowerName.find("hotfix") != std::string::npos ||
+      lowerName.find("kb") != std::string::npos) {
+    return false;
+  }
+
+  entry->subKeyName = subKeyName;
+  entry->displayName = displayName;
+  entry->installLocation = FindRegistryValue(values, "InstallLocation");
+  entry->uninstallString = FindRegistryValue(values, "UninstallString");
+  entry->displayIcon = FindRegistryValue(values, "DisplayIcon");
+  return true;
+}
+
+std::string ResolveUninstallExe(FileSystemBackend& fileSystem, const UninstallEntry& entry) {
+  std::string exePath = FindExePath(fileSystem, entry.installLocation, entry.uninstallString);
+  if (exePath.empty() && !entry.displayIcon.empty()) {
+    // Try to extract path from icon string
+    exePath = entry.displayIcon.substr(0, entry.displayIcon.find(','));
+    // Remove quotes
+    if (!exePath.empty() && exePath.front() == '"') exePath = exePath.substr(1);
+    if (!exePath.empty() && exePath.back() == '"') exePath.pop_back();
+  }
+  return exePath;
+}
+
+void ScanUninstallEntries(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                          std::vector<DiscoveredApp>* apps) {
+  std::vector<std::string> subKeyNames;
+  if (ListUninstallEntries(registry, &subKeyNames) != BackendStatus::Ok) return;
+
+  for (const std::string& subKeyName : subKeyNames) {
+    UninstallEntry entry;
+    if (!ReadUninstallEntry(registry, subKeyName, &entry)) continue;
+
+    std::string exePath = ResolveUninstallExe(fileSystem, entry);
+    if (exePath.empty() || !fileSystem.Exists(exePath)) continue;
+
+    apps->push_back({ subKeyName, entry.displayName, exePath, entry.displayIcon });
+  }
+}
+
+void ScanRegisteredApps(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                        std::vector<DiscoveredApp>* apps) {
+  RegisteredAppCollector collector(fileSystem, apps);
+  const RegistryRoot userAndMachine[] = { RegistryRoot::CurrentUser, RegistryRoot::LocalMachine };
+
+  // RegisteredApplications: app name -> its Capabilities key, whose parent
+  // usually has the shell\open\command that launches it
+  for (RegistryRoot root : userAndMachine) {
+    std::vector<RegistryValue> registered;
+    if (registry.ReadValues(root, kRegisteredApplicationsKey, &registered) != BackendStatus::Ok) continue;
+    for (const RegistryValue& entry : registered) {
+      if (entry.name.empty() || entry.data.empty()) continue;
+      std::vector<RegistryValue> capabilities;
+      registry.ReadValues(root, entry.data, &capabilities);
+      std::string name = FindRegistryValue(capabilities, "ApplicationName");
+      if (name.empty() || IsIndirectString(name)) name = entry.name;
+      std::string icon = FindRegistryValue(capabilities, "ApplicationIcon");
+
+      size_t lastSlash = entry.data.find_last_of('\\');
+      std::string exePath;
+      if (lastSlash != std::string::npos) {
+        exePath = ExePathFromCommand(ShellOpenCommand(registry, root, entry.data.substr(0, lastSlash)));
+      }
+      if (exePath.empty()) exePath = ExePathFromCommand(icon);
+      collector.Add("regapps_" + entry.name, name, exePath, icon);
+    }
+  }
+
+  // App Paths: <exe name> -> default value with the full path
+  for (RegistryRoot root : userAndMachine) {
+    std::vector<std::string> exeNames;
+    if (registry.EnumerateSubKeys(root, kAppPathsKey, &exeNames) != BackendStatus::Ok) continue;
+    for (const std::string& exeName : exeNames) {
+      std::vector<RegistryValue> values;
+      registry.ReadValues(root, std::string(kAppPathsKey) + "\\" + exeName, &values);
+      std::string exePath = ExePathFromCommand(FindRegistryValue(values, ""));
+      collector.Add("apppaths_" + LowerAscii(exeName), StemOf(exeName), exePath, "");
+    }
+  }
+
+  // HKCR\Applications: <exe name> -> FriendlyAppName and open command
+  std::vector<std::string> applications;
+  if (registry.EnumerateSubKeys(RegistryRoot::ClassesRoot, kApplicationsKey, &applications) == BackendStatus::Ok) {
+    for (const std::string& exeName : applications) {
+      if (!EndsWithNoCase(exeName, ".exe")) continue;
+      std::string keyPath = std::string(kApplicationsKey) + "\\" + exeName;
+      std::vector<RegistryValue> values;
+      registry.ReadValues(RegistryRoot::ClassesRoot, keyPath, &values);
+      std::string exePath = ExePathFromCommand(ShellOpenCommand(registry, RegistryRoot::ClassesRoot, keyPath));
+      collector.Add("hkcrapp_" + LowerAscii(exeName), FindRegistryValue(values, "FriendlyAppName"), exePath, "");
+    }
+  }
+}
+
+const std::vector<std::string>& DefaultProgramFilesRoots() {
+  static const std::vector<std::string> roots = {
+    "C:\\Program Files",
+    "C:\\Program Files (x86)"
+  };
+  return roots;
+}
+
+const char* RootScanStatusName(RootScanStatus status) {
+  switch (status) {
+    case RootScanStatus::Complete: return "complete";
+    case RootScanStatus::Unavailable: return "unavailable";
+    case RootScanStatus::Degraded: return "degraded";
+    case RootScanStatus::Abandoned: return "abandoned";
+  }
+  return "complete";
+}
+
+void ScanProgramFilesRoots(FileSystemBackend& fileSystem, const std::vector<std::string>& roots,
+                           const ProgramFilesScanOptions& options, std::vector<DiscoveredApp>* apps,
+                           std::vector<ProgramFilesRootStats>* stats) {
+  Clock::time_point start = Clock::now();
+  auto scan = std::make_shared<ProgramFilesScan>(fileSystem, options);
+  scan->roots.resize(roots.size());
+  for (size_t i = 0; i < roots.size(); i++) scan->roots[i].stats.root = roots[i];
+
+  if (options.abandonHungRoots && options.rootTimeoutMs > 0) {
+    // Roots go to workers, and the caller walks any none has claimed yet, so
+    // a busy executor cannot starve the scan. The caller only stops waiting
+    // on roots the workers hold; one it walks itself still stops at its
+    // deadline before the next call.
+    for (size_t i = 0; i < roots.size(); i++) {
+      SharedExecutor().Submit(options.lane, [scan, i](const CancellationToken&) { ExecutableWalk(scan, i).Run(); });
+    }
+    for (size_t i = 0; i < roots.size(); i++) ExecutableWalk(scan, i).Run();
+    WaitForRoots(*scan);
+  } else {
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < roots.size(); i++) {
+      tasks.push_back([scan, i]() { ExecutableWalk(scan, i).Run(); });
+    }
+    RunParallel(std::move(tasks), options.lane);
+  }
+
+  // Roots are merged in order, so app ids do not depend on which finished first
+  std::vector<std::string> exePaths;
+  {
+    std::lock_guard<std::mutex> lock(scan->mutex);
+    scan->returned = true;
+    for (ProgramFilesScan::Root& root : scan->roots) {
+      if (!root.finished) {
+        root.stats.status = RootScanStatus::Abandoned;
+        root.stats.elapsedMs = MillisecondsSince(root.started ? root.startedAt : start);
+      }
+      exePaths.insert(exePaths.end(), root.exePaths.begin(), root.exePaths.end());
+      if (stats) stats->push_back(root.stats);
+    }
+  }
+
+  size_t index = 0;
+  for (const std::string& exePath : exePaths) {
+    // App name is the file name without its extension
+    std::string fileName = FileNameOf(exePath);
+    size_t dotPos = fileName.find_last_of('.');
+    if (dotPos != std::string::npos) {
+      fileName = fileName.substr(0, dotPos);
+    }
+
+    // Icons extracted separately if needed
+    apps->push_back({ fileName + "_" + std::to_string(index++), fileName, exePath, "" });
+  }
+}
+
+void ScanSystemAppList(FileSystemBackend& fileSystem, std::vector<DiscoveredApp>* apps) {
+  // Common Windows system apps that users might want to use
+  struct SystemApp {
+    const char* name;
+    const char* exeName;
+    const char* path;
+  };
+
+  static const SystemApp systemApps[] = {
+    { "Notepad", "notepad.exe", "C:\\Windows\\System32\\notepad.exe" },
+    { "Calculator", "calc.exe", "C:\\Windows\\System32\\calc.exe" },
+    { "Paint", "mspaint.exe", "C:\\Windows\\System32\\mspaint.exe" },
+    { "Command Prompt", "cmd.exe", "C:\\Windows\\System32\\cmd.exe" },
+    { "Windows PowerShell", "powershell.exe", "C:\\Windows\\System32\\WindowsPowerShell\\v1.0\\powershell.exe" },
+    { "Task Manager", "taskmgr.exe", "C:\\Windows\\System32\\taskmgr.exe" },
+    { "Registry Editor", "regedit.exe", "C:\\Windows\\regedit.exe" },
+    { "Character Map", "charmap.exe", "C:\\Windows\\System32\\charmap.exe" },
+    { "Snipping Tool", "SnippingTool.exe", "C:\\Windows\\System32\\SnippingTool.exe" },
+    { "Magnifier", "magnify.exe", "C:\\Windows\\System32\\magnify.exe" },
+    { "On-Screen Keyboard", "osk.exe", "C:\\Windows\\System32\\osk.exe" },
+    { "Remote Desktop Connection", "mstsc.exe", "C:\\Windows\\System32\\mstsc.exe" }
+  };
+
+  for (const SystemApp& app : systemApps) {
+    // Check if the file exists
+    if (fileSystem.Exists(app.path)) {
+      apps->push_back({ std::string(app.exeName) + "_system", app.name, app.path, app.path });
+    }
+  }
+}
+
+Napi::Array AppsToNapi(Napi::Env env, const std::vector<DiscoveredApp>& apps) {
+  Napi::Array result = Napi::Array::New(env, apps.size());
+  for (size_t i = 0; i < apps.size(); i++) {
+    Napi::Object app = Napi::Object::New(env);
+    app.Set("id", Napi::String::New(env, apps[i].id));
+    app.Set("name", Napi::String::New(env, apps[i].name));
+    app.Set("path", Napi::String::New(env, apps[i].path));
+    app.Set("icon", Napi::String::New(env, apps[i].icon));
+    if (!apps[i].arch.empty()) app.Set("arch", Napi::String::New(env, apps[i].arch));
+    if (apps[i].source) app.Set("source", Napi::String::New(env, apps[i].source));
+    if (apps[i].subsystem != PeSubsystem::Unknown) {
+      app.Set("subsystem", Napi::String::New(env, PeSubsystemName(apps[i].subsystem)));
+    }
+    result.Set((uint32_t)i, app);
+  }
+  return result;
+}
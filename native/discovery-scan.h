@@ -0,0 +1,107 @@
+#ifndef DISCOVERY_SCAN_H
+#define DISCOVERY_SCAN_H
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "discovery-backend.h"
+#include "executor.h"
+#include "pe-image.h"
+
+struct DiscoveredApp {
+  DiscoveredApp() = default;
+  DiscoveredApp(std::string id, std::string name, std::string path, std::string icon)
+    : id(std::move(id)), name(std::move(name)), path(std::move(path)), icon(std::move(icon)) {}
+
+  std::string id;
+  std::string name;
+  std::string path;
+  std::string icon;
+  std::string arch;  // PE machine, when a scan read the headers
+  PeSubsystem subsystem = PeSubsystem::Unknown;
+  const char* source = nullptr;  // Name of the discovery source it was merged from
+};
+
+// Platform-neutral scanners behind scanRegistry/scanProgramFiles/
+// scanSystemApps, run against live or fake backends
+
+// Installed programs from HKLM\...\Uninstall, resolved to an existing exe
+void ScanUninstallEntries(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                          std::vector<DiscoveredApp>* apps);
+
+// The steps of ScanUninstallEntries, for callers that run them as separate
+// stages (discovery-pipeline.cc)
+struct UninstallEntry {
+  std::string subKeyName;
+  std::string displayName;
+  std::string installLocation;
+  std::string uninstallString;
+  std::string displayIcon;
+};
+
+BackendStatus ListUninstallEntries(RegistryBackend& registry, std::vector<std::string>* subKeyNames);
+// False when the entry has no name or is a system update
+bool ReadUninstallEntry(RegistryBackend& registry, const std::string& subKeyName, UninstallEntry* entry);
+// Exe under InstallLocation, else from UninstallString or DisplayIcon; may
+// not exist
+std::string ResolveUninstallExe(FileSystemBackend& fileSystem, const UninstallEntry& entry);
+
+// Exe name -> path/name mappings the system keeps in the registry:
+// RegisteredApplications capabilities, App Paths (HKLM and HKCU) and
+// HKCR\Applications. Each key is read with one batched ReadValues, so this
+// is far cheaper than walking Program Files and its results take precedence.
+void ScanRegisteredApps(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                        std::vector<DiscoveredApp>* apps);
+
+// How a root's walk ended
+enum class RootScanStatus {
+  Complete,
+  Unavailable,  // Missing or unlistable
+  Degraded,     // Its deadline passed; results are partial
+  Abandoned     // Stuck in one call at its deadline; results are partial
+};
+
+const char* RootScanStatusName(RootScanStatus status);
+
+constexpr uint32_t kDefaultRootTimeoutMs = 5000;
+
+struct ProgramFilesScanOptions {
+  uint32_t maxDepth = 2;     // Directory levels listed, the root's included
+  bool followLinks = false;  // Junctions and directory symlinks
+  uint32_t rootTimeoutMs = kDefaultRootTimeoutMs;  // Per root; 0 for none
+  // Return without waiting for a root stuck in one call (a dead share) past
+  // its deadline. The call still finishes on its worker afterwards, so only
+  // for backends that outlive every scan, such as the live ones. Roots the
+  // caller walks itself, because no worker was free, are always waited on.
+  bool abandonHungRoots = false;
+  TaskLane lane = TaskLane::Normal;  // Roots walk concurrently on the executor
+};
+
+struct ProgramFilesRootStats {
+  std::string root;
+  RootScanStatus status = RootScanStatus::Complete;
+  uint32_t directoriesListed = 0;
+  uint32_t linksSkipped = 0;
+  uint32_t linksFollowed = 0;
+  uint32_t revisitsSkipped = 0;  // Directories already listed through another path
+  uint32_t brokenLinks = 0;      // Dangling or looping
+  double elapsedMs = 0;
+};
+
+// Executables below each root, skipping installers. Roots walk concurrently,
+// each under its own deadline, so a slow one only costs its own results.
+// Whether or not links are followed, no physical directory is listed twice
+// in one scan. stats is optional.
+void ScanProgramFilesRoots(FileSystemBackend& fileSystem, const std::vector<std::string>& roots,
+                           const ProgramFilesScanOptions& options, std::vector<DiscoveredApp>* apps,
+                           std::vector<ProgramFilesRootStats>* stats);
+const std::vector<std::string>& DefaultProgramFilesRoots();
+
+// Built-in Windows tools that exist on this machine
+void ScanSystemAppList(FileSystemBackend& fileSystem, std::vector<DiscoveredApp>* apps);
+
+Napi::Array AppsToNapi(Napi::Env env, const std::vector<DiscoveredApp>& apps);
+
+#endif
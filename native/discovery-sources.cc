@@ -0,0 +1,424 @@
+#include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "discovery-pipeline.h"
+#include "discovery-sources.h"
+#include "fake-discovery-backend.h"
+#include "stat-cache.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint32_t kMinuteMs = 60 * 1000;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void ScanRegistrySource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                        std::vector<SourceRootStats>*) {
+  DiscoveryPipelineOptions options;
+  options.lane = context.lane;
+  RunUninstallPipeline(context.registry, context.fileSystem, options, apps, nullptr);
+}
+
+void ScanRegisteredSource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                          std::vector<SourceRootStats>*) {
+  ScanRegisteredApps(context.registry, context.fileSystem, apps);
+}
+
+void ScanPackagesSource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                        std::vector<SourceRootStats>*) {
+  ScanPackageManagers(context.fileSystem, context.registry, context.roots.packageManagers, apps);
+}
+
+void ScanGamesSource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                     std::vector<SourceRootStats>*) {
+  ScanGameLibraries(context.fileSystem, context.registry, context.roots.gameLibraries,
+                    context.gameCache, apps);
+}
+
+void ScanProgramFilesSource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                            std::vector<SourceRootStats>* roots) {
+  ProgramFilesScanOptions options;
+  options.lane = context.lane;
+  options.abandonHungRoots = context.backendsOutliveRun;
+  options.rootTimeoutMs = context.rootTimeoutMs;
+  std::vector<ProgramFilesRootStats> stats;
+  ScanProgramFilesRoots(context.fileSystem, context.roots.programFiles, options, apps, &stats);
+  for (const ProgramFilesRootStats& root : stats) roots->push_back({ root.root, root.status, root.elapsedMs });
+}
+
+void ScanSystemAppsSource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                          std::vector<SourceRootStats>*) {
+  ScanSystemAppList(context.fileSystem, apps);
+}
+
+void ScanUserAppsSource(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+                        std::vector<SourceRootStats>*) {
+  ScanUserProfileRoots(context.fileSystem, context.roots.userProfile, ProfileScanBudget(),
+                       context.profileCache, apps, nullptr);
+}
+
+// FNV-1a over the lowercased paths the cheap sources found, in source order
+uint64_t CheapFingerprint(const std::vector<DiscoverySource>& sources,
+                          const std::vector<std::vector<DiscoveredApp>*>& results) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < sources.size(); i++) {
+    if (sources[i].cost != SourceCost::Cheap) continue;
+    for (const DiscoveredApp& app : *results[i]) {
+      for (char c : LowerAscii(app.path)) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ull;
+      }
+      hash ^= 0xff;  // Path separator, so "ab"+"c" differs from "a"+"bc"
+      hash *= 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+// Runs the sources on the executor and settles with the merged apps and
+// per-source stats. With fixtures it scans fakes through its own caches, so
+// test runs never touch the shared ones.
+class DiscoveryWorker : public ExecutorWorker {
+ public:
+  explicit DiscoveryWorker(Napi::Env env)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)) {}
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    Napi::Value force = options.Get("force");
+    if (force.IsBoolean()) options_.force = force.As<Napi::Boolean>().Value();
+
+    Napi::Value sources = options.Get("sources");
+    if (sources.IsArray()) {
+      Napi::Array array = sources.As<Napi::Array>();
+      for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value value = array.Get(i);
+        std::string name = value.IsString() ? value.As<Napi::String>().Utf8Value() : "";
+        bool known = false;
+        for (const DiscoverySource& source : DiscoverySources()) {
+          if (name == source.name) known = true;
+        }
+        if (!known) {
+          *error = "Unknown discovery source: " + name;
+          return false;
+        }
+        options_.only.push_back(name);
+      }
+    }
+
+    Napi::Value filesystem = options.Get("filesystem");
+    Napi::Value registry = options.Get("registry");
+    useFixtures_ = !filesystem.IsUndefined() || !registry.IsUndefined();
+    if (!useFixtures_) return true;
+
+    roots_.programFiles = DefaultProgramFilesRoots();
+    return ReadFakeFileSystem(filesystem, &fileSystem_, error) &&
+           ReadFakeRegistry(registry, &registry_, error);
+  }
+
+  bool UsesFixtures() const { return useFixtures_; }
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    if (useFixtures_) {
+      DiscoveryContext context = { fileSystem_, registry_, roots_, &gameCache_, &profileCache_ };
+      RunDiscoverySources(context, options_, &sourceCache_, &run_);
+      return;
+    }
+#ifdef _WIN32
+    DiscoveryRoots roots = DefaultDiscoveryRoots();
+    DiscoveryContext context = { CachedLiveFileSystem(), LiveRegistry(), roots, &SharedGameLibraryCache(),
+                                 &SharedProfileScanCache() };
+    context.backendsOutliveRun = true;
+    RunDiscoverySources(context, options_, &SharedDiscoverySourceCache(), &run_);
+#endif
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("apps", AppsToNapi(env, run_.apps));
+    result.Set("sources", SourceRunStatsToNapi(env, run_.sources));
+    result.Set("elapsedMs", Napi::Number::New(env, run_.elapsedMs));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  DiscoveryRunOptions options_;
+  bool useFixtures_ = false;
+  DiscoveryRoots roots_;
+  FakeFileSystem fileSystem_;
+  FakeRegistry registry_;
+  DiscoverySourceCache sourceCache_;
+  GameLibraryCache gameCache_;
+  ProfileScanCache profileCache_;
+  DiscoveryRun run_;
+};
+
+}  // namespace
+
+const char* SourceCostName(SourceCost cost) {
+  switch (cost) {
+    case SourceCost::Cheap: return "cheap";
+    case SourceCost::Moderate: return "moderate";
+    case SourceCost::Expensive: return "expensive";
+  }
+  return "cheap";
+}
+
+const std::vector<DiscoverySource>& DiscoverySources() {
+  // Registry records carry the best names and icons, package and store
+  // manifests name their own exes, and the walks only guess from file names.
+  // Manifests are one read per package, so they get a short fresh window;
+  // the walks are what a long one saves.
+  static const std::vector<DiscoverySource> sources = {
+    { "registry", SourceCost::Cheap, 0, 0, ScanRegistrySource },
+    { "registered", SourceCost::Cheap, 1, 0, ScanRegisteredSource },
+    { "packages", SourceCost::Moderate, 2, 10 * kMinuteMs, ScanPackagesSource },
+    { "games", SourceCost::Moderate, 3, 10 * kMinuteMs, ScanGamesSource },
+    { "programFiles", SourceCost::Expensive, 4, 6 * 60 * kMinuteMs, ScanProgramFilesSource },
+    { "systemApps", SourceCost::Cheap, 5, 0, ScanSystemAppsSource },
+    { "userApps", SourceCost::Expensive, 6, 30 * kMinuteMs, ScanUserAppsSource }
+  };
+  return sources;
+}
+
+void DiscoverySourceCache::Clear() {
+  std::lock_guard<std::mutex> lock(runMutex_);
+  entries_.clear();
+}
+
+std::vector<std::vector<DiscoveredApp>> DiscoverySourceCache::Snapshot() {
+  std::lock_guard<std::mutex> lock(runMutex_);
+  std::vector<std::vector<DiscoveredApp>> snapshot(DiscoverySources().size());
+  for (size_t i = 0; i < entries_.size(); i++) {
+    if (entries_[i].valid) snapshot[i] = entries_[i].apps;
+  }
+  return snapshot;
+}
+
+void DiscoverySourceCache::Seed(size_t sourceIndex, const std::vector<DiscoveredApp>& apps) {
+  std::lock_guard<std::mutex> lock(runMutex_);
+  entries_.resize(DiscoverySources().size());
+  Entry& entry = entries_[sourceIndex];
+  if (!entry.valid) {
+    entry.valid = true;
+    entry.seeded = true;
+    entry.partial = false;
+    entry.ranAt = Clock::now();
+    entry.apps = apps;
+    return;
+  }
+
+  std::unordered_set<std::string> known;
+  for (const DiscoveredApp& app : entry.apps) known.insert(LowerAscii(app.path));
+  for (const DiscoveredApp& app : apps) {
+    if (known.insert(LowerAscii(app.path)).second) entry.apps.push_back(app);
+  }
+}
+
+void RunDiscoverySources(const DiscoveryContext& baseContext, const DiscoveryRunOptions& options,
+                         DiscoverySourceCache* cache, DiscoveryRun* run) {
+  Clock::time_point start = Clock::now();
+  DiscoveryContext context = baseContext;
+  context.lane = options.lane;
+  const std::vector<DiscoverySource>& sources = DiscoverySources();
+  std::lock_guard<std::mutex> lock(cache->runMutex_);
+  cache->entries_.resize(sources.size());
+
+  std::vector<bool> selected(sources.size(), options.only.empty());
+  for (const std::string& name : options.only) {
+    for (size_t i = 0; i < sources.size(); i++) {
+      if (name == sources[i].name) selected[i] = true;
+    }
+  }
+
+  std::vector<SourceRunStats> stats(sources.size());
+  std::vector<std::vector<DiscoveredApp>*> results(sources.size());
+  for (size_t i = 0; i < sources.size(); i++) {
+    stats[i].source = &sources[i];
+    results[i] = &cache->entries_[i].apps;
+  }
+
+  // Cheap sources always run, so the fingerprint is known before any
+  // freshness decision needs it
+  uint64_t fingerprint = 0;
+  for (int tier = 0; tier < kSourceCostCount; tier++) {
+    Clock::time_point now = Clock::now();
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < sources.size(); i++) {
+      const DiscoverySource& source = sources[i];
+      if (!selected[i] || (int)source.cost != tier) continue;
+
+      DiscoverySourceCache::Entry& entry = cache->entries_[i];
+      bool fresh = !options.force && source.freshForMs > 0 && entry.valid && !entry.partial &&
+                   (entry.seeded || entry.cheapFingerprint == fingerprint) &&
+                   now - entry.ranAt < std::chrono::milliseconds(source.freshForMs);
+      if (fresh) {
+        // Seeded results predate any local cheap run; from here on an
+        // install on this machine invalidates them like any other
+        entry.cheapFingerprint = fingerprint;
+        entry.seeded = false;
+        stats[i].reused = true;
+        continue;
+      }
+
+      tasks.push_back([&context, &source, &entry, &stats, i, fingerprint]() {
+        Clock::time_point sourceStart = Clock::now();
+        std::vector<DiscoveredApp> apps;
+        std::vector<SourceRootStats> roots;
+        source.scan(context, &apps, &roots);
+        bool degraded = false;
+        for (const SourceRootStats& root : roots) {
+          if (root.status == RootScanStatus::Degraded || root.status == RootScanStatus::Abandoned) degraded = true;
+        }
+        if (degraded && entry.valid) {
+          // A cut-short walk keeps what the last run found, rather than
+          // dropping the apps on a share that was slow this time
+          std::unordered_set<std::string> found;
+          for (const DiscoveredApp& app : apps) found.insert(LowerAscii(app.path));
+          for (const DiscoveredApp& app : entry.apps) {
+            if (found.insert(LowerAscii(app.path)).second) apps.push_back(app);
+          }
+        }
+        entry.apps = std::move(apps);
+        entry.valid = true;
+        entry.partial = degraded;
+        entry.ranAt = Clock::now();
+        entry.cheapFingerprint = fingerprint;
+        entry.seeded = false;
+        stats[i].ran = true;
+        stats[i].degraded = degraded;
+        stats[i].roots = std::move(roots);
+        stats[i].elapsedMs = MillisecondsSince(sourceStart);
+      });
+    }
+    RunParallel(std::move(tasks), options.lane);
+
+    if (tier == (int)SourceCost::Cheap) fingerprint = CheapFingerprint(sources, results);
+  }
+
+  run->apps.clear();
+  run->sources.clear();
+  std::vector<size_t> mergeOrder;
+  for (size_t i = 0; i < sources.size(); i++) {
+    if (!selected[i]) continue;
+    stats[i].appCount = results[i]->size();
+    run->sources.push_back(stats[i]);
+    mergeOrder.push_back(i);
+  }
+
+  // The source with the lowest precedence to claim a path wins it
+  std::stable_sort(mergeOrder.begin(), mergeOrder.end(), [&sources](size_t a, size_t b) {
+    return sources[a].precedence < sources[b].precedence;
+  });
+  std::unordered_set<std::string> seenPaths;
+  for (size_t i : mergeOrder) {
+    for (const DiscoveredApp& app : *results[i]) {
+      if (app.path.empty() || !seenPaths.insert(LowerAscii(app.path)).second) continue;
+      run->apps.push_back(app);
+      run->apps.back().source = sources[i].name;
+    }
+  }
+  run->elapsedMs = MillisecondsSince(start);
+}
+
+DiscoverySourceCache& SharedDiscoverySourceCache() {
+  static DiscoverySourceCache* cache = new DiscoverySourceCache();
+  return *cache;
+}
+
+#ifdef _WIN32
+DiscoveryRoots DefaultDiscoveryRoots() {
+  DiscoveryRoots roots;
+  roots.programFiles = DefaultProgramFilesRoots();
+  roots.packageManagers = DefaultPackageManagerRoots();
+  roots.gameLibraries = DefaultGameLibraryRoots();
+  roots.userProfile = DefaultUserProfileRoots();
+  return roots;
+}
+#endif
+
+Napi::Array SourceRunStatsToNapi(Napi::Env env, const std::vector<SourceRunStats>& stats) {
+  Napi::Array result = Napi::Array::New(env, stats.size());
+  for (size_t i = 0; i < stats.size(); i++) {
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("name", Napi::String::New(env, stats[i].source->name));
+    entry.Set("cost", Napi::String::New(env, SourceCostName(stats[i].source->cost)));
+    entry.Set("precedence", Napi::Number::New(env, stats[i].source->precedence));
+    entry.Set("ran", Napi::Boolean::New(env, stats[i].ran));
+    entry.Set("reused", Napi::Boolean::New(env, stats[i].reused));
+    entry.Set("degraded", Napi::Boolean::New(env, stats[i].degraded));
+    entry.Set("apps", Napi::Number::New(env, (double)stats[i].appCount));
+    entry.Set("elapsedMs", Napi::Number::New(env, stats[i].elapsedMs));
+    if (!stats[i].roots.empty()) {
+      Napi::Array roots = Napi::Array::New(env, stats[i].roots.size());
+      for (size_t j = 0; j < stats[i].roots.size(); j++) {
+        const SourceRootStats& root = stats[i].roots[j];
+        Napi::Object rootEntry = Napi::Object::New(env);
+        rootEntry.Set("root", Napi::String::New(env, root.root));
+        rootEntry.Set("status", Napi::String::New(env, RootScanStatusName(root.status)));
+        rootEntry.Set("elapsedMs", Napi::Number::New(env, root.elapsedMs));
+        roots.Set((uint32_t)j, rootEntry);
+      }
+      entry.Set("roots", roots);
+    }
+    result.Set((uint32_t)i, entry);
+  }
+  return result;
+}
+
+// DiscoverApps: Run every discovery source, cheapest first and in parallel,
+// skipping walks whose results are still fresh, and merge by precedence.
+// With filesystem/registry fixtures the sources scan fake backends, which
+// works on any platform.
+Napi::Value DiscoverApps(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { force?: boolean, sources?: string[], filesystem?, registry? })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  auto* worker = new DiscoveryWorker(env);
+  std::string error;
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifndef _WIN32
+  if (!worker->UsesFixtures()) {
+    delete worker;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("apps", Napi::Array::New(env));
+    result.Set("error", Napi::String::New(env, "Live discovery needs Windows; pass filesystem/registry fixtures"));
+    deferred.Resolve(result);
+    return deferred.Promise();
+  }
+#endif
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
@@ -0,0 +1,151 @@
+#ifndef DISCOVERY_SOURCES_H
+#define DISCOVERY_SOURCES_H
+
+#include <napi.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+#include "executor.h"
+#include "game-library-scan.h"
+#include "package-manager-scan.h"
+#include "user-profile-scan.h"
+
+// Every app-discovery source in one table, so adding or reordering a source
+// is one entry here instead of edits to each scan export and the JS merge.
+// Each source declares what a run costs, how much its results are trusted
+// (precedence) and how long they stay fresh; RunDiscoverySources uses that
+// to run cheap sources first and skip walks whose results are still good.
+
+enum class SourceCost {
+  Cheap,     // A few registry keys or stats
+  Moderate,  // One manifest per installed package
+  Expensive  // Directory walks
+};
+
+constexpr int kSourceCostCount = 3;
+
+const char* SourceCostName(SourceCost cost);
+
+// Roots the filesystem sources scan
+struct DiscoveryRoots {
+  std::vector<std::string> programFiles;
+  PackageManagerRoots packageManagers;
+  GameLibraryRoots gameLibraries;
+  std::vector<std::string> userProfile;
+};
+
+struct DiscoveryContext {
+  FileSystemBackend& fileSystem;
+  RegistryBackend& registry;
+  const DiscoveryRoots& roots;
+  GameLibraryCache* gameCache;
+  ProfileScanCache* profileCache;
+  TaskLane lane = TaskLane::Normal;  // For sources that fan out; set from DiscoveryRunOptions
+  // The backends live as long as the process (the live ones, ungated), so
+  // walks may return while a call stuck past a root's deadline finishes
+  bool backendsOutliveRun = false;
+  // Per walked root; 0 where calls pause for other reasons (idle rescans
+  // wait out user activity), so wall time says nothing about the root
+  uint32_t rootTimeoutMs = kDefaultRootTimeoutMs;
+};
+
+// How one root of a walking source went
+struct SourceRootStats {
+  std::string root;
+  RootScanStatus status = RootScanStatus::Complete;
+  double elapsedMs = 0;
+};
+
+struct DiscoverySource {
+  const char* name;
+  SourceCost cost;
+  int precedence;       // Lower wins when two sources find the same path
+  uint32_t freshForMs;  // 0: always rerun. Otherwise the last results are
+                        // reused this long, unless the cheap sources changed.
+  // Sources that walk roots report each one in roots
+  void (*scan)(const DiscoveryContext& context, std::vector<DiscoveredApp>* apps,
+               std::vector<SourceRootStats>* roots);
+};
+
+// Table order, which is also the order of run stats; the merge goes by
+// precedence
+const std::vector<DiscoverySource>& DiscoverySources();
+
+struct DiscoveryRunOptions {
+  bool force = false;                // Rerun every source regardless of freshness
+  std::vector<std::string> only;     // Source names to run; empty runs all
+  TaskLane lane = TaskLane::Normal;  // Lane for the parallel source tasks
+};
+
+struct SourceRunStats {
+  const DiscoverySource* source = nullptr;
+  bool ran = false;
+  bool reused = false;  // Skipped as fresh; cached results were merged
+  bool degraded = false;  // A root was cut short; its results are partial
+  size_t appCount = 0;
+  double elapsedMs = 0;
+  std::vector<SourceRootStats> roots;
+};
+
+struct DiscoveryRun {
+  std::vector<DiscoveredApp> apps;  // Merged by path, lowest precedence first
+  std::vector<SourceRunStats> sources;
+  double elapsedMs = 0;
+};
+
+// Last results per source, with the cheap-source fingerprint they were
+// taken under. Thread-safe; runs sharing a cache run one at a time.
+class DiscoverySourceCache {
+ public:
+  void Clear();
+
+  // Each source's last results, indexed like DiscoverySources(); empty for
+  // sources that have not run
+  std::vector<std::vector<DiscoveredApp>> Snapshot();
+
+  // Adds apps found elsewhere (an imported catalog) to a source's results.
+  // A source with no results of its own takes them as fresh, so the next
+  // run skips it until its window passes; otherwise paths it lacks are added.
+  void Seed(size_t sourceIndex, const std::vector<DiscoveredApp>& apps);
+
+ private:
+  friend void RunDiscoverySources(const DiscoveryContext&, const DiscoveryRunOptions&,
+                                  DiscoverySourceCache*, DiscoveryRun*);
+
+  struct Entry {
+    bool valid = false;
+    std::chrono::steady_clock::time_point ranAt;
+    uint64_t cheapFingerprint = 0;
+    bool seeded = false;  // From Seed; adopts the next run's fingerprint
+    bool partial = false;  // A degraded run; never reused as fresh
+    std::vector<DiscoveredApp> apps;
+  };
+
+  std::mutex runMutex_;  // Held for a whole run
+  std::vector<Entry> entries_;  // Indexed like DiscoverySources()
+};
+
+// Runs each cost tier's sources in parallel on the shared executor, cheapest
+// tier first. A source with a freshness window is skipped while its cached
+// results are inside it and the cheap sources found the same apps as when
+// it last ran, since an install or uninstall shows up there first. Results
+// of a degraded run are used but not reused: the next run repeats it.
+void RunDiscoverySources(const DiscoveryContext& context, const DiscoveryRunOptions& options,
+                         DiscoverySourceCache* cache, DiscoveryRun* run);
+
+// Cache shared by runDiscoverySources and idle rescans
+DiscoverySourceCache& SharedDiscoverySourceCache();
+
+// Live roots (Windows only)
+DiscoveryRoots DefaultDiscoveryRoots();
+
+Napi::Array SourceRunStatsToNapi(Napi::Env env, const std::vector<SourceRunStats>& stats);
+
+// Function declarations for scheduled discovery across all sources
+Napi::Value DiscoverApps(const Napi::CallbackInfo& info);
+
+#endif
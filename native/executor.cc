@@ -0,0 +1,444 @@
+#include <napi.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "executor.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Queue bounds per lane; interactive work should never back up this far
+constexpr uint32_t kLaneCapacity[kTaskLaneCount] = { 128, 1024, 1024 };
+
+// Latency percentiles cover this many of the most recent tasks per lane
+constexpr size_t kLatencyWindow = 1024;
+
+struct QueuedTask {
+  ExecutorTask task;
+  CancellationToken token;
+  Clock::time_point enqueued;
+};
+
+// Per-worker deques: the owner pushes and pops at the back, thieves take
+// from the front
+struct WorkerQueues {
+  std::mutex mutex;
+  std::deque<QueuedTask> lanes[kTaskLaneCount];
+};
+
+// Fixed-size ring of recent samples, so a long-lived pool reports current
+// latency in bounded memory
+class LatencyWindow {
+ public:
+  void Add(double ms) {
+    if (samples_.size() < kLatencyWindow) {
+      samples_.push_back(ms);
+    } else {
+      samples_[next_] = ms;
+      next_ = (next_ + 1) % kLatencyWindow;
+    }
+  }
+
+  LatencySummary Summarize() const {
+    LatencyRecorder recorder;
+    for (double ms : samples_) recorder.Add(ms);
+    return recorder.Summarize();
+  }
+
+ private:
+  std::vector<double> samples_;
+  size_t next_ = 0;
+};
+
+struct LaneState {
+  std::atomic<uint64_t> queued{0};
+  std::atomic<uint64_t> running{0};
+  uint64_t submitted = 0;   // Counters and windows below are guarded by statsMutex
+  uint64_t completed = 0;
+  uint64_t cancelled = 0;
+  uint64_t rejected = 0;
+  LatencyWindow wait;
+  LatencyWindow run;
+};
+
+double MillisecondsBetween(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// Index of the executor worker running on this thread, or -1
+thread_local int t_workerIndex = -1;
+
+}  // namespace
+
+CancellationToken CancellationToken::Create() {
+  CancellationToken token;
+  token.cancelled_ = std::make_shared<std::atomic<bool>>(false);
+  return token;
+}
+
+void CancellationToken::Cancel() const {
+  if (cancelled_) cancelled_->store(true);
+}
+
+bool CancellationToken::IsCancelled() const {
+  return cancelled_ && cancelled_->load();
+}
+
+const char* TaskLaneName(TaskLane lane) {
+  switch (lane) {
+    case TaskLane::Interactive: return "interactive";
+    case TaskLane::Normal: return "normal";
+    case TaskLane::Background: return "background";
+  }
+  return "normal";
+}
+
+class Executor::Impl {
+ public:
+  Impl() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    // Half the cores: Electron's renderer/GPU threads and the libuv pool
+    // compete for the rest
+    workerCount_ = std::max(2u, cores / 2);
+    backgroundLimit_ = std::max(1u, workerCount_ / 2);
+
+    for (uint32_t i = 0; i < workerCount_; i++) {
+      queues_.emplace_back(new WorkerQueues());
+    }
+    // Leaked with the executor: workers run until process exit
+    for (uint32_t i = 0; i < workerCount_; i++) {
+      std::thread(&Impl::WorkerLoop, this, (int)i).detach();
+    }
+  }
+
+  bool Enqueue(TaskLane lane, ExecutorTask task, CancellationToken token, bool block) {
+    int index = (int)lane;
+    LaneState& state = lanes_[index];
+    bool onWorker = t_workerIndex >= 0;
+
+    // Reserve a queue slot; workers never wait on their own pool
+    if (onWorker) {
+      state.queued++;
+    } else if (!ReserveSlot(state, kLaneCapacity[index], block)) {
+      std::lock_guard<std::mutex> lock(statsMutex_);
+      state.rejected++;
+      return false;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(statsMutex_);
+      state.submitted++;
+    }
+
+    QueuedTask queued = { std::move(task), std::move(token), Clock::now() };
+    if (onWorker) {
+      WorkerQueues& own = *queues_[t_workerIndex];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      own.lanes[index].push_back(std::move(queued));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!onWorker) injection_[index].push_back(std::move(queued));
+      generation_++;
+    }
+    workAvailable_.notify_one();
+    return true;
+  }
+
+  LaneStats Stats(TaskLane lane) {
+    int index = (int)lane;
+    LaneState& state = lanes_[index];
+    LaneStats stats;
+    stats.capacity = kLaneCapacity[index];
+    stats.queued = state.queued.load();
+    stats.running = state.running.load();
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats.submitted = state.submitted;
+    stats.completed = state.completed;
+    stats.cancelled = state.cancelled;
+    stats.rejected = state.rejected;
+    stats.waitMs = state.wait.Summarize();
+    stats.runMs = state.run.Summarize();
+    return stats;
+  }
+
+  uint32_t WorkerCount() const { return workerCount_; }
+
+ private:
+  bool ReserveSlot(LaneState& state, uint32_t capacity, bool block) {
+    uint64_t queued = state.queued.load();
+    while (true) {
+      if (queued < capacity) {
+        if (state.queued.compare_exchange_weak(queued, queued + 1)) return true;
+        continue;
+      }
+      if (!block) return false;
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      spaceAvailable_.wait(lock, [&]() { return state.queued.load() < capacity; });
+      queued = state.queued.load();
+    }
+  }
+
+  // Background tasks may only occupy backgroundLimit_ workers, so a burst
+  // of rescans always leaves workers free for interactive and normal tasks
+  bool ReserveBackgroundWorker() {
+    uint64_t running = lanes_[(int)TaskLane::Background].running.load();
+    while (running < backgroundLimit_) {
+      if (lanes_[(int)TaskLane::Background].running.compare_exchange_weak(running, running + 1)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool PopLocal(int worker, int lane, QueuedTask* out) {
+    WorkerQueues& own = *queues_[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.lanes[lane].empty()) return false;
+    *out = std::move(own.lanes[lane].back());
+    own.lanes[lane].pop_back();
+    return true;
+  }
+
+  bool PopInjected(int lane, QueuedTask* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (injection_[lane].empty()) return false;
+    *out = std::move(injection_[lane].front());
+    injection_[lane].pop_front();
+    return true;
+  }
+
+  bool Steal(int worker, int lane, QueuedTask* out) {
+    for (uint32_t offset = 1; offset < workerCount_; offset++) {
+      WorkerQueues& victim = *queues_[(worker + offset) % workerCount_];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (victim.lanes[lane].empty()) continue;
+      *out = std::move(victim.lanes[lane].front());
+      victim.lanes[lane].pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  // Highest-priority lane first: own deque, then the shared injection
+  // queue, then other workers' deques
+  bool Take(int worker, QueuedTask* out, int* laneOut) {
+    for (int lane = 0; lane < kTaskLaneCount; lane++) {
+      bool background = lane == (int)TaskLane::Background;
+      if (background && !ReserveBackgroundWorker()) continue;
+
+      if (PopLocal(worker, lane, out) || PopInjected(lane, out) || Steal(worker, lane, out)) {
+        if (!background) lanes_[lane].running++;
+        *laneOut = lane;
+        return true;
+      }
+      if (background) lanes_[lane].running--;
+    }
+    return false;
+  }
+
+  void WorkerLoop(int worker) {
+    t_workerIndex = worker;
+    while (true) {
+      // Anything queued (or a background slot freed) after this snapshot
+      // bumps the generation, so a failed Take cannot sleep through it
+      uint64_t seen;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        seen = generation_;
+      }
+
+      QueuedTask queued;
+      int lane = 0;
+      if (!Take(worker, &queued, &lane)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        workAvailable_.wait(lock, [&]() { return generation_ != seen; });
+        continue;
+      }
+      Run(lane, queued);
+    }
+  }
+
+  void Run(int lane, QueuedTask& queued) {
+    LaneState& state = lanes_[lane];
+    uint64_t depth = state.queued--;
+    if (depth >= kLaneCapacity[lane]) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      spaceAvailable_.notify_all();
+    }
+
+    Clock::time_point start = Clock::now();
+    bool cancelled = queued.token.IsCancelled();
+
+#ifdef _WIN32
+    // Lowers this thread's CPU, I/O and memory priority for the task
+    bool background = lane == (int)TaskLane::Background;
+    if (background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#endif
+    queued.task(queued.token);
+#ifdef _WIN32
+    if (background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+#endif
+
+    Clock::time_point end = Clock::now();
+    state.running--;
+    {
+      std::lock_guard<std::mutex> lock(statsMutex_);
+      if (cancelled) {
+        state.cancelled++;
+      } else {
+        state.completed++;
+        state.wait.Add(MillisecondsBetween(queued.enqueued, start));
+        state.run.Add(MillisecondsBetween(start, end));
+      }
+    }
+    // Finishing a background task frees a slot for one still queued
+    if (lane == (int)TaskLane::Background && state.queued.load() > 0) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+      }
+      workAvailable_.notify_all();
+    }
+  }
+
+  uint32_t workerCount_ = 0;
+  uint32_t backgroundLimit_ = 0;
+  std::vector<std::unique_ptr<WorkerQueues>> queues_;
+
+  std::mutex mutex_;                       // Injection queues and sleeping workers
+  std::condition_variable workAvailable_;
+  std::condition_variable spaceAvailable_;
+  std::deque<QueuedTask> injection_[kTaskLaneCount];
+  uint64_t generation_ = 0;                // Bumped whenever new work may be takeable
+
+  std::mutex statsMutex_;
+  LaneState lanes_[kTaskLaneCount];
+};
+
+void Executor::Submit(TaskLane lane, ExecutorTask task, CancellationToken token) {
+  impl_->Enqueue(lane, std::move(task), std::move(token), true);
+}
+
+bool Executor::TrySubmit(TaskLane lane, ExecutorTask task, CancellationToken token) {
+  return impl_->Enqueue(lane, std::move(task), std::move(token), false);
+}
+
+LaneStats Executor::GetLaneStats(TaskLane lane) {
+  return impl_->Stats(lane);
+}
+
+uint32_t Executor::WorkerCount() const {
+  return impl_->WorkerCount();
+}
+
+Executor& SharedExecutor() {
+  // Leaked so detached workers never outlive it
+  static Executor* executor = new Executor(new Executor::Impl());
+  return *executor;
+}
+
+void RunParallel(std::vector<std::function<void()>> tasks, TaskLane lane) {
+  if (tasks.empty()) return;
+
+  struct Batch {
+    std::vector<std::function<void()>> tasks;
+    std::unique_ptr<std::atomic<bool>[]> claimed;
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t remaining = 0;
+  };
+  auto batch = std::make_shared<Batch>();
+  batch->remaining = tasks.size();
+  batch->claimed.reset(new std::atomic<bool>[tasks.size()]());
+  batch->tasks = std::move(tasks);
+
+  auto runTask = [](Batch& batch, size_t index) {
+    if (batch.claimed[index].exchange(true)) return;
+    batch.tasks[index]();
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (--batch.remaining == 0) batch.finished.notify_all();
+  };
+
+  for (size_t i = 1; i < batch->tasks.size(); i++) {
+    SharedExecutor().Submit(lane, [batch, i, runTask](const CancellationToken&) { runTask(*batch, i); });
+  }
+  for (size_t i = 0; i < batch->tasks.size(); i++) runTask(*batch, i);
+
+  std::unique_lock<std::mutex> lock(batch->mutex);
+  batch->finished.wait(lock, [&batch]() { return batch->remaining == 0; });
+}
+
+ExecutorWorker::ExecutorWorker(Napi::Env env, TaskLane lane)
+  : env_(env), lane_(lane), token_(CancellationToken::Create()) {}
+
+bool ExecutorWorker::Queue() {
+  // Keeps the event loop alive until OnOK has run, as an AsyncWorker does
+  Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+    env_, Napi::Function::New(env_, [](const Napi::CallbackInfo&) {}), "executorWorker", 0, 1);
+
+  bool queued = SharedExecutor().TrySubmit(lane_, [this, tsfn](const CancellationToken& token) mutable {
+    if (!token.IsCancelled()) Execute(token);
+
+    // `this` may be deleted on the JS thread as soon as the call is queued
+    Napi::ThreadSafeFunction done = tsfn;
+    napi_status status = done.NonBlockingCall([this](Napi::Env env, Napi::Function) {
+      OnOK(env);
+      delete this;
+    });
+    if (status != napi_ok) delete this;
+    done.Release();
+  }, token_);
+
+  if (!queued) tsfn.Release();
+  return queued;
+}
+
+Napi::Value ExecutorBusyResult(Napi::Env env) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, false));
+  result.Set("error", Napi::String::New(env, "Executor queue is full"));
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  deferred.Resolve(result);
+  return deferred.Promise();
+}
+
+// GetExecutorStats: Worker count plus per-lane queue depth and latency
+Napi::Value GetExecutorStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Executor& executor = SharedExecutor();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("workers", Napi::Number::New(env, executor.WorkerCount()));
+
+  Napi::Object lanes = Napi::Object::New(env);
+  for (int i = 0; i < kTaskLaneCount; i++) {
+    TaskLane lane = (TaskLane)i;
+    LaneStats stats = executor.GetLaneStats(lane);
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("capacity", Napi::Number::New(env, stats.capacity));
+    entry.Set("queued", Napi::Number::New(env, (double)stats.queued));
+    entry.Set("running", Napi::Number::New(env, (double)stats.running));
+    entry.Set("submitted", Napi::Number::New(env, (double)stats.submitted));
+    entry.Set("completed", Napi::Number::New(env, (double)stats.completed));
+    entry.Set("cancelled", Napi::Number::New(env, (double)stats.cancelled));
+    entry.Set("rejected", Napi::Number::New(env, (double)stats.rejected));
+    entry.Set("waitMs", LatencySummaryToObject(env, stats.waitMs));
+    entry.Set("runMs", LatencySummaryToObject(env, stats.runMs));
+    lanes.Set(TaskLaneName(lane), entry);
+  }
+  result.Set("lanes", lanes);
+  return result;
+}
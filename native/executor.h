@@ -0,0 +1,117 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <napi.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "latency-stats.h"
+
+// One work-stealing thread pool shared by every addon subsystem that needs
+// CPU or blocking I/O off the JS thread (scans, enrichment, diagnostics), so
+// they do not each start threads and oversubscribe the cores Electron and
+// libuv already use. Window ops keep their own threads: those isolate hung
+// apps rather than doing work.
+
+enum class TaskLane {
+  Interactive,  // The user is waiting on the result
+  Normal,
+  Background    // Rescans, enrichment; at most half the workers at once
+};
+
+constexpr int kTaskLaneCount = 3;
+
+const char* TaskLaneName(TaskLane lane);
+
+// Cooperative cancellation: long tasks poll IsCancelled between steps.
+// Copies share state; a default-constructed token can never be cancelled.
+class CancellationToken {
+ public:
+  static CancellationToken Create();
+
+  void Cancel() const;
+  bool IsCancelled() const;
+
+ private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// A task whose token is cancelled while it is queued is still invoked once,
+// with the cancelled token, so it can release what it holds (promises, TSFNs)
+using ExecutorTask = std::function<void(const CancellationToken& token)>;
+
+struct LaneStats {
+  uint32_t capacity = 0;
+  uint64_t queued = 0;      // Current queue depth
+  uint64_t running = 0;
+  uint64_t submitted = 0;
+  uint64_t completed = 0;
+  uint64_t cancelled = 0;   // Dequeued already cancelled
+  uint64_t rejected = 0;    // TrySubmit on a full lane
+  LatencySummary waitMs;    // Enqueue to start, over recent tasks
+  LatencySummary runMs;
+};
+
+class Executor {
+ public:
+  // Blocks while the lane is full (back-pressure), except on executor
+  // workers, which never block on their own pool and may exceed capacity
+  void Submit(TaskLane lane, ExecutorTask task, CancellationToken token = CancellationToken());
+  // Never blocks; false when the lane is full. Use on the JS thread.
+  bool TrySubmit(TaskLane lane, ExecutorTask task, CancellationToken token = CancellationToken());
+
+  LaneStats GetLaneStats(TaskLane lane);
+  uint32_t WorkerCount() const;
+
+ private:
+  friend Executor& SharedExecutor();
+  class Impl;
+  explicit Executor(Impl* impl) : impl_(impl) {}
+  Impl* impl_;
+};
+
+// Started on first use; lives until process exit
+Executor& SharedExecutor();
+
+// Fork-join over the shared executor: runs every task, on workers and on
+// the calling thread, and returns once all have finished. The caller takes
+// any task no worker has started yet, so this never waits on a queue and is
+// safe to call from a worker.
+void RunParallel(std::vector<std::function<void()>> tasks, TaskLane lane);
+
+// Napi::AsyncWorker counterpart on the shared executor: Execute runs on a
+// worker, then OnOK runs on the JS thread and the worker deletes itself.
+// Execute is skipped if the token is cancelled before it starts; OnOK still
+// runs so promises settle.
+class ExecutorWorker {
+ public:
+  ExecutorWorker(Napi::Env env, TaskLane lane);
+  virtual ~ExecutorWorker() = default;
+
+  // Never blocks. Returns false when the lane is full; the caller still owns
+  // (and deletes) the worker in that case.
+  bool Queue();
+  void Cancel() { token_.Cancel(); }
+
+ protected:
+  virtual void Execute(const CancellationToken& token) = 0;
+  virtual void OnOK(Napi::Env env) = 0;
+
+  const CancellationToken& Token() const { return token_; }
+
+ private:
+  Napi::Env env_;
+  TaskLane lane_;
+  CancellationToken token_;
+};
+
+// Promise resolving { success: false, error } for an export whose worker
+// could not be queued
+Napi::Value ExecutorBusyResult(Napi::Env env);
+
+// Function declarations for executor diagnostics
+Napi::Value GetExecutorStats(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,428 @@
+#include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "discovery-backend.h"
+#include "facet-index.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Nested and/or/not deeper than this is rejected rather than recursed into
+constexpr int kMaxQueryDepth = 32;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint32_t Trigram(const std::string& text, size_t offset) {
+  return ((uint32_t)(uint8_t)text[offset] << 16) | ((uint32_t)(uint8_t)text[offset + 1] << 8) |
+         (uint8_t)text[offset + 2];
+}
+
+// Trigrams of each line of text, without ones that span a line break
+template <typename Visit>
+void ForEachTrigram(const std::string& text, Visit visit) {
+  for (size_t i = 0; i + 3 <= text.size(); i++) {
+    if (text[i] == '\n' || text[i + 1] == '\n' || text[i + 2] == '\n') continue;
+    visit(Trigram(text, i));
+  }
+}
+
+// The index queries run against; replaced whole by each build so a query
+// never sees a half-built one
+struct SharedIndex {
+  std::mutex mutex;
+  std::shared_ptr<const FacetIndex> index;
+};
+
+// Leaked, like the other module-wide state
+SharedIndex& CurrentIndex() {
+  static SharedIndex* shared = new SharedIndex();
+  return *shared;
+}
+
+std::string ReadString(const Napi::Object& object, const char* name) {
+  Napi::Value value = object.Get(name);
+  return value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string();
+}
+
+bool ReadStringList(const Napi::Value& value, std::vector<std::string>* strings) {
+  if (value.IsString()) {
+    strings->push_back(value.As<Napi::String>().Utf8Value());
+    return true;
+  }
+  if (!value.IsArray()) return false;
+  Napi::Array array = value.As<Napi::Array>();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value item = array.Get(i);
+    if (!item.IsString()) return false;
+    strings->push_back(item.As<Napi::String>().Utf8Value());
+  }
+  return true;
+}
+
+// A finite number clamped to [0, UINT32_MAX]; casting NaN, infinities or
+// values past the target type to an integer is undefined
+bool ReadCount(const Napi::Value& value, uint32_t* count) {
+  if (!value.IsNumber()) return false;
+  double number = value.As<Napi::Number>().DoubleValue();
+  if (!std::isfinite(number)) return false;
+  *count = (uint32_t)std::min(std::max(number, 0.0), (double)UINT32_MAX);
+  return true;
+}
+
+//   { facet, value } | { facet, values: [] } | { and: [] } | { or: [] } | { not: query }
+bool ReadFacetQuery(const Napi::Value& value, int depth, FacetQuery* query, std::string* error) {
+  if (depth > kMaxQueryDepth) {
+    *error = "where is nested too deeply";
+    return false;
+  }
+  if (!value.IsObject()) {
+    *error = "where clauses must be objects";
+    return false;
+  }
+  Napi::Object object = value.As<Napi::Object>();
+
+  if (!object.Get("facet").IsUndefined()) {
+    query->op = FacetQuery::Op::Match;
+    Napi::Value values = object.Get("values");
+    if (values.IsUndefined()) values = object.Get("value");
+    if (!ParseFacetName(ReadString(object, "facet"), &query->facet) || !ReadStringList(values, &query->values)) {
+      *error = "Expected { facet: 'source' | 'publisher' | 'arch' | 'signed' | 'subsystem', value | values }";
+      return false;
+    }
+    return true;
+  }
+
+  if (!object.Get("not").IsUndefined()) {
+    query->op = FacetQuery::Op::Not;
+    query->children.resize(1);
+    return ReadFacetQuery(object.Get("not"), depth + 1, &query->children[0], error);
+  }
+
+  const char* operands = nullptr;
+  if (!object.Get("and").IsUndefined()) {
+    operands = "and";
+  } else if (!object.Get("or").IsUndefined()) {
+    operands = "or";
+  }
+  if (!operands || !object.Get(operands).IsArray()) {
+    *error = "where clauses need facet, and, or or not";
+    return false;
+  }
+  query->op = operands[0] == 'a' ? FacetQuery::Op::And : FacetQuery::Op::Or;
+  Napi::Array array = object.Get(operands).As<Napi::Array>();
+  query->children.resize(array.Length());
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    if (!ReadFacetQuery(array.Get(i), depth + 1, &query->children[i], error)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+const char* FacetName(Facet facet) {
+  switch (facet) {
+    case Facet::Source: return "source";
+    case Facet::Publisher: return "publisher";
+    case Facet::Arch: return "arch";
+    case Facet::Signed: return "signed";
+    case Facet::Subsystem: return "subsystem";
+  }
+  return "source";
+}
+
+bool ParseFacetName(const std::string& name, Facet* facet) {
+  for (int i = 0; i < kFacetCount; i++) {
+    if (name == FacetName((Facet)i)) {
+      *facet = (Facet)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+FacetIndex::FacetIndex(std::vector<FacetRow> rows) : rows_(std::move(rows)) {
+  all_ = RoaringBitmap::Range((uint32_t)rows_.size());
+  searchText_.reserve(rows_.size());
+  for (uint32_t id = 0; id < rows_.size(); id++) {
+    const FacetRow& row = rows_[id];
+    for (int f = 0; f < kFacetCount; f++) {
+      if (row.values[f].empty()) continue;
+      FacetValues& facet = facets_[f];
+      auto inserted = facet.indexByKey.emplace(LowerAscii(row.values[f]), facet.names.size());
+      if (inserted.second) {
+        facet.names.push_back(row.values[f]);
+        facet.rows.emplace_back();
+      }
+      facet.rows[inserted.first->second].Add(id);
+    }
+
+    searchText_.push_back(LowerAscii(row.name) + "\n" + LowerAscii(row.path));
+    ForEachTrigram(searchText_.back(), [this, id](uint32_t trigram) { trigrams_[trigram].Add(id); });
+  }
+}
+
+size_t FacetIndex::SizeInBytes() const {
+  size_t bytes = all_.SizeInBytes();
+  for (const FacetValues& facet : facets_) {
+    for (const RoaringBitmap& rows : facet.rows) bytes += rows.SizeInBytes();
+  }
+  for (const auto& trigram : trigrams_) bytes += sizeof(trigram.first) + trigram.second.SizeInBytes();
+  return bytes;
+}
+
+RoaringBitmap FacetIndex::Evaluate(const FacetQuery& query) const {
+  switch (query.op) {
+    case FacetQuery::Op::All:
+      return all_;
+    case FacetQuery::Op::Match: {
+      const FacetValues& facet = facets_[(int)query.facet];
+      RoaringBitmap matched;
+      for (const std::string& value : query.values) {
+        auto it = facet.indexByKey.find(LowerAscii(value));
+        if (it != facet.indexByKey.end()) matched = RoaringBitmap::Or(matched, facet.rows[it->second]);
+      }
+      return matched;
+    }
+    case FacetQuery::Op::And: {
+      if (query.children.empty()) return all_;
+      RoaringBitmap matched = Evaluate(query.children[0]);
+      for (size_t i = 1; i < query.children.size() && !matched.Empty(); i++) {
+        matched = RoaringBitmap::And(matched, Evaluate(query.children[i]));
+      }
+      return matched;
+    }
+    case FacetQuery::Op::Or: {
+      RoaringBitmap matched;
+      for (const FacetQuery& child : query.children) matched = RoaringBitmap::Or(matched, Evaluate(child));
+      return matched;
+    }
+    case FacetQuery::Op::Not:
+      return RoaringBitmap::AndNot(all_, Evaluate(query.children[0]));
+  }
+  return all_;
+}
+
+RoaringBitmap FacetIndex::MatchText(const std::string& loweredText, const RoaringBitmap& candidates) const {
+  // Rows holding every trigram of the text are a superset of the matches;
+  // shorter text has no trigrams and checks every candidate
+  RoaringBitmap narrowed = candidates;
+  bool missing = false;
+  ForEachTrigram(loweredText, [&](uint32_t trigram) {
+    if (missing || narrowed.Empty()) return;
+    auto it = trigrams_.find(trigram);
+    if (it == trigrams_.end()) {
+      missing = true;
+    } else {
+      narrowed = RoaringBitmap::And(narrowed, it->second);
+    }
+  });
+  if (missing) return RoaringBitmap();
+
+  std::vector<uint32_t> ids;
+  narrowed.ToVector(&ids);
+  RoaringBitmap matched;
+  for (uint32_t id : ids) {
+    if (searchText_[id].find(loweredText) != std::string::npos) matched.Add(id);
+  }
+  return matched;
+}
+
+void FacetIndex::Search(const FacetSearch& search, FacetSearchResult* result) const {
+  RoaringBitmap matched = Evaluate(search.where);
+  if (search.hasRows) {
+    RoaringBitmap rows;
+    for (uint32_t id : search.rows) {
+      if (id < rows_.size()) rows.Add(id);
+    }
+    matched = RoaringBitmap::And(matched, rows);
+  }
+  if (!search.text.empty()) matched = MatchText(LowerAscii(search.text), matched);
+
+  result->total = matched.Cardinality();
+  result->rows.clear();
+  matched.ToVector(&result->rows, search.offset, search.limit);
+
+  result->counts.clear();
+  for (Facet facet : search.countFacets) {
+    const FacetValues& values = facets_[(int)facet];
+    std::vector<FacetValueCount> counts;
+    for (size_t i = 0; i < values.names.size(); i++) {
+      uint64_t count = RoaringBitmap::AndCardinality(matched, values.rows[i]);
+      if (count > 0) counts.push_back({ values.names[i], count });
+    }
+    std::sort(counts.begin(), counts.end(), [](const FacetValueCount& a, const FacetValueCount& b) {
+      return a.count != b.count ? a.count > b.count : a.value < b.value;
+    });
+    result->counts.emplace_back(facet, std::move(counts));
+  }
+}
+
+// BuildFacetIndex: Index catalog rows for queryFacetIndex, replacing the
+// previous index. Row ids are positions in rows. Returns { success, rows,
+// values: { <facet>: distinct values }, bytes, elapsedMs }.
+Napi::Value BuildFacetIndex(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected (rows: { name, path, source?, publisher?, arch?, subsystem?, signed? }[])").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Clock::time_point start = Clock::now();
+  Napi::Array array = info[0].As<Napi::Array>();
+  std::vector<FacetRow> rows(array.Length());
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    // Non-objects stay as empty rows so ids keep matching positions
+    Napi::Value value = array.Get(i);
+    if (!value.IsObject()) continue;
+    Napi::Object object = value.As<Napi::Object>();
+    FacetRow& row = rows[i];
+    row.name = ReadString(object, "name");
+    row.path = ReadString(object, "path");
+    row.values[(int)Facet::Source] = ReadString(object, "source");
+    row.values[(int)Facet::Publisher] = ReadString(object, "publisher");
+    row.values[(int)Facet::Arch] = ReadString(object, "arch");
+    row.values[(int)Facet::Subsystem] = ReadString(object, "subsystem");
+    Napi::Value isSigned = object.Get("signed");
+    if (isSigned.IsBoolean()) {
+      row.values[(int)Facet::Signed] = isSigned.As<Napi::Boolean>().Value() ? "signed" : "unsigned";
+    }
+  }
+
+  auto index = std::make_shared<const FacetIndex>(std::move(rows));
+  {
+    std::lock_guard<std::mutex> lock(CurrentIndex().mutex);
+    CurrentIndex().index = index;
+  }
+
+  Napi::Object values = Napi::Object::New(env);
+  for (int f = 0; f < kFacetCount; f++) {
+    values.Set(FacetName((Facet)f), Napi::Number::New(env, (double)index->ValueCount((Facet)f)));
+  }
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, true));
+  result.Set("rows", Napi::Number::New(env, (double)index->RowCount()));
+  result.Set("values", values);
+  result.Set("bytes", Napi::Number::New(env, (double)index->SizeInBytes()));
+  result.Set("elapsedMs", Napi::Number::New(env, MillisecondsSince(start)));
+  return result;
+}
+
+// QueryFacetIndex: Rows matching a facet filter, text and/or row ids from
+// another search, with value counts over the matches. Returns { success,
+// total, rows, counts: { <facet>: [{ value, count }] }, elapsedMs }.
+Napi::Value QueryFacetIndex(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* usage = "Expected (query?: { where?, text?, rows?: number[], counts?: string[], offset?, limit? })";
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object query = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  FacetSearch search;
+  std::string error;
+  Napi::Value where = query.Get("where");
+  if (!where.IsUndefined() && !ReadFacetQuery(where, 0, &search.where, &error)) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  search.text = ReadString(query, "text");
+
+  Napi::Value rows = query.Get("rows");
+  if (rows.IsArray()) {
+    search.hasRows = true;
+    Napi::Array array = rows.As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value id = array.Get(i);
+      uint32_t row;
+      if (id.IsNumber() && id.As<Napi::Number>().DoubleValue() >= 0 && ReadCount(id, &row)) {
+        search.rows.push_back(row);
+      }
+    }
+  }
+
+  // Every facet unless counts names some (or none)
+  std::vector<std::string> countNames;
+  Napi::Value counts = query.Get("counts");
+  if (counts.IsUndefined()) {
+    for (int f = 0; f < kFacetCount; f++) countNames.push_back(FacetName((Facet)f));
+  } else if (!ReadStringList(counts, &countNames)) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  for (const std::string& name : countNames) {
+    Facet facet;
+    if (!ParseFacetName(name, &facet)) {
+      Napi::TypeError::New(env, "Unknown facet: " + name).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    search.countFacets.push_back(facet);
+  }
+
+  Napi::Value offset = query.Get("offset");
+  Napi::Value limit = query.Get("limit");
+  uint32_t count;
+  if (offset.IsNumber()) {
+    if (!ReadCount(offset, &count)) {
+      Napi::TypeError::New(env, "offset must be a finite number").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    search.offset = count;
+  }
+  if (limit.IsNumber()) {
+    if (!ReadCount(limit, &count)) {
+      Napi::TypeError::New(env, "limit must be a finite number").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    search.limit = count;
+  }
+
+  std::shared_ptr<const FacetIndex> index;
+  {
+    std::lock_guard<std::mutex> lock(CurrentIndex().mutex);
+    index = CurrentIndex().index;
+  }
+  Napi::Object result = Napi::Object::New(env);
+  if (!index) {
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("error", Napi::String::New(env, "No facet index; call buildFacetIndex first"));
+    return result;
+  }
+
+  Clock::time_point start = Clock::now();
+  FacetSearchResult found;
+  index->Search(search, &found);
+  double elapsedMs = MillisecondsSince(start);
+
+  Napi::Array ids = Napi::Array::New(env, found.rows.size());
+  for (size_t i = 0; i < found.rows.size(); i++) ids.Set((uint32_t)i, Napi::Number::New(env, found.rows[i]));
+  Napi::Object facetCounts = Napi::Object::New(env);
+  for (const auto& facet : found.counts) {
+    Napi::Array values = Napi::Array::New(env, facet.second.size());
+    for (size_t i = 0; i < facet.second.size(); i++) {
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("value", Napi::String::New(env, facet.second[i].value));
+      entry.Set("count", Napi::Number::New(env, (double)facet.second[i].count));
+      values.Set((uint32_t)i, entry);
+    }
+    facetCounts.Set(FacetName(facet.first), values);
+  }
+
+  result.Set("success", Napi::Boolean::New(env, true));
+  result.Set("total", Napi::Number::New(env, (double)found.total));
+  result.Set("rows", ids);
+  result.Set("counts", facetCounts);
+  result.Set("elapsedMs", Napi::Number::New(env, elapsedMs));
+  return result;
+}
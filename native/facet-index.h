@@ -0,0 +1,102 @@
+#ifndef FACET_INDEX_H
+#define FACET_INDEX_H
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "roaring-bitmap.h"
+
+// Filters for the app picker, answered from bitmaps instead of a pass over
+// the catalog array. Row ids are indexes into the array the index was built
+// from. Each facet value keeps the bitmap of rows carrying it, so a query is
+// a few bitmap ANDs/ORs/NOTs and facet counts are intersection counts. Text
+// search narrows candidates with a bitmap per name and path trigram, then
+// checks the survivors, and ANDs with the facet filter before it checks
+// anything.
+
+enum class Facet {
+  Source,
+  Publisher,
+  Arch,
+  Signed,     // "signed" / "unsigned"
+  Subsystem   // "gui" / "console" / ...
+};
+
+constexpr int kFacetCount = 5;
+
+const char* FacetName(Facet facet);
+bool ParseFacetName(const std::string& name, Facet* facet);
+
+struct FacetRow {
+  std::string name;
+  std::string path;
+  std::string values[kFacetCount];  // Indexed by Facet; "" leaves the row out of that facet
+};
+
+struct FacetQuery {
+  enum class Op { All, Match, And, Or, Not };
+
+  Op op = Op::All;
+  Facet facet = Facet::Source;       // Match
+  std::vector<std::string> values;   // Match: rows with any of these (case-insensitive)
+  std::vector<FacetQuery> children;  // And/Or: operands; Not: the one negated
+};
+
+struct FacetSearch {
+  FacetQuery where;
+  std::string text;                 // Substring of the name or full path, case-insensitive
+  bool hasRows = false;             // Restrict to rows, e.g. an external fuzzy search's hits
+  std::vector<uint32_t> rows;
+  std::vector<Facet> countFacets;   // Value counts over the matching rows
+  uint64_t offset = 0;
+  uint64_t limit = UINT64_MAX;
+};
+
+struct FacetValueCount {
+  std::string value;
+  uint64_t count = 0;
+};
+
+struct FacetSearchResult {
+  uint64_t total = 0;
+  std::vector<uint32_t> rows;  // Ascending ids, after offset and limit
+  std::vector<std::pair<Facet, std::vector<FacetValueCount>>> counts;  // Most common first
+};
+
+// Immutable once built; safe to query from several threads
+class FacetIndex {
+ public:
+  explicit FacetIndex(std::vector<FacetRow> rows);
+
+  size_t RowCount() const { return rows_.size(); }
+  size_t ValueCount(Facet facet) const { return facets_[(int)facet].names.size(); }
+  size_t SizeInBytes() const;
+
+  RoaringBitmap Evaluate(const FacetQuery& query) const;
+  void Search(const FacetSearch& search, FacetSearchResult* result) const;
+
+ private:
+  struct FacetValues {
+    std::vector<std::string> names;                     // As first seen
+    std::unordered_map<std::string, size_t> indexByKey; // Lowercased value -> names index
+    std::vector<RoaringBitmap> rows;
+  };
+
+  // Rows of candidates whose search text contains loweredText
+  RoaringBitmap MatchText(const std::string& loweredText, const RoaringBitmap& candidates) const;
+
+  std::vector<FacetRow> rows_;
+  std::vector<std::string> searchText_;  // Lowercased "name\npath" per row
+  FacetValues facets_[kFacetCount];
+  std::unordered_map<uint32_t, RoaringBitmap> trigrams_;
+  RoaringBitmap all_;
+};
+
+// Function declarations for catalog facet indexes
+Napi::Value BuildFacetIndex(const Napi::CallbackInfo& info);
+Napi::Value QueryFacetIndex(const Napi::CallbackInfo& info);
+
+#endif
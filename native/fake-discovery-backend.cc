@@ -0,0 +1,408 @@
+#include "fake-discovery-backend.h"
+
+namespace {
+
+// What Windows allows in one path before failing with ERROR_CANT_RESOLVE_FILENAME
+constexpr int kMaxLinkHops = 63;
+
+// Canonical map key: backslashes, no trailing separator, lowercase
+std::string NormalizePath(const std::string& path) {
+  std::string key = path;
+  for (char& c : key) {
+    if (c == '/') c = '\\';
+  }
+  while (key.size() > 1 && key.back() == '\\') key.pop_back();
+  return LowerAscii(key);
+}
+
+std::string DisplayPath(const std::string& path) {
+  std::string display = path;
+  for (char& c : display) {
+    if (c == '/') c = '\\';
+  }
+  while (display.size() > 1 && display.back() == '\\') display.pop_back();
+  return display;
+}
+
+std::string RegistryKey(RegistryRoot root, const std::string& keyPath) {
+  std::string key = RegistryRootName(root);
+  if (!keyPath.empty()) key += "\\" + DisplayPath(keyPath);
+  return key;
+}
+
+bool ReadRoot(const Napi::Value& value, RegistryRoot* root) {
+  if (!value.IsString()) return true;  // Default HKLM
+  std::string name = value.As<Napi::String>().Utf8Value();
+  const RegistryRoot roots[] = {
+    RegistryRoot::LocalMachine, RegistryRoot::CurrentUser, RegistryRoot::ClassesRoot
+  };
+  for (RegistryRoot candidate : roots) {
+    if (name == RegistryRootName(candidate)) {
+      *root = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+FakeFileSystem::Node& FakeFileSystem::Ensure(const std::string& path, bool isDirectory, int64_t mtimeMs) {
+  std::string display = DisplayPath(path);
+  std::string key = LowerAscii(display);
+
+  auto it = nodes_.find(key);
+  if (it != nodes_.end()) {
+    it->second.entry.isDirectory = it->second.entry.isDirectory || isDirectory;
+    if (mtimeMs) it->second.entry.mtimeMs = mtimeMs;
+    return it->second;
+  }
+
+  size_t lastSlash = display.find_last_of('\\');
+  if (lastSlash != std::string::npos && lastSlash > 0) {
+    Node& parent = Ensure(display.substr(0, lastSlash), true, 0);
+    parent.children.push_back(key);
+  }
+
+  Node& node = nodes_[key];
+  node.id = nextId_++;
+  node.entry.name = FileNameOf(display);
+  node.entry.isDirectory = isDirectory;
+  node.entry.mtimeMs = mtimeMs;
+  return node;
+}
+
+bool FakeFileSystem::Resolve(const std::string& path, bool followLast, std::string* key) {
+  *key = NormalizePath(path);
+  if (linkCount_ == 0) return true;
+
+  // Components resolve left to right, so the shortest link prefix goes first
+  for (int hop = 0; hop < kMaxLinkHops; hop++) {
+    bool redirected = false;
+    size_t end = key->find('\\');
+    while (!redirected) {
+      bool last = end == std::string::npos;
+      size_t prefixLength = last ? key->size() : end;
+      if (!last || followLast) {
+        auto it = nodes_.find(key->substr(0, prefixLength));
+        if (it != nodes_.end() && it->second.entry.link != LinkKind::None) {
+          *key = it->second.target + key->substr(prefixLength);
+          redirected = true;
+        }
+      }
+      if (last) break;
+      end = key->find('\\', end + 1);
+    }
+    if (!redirected) return true;
+  }
+  return false;
+}
+
+BackendStatus FakeFileSystem::Fault(const std::string& path) {
+  return faults_ ? faults_->Inject(path) : BackendStatus::Ok;
+}
+
+void FakeFileSystem::AddDirectory(const std::string& path, int64_t mtimeMs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Ensure(path, true, mtimeMs);
+}
+
+void FakeFileSystem::AddFile(const std::string& path, const std::string& contents, int64_t mtimeMs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Node& node = Ensure(path, false, mtimeMs);
+  node.contents = contents;
+  node.entry.size = contents.size();
+}
+
+void FakeFileSystem::AddFileEntry(const std::string& path, uint64_t size, int64_t mtimeMs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Node& node = Ensure(path, false, mtimeMs);
+  node.entry.size = size;
+}
+
+void FakeFileSystem::AddLink(const std::string& path, const std::string& target, LinkKind kind) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Node& node = Ensure(path, true, 0);
+  if (node.entry.link == LinkKind::None) linkCount_++;
+  node.entry.isReparsePoint = true;
+  node.entry.link = kind == LinkKind::None ? LinkKind::Junction : kind;
+  node.target = NormalizePath(target);
+}
+
+BackendStatus FakeFileSystem::ListDirectory(const std::string& path, std::vector<DirEntry>* entries) {
+  BackendStatus status = Fault(path);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key;
+  if (!Resolve(path, true, &key)) return BackendStatus::IoError;
+  auto it = nodes_.find(key);
+  if (it == nodes_.end() || !it->second.entry.isDirectory) return BackendStatus::NotFound;
+  for (const std::string& child : it->second.children) {
+    entries->push_back(nodes_.at(child).entry);
+  }
+  return BackendStatus::Ok;
+}
+
+BackendStatus FakeFileSystem::Stat(const std::string& path, DirEntry* entry) {
+  BackendStatus status = Fault(path);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key;
+  if (!Resolve(path, false, &key)) return BackendStatus::IoError;
+  auto it = nodes_.find(key);
+  if (it == nodes_.end()) return BackendStatus::NotFound;
+  *entry = it->second.entry;
+  return BackendStatus::Ok;
+}
+
+BackendStatus FakeFileSystem::ReadFile(const std::string& path, size_t maxBytes, std::string* contents) {
+  return ReadFileAt(path, 0, maxBytes, contents);
+}
+
+BackendStatus FakeFileSystem::ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                                         std::string* contents) {
+  BackendStatus status = Fault(path);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key;
+  if (!Resolve(path, true, &key)) return BackendStatus::IoError;
+  auto it = nodes_.find(key);
+  if (it == nodes_.end()) return BackendStatus::NotFound;
+  if (it->second.entry.isDirectory) return BackendStatus::AccessDenied;
+  const std::string& data = it->second.contents;
+  *contents = offset < data.size() ? data.substr((size_t)offset, maxBytes) : std::string();
+  return BackendStatus::Ok;
+}
+
+BackendStatus FakeFileSystem::Identify(const std::string& path, FileIdentity* identity) {
+  BackendStatus status = Fault(path);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key;
+  if (!Resolve(path, true, &key)) return BackendStatus::IoError;
+  auto it = nodes_.find(key);
+  if (it == nodes_.end()) return BackendStatus::NotFound;
+  identity->volume = 1;
+  identity->fileIdHigh = 0;
+  identity->fileIdLow = it->second.id;
+  return BackendStatus::Ok;
+}
+
+FakeRegistry::Key& FakeRegistry::Ensure(RegistryRoot root, const std::string& keyPath) {
+  std::string display = RegistryKey(root, keyPath);
+  std::string key = LowerAscii(display);
+
+  auto it = keys_.find(key);
+  if (it != keys_.end()) return it->second;
+
+  std::string path = DisplayPath(keyPath);
+  size_t lastSlash = path.find_last_of('\\');
+  if (!path.empty()) {
+    Key& parent = Ensure(root, lastSlash == std::string::npos ? "" : path.substr(0, lastSlash));
+    parent.subKeys.push_back(FileNameOf(path));
+  }
+  return keys_[key];
+}
+
+BackendStatus FakeRegistry::Fault(RegistryRoot root, const std::string& keyPath) {
+  return faults_ ? faults_->Inject(RegistryKey(root, keyPath)) : BackendStatus::Ok;
+}
+
+void FakeRegistry::AddKey(RegistryRoot root, const std::string& keyPath) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Ensure(root, keyPath);
+}
+
+void FakeRegistry::SetString(RegistryRoot root, const std::string& keyPath,
+                             const std::string& valueName, const std::string& data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  SetValue(root, keyPath, valueName, data, false);
+}
+
+void FakeRegistry::SetBinary(RegistryRoot root, const std::string& keyPath,
+                             const std::string& valueName, const std::string& data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  SetValue(root, keyPath, valueName, data, true);
+}
+
+void FakeRegistry::SetValue(RegistryRoot root, const std::string& keyPath, const std::string& valueName,
+                            const std::string& data, bool binary) {
+  Key& key = Ensure(root, keyPath);
+  std::string name = LowerAscii(valueName);
+  if (key.values.count(name) == 0) key.valueNames.push_back(valueName);
+  key.values[name] = data;
+  if (binary) {
+    key.binary.insert(name);
+  } else {
+    key.binary.erase(name);
+  }
+}
+
+BackendStatus FakeRegistry::EnumerateSubKeys(RegistryRoot root, const std::string& keyPath,
+                                             std::vector<std::string>* names) {
+  BackendStatus status = Fault(root, keyPath);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = keys_.find(LowerAscii(RegistryKey(root, keyPath)));
+  if (it == keys_.end()) return BackendStatus::NotFound;
+  names->insert(names->end(), it->second.subKeys.begin(), it->second.subKeys.end());
+  return BackendStatus::Ok;
+}
+
+BackendStatus FakeRegistry::ReadString(RegistryRoot root, const std::string& keyPath,
+                                       const std::string& valueName, std::string* data) {
+  BackendStatus status = Fault(root, keyPath);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = keys_.find(LowerAscii(RegistryKey(root, keyPath)));
+  if (it == keys_.end()) return BackendStatus::NotFound;
+  auto value = it->second.values.find(LowerAscii(valueName));
+  if (value == it->second.values.end() || it->second.binary.count(value->first)) return BackendStatus::NotFound;
+  *data = value->second;
+  return BackendStatus::Ok;
+}
+
+BackendStatus FakeRegistry::ReadValues(RegistryRoot root, const std::string& keyPath,
+                                       std::vector<RegistryValue>* values) {
+  BackendStatus status = Fault(root, keyPath);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = keys_.find(LowerAscii(RegistryKey(root, keyPath)));
+  if (it == keys_.end()) return BackendStatus::NotFound;
+  for (const std::string& name : it->second.valueNames) {
+    if (it->second.binary.count(LowerAscii(name))) continue;
+    values->push_back({ name, it->second.values.at(LowerAscii(name)) });
+  }
+  return BackendStatus::Ok;
+}
+
+BackendStatus FakeRegistry::ReadBinaryValues(RegistryRoot root, const std::string& keyPath,
+                                             std::vector<RegistryValue>* values) {
+  BackendStatus status = Fault(root, keyPath);
+  if (status != BackendStatus::Ok) return status;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = keys_.find(LowerAscii(RegistryKey(root, keyPath)));
+  if (it == keys_.end()) return BackendStatus::NotFound;
+  for (const std::string& name : it->second.valueNames) {
+    if (!it->second.binary.count(LowerAscii(name))) continue;
+    values->push_back({ name, it->second.values.at(LowerAscii(name)) });
+  }
+  return BackendStatus::Ok;
+}
+
+bool ReadFakeFileSystem(const Napi::Value& value, FakeFileSystem* fileSystem, std::string* error) {
+  if (value.IsUndefined() || value.IsNull()) return true;
+  if (!value.IsObject()) {
+    *error = "filesystem fixture must be an object";
+    return false;
+  }
+  Napi::Object fixture = value.As<Napi::Object>();
+
+  Napi::Value directories = fixture.Get("directories");
+  if (directories.IsArray()) {
+    Napi::Array array = directories.As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value path = array.Get(i);
+      if (path.IsString()) fileSystem->AddDirectory(path.As<Napi::String>().Utf8Value());
+    }
+  }
+
+  Napi::Value files = fixture.Get("files");
+  if (files.IsArray()) {
+    Napi::Array array = files.As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value entry = array.Get(i);
+      if (!entry.IsObject() || !entry.As<Napi::Object>().Get("path").IsString()) {
+        *error = "files[" + std::to_string(i) + "] needs a path";
+        return false;
+      }
+      Napi::Object file = entry.As<Napi::Object>();
+      std::string path = file.Get("path").As<Napi::String>().Utf8Value();
+      Napi::Value mtime = file.Get("mtimeMs");
+      int64_t mtimeMs = mtime.IsNumber() ? mtime.As<Napi::Number>().Int64Value() : 0;
+      Napi::Value contents = file.Get("contents");
+      Napi::Value size = file.Get("size");
+      if (contents.IsString()) {
+        fileSystem->AddFile(path, contents.As<Napi::String>().Utf8Value(), mtimeMs);
+      } else if (contents.IsBuffer()) {
+        Napi::Buffer<char> bytes = contents.As<Napi::Buffer<char>>();
+        fileSystem->AddFile(path, std::string(bytes.Data(), bytes.Length()), mtimeMs);
+      } else {
+        fileSystem->AddFileEntry(path, size.IsNumber() ? size.As<Napi::Number>().Int64Value() : 0, mtimeMs);
+      }
+    }
+  }
+
+  Napi::Value links = fixture.Get("links");
+  if (links.IsArray()) {
+    Napi::Array array = links.As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value entry = array.Get(i);
+      if (!entry.IsObject() || !entry.As<Napi::Object>().Get("path").IsString() ||
+          !entry.As<Napi::Object>().Get("target").IsString()) {
+        *error = "links[" + std::to_string(i) + "] needs a path and a target";
+        return false;
+      }
+      Napi::Object link = entry.As<Napi::Object>();
+      Napi::Value kind = link.Get("kind");
+      LinkKind linkKind = LinkKind::Junction;
+      if (kind.IsString() && kind.As<Napi::String>().Utf8Value() == LinkKindName(LinkKind::Symlink)) {
+        linkKind = LinkKind::Symlink;
+      }
+      fileSystem->AddLink(link.Get("path").As<Napi::String>().Utf8Value(),
+                          link.Get("target").As<Napi::String>().Utf8Value(), linkKind);
+    }
+  }
+  return true;
+}
+
+bool ReadFakeRegistry(const Napi::Value& value, FakeRegistry* registry, std::string* error) {
+  if (value.IsUndefined() || value.IsNull()) return true;
+  if (!value.IsArray()) {
+    *error = "registry fixture must be an array";
+    return false;
+  }
+
+  Napi::Array keys = value.As<Napi::Array>();
+  for (uint32_t i = 0; i < keys.Length(); i++) {
+    Napi::Value entry = keys.Get(i);
+    if (!entry.IsObject() || !entry.As<Napi::Object>().Get("key").IsString()) {
+      *error = "registry[" + std::to_string(i) + "] needs a key";
+      return false;
+    }
+    Napi::Object object = entry.As<Napi::Object>();
+
+    RegistryRoot root = RegistryRoot::LocalMachine;
+    if (!ReadRoot(object.Get("root"), &root)) {
+      *error = "registry[" + std::to_string(i) + "] has an unknown root";
+      return false;
+    }
+    std::string keyPath = object.Get("key").As<Napi::String>().Utf8Value();
+    registry->AddKey(root, keyPath);
+
+    Napi::Value values = object.Get("values");
+    if (values.IsObject()) {
+      Napi::Object valueMap = values.As<Napi::Object>();
+      Napi::Array names = valueMap.GetPropertyNames();
+      for (uint32_t j = 0; j < names.Length(); j++) {
+        std::string name = names.Get(j).As<Napi::String>().Utf8Value();
+        Napi::Value data = valueMap.Get(name);
+        if (data.IsString()) {
+          registry->SetString(root, keyPath, name, data.As<Napi::String>().Utf8Value());
+        } else if (data.IsBuffer()) {
+          Napi::Buffer<char> bytes = data.As<Napi::Buffer<char>>();
+          registry->SetBinary(root, keyPath, name, std::string(bytes.Data(), bytes.Length()));
+        }
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,109 @@
+#ifndef FAKE_DISCOVERY_BACKEND_H
+#define FAKE_DISCOVERY_BACKEND_H
+
+#include <napi.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "discovery-backend.h"
+#include "fault-injection.h"
+
+// In-memory filesystem with Windows path semantics (case-insensitive, "\"
+// or "/" separators). Every call first passes through the fault injector, if
+// one is set, keyed by the path. Thread-safe.
+class FakeFileSystem : public FileSystemBackend {
+ public:
+  explicit FakeFileSystem(FaultInjector* faults = nullptr) : faults_(faults) {}
+
+  // Parent directories are created as needed
+  void AddDirectory(const std::string& path, int64_t mtimeMs = 0);
+  void AddFile(const std::string& path, const std::string& contents, int64_t mtimeMs = 0);
+  // Metadata-only file for large synthetic trees
+  void AddFileEntry(const std::string& path, uint64_t size, int64_t mtimeMs = 0);
+  // Directory link to target, which need not exist. Links are followed
+  // anywhere in a path, except that Stat describes a final link itself.
+  void AddLink(const std::string& path, const std::string& target, LinkKind kind = LinkKind::Junction);
+
+  BackendStatus ListDirectory(const std::string& path, std::vector<DirEntry>* entries) override;
+  BackendStatus Stat(const std::string& path, DirEntry* entry) override;
+  BackendStatus ReadFile(const std::string& path, size_t maxBytes, std::string* contents) override;
+  BackendStatus ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                           std::string* contents) override;
+  BackendStatus Identify(const std::string& path, FileIdentity* identity) override;
+
+ private:
+  struct Node {
+    DirEntry entry;
+    std::string contents;
+    std::vector<std::string> children;  // Keys, in insertion order
+    std::string target;                 // Key a link points to
+    uint64_t id = 0;
+  };
+
+  // Caller holds mutex_
+  Node& Ensure(const std::string& path, bool isDirectory, int64_t mtimeMs);
+  // Caller holds mutex_. Key of the node path names once links are
+  // followed; false when they loop.
+  bool Resolve(const std::string& path, bool followLast, std::string* key);
+  BackendStatus Fault(const std::string& path);
+
+  FaultInjector* faults_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, Node> nodes_;
+  uint64_t nextId_ = 1;
+  size_t linkCount_ = 0;
+};
+
+// In-memory registry of keys and string values, fault-injected by
+// "HKLM\<key path>" style keys. Thread-safe.
+class FakeRegistry : public RegistryBackend {
+ public:
+  explicit FakeRegistry(FaultInjector* faults = nullptr) : faults_(faults) {}
+
+  // Ancestor keys are created as needed
+  void AddKey(RegistryRoot root, const std::string& keyPath);
+  void SetString(RegistryRoot root, const std::string& keyPath, const std::string& valueName,
+                 const std::string& data);
+  void SetBinary(RegistryRoot root, const std::string& keyPath, const std::string& valueName,
+                 const std::string& data);
+
+  BackendStatus EnumerateSubKeys(RegistryRoot root, const std::string& keyPath,
+                                 std::vector<std::string>* names) override;
+  BackendStatus ReadString(RegistryRoot root, const std::string& keyPath,
+                           const std::string& valueName, std::string* data) override;
+  BackendStatus ReadValues(RegistryRoot root, const std::string& keyPath,
+                           std::vector<RegistryValue>* values) override;
+  BackendStatus ReadBinaryValues(RegistryRoot root, const std::string& keyPath,
+                                 std::vector<RegistryValue>* values) override;
+
+ private:
+  struct Key {
+    std::vector<std::string> subKeys;  // Display names, in insertion order
+    std::vector<std::string> valueNames;  // Display names, in insertion order
+    std::unordered_map<std::string, std::string> values;  // Lowercased name -> data
+    std::unordered_set<std::string> binary;  // Lowercased names of REG_BINARY values
+  };
+
+  // Caller holds mutex_
+  Key& Ensure(RegistryRoot root, const std::string& keyPath);
+  void SetValue(RegistryRoot root, const std::string& keyPath, const std::string& valueName,
+                const std::string& data, bool binary);
+  BackendStatus Fault(RegistryRoot root, const std::string& keyPath);
+
+  FaultInjector* faults_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, Key> keys_;
+};
+
+// Populate fakes from JS fixtures:
+//   filesystem: { directories?: [path], files?: [{ path, contents?: string | Buffer, size?, mtimeMs? }],
+//                 links?: [{ path, target, kind?: "junction" | "symlink" }] }
+//   registry:   [{ root?: "HKLM" | "HKCU" | "HKCR", key, values?: { name: data } }], where
+//               Buffer data is a REG_BINARY value
+bool ReadFakeFileSystem(const Napi::Value& value, FakeFileSystem* fileSystem, std::string* error);
+bool ReadFakeRegistry(const Napi::Value& value, FakeRegistry* registry, std::string* error);
+
+#endif
@@ -0,0 +1,185 @@
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "fault-injection.h"
+
+namespace {
+
+// z-score of the 99th percentile of a standard normal distribution
+constexpr double kZ99 = 2.3263478740;
+
+void SleepMs(double ms) {
+  if (ms > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds((int64_t)(ms * 1000)));
+  }
+}
+
+double ReadNumber(const Napi::Object& object, const char* name, double fallback) {
+  Napi::Value value = object.Get(name);
+  return value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : fallback;
+}
+
+bool ReadStatus(const std::string& name, BackendStatus* status) {
+  const BackendStatus statuses[] = {
+    BackendStatus::NotFound, BackendStatus::AccessDenied,
+    BackendStatus::IoError, BackendStatus::Timeout
+  };
+  for (BackendStatus candidate : statuses) {
+    if (name == BackendStatusName(candidate)) {
+      *status = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadLatency(const Napi::Object& object, LatencyDistribution* latency, std::string* error) {
+  Napi::Value distribution = object.Get("distribution");
+  std::string kind = distribution.IsString() ? distribution.As<Napi::String>().Utf8Value() : "fixed";
+
+  if (kind == "fixed") {
+    latency->kind = LatencyKind::Fixed;
+    latency->fixedMs = ReadNumber(object, "ms", 0);
+  } else if (kind == "uniform") {
+    latency->kind = LatencyKind::Uniform;
+    latency->minMs = ReadNumber(object, "minMs", 0);
+    latency->maxMs = ReadNumber(object, "maxMs", latency->minMs);
+    // uniform_real_distribution needs finite bounds with min <= max
+    if (!(latency->minMs >= 0 && latency->minMs <= latency->maxMs) || !std::isfinite(latency->maxMs)) {
+      *error = "uniform latency needs finite 0 <= minMs <= maxMs";
+      return false;
+    }
+  } else if (kind == "lognormal") {
+    latency->kind = LatencyKind::LogNormal;
+    latency->medianMs = ReadNumber(object, "medianMs", 1);
+    latency->p99Ms = ReadNumber(object, "p99Ms", latency->medianMs);
+    if (latency->medianMs <= 0 || latency->p99Ms < latency->medianMs) {
+      *error = "lognormal latency needs 0 < medianMs <= p99Ms";
+      return false;
+    }
+  } else {
+    *error = "Unknown latency distribution: " + kind;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void FaultInjector::AddRule(FaultRule rule) {
+  rule.prefix = LowerAscii(rule.prefix);
+  rules_.push_back(std::move(rule));
+}
+
+const FaultRule* FaultInjector::Match(const std::string& key) const {
+  std::string lowerKey = LowerAscii(key);
+  const FaultRule* best = nullptr;
+  for (const FaultRule& rule : rules_) {
+    if (lowerKey.compare(0, rule.prefix.size(), rule.prefix) == 0 &&
+        (!best || rule.prefix.size() > best->prefix.size())) {
+      best = &rule;
+    }
+  }
+  return best;
+}
+
+double FaultInjector::SampleLatencyMs(const LatencyDistribution& latency) {
+  switch (latency.kind) {
+    case LatencyKind::None:
+      return 0;
+    case LatencyKind::Fixed:
+      return latency.fixedMs;
+    case LatencyKind::Uniform:
+      return std::uniform_real_distribution<double>(latency.minMs, latency.maxMs)(random_);
+    case LatencyKind::LogNormal: {
+      double mu = std::log(latency.medianMs);
+      double sigma = (std::log(latency.p99Ms) - mu) / kZ99;
+      return std::lognormal_distribution<double>(mu, sigma)(random_);
+    }
+  }
+  return 0;
+}
+
+BackendStatus FaultInjector::Inject(const std::string& key) {
+  const FaultRule* rule = Match(key);
+  if (!rule) return BackendStatus::Ok;
+
+  double latencyMs;
+  bool hang;
+  bool fail;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencyMs = SampleLatencyMs(rule->latency);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    hang = rule->hangRate > 0 && unit(random_) < rule->hangRate;
+    fail = rule->errorRate > 0 && unit(random_) < rule->errorRate;
+
+    stats_.calls++;
+    if (hang) {
+      stats_.hangs++;
+    } else {
+      stats_.delayMs += latencyMs;
+      if (fail) stats_.errors++;
+    }
+  }
+
+  if (hang) {
+    SleepMs(rule->hangMs);
+    return BackendStatus::Timeout;
+  }
+  SleepMs(latencyMs);
+  return fail ? rule->error : BackendStatus::Ok;
+}
+
+FaultInjector::Stats FaultInjector::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+Napi::Object FaultStatsToObject(Napi::Env env, const FaultInjector::Stats& stats) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("calls", Napi::Number::New(env, (double)stats.calls));
+  result.Set("errors", Napi::Number::New(env, (double)stats.errors));
+  result.Set("hangs", Napi::Number::New(env, (double)stats.hangs));
+  result.Set("delayMs", Napi::Number::New(env, stats.delayMs));
+  return result;
+}
+
+bool ReadFaultRules(const Napi::Value& value, FaultInjector* injector, std::string* error) {
+  if (value.IsUndefined() || value.IsNull()) return true;
+  if (!value.IsArray()) {
+    *error = "faults must be an array";
+    return false;
+  }
+
+  Napi::Array rules = value.As<Napi::Array>();
+  for (uint32_t i = 0; i < rules.Length(); i++) {
+    Napi::Value entry = rules.Get(i);
+    if (!entry.IsObject()) {
+      *error = "faults[" + std::to_string(i) + "] must be an object";
+      return false;
+    }
+    Napi::Object object = entry.As<Napi::Object>();
+
+    FaultRule rule;
+    Napi::Value match = object.Get("match");
+    rule.prefix = match.IsString() ? match.As<Napi::String>().Utf8Value() : "";
+
+    Napi::Value latency = object.Get("latency");
+    if (latency.IsObject() && !ReadLatency(latency.As<Napi::Object>(), &rule.latency, error)) {
+      return false;
+    }
+
+    rule.errorRate = ReadNumber(object, "errorRate", 0);
+    Napi::Value status = object.Get("error");
+    if (status.IsString() && !ReadStatus(status.As<Napi::String>().Utf8Value(), &rule.error)) {
+      *error = "Unknown fault error: " + status.As<Napi::String>().Utf8Value();
+      return false;
+    }
+    rule.hangRate = ReadNumber(object, "hangRate", 0);
+    rule.hangMs = (uint32_t)ReadNumber(object, "hangMs", rule.hangMs);
+
+    injector->AddRule(std::move(rule));
+  }
+  return true;
+}
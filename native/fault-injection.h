@@ -0,0 +1,77 @@
+#ifndef FAULT_INJECTION_H
+#define FAULT_INJECTION_H
+
+#include <napi.h>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "discovery-backend.h"
+
+// Latency, error and hang injection for the fake discovery backends and the
+// simulated window system. Rules are keyed by path prefix (filesystem paths,
+// "HKLM\..." registry keys, "window:<op>" window calls); the longest
+// matching prefix wins, compared case-insensitively.
+
+enum class LatencyKind {
+  None,
+  Fixed,      // fixedMs
+  Uniform,    // minMs..maxMs
+  LogNormal   // medianMs with a p99Ms tail
+};
+
+struct LatencyDistribution {
+  LatencyKind kind = LatencyKind::None;
+  double fixedMs = 0;
+  double minMs = 0;
+  double maxMs = 0;
+  double medianMs = 0;
+  double p99Ms = 0;
+};
+
+struct FaultRule {
+  std::string prefix;
+  LatencyDistribution latency;
+  double errorRate = 0;                           // 0..1
+  BackendStatus error = BackendStatus::AccessDenied;
+  double hangRate = 0;                            // 0..1
+  uint32_t hangMs = 5000;                         // A hang stalls this long, then times out
+};
+
+// Thread-safe. Inject sleeps for the sampled latency (outside any lock) and
+// returns the status the faked call should fail with, or Ok.
+class FaultInjector {
+ public:
+  struct Stats {
+    uint64_t calls = 0;     // Calls that matched a rule
+    uint64_t errors = 0;
+    uint64_t hangs = 0;
+    double delayMs = 0;     // Total injected latency, excluding hangs
+  };
+
+  explicit FaultInjector(uint32_t seed = 1) : random_(seed) {}
+
+  // Rules are added before the injector is shared with other threads
+  void AddRule(FaultRule rule);
+  bool Empty() const { return rules_.empty(); }
+  BackendStatus Inject(const std::string& key);
+  Stats GetStats();
+
+ private:
+  const FaultRule* Match(const std::string& key) const;
+  double SampleLatencyMs(const LatencyDistribution& latency);
+
+  std::vector<FaultRule> rules_;
+  std::mutex mutex_;
+  std::mt19937 random_;
+  Stats stats_;
+};
+
+Napi::Object FaultStatsToObject(Napi::Env env, const FaultInjector::Stats& stats);
+
+// Parse [{ match, latency: { distribution, ms | minMs, maxMs | medianMs, p99Ms },
+//          errorRate, error, hangRate, hangMs }] into injector rules
+bool ReadFaultRules(const Napi::Value& value, FaultInjector* injector, std::string* error);
+
+#endif
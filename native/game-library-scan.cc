@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include "fake-discovery-backend.h"
+#include "fault-injection.h"
+#include "game-library-scan.h"
+#include "helper-executables.h"
+#include "json-reader.h"
+#include "stat-cache.h"
+
+namespace {
+
+// Manifests are a few KB; libraryfolders.vdf grows with installed apps
+constexpr size_t kMaxManifestBytes = 4 * 1024 * 1024;
+constexpr int kMaxVdfDepth = 32;
+
+const char kSteamUserKey[] = "Software\\Valve\\Steam";
+const char kSteamMachineKeys[][40] = {
+  "SOFTWARE\\WOW6432Node\\Valve\\Steam",
+  "SOFTWARE\\Valve\\Steam"
+};
+const char kGogGameKeys[][40] = {
+  "SOFTWARE\\WOW6432Node\\GOG.com\\Games",
+  "SOFTWARE\\GOG.com\\Games"
+};
+
+// Steam's runtimes and redistributables have app manifests but are not games
+const char* const kSteamToolPrefixes[] = {
+  "proton ", "steam linux runtime", "steamworks common", "steamvr"
+};
+
+// Folder names under which engines commonly put the real game exe
+const char* const kBinaryFolders[] = {
+  "bin", "bin32", "bin64", "binaries", "win32", "win64", "x64", "x86", "game", "retail", "release"
+};
+constexpr uint32_t kMaxExeDepth = 2;
+
+class VdfParser {
+ public:
+  explicit VdfParser(const std::string& text) : text_(text) {
+    if (text_.compare(0, 3, "\xEF\xBB\xBF") == 0) pos_ = 3;
+  }
+
+  bool Parse(VdfNode* root, std::string* error) {
+    bool ok = ParseChildren(root, 0);
+    if (ok && pos_ < text_.size()) ok = Fail("unexpected '}'");
+    if (!ok) *error = error_ + " at offset " + std::to_string(pos_);
+    return ok;
+  }
+
+ private:
+  enum class Token { End, Open, Close, String };
+
+  bool Fail(const char* message) {
+    if (error_.empty()) error_ = message;
+    return false;
+  }
+
+  void SkipSpaceAndComments() {
+    while (pos_ < text_.size()) {
+      char c = text_[pos_];
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+        pos_++;
+      } else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/') {
+        while (pos_ < text_.size() && text_[pos_] != '\n') pos_++;
+      } else if (c == '[') {
+        // Platform conditionals like [$WIN32] apply to the preceding pair; ignored
+        while (pos_ < text_.size() && text_[pos_] != ']') pos_++;
+        if (pos_ < text_.size()) pos_++;
+      } else {
+        break;
+      }
+    }
+  }
+
+  Token Next(std::string* text) {
+    SkipSpaceAndComments();
+    if (pos_ >= text_.size()) return Token::End;
+    char c = text_[pos_];
+    if (c == '{') {
+      pos_++;
+      return Token::Open;
+    }
+    if (c == '}') {
+      pos_++;
+      return Token::Close;
+    }
+    text->clear();
+    if (c == '"') {
+      pos_++;
+      while (pos_ < text_.size() && text_[pos_] != '"') {
+        char next = text_[pos_++];
+        if (next == '\\' && pos_ < text_.size()) {
+          char escape = text_[pos_++];
+          next = escape == 'n' ? '\n' : escape == 't' ? '\t' : escape;
+        }
+        *text += next;
+      }
+      if (pos_ >= text_.size()) {
+        Fail("unterminated string");
+        return Token::End;
+      }
+      pos_++;
+      return Token::String;
+    }
+    while (pos_ < text_.size() && !isspace((unsigned char)text_[pos_]) &&
+           text_[pos_] != '{' && text_[pos_] != '}' && text_[pos_] != '"') {
+      *text += text_[pos_++];
+    }
+    return Token::String;
+  }
+
+  // Pairs until the matching '}' (consumed) or, at the top level, the end
+  bool ParseChildren(VdfNode* node, int depth) {
+    if (depth > kMaxVdfDepth) return Fail("nesting too deep");
+    while (true) {
+      std::string key;
+      Token token = Next(&key);
+      if (!error_.empty()) return false;
+      if (token == Token::End) return depth == 0 || Fail("unexpected end of input");
+      if (token == Token::Close) return depth > 0 || Fail("unexpected '}'");
+      if (token == Token::Open) return Fail("expected key");
+
+      std::pair<std::string, VdfNode> child;
+      child.first = std::move(key);
+      token = Next(&child.second.value);
+      if (token == Token::Open) {
+        if (!ParseChildren(&child.second, depth + 1)) return false;
+      } else if (token != Token::String) {
+        return Fail("expected value");
+      }
+      node->children.push_back(std::move(child));
+    }
+  }
+
+  const std::string& text_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+// Stores write paths with "/" and doubled or trailing separators
+std::string NormalizePath(std::string path) {
+  for (char& c : path) {
+    if (c == '/') c = '\\';
+  }
+  while (path.size() > 3 && path.back() == '\\') path.pop_back();
+  return path;
+}
+
+std::string StemOf(const std::string& fileName) {
+  size_t dot = fileName.find_last_of('.');
+  return dot != std::string::npos ? fileName.substr(0, dot) : fileName;
+}
+
+// Lowercase letters and digits only, so "Hollow Knight" matches hollow_knight.exe
+std::string Squash(const std::string& text) {
+  std::string squashed;
+  for (unsigned char c : LowerAscii(text)) {
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) squashed += (char)c;
+  }
+  return squashed;
+}
+
+bool IsBinaryFolder(const std::string& name) {
+  std::string lower = LowerAscii(name);
+  for (const char* folder : kBinaryFolders) {
+    if (lower == folder) return true;
+  }
+  return false;
+}
+
+// Best exe for a game under installDir: a name matching the folder or title
+// wins, shallower beats deeper, then larger beats smaller. Only the top level
+// and engine binary folders are listed, never the content tree.
+std::string PickGameExe(FileSystemBackend& fileSystem, const std::string& installDir,
+                        const std::vector<std::string>& hints) {
+  std::vector<std::string> squashedHints;
+  for (const std::string& hint : hints) {
+    if (!Squash(hint).empty()) squashedHints.push_back(Squash(hint));
+  }
+
+  std::string best;
+  uint64_t bestScore = 0;
+  std::vector<std::pair<std::string, uint32_t>> pending = { { installDir, 0 } };
+  for (size_t i = 0; i < pending.size(); i++) {
+    auto [dir, depth] = pending[i];
+    std::vector<DirEntry> entries;
+    if (fileSystem.ListDirectory(dir, &entries) != BackendStatus::Ok) continue;
+
+    for (const DirEntry& entry : entries) {
+      if (entry.isDirectory) {
+        if (depth < kMaxExeDepth && !entry.isReparsePoint && IsBinaryFolder(entry.name)) {
+          pending.push_back({ JoinPath(dir, entry.name), depth + 1 });
+        }
+        continue;
+      }
+      if (!EndsWithNoCase(entry.name, ".exe") || IsHelperExecutable(entry.name) ||
+          LooksLikeInstaller(entry.name)) {
+        continue;
+      }
+
+      std::string stem = Squash(StemOf(entry.name));
+      uint64_t match = 0;
+      for (const std::string& hint : squashedHints) {
+        if (stem == hint) match = 2;
+        else if (match == 0 && !stem.empty() && (hint.find(stem) != std::string::npos || stem.find(hint) != std::string::npos)) match = 1;
+      }
+      // Size in KB caps at 2^40 so the ranks above it never overflow
+      uint64_t score = (match << 62) | ((uint64_t)(kMaxExeDepth - depth) << 60) |
+                       std::min<uint64_t>(entry.size >> 10, (1ULL << 40) - 1);
+      if (best.empty() || score > bestScore) {
+        best = JoinPath(dir, entry.name);
+        bestScore = score;
+      }
+    }
+  }
+  return best;
+}
+
+bool IsSteamTool(const std::string& appId, const std::string& name) {
+  if (appId == "228980") return true;  // Steamworks Common Redistributables
+  std::string lower = LowerAscii(name);
+  for (const char* prefix : kSteamToolPrefixes) {
+    if (lower.compare(0, strlen(prefix), prefix) == 0) return true;
+  }
+  return false;
+}
+
+bool ReadVdfFile(FileSystemBackend& fileSystem, const std::string& path, VdfNode* root) {
+  std::string contents;
+  std::string error;
+  return fileSystem.ReadFile(path, kMaxManifestBytes, &contents) == BackendStatus::Ok &&
+         ParseVdf(contents, root, &error);
+}
+
+// Library folders from libraryfolders.vdf: "N" { "path" "..." } today,
+// "N" "path" in the pre-2021 format
+void ReadSteamLibraries(FileSystemBackend& fileSystem, const std::string& steamRoot,
+                        std::vector<std::string>* libraries) {
+  libraries->push_back(steamRoot);
+  VdfNode root;
+  if (!ReadVdfFile(fileSystem, JoinPath(steamRoot, "steamapps\\libraryfolders.vdf"), &root)) return;
+  const VdfNode* folders = root.Find("libraryfolders");
+  if (!folders) return;
+  for (const auto& child : folders->children) {
+    if (child.first.empty() || !isdigit((unsigned char)child.first[0])) continue;
+    std::string path = child.second.children.empty() ? child.second.value : child.second.GetString("path");
+    if (!path.empty()) libraries->push_back(NormalizePath(path));
+  }
+}
+
+}  // namespace
+
+const VdfNode* VdfNode::Find(const std::string& key) const {
+  std::string lowerKey = LowerAscii(key);
+  for (const auto& child : children) {
+    if (LowerAscii(child.first) == lowerKey) return &child.second;
+  }
+  return nullptr;
+}
+
+std::string VdfNode::GetString(const std::string& key) const {
+  const VdfNode* child = Find(key);
+  return child && child->children.empty() ? child->value : "";
+}
+
+bool ParseVdf(const std::string& text, VdfNode* root, std::string* error) {
+  *root = VdfNode();
+  return VdfParser(text).Parse(root, error);
+}
+
+void GameLibraryCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  manifests_.clear();
+}
+
+size_t GameLibraryCache::ManifestCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return manifests_.size();
+}
+
+void ScanGameLibraries(FileSystemBackend& fileSystem, RegistryBackend& registry,
+                       const GameLibraryRoots& roots, GameLibraryCache* cache,
+                       std::vector<DiscoveredApp>* apps) {
+  std::lock_guard<std::mutex> lock(cache->mutex_);
+  uint64_t generation = ++cache->generation_;
+  std::unordered_set<std::string> seenPaths;
+  auto addApps = [&](const std::vector<DiscoveredApp>& found) {
+    for (const DiscoveredApp& app : found) {
+      if (seenPaths.insert(LowerAscii(app.path)).second) apps->push_back(app);
+    }
+  };
+
+  // Manifests whose listing mtime and size match the cache are not reread
+  auto scanManifests = [&](const std::string& dir, const char* prefix, const char* suffix,
+                           auto resolve) {
+    std::vector<DirEntry> entries;
+    if (fileSystem.ListDirectory(dir, &entries) != BackendStatus::Ok) return;
+    for (const DirEntry& entry : entries) {
+      if (entry.isDirectory || LowerAscii(entry.name).compare(0, strlen(prefix), prefix) != 0 ||
+          !EndsWithNoCase(entry.name, suffix)) {
+        continue;
+      }
+      std::string path = JoinPath(dir, entry.name);
+      GameLibraryCache::CachedManifest& cached = cache->manifests_[LowerAscii(path)];
+      if (cached.generation == 0 || cached.mtimeMs != entry.mtimeMs || cached.size != entry.size ||
+          entry.mtimeMs == 0) {
+        cached.apps.clear();
+        std::string contents;
+        if (fileSystem.ReadFile(path, kMaxManifestBytes, &contents) != BackendStatus::Ok) {
+          // Unreadable (locked mid-update, say): no entry, so the next scan retries
+          cache->manifests_.erase(LowerAscii(path));
+          continue;
+        }
+        resolve(contents, &cached.apps);
+        cached.mtimeMs = entry.mtimeMs;
+        cached.size = entry.size;
+      }
+      cached.generation = generation;
+      addApps(cached.apps);
+    }
+  };
+
+  // Steam
+  std::vector<std::string> steamRoots = roots.steam;
+  if (roots.steamFromRegistry) {
+    std::vector<RegistryValue> values;
+    if (registry.ReadValues(RegistryRoot::CurrentUser, kSteamUserKey, &values) == BackendStatus::Ok) {
+      steamRoots.push_back(FindRegistryValue(values, "SteamPath"));
+    }
+    for (const char* key : kSteamMachineKeys) {
+      values.clear();
+      if (registry.ReadValues(RegistryRoot::LocalMachine, key, &values) == BackendStatus::Ok) {
+        steamRoots.push_back(FindRegistryValue(values, "InstallPath"));
+      }
+    }
+  }
+  std::vector<std::string> libraries;
+  std::unordered_set<std::string> seenRoots;
+  for (const std::string& steamRoot : steamRoots) {
+    if (steamRoot.empty() || !seenRoots.insert(LowerAscii(NormalizePath(steamRoot))).second) continue;
+    ReadSteamLibraries(fileSystem, NormalizePath(steamRoot), &libraries);
+  }
+  std::unordered_set<std::string> seenLibraries;
+  for (const std::string& library : libraries) {
+    if (!seenLibraries.insert(LowerAscii(library)).second) continue;
+    std::string steamapps = JoinPath(library, "steamapps");
+    scanManifests(steamapps, "appmanifest_", ".acf", [&](const std::string& contents, std::vector<DiscoveredApp>* found) {
+      VdfNode root;
+      std::string error;
+      if (!ParseVdf(contents, &root, &error)) return;
+      const VdfNode* state = root.Find("AppState");
+      if (!state) return;
+      std::string appId = state->GetString("appid");
+      std::string name = state->GetString("name");
+      std::string installDir = state->GetString("installdir");
+      // StateFlags 4 is "fully installed"; updating games keep the bit
+      uint32_t flags = (uint32_t)strtoul(state->GetString("StateFlags").c_str(), nullptr, 10);
+      if (appId.empty() || installDir.empty() || (flags & 4) == 0 || IsSteamTool(appId, name)) return;
+
+      std::string gameDir = JoinPath(JoinPath(steamapps, "common"), installDir);
+      std::string exePath = PickGameExe(fileSystem, gameDir, { installDir, name });
+      if (!exePath.empty()) found->push_back({ "steam_" + appId, name.empty() ? installDir : name, exePath, "" });
+    });
+  }
+
+  // Epic
+  for (const std::string& manifestDir : roots.epicManifests) {
+    scanManifests(manifestDir, "", ".item", [&](const std::string& contents, std::vector<DiscoveredApp>* found) {
+      JsonValue manifest;
+      std::string error;
+      if (!ParseJson(contents, &manifest, &error) || !manifest.IsObject()) return;
+      const JsonValue* incomplete = manifest.Find("bIsIncompleteInstall");
+      if (incomplete && incomplete->type == JsonType::Bool && incomplete->boolean) return;
+      // DLC manifests point at their base game
+      std::string appName = manifest.GetString("AppName");
+      std::string mainApp = manifest.GetString("MainGameAppName");
+      if (!mainApp.empty() && mainApp != appName) return;
+
+      std::string installLocation = manifest.GetString("InstallLocation");
+      std::string launch = manifest.GetString("LaunchExecutable");
+      if (installLocation.empty() || launch.empty()) return;
+      std::string exePath = JoinPath(NormalizePath(installLocation), NormalizePath(launch));
+      if (!fileSystem.Exists(exePath)) return;
+      std::string name = manifest.GetString("DisplayName", appName);
+      found->push_back({ "epic_" + appName, name.empty() ? StemOf(FileNameOf(exePath)) : name, exePath, "" });
+    });
+  }
+
+  // GOG keeps no manifest files; its registry entries already name the exe
+  if (roots.gog) {
+    std::vector<DiscoveredApp> gogApps;
+    for (const char* key : kGogGameKeys) {
+      std::vector<std::string> gameIds;
+      if (registry.EnumerateSubKeys(RegistryRoot::LocalMachine, key, &gameIds) != BackendStatus::Ok) continue;
+      for (const std::string& gameId : gameIds) {
+        std::vector<RegistryValue> values;
+        if (registry.ReadValues(RegistryRoot::LocalMachine, std::string(key) + "\\" + gameId, &values) != BackendStatus::Ok) {
+          continue;
+        }
+        std::string exePath = FindRegistryValue(values, "exe");
+        std::string exeFile = FindRegistryValue(values, "exeFile");
+        std::string gamePath = FindRegistryValue(values, "path");
+        if (exePath.empty() && !exeFile.empty() && !gamePath.empty()) exePath = JoinPath(gamePath, exeFile);
+        if (exePath.empty() || !fileSystem.Exists(exePath)) continue;
+        std::string name = FindRegistryValue(values, "gameName");
+        gogApps.push_back({ "gog_" + gameId, name.empty() ? StemOf(FileNameOf(exePath)) : name, exePath, "" });
+      }
+    }
+    addApps(gogApps);
+  }
+
+  // Manifests not listed this time were uninstalled or are on a drive that
+  // is gone; either way their games are no longer launchable
+  for (auto it = cache->manifests_.begin(); it != cache->manifests_.end();) {
+    if (it->second.generation != generation) {
+      it = cache->manifests_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+GameLibraryCache& SharedGameLibraryCache() {
+  static GameLibraryCache* cache = new GameLibraryCache();
+  return *cache;
+}
+
+namespace {
+
+bool ReadRootList(const Napi::Value& value, std::vector<std::string>* roots) {
+  if (value.IsUndefined()) return true;
+  if (!value.IsArray()) return false;
+  Napi::Array array = value.As<Napi::Array>();
+  roots->clear();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value root = array.Get(i);
+    if (!root.IsString()) return false;
+    roots->push_back(root.As<Napi::String>().Utf8Value());
+  }
+  return true;
+}
+
+bool ReadFlag(const Napi::Value& value, bool* flag) {
+  if (value.IsUndefined()) return true;
+  if (!value.IsBoolean()) return false;
+  *flag = value.As<Napi::Boolean>().Value();
+  return true;
+}
+
+}  // namespace
+
+// ScanGameLibraryApps: Find Steam, Epic and GOG games from their manifests
+// and registry entries. With filesystem/registry fixtures the scan runs
+// against fake backends with a fresh cache, which works on any platform;
+// faults (see fault-injection.h) make fixture reads fail or stall.
+Napi::Value ScanGameLibraryApps(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* usage = "Expected (options?: { roots?: { steam?: string[], steamFromRegistry?: boolean, epicManifests?: string[], gog?: boolean }, filesystem?, registry?, faults? })";
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  Napi::Value filesystem = options.Get("filesystem");
+  Napi::Value registry = options.Get("registry");
+  bool useFixtures = !filesystem.IsUndefined() || !registry.IsUndefined();
+
+  GameLibraryRoots roots;
+#ifdef _WIN32
+  if (!useFixtures) roots = DefaultGameLibraryRoots();
+#endif
+  Napi::Value rootOptions = options.Get("roots");
+  if (rootOptions.IsObject()) {
+    Napi::Object object = rootOptions.As<Napi::Object>();
+    if (!ReadRootList(object.Get("steam"), &roots.steam) ||
+        !ReadFlag(object.Get("steamFromRegistry"), &roots.steamFromRegistry) ||
+        !ReadRootList(object.Get("epicManifests"), &roots.epicManifests) ||
+        !ReadFlag(object.Get("gog"), &roots.gog)) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  std::vector<DiscoveredApp> apps;
+
+  if (useFixtures) {
+    FaultInjector faults;
+    FakeFileSystem fakeFileSystem(&faults);
+    FakeRegistry fakeRegistry(&faults);
+    GameLibraryCache cache;
+    std::string error;
+    if (!ReadFaultRules(options.Get("faults"), &faults, &error) ||
+        !ReadFakeFileSystem(filesystem, &fakeFileSystem, &error) ||
+        !ReadFakeRegistry(registry, &fakeRegistry, &error)) {
+      Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    ScanGameLibraries(fakeFileSystem, fakeRegistry, roots, &cache, &apps);
+  } else {
+#ifdef _WIN32
+    ScanGameLibraries(CachedLiveFileSystem(), LiveRegistry(), roots, &SharedGameLibraryCache(), &apps);
+#else
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("apps", Napi::Array::New(env));
+    result.Set("error", Napi::String::New(env, "Live game library scans need Windows; pass filesystem/registry fixtures"));
+    return result;
+#endif
+  }
+
+  result.Set("success", Napi::Boolean::New(env, true));
+  result.Set("apps", AppsToNapi(env, apps));
+  return result;
+}
@@ -0,0 +1,77 @@
+#ifndef GAME_LIBRARY_SCAN_H
+#define GAME_LIBRARY_SCAN_H
+
+#include <napi.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+
+// Installed games from the stores' own records rather than a walk:
+//   Steam: steamapps\libraryfolders.vdf -> each library's appmanifest_*.acf
+//   Epic:  <ProgramData>\Epic\EpicGamesLauncher\Data\Manifests\*.item (JSON)
+//   GOG:   HKLM\SOFTWARE\WOW6432Node\GOG.com\Games\<id> values
+// Epic and GOG name the exe; Steam only names the install folder, so the
+// exe is picked from that folder's top two levels.
+
+struct GameLibraryRoots {
+  std::vector<std::string> steam;          // Steam install folders
+  bool steamFromRegistry = true;           // Also SteamPath/InstallPath from the registry
+  std::vector<std::string> epicManifests;  // Epic manifest folders
+  bool gog = true;
+};
+
+// Valve KeyValues text (VDF/ACF): nested "key" "value" and "key" { ... }
+// blocks. Keys are matched case-insensitively, as Steam does.
+struct VdfNode {
+  std::string value;
+  std::vector<std::pair<std::string, VdfNode>> children;
+
+  const VdfNode* Find(const std::string& key) const;
+  std::string GetString(const std::string& key) const;
+};
+
+bool ParseVdf(const std::string& text, VdfNode* root, std::string* error);
+
+// Resolved games per manifest, reused while the manifest's mtime and size
+// are unchanged. Thread-safe; scans sharing a cache run one at a time.
+class GameLibraryCache {
+ public:
+  void Clear();
+  size_t ManifestCount();
+
+ private:
+  friend void ScanGameLibraries(FileSystemBackend&, RegistryBackend&, const GameLibraryRoots&,
+                                GameLibraryCache*, std::vector<DiscoveredApp>*);
+
+  struct CachedManifest {
+    int64_t mtimeMs = 0;
+    uint64_t size = 0;
+    uint64_t generation = 0;
+    std::vector<DiscoveredApp> apps;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, CachedManifest> manifests_;  // Lowercased path -> entry
+  uint64_t generation_ = 0;
+};
+
+void ScanGameLibraries(FileSystemBackend& fileSystem, RegistryBackend& registry,
+                       const GameLibraryRoots& roots, GameLibraryCache* cache,
+                       std::vector<DiscoveredApp>* apps);
+
+// Cache shared by scanGameLibraryApps and idle rescans
+GameLibraryCache& SharedGameLibraryCache();
+
+// Default Steam folder and the Epic manifest folder under %ProgramData%
+// (Windows only, app-discovery.cc)
+GameLibraryRoots DefaultGameLibraryRoots();
+
+// Function declarations for game library discovery
+Napi::Value ScanGameLibraryApps(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,78 @@
+#!/usr/bin/env node
+/**
+ * Generate helper-executables.inc from helper-executables.txt.
+ * The C++ side (helper-executables.cc) builds its perfect-hash table from
+ * the generated lists at compile time, so only the data file is edited.
+ *
+ * Usage: node native/gen-helper-executables.js
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const DATA_PATH = path.join(__dirname, 'helper-executables.txt');
+const OUTPUT_PATH = path.join(__dirname, 'helper-executables.inc');
+
+function fail(lineNumber, message) {
+  console.error(`helper-executables.txt:${lineNumber}: ${message}`);
+  process.exit(1);
+}
+
+function cString(text) {
+  return `"${text.replace(/\\/g, '\\\\').replace(/"/g, '\\"')}"`;
+}
+
+function main() {
+  const names = new Set();
+  const prefixes = new Set();
+  const suffixes = new Set();
+
+  fs.readFileSync(DATA_PATH, 'utf8').split(/\r?\n/).forEach((rawLine, index) => {
+    const lineNumber = index + 1;
+    const line = rawLine.trim();
+    if (!line || line.startsWith('#')) return;
+
+    // Lookups lowercase ASCII only, so entries must already be lowercase ASCII
+    if (!/^[\x20-\x7e]+$/.test(line)) fail(lineNumber, 'entries must be printable ASCII');
+    if (line !== line.toLowerCase()) fail(lineNumber, 'entries must be lowercase');
+
+    const stars = (line.match(/\*/g) || []).length;
+    if (stars === 0) {
+      if (names.has(line)) fail(lineNumber, `duplicate entry "${line}"`);
+      names.add(line);
+    } else if (stars === 1 && line.endsWith('*') && line.length > 1) {
+      prefixes.add(line.slice(0, -1));
+    } else if (stars === 1 && line.startsWith('*') && line.length > 1) {
+      suffixes.add(line.slice(1));
+    } else {
+      fail(lineNumber, 'patterns take a single leading or trailing "*"');
+    }
+  });
+
+  const list = (values) => [...values].sort()
+    .map((value) => `  { ${cString(value)}, ${value.length} }, \\`)
+    .join('\n');
+
+  const output = [
+    '// Generated by gen-helper-executables.js from helper-executables.txt.',
+    '// Do not edit; edit the data file and rerun the generator.',
+    '',
+    '#define HELPER_EXECUTABLE_NAMES \\',
+    list(names),
+    '',
+    '',
+    '#define HELPER_EXECUTABLE_PREFIXES \\',
+    list(prefixes),
+    '',
+    '',
+    '#define HELPER_EXECUTABLE_SUFFIXES \\',
+    list(suffixes),
+    '',
+    ''
+  ].join('\n');
+
+  fs.writeFileSync(OUTPUT_PATH, output);
+  console.log(`Wrote ${names.size} names, ${prefixes.size} prefixes, ${suffixes.size} suffixes to ${path.basename(OUTPUT_PATH)}`);
+}
+
+main();
@@ -0,0 +1,259 @@
+#include <napi.h>
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "hang-watchdog.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Probe cadence: healthy windows back off towards kMaxIntervalMs, anything
+// slow or missing probes is checked every kMinIntervalMs
+constexpr uint32_t kMinIntervalMs = 250;
+constexpr uint32_t kInitialIntervalMs = 500;
+constexpr uint32_t kMaxIntervalMs = 4000;
+
+// Bounded wait for the WM_NULL round trip; slower replies count as suspect
+constexpr UINT kProbeTimeoutMs = 200;
+constexpr double kSlowReplyMs = 50;
+
+// Consecutive missed probes before a window is reported hung, so a single
+// long paint does not flap the placeholder
+constexpr int kMissesBeforeHung = 2;
+
+enum class ProbeResult { Responsive, Slow, Missed, Gone };
+
+struct WatchState {
+  Clock::time_point nextProbe;
+  Clock::time_point lastResponsive;
+  Clock::time_point hungSince;
+  uint32_t intervalMs = kInitialIntervalMs;
+  int misses = 0;
+  bool hung = false;
+};
+
+struct HangEvent {
+  uintptr_t hwnd;
+  bool hung;
+  double durationMs;
+};
+
+double MillisecondsBetween(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+ProbeResult ProbeWindow(HWND hwnd) {
+  if (!IsWindow(hwnd)) return ProbeResult::Gone;
+
+  // Free check first: no message is sent, the system just reports whether
+  // the owning thread has stopped calling GetMessage for several seconds
+  if (IsHungAppWindow(hwnd)) return ProbeResult::Missed;
+
+  Clock::time_point start = Clock::now();
+  DWORD_PTR ignored = 0;
+  if (!SendMessageTimeoutW(hwnd, WM_NULL, 0, 0, SMTO_ABORTIFHUNG | SMTO_BLOCK,
+                           kProbeTimeoutMs, &ignored)) {
+    return IsWindow(hwnd) ? ProbeResult::Missed : ProbeResult::Gone;
+  }
+  return MillisecondsBetween(start, Clock::now()) > kSlowReplyMs ?
+    ProbeResult::Slow : ProbeResult::Responsive;
+}
+
+// Background thread that probes every watched window on its own adaptive
+// schedule and reports hung/recovered transitions to a JS callback
+class HangWatchdog {
+ public:
+  bool Start(Napi::Env env, Napi::Function callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return false;
+
+    tsfn_ = Napi::ThreadSafeFunction::New(env, callback, "hangWatchdog", 0, 1);
+    tsfn_.Unref(env);
+    running_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&HangWatchdog::Loop, this);
+    return true;
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_) return;
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    tsfn_.Release();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+
+  void Watch(uintptr_t hwnd) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      WatchState& state = windows_[hwnd];
+      state = WatchState();
+      state.lastResponsive = Clock::now();
+      state.nextProbe = state.lastResponsive + std::chrono::milliseconds(kInitialIntervalMs);
+    }
+    cv_.notify_all();
+  }
+
+  void Unwatch(uintptr_t hwnd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    windows_.erase(hwnd);
+  }
+
+  bool IsHung(uintptr_t hwnd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = windows_.find(hwnd);
+    return it != windows_.end() && it->second.hung;
+  }
+
+ private:
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      Clock::time_point now = Clock::now();
+      std::vector<uintptr_t> due;
+      for (const auto& entry : windows_) {
+        if (entry.second.nextProbe <= now) due.push_back(entry.first);
+      }
+
+      // Probes can each take up to kProbeTimeoutMs, so run them unlocked
+      std::vector<std::pair<uintptr_t, ProbeResult>> results;
+      if (!due.empty()) {
+        lock.unlock();
+        for (uintptr_t hwnd : due) {
+          results.emplace_back(hwnd, ProbeWindow((HWND)hwnd));
+        }
+        lock.lock();
+      }
+
+      now = Clock::now();
+      for (const auto& probe : results) {
+        auto it = windows_.find(probe.first);
+        if (it == windows_.end()) continue;  // Unwatched while probing
+        if (probe.second == ProbeResult::Gone) {
+          windows_.erase(it);
+          continue;
+        }
+        Record(probe.first, it->second, probe.second, now);
+      }
+
+      Clock::time_point next = Clock::time_point::max();
+      for (const auto& entry : windows_) {
+        next = std::min(next, entry.second.nextProbe);
+      }
+      if (next == Clock::time_point::max()) {
+        cv_.wait(lock);
+      } else {
+        cv_.wait_until(lock, next);
+      }
+    }
+  }
+
+  // Caller holds mutex_
+  void Record(uintptr_t hwnd, WatchState& state, ProbeResult result, Clock::time_point now) {
+    if (result == ProbeResult::Missed) {
+      state.misses++;
+      state.intervalMs = state.hung ? kInitialIntervalMs : kMinIntervalMs;
+      if (!state.hung && state.misses >= kMissesBeforeHung) {
+        state.hung = true;
+        state.hungSince = state.lastResponsive;
+        Emit({ hwnd, true, MillisecondsBetween(state.hungSince, now) });
+      }
+    } else {
+      if (state.hung) {
+        state.hung = false;
+        Emit({ hwnd, false, MillisecondsBetween(state.hungSince, now) });
+      }
+      state.misses = 0;
+      state.lastResponsive = now;
+      state.intervalMs = result == ProbeResult::Slow ?
+        kMinIntervalMs : std::min(state.intervalMs * 2, kMaxIntervalMs);
+    }
+    state.nextProbe = now + std::chrono::milliseconds(state.intervalMs);
+  }
+
+  void Emit(const HangEvent& event) {
+    auto* data = new HangEvent(event);
+    napi_status status = tsfn_.BlockingCall(data, [](Napi::Env env, Napi::Function callback, HangEvent* data) {
+      Napi::Object payload = Napi::Object::New(env);
+      payload.Set("hwnd", Napi::Number::New(env, (double)data->hwnd));
+      payload.Set("state", Napi::String::New(env, data->hung ? "hung" : "recovered"));
+      payload.Set("durationMs", Napi::Number::New(env, data->durationMs));
+      delete data;
+      callback.Call({ payload });
+    });
+    if (status != napi_ok) {
+      delete data;
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unordered_map<uintptr_t, WatchState> windows_;
+  std::thread thread_;
+  Napi::ThreadSafeFunction tsfn_;
+  bool running_ = false;
+  bool stopping_ = false;
+};
+
+// Shared with the window-ops thread; leaked so it outlives module teardown
+HangWatchdog* g_watchdog = new HangWatchdog();
+
+}  // namespace
+
+bool IsWindowMarkedHung(uintptr_t hwnd) {
+  return g_watchdog->IsHung(hwnd);
+}
+
+// StartHangWatchdog: Start probing watched windows, reporting transitions to callback
+Napi::Value StartHangWatchdog(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (callback: (event: { hwnd, state, durationMs }) => void)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  bool started = g_watchdog->Start(env, info[0].As<Napi::Function>());
+  if (started) {
+    env.AddCleanupHook([]() { g_watchdog->Stop(); });
+  }
+  return Napi::Boolean::New(env, started);
+}
+
+// WatchWindow: Add an embedded window to the watchdog
+Napi::Value WatchWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (hwnd: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  g_watchdog->Watch((uintptr_t)info[0].As<Napi::Number>().Int64Value());
+  return env.Undefined();
+}
+
+// UnwatchWindow: Stop probing a window (tab closed)
+Napi::Value UnwatchWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (hwnd: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  g_watchdog->Unwatch((uintptr_t)info[0].As<Napi::Number>().Int64Value());
+  return env.Undefined();
+}
@@ -0,0 +1,16 @@
+#ifndef HANG_WATCHDOG_H
+#define HANG_WATCHDOG_H
+
+#include <napi.h>
+#include <cstdint>
+
+// Function declarations for the hung-window watchdog
+Napi::Value StartHangWatchdog(const Napi::CallbackInfo& info);
+Napi::Value WatchWindow(const Napi::CallbackInfo& info);
+Napi::Value UnwatchWindow(const Napi::CallbackInfo& info);
+
+// True while the watchdog considers the window hung. Window-ops lambdas use
+// this to skip geometry updates an unresponsive app could not process anyway.
+bool IsWindowMarkedHung(uintptr_t hwnd);
+
+#endif
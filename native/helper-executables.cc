@@ -0,0 +1,166 @@
+#include <cstdint>
+#include "helper-executables.h"
+#include "helper-executables.inc"
+
+namespace {
+
+struct Entry {
+  const char* text;
+  size_t length;
+};
+
+// Generated from helper-executables.txt; each list must be non-empty
+constexpr Entry kNames[] = { HELPER_EXECUTABLE_NAMES };
+constexpr Entry kPrefixes[] = { HELPER_EXECUTABLE_PREFIXES };
+constexpr Entry kSuffixes[] = { HELPER_EXECUTABLE_SUFFIXES };
+
+constexpr size_t kNameCount = sizeof(kNames) / sizeof(kNames[0]);
+
+constexpr size_t NextPowerOfTwo(size_t n) {
+  size_t power = 1;
+  while (power < n) power <<= 1;
+  return power;
+}
+
+// A half-empty slot table keeps each bucket's seed search short; buckets
+// average under two names
+constexpr size_t kSlotCount = NextPowerOfTwo(kNameCount * 2);
+constexpr size_t kSlotMask = kSlotCount - 1;
+constexpr size_t kBucketCount = kSlotCount / 4;
+constexpr size_t kMaxBucketSize = 16;
+constexpr uint32_t kMaxSeed = 65535;
+
+constexpr char Lower(char c) {
+  return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+// FNV-1a over the lowercased name with a seeded basis, then a finalizer so
+// the low bits used for slots depend on every byte
+constexpr uint32_t Hash(const char* text, size_t length, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)Lower(text[i]);
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  hash *= 0xC2B2AE35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+constexpr bool EqualsLower(const char* text, const char* lower, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (Lower(text[i]) != lower[i]) return false;
+  }
+  return true;
+}
+
+// Hash-and-displace: names are grouped into buckets by Hash(name, 0), and each
+// bucket gets the first seed that sends all of its names to free slots.
+// Lookup is one bucket read, one slot read and one comparison.
+struct PerfectHashTable {
+  int16_t slots[kSlotCount];     // Index into kNames, or -1
+  uint16_t seeds[kBucketCount];
+  bool complete;
+};
+
+constexpr PerfectHashTable BuildTable() {
+  PerfectHashTable table{};
+  for (size_t slot = 0; slot < kSlotCount; slot++) table.slots[slot] = -1;
+  table.complete = true;
+
+  // Group name indices by bucket (counting sort) so each seed trial only
+  // hashes that bucket's names; keeps compile-time evaluation cheap
+  size_t bucketOf[kNameCount] = {};
+  size_t bucketStart[kBucketCount + 1] = {};
+  size_t largest = 0;
+  for (size_t i = 0; i < kNameCount; i++) {
+    bucketOf[i] = Hash(kNames[i].text, kNames[i].length, 0) % kBucketCount;
+    bucketStart[bucketOf[i] + 1]++;
+  }
+  for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+    if (bucketStart[bucket + 1] > largest) largest = bucketStart[bucket + 1];
+    bucketStart[bucket + 1] += bucketStart[bucket];
+  }
+  if (largest > kMaxBucketSize) {
+    table.complete = false;
+    return table;
+  }
+  size_t members[kNameCount] = {};
+  size_t filled[kBucketCount] = {};
+  for (size_t i = 0; i < kNameCount; i++) {
+    members[bucketStart[bucketOf[i]] + filled[bucketOf[i]]++] = i;
+  }
+
+  // Largest buckets first, while the table is emptiest
+  for (size_t size = largest; size > 0; size--) {
+    for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+      if (bucketStart[bucket + 1] - bucketStart[bucket] != size) continue;
+      const size_t* names = members + bucketStart[bucket];
+
+      bool placed = false;
+      for (uint32_t seed = 1; seed <= kMaxSeed && !placed; seed++) {
+        size_t chosen[kMaxBucketSize] = {};
+        bool fits = true;
+        for (size_t j = 0; j < size && fits; j++) {
+          const Entry& name = kNames[names[j]];
+          chosen[j] = Hash(name.text, name.length, seed) & kSlotMask;
+          if (table.slots[chosen[j]] != -1) fits = false;
+          for (size_t k = 0; k < j && fits; k++) {
+            if (chosen[k] == chosen[j]) fits = false;
+          }
+        }
+        if (!fits) continue;
+
+        for (size_t j = 0; j < size; j++) table.slots[chosen[j]] = (int16_t)names[j];
+        table.seeds[bucket] = (uint16_t)seed;
+        placed = true;
+      }
+      if (!placed) table.complete = false;
+    }
+  }
+  return table;
+}
+
+constexpr PerfectHashTable kTable = BuildTable();
+static_assert(kTable.complete,
+              "No perfect hash for helper-executables.txt; check for duplicates or raise kMaxSeed");
+
+bool IsKnownName(const char* fileName, size_t length) {
+  uint32_t seed = kTable.seeds[Hash(fileName, length, 0) % kBucketCount];
+  int16_t index = kTable.slots[Hash(fileName, length, seed) & kSlotMask];
+  return index >= 0 && kNames[index].length == length &&
+    EqualsLower(fileName, kNames[index].text, length);
+}
+
+bool MatchesPattern(const char* fileName, size_t length) {
+  for (const Entry& prefix : kPrefixes) {
+    if (length >= prefix.length && EqualsLower(fileName, prefix.text, prefix.length)) return true;
+  }
+  for (const Entry& suffix : kSuffixes) {
+    if (length >= suffix.length &&
+        EqualsLower(fileName + length - suffix.length, suffix.text, suffix.length)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ContainsLower(const std::string& text, const char* lower, size_t length) {
+  for (size_t i = 0; i + length <= text.size(); i++) {
+    if (EqualsLower(text.data() + i, lower, length)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool IsHelperExecutable(const char* fileName, size_t length) {
+  return IsKnownName(fileName, length) || MatchesPattern(fileName, length);
+}
+
+bool LooksLikeInstaller(const std::string& fileName) {
+  return ContainsLower(fileName, "setup", 5) || ContainsLower(fileName, "install", 7);
+}
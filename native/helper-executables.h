@@ -0,0 +1,22 @@
+#ifndef HELPER_EXECUTABLES_H
+#define HELPER_EXECUTABLES_H
+
+#include <cstddef>
+#include <string>
+
+// Known non-app executables (crash handlers, updaters, service hosts,
+// installers, bundled runtimes) from helper-executables.txt. Exact names are
+// a perfect-hash probe built at compile time; vendor patterns are a short
+// prefix/suffix scan. Case-insensitive and allocation-free.
+bool IsHelperExecutable(const char* fileName, size_t length);
+
+inline bool IsHelperExecutable(const std::string& fileName) {
+  return IsHelperExecutable(fileName.data(), fileName.size());
+}
+
+// Installers and setup stubs that ship next to apps (setup.exe,
+// MyApp-Installer.exe, ...), by name. Scans that pick an exe from a folder
+// they know nothing else about skip these.
+bool LooksLikeInstaller(const std::string& fileName);
+
+#endif
@@ -0,0 +1,602 @@
+#include <napi.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "app-enrichment.h"
+#include "authenticode.h"
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+#include "discovery-sources.h"
+#include "executor.h"
+#include "idle-scheduler.h"
+#include "stat-cache.h"
+#include "system-activity.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint32_t kDefaultIdleThresholdMs = 20000;
+constexpr double kDefaultMaxCpuLoad = 0.5;
+constexpr uint32_t kDefaultPollIntervalMs = 500;
+
+// Running jobs re-check input at most this often, so a keypress pauses work
+// within one filesystem/registry call plus this interval
+constexpr uint32_t kCheckpointIntervalMs = 50;
+
+enum class IdleJobKind { Rescan, Icons, Metadata, Verify };
+
+const char* IdleJobKindName(IdleJobKind kind) {
+  switch (kind) {
+    case IdleJobKind::Rescan: return "rescan";
+    case IdleJobKind::Icons: return "icons";
+    case IdleJobKind::Metadata: return "metadata";
+    case IdleJobKind::Verify: return "verify";
+  }
+  return "rescan";
+}
+
+struct IdleOptions {
+  uint32_t idleThresholdMs = kDefaultIdleThresholdMs;
+  double maxCpuLoad = kDefaultMaxCpuLoad;
+  uint32_t pollIntervalMs = kDefaultPollIntervalMs;
+};
+
+struct IdleJob {
+  uint64_t id;
+  IdleJobKind kind;
+  std::vector<std::string> paths;  // icons/metadata/verify targets
+};
+
+struct IdleResult {
+  std::string path;
+  bool ok = false;
+  std::string icon;
+  AppMetadata metadata;
+  bool trusted = false;
+  std::string error;
+};
+
+struct IdleEvent {
+  const char* type;                // paused, resumed, rescan, icons, metadata, verify, error
+  uint64_t jobId = 0;
+  IdleJobKind kind = IdleJobKind::Rescan;
+  double pausedMs = 0;
+  std::string error;
+  DiscoveryRun discovery;
+  std::vector<IdleResult> results;
+};
+
+struct IdleState {
+  bool running = false;
+  bool idle = false;
+  bool paused = false;
+  bool inputAvailable = false;
+  uint64_t inputIdleMs = 0;
+  bool cpuAvailable = false;
+  double cpuLoad = 0;
+  size_t pendingJobs = 0;
+  bool active = false;
+  IdleJobKind activeKind = IdleJobKind::Rescan;
+};
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double ReadNumber(const Napi::Object& object, const char* name, double fallback) {
+  Napi::Value value = object.Get(name);
+  return value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : fallback;
+}
+
+class IdleScheduler;
+
+// Backends that block at every call while the user is active, so a scan
+// written against the plain interfaces pauses mid-walk without knowing it
+class GatedFileSystem : public FileSystemBackend {
+ public:
+  GatedFileSystem(FileSystemBackend& inner, IdleScheduler* scheduler)
+    : inner_(inner), scheduler_(scheduler) {}
+
+  BackendStatus ListDirectory(const std::string& path, std::vector<DirEntry>* entries) override;
+  BackendStatus Stat(const std::string& path, DirEntry* entry) override;
+  BackendStatus ReadFile(const std::string& path, size_t maxBytes, std::string* contents) override;
+  BackendStatus ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                           std::string* contents) override;
+  BackendStatus Identify(const std::string& path, FileIdentity* identity) override;
+
+ private:
+  FileSystemBackend& inner_;
+  IdleScheduler* scheduler_;
+};
+
+class GatedRegistry : public RegistryBackend {
+ public:
+  GatedRegistry(RegistryBackend& inner, IdleScheduler* scheduler)
+    : inner_(inner), scheduler_(scheduler) {}
+
+  BackendStatus EnumerateSubKeys(RegistryRoot root, const std::string& keyPath,
+                                 std::vector<std::string>* names) override;
+  BackendStatus ReadString(RegistryRoot root, const std::string& keyPath,
+                           const std::string& valueName, std::string* data) override;
+  BackendStatus ReadValues(RegistryRoot root, const std::string& keyPath,
+                           std::vector<RegistryValue>* values) override;
+  BackendStatus ReadBinaryValues(RegistryRoot root, const std::string& keyPath,
+                                 std::vector<RegistryValue>* values) override;
+
+ private:
+  RegistryBackend& inner_;
+  IdleScheduler* scheduler_;
+};
+
+// Background thread that holds queued jobs until the user has been idle for
+// idleThresholdMs and CPU load is at most maxCpuLoad, then runs each on the
+// executor's background lane. Input during a job pauses it at the next
+// checkpoint until the machine is idle again; CPU load only gates starting,
+// since the job itself adds to it.
+class IdleScheduler {
+ public:
+  bool Start(Napi::Env env, Napi::Function callback, const IdleOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return false;
+
+    tsfn_ = Napi::ThreadSafeFunction::New(env, callback, "idleScheduler", 0, 1);
+    tsfn_.Unref(env);
+    options_ = options;
+    running_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&IdleScheduler::Loop, this);
+    return true;
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_) return;
+      stopping_ = true;
+      jobToken_.Cancel();
+    }
+    cv_.notify_all();
+    thread_.join();
+    tsfn_.Release();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.clear();
+    running_ = false;
+  }
+
+  // Returns the job id, or 0 when the scheduler is not running. A rescan
+  // already waiting in the queue absorbs new rescan requests.
+  uint64_t Schedule(IdleJobKind kind, std::vector<std::string> paths) {
+    uint64_t id;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_ || stopping_) return 0;
+      if (kind == IdleJobKind::Rescan) {
+        for (const IdleJob& job : jobs_) {
+          if (job.kind == IdleJobKind::Rescan) return job.id;
+        }
+      }
+      id = ++lastJobId_;
+      jobs_.push_back({ id, kind, std::move(paths) });
+    }
+    cv_.notify_all();
+    return id;
+  }
+
+  IdleState Snapshot() {
+    // Input is cheap to query fresh; CPU load needs two samples over time,
+    // so report the scheduler thread's latest
+    uint64_t inputIdleMs = 0;
+    bool inputAvailable = QueryInputIdleMs(&inputIdleMs);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    IdleState state;
+    state.running = running_;
+    state.paused = paused_;
+    state.inputAvailable = inputAvailable;
+    state.inputIdleMs = inputIdleMs;
+    state.cpuAvailable = cpuAvailable_;
+    state.cpuLoad = cpuLoad_;
+    state.pendingJobs = jobs_.size();
+    state.active = active_;
+    state.activeKind = activeJob_.kind;
+    state.idle = IsIdleLocked(inputAvailable, inputIdleMs);
+    return state;
+  }
+
+  // Called by gated backends and between job steps while a job runs.
+  // Returns false once the scheduler is stopping and the job should end.
+  // A rescan's sources run in parallel; while one waits for idle here the
+  // others block on the lock, so they pause together.
+  bool Checkpoint() {
+    if (stopping_) return false;
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    Clock::time_point now = Clock::now();
+    if (now - lastCheckpoint_ < std::chrono::milliseconds(kCheckpointIntervalMs)) return true;
+    lastCheckpoint_ = now;
+
+    return InputIdle() || WaitForIdle(true);
+  }
+
+ private:
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      if (jobs_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+
+      lock.unlock();
+      bool idle = WaitForIdle(false);
+      lock.lock();
+      if (!idle || jobs_.empty()) continue;
+
+      activeJob_ = std::move(jobs_.front());
+      jobs_.pop_front();
+      active_ = true;
+      jobDone_ = false;
+      jobToken_ = CancellationToken::Create();
+      lock.unlock();
+
+      // This thread only waits while the job runs, so the job's checkpoints
+      // can use the sampler and checkpoint clock without sharing them
+      SharedExecutor().Submit(TaskLane::Background, [this](const CancellationToken& token) {
+        if (!token.IsCancelled()) RunJob(activeJob_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobDone_ = true;
+        cv_.notify_all();
+      }, jobToken_);
+
+      lock.lock();
+      cv_.wait(lock, [this]() { return jobDone_; });
+      active_ = false;
+    }
+  }
+
+  // Caller holds mutex_
+  bool IsIdleLocked(bool inputAvailable, uint64_t inputIdleMs) const {
+    // Without an input source (e.g. Wayland) only load gates the work
+    bool inputIdle = !inputAvailable || inputIdleMs >= options_.idleThresholdMs;
+    bool cpuIdle = !cpuAvailable_ || cpuLoad_ <= options_.maxCpuLoad;
+    return inputIdle && cpuIdle;
+  }
+
+  bool InputIdle() const {
+    uint64_t inputIdleMs = 0;
+    return !QueryInputIdleMs(&inputIdleMs) || inputIdleMs >= options_.idleThresholdMs;
+  }
+
+  // Load is the busy fraction since the previous sample, i.e. over the last
+  // poll interval
+  bool SampleIdle() {
+    uint64_t inputIdleMs = 0;
+    bool inputAvailable = QueryInputIdleMs(&inputIdleMs);
+    double cpuLoad = 0;
+    bool cpuSampled = cpuSampler_.Sample(&cpuLoad);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cpuSampled) {
+      cpuLoad_ = cpuLoad;
+      cpuAvailable_ = true;
+    }
+    return IsIdleLocked(inputAvailable, inputIdleMs);
+  }
+
+  // Blocks until the machine is idle, checking every pollIntervalMs.
+  // duringJob reports the wait to JS as a pause of the active job.
+  // Returns false if stopping.
+  bool WaitForIdle(bool duringJob) {
+    Clock::time_point pausedAt = Clock::now();
+    bool announced = false;
+    double ignored;
+    cpuSampler_.Sample(&ignored);
+
+    do {
+      if (duringJob && !announced && !InputIdle()) {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          paused_ = true;
+        }
+        EmitJobEvent("paused", 0);
+        announced = true;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (cv_.wait_for(lock, std::chrono::milliseconds(options_.pollIntervalMs),
+                       [this]() { return stopping_.load(); })) {
+        return false;
+      }
+    } while (!SampleIdle());
+
+    if (announced) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        paused_ = false;
+      }
+      EmitJobEvent("resumed", MillisecondsSince(pausedAt));
+    }
+    return !stopping_;
+  }
+
+  void RunJob(const IdleJob& job) {
+    auto* event = new IdleEvent();
+    event->type = IdleJobKindName(job.kind);
+    event->jobId = job.id;
+    event->kind = job.kind;
+
+#ifdef _WIN32
+    if (job.kind == IdleJobKind::Rescan) {
+      GatedRegistry registry(LiveRegistry(), this);
+      GatedFileSystem fileSystem(CachedLiveFileSystem(), this);
+      DiscoveryRoots roots = DefaultDiscoveryRoots();
+      DiscoveryContext context = { fileSystem, registry, roots, &SharedGameLibraryCache(),
+                                   &SharedProfileScanCache() };
+      context.rootTimeoutMs = 0;  // Gated calls block for as long as the user is active
+      DiscoveryRunOptions options;
+      options.lane = TaskLane::Background;
+      RunDiscoverySources(context, options, &SharedDiscoverySourceCache(), &event->discovery);
+    } else {
+      for (const std::string& path : job.paths) {
+        if (!Checkpoint()) break;
+        IdleResult result;
+        result.path = path;
+        if (job.kind == IdleJobKind::Icons) {
+          result.ok = ExtractIconDataUrl(path, &result.icon, &result.error);
+        } else if (job.kind == IdleJobKind::Metadata) {
+          result.ok = ReadVersionMetadata(path, &result.metadata, &result.error);
+        } else {
+          // Later signer reads report the verdict until the file changes
+          result.ok = VerifyAuthenticode(path, &result.trusted, &result.error);
+          if (result.ok) SharedSignatureCache().RecordTrust(LiveFileSystem(), path, result.trusted);
+        }
+        event->results.push_back(std::move(result));
+      }
+    }
+#else
+    event->type = "error";
+    event->error = std::string(IdleJobKindName(job.kind)) + " jobs need the live Windows backends";
+#endif
+
+    // A stopped job's partial results are dropped
+    if (stopping_) {
+      delete event;
+      return;
+    }
+    Emit(event);
+  }
+
+  void EmitJobEvent(const char* type, double pausedMs) {
+    auto* event = new IdleEvent();
+    event->type = type;
+    event->jobId = activeJob_.id;
+    event->kind = activeJob_.kind;
+    event->pausedMs = pausedMs;
+    Emit(event);
+  }
+
+  void Emit(IdleEvent* event) {
+    napi_status status = tsfn_.BlockingCall(event, [](Napi::Env env, Napi::Function callback, IdleEvent* data) {
+      Napi::Object payload = Napi::Object::New(env);
+      payload.Set("type", Napi::String::New(env, data->type));
+      payload.Set("jobId", Napi::Number::New(env, (double)data->jobId));
+      payload.Set("kind", Napi::String::New(env, IdleJobKindName(data->kind)));
+      std::string type = data->type;
+
+      if (type == "resumed") {
+        payload.Set("pausedMs", Napi::Number::New(env, data->pausedMs));
+      } else if (type == "error") {
+        payload.Set("error", Napi::String::New(env, data->error));
+      } else if (type == "rescan") {
+        payload.Set("apps", AppsToNapi(env, data->discovery.apps));
+        payload.Set("sources", SourceRunStatsToNapi(env, data->discovery.sources));
+      } else if (type == "icons" || type == "metadata" || type == "verify") {
+        Napi::Array results = Napi::Array::New(env, data->results.size());
+        for (size_t i = 0; i < data->results.size(); i++) {
+          const IdleResult& result = data->results[i];
+          Napi::Object entry = Napi::Object::New(env);
+          entry.Set("path", Napi::String::New(env, result.path));
+          entry.Set("success", Napi::Boolean::New(env, result.ok));
+          if (!result.ok) {
+            entry.Set("error", Napi::String::New(env, result.error));
+          } else if (type == "icons") {
+            entry.Set("icon", Napi::String::New(env, result.icon));
+          } else if (type == "verify") {
+            entry.Set("trusted", Napi::Boolean::New(env, result.trusted));
+          } else {
+            entry.Set("companyName", Napi::String::New(env, result.metadata.companyName));
+            entry.Set("productName", Napi::String::New(env, result.metadata.productName));
+            entry.Set("fileDescription", Napi::String::New(env, result.metadata.fileDescription));
+            entry.Set("fileVersion", Napi::String::New(env, result.metadata.fileVersion));
+          }
+          results.Set((uint32_t)i, entry);
+        }
+        payload.Set("results", results);
+      }
+
+      delete data;
+      callback.Call({ payload });
+    });
+    if (status != napi_ok) {
+      delete event;
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<IdleJob> jobs_;
+  IdleJob activeJob_ = { 0, IdleJobKind::Rescan, {} };
+  std::thread thread_;
+  Napi::ThreadSafeFunction tsfn_;
+  IdleOptions options_;
+  CancellationToken jobToken_;
+  CpuLoadSampler cpuSampler_;          // Loop thread, or the job task while it runs
+  std::mutex checkpointMutex_;         // Serializes the job's checkpoints
+  Clock::time_point lastCheckpoint_;   // Job tasks only, under checkpointMutex_
+  double cpuLoad_ = 0;
+  uint64_t lastJobId_ = 0;
+  bool cpuAvailable_ = false;
+  bool running_ = false;
+  bool active_ = false;
+  bool paused_ = false;
+  bool jobDone_ = false;
+  std::atomic<bool> stopping_{false};
+};
+
+BackendStatus GatedFileSystem::ListDirectory(const std::string& path, std::vector<DirEntry>* entries) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.ListDirectory(path, entries);
+}
+
+BackendStatus GatedFileSystem::Stat(const std::string& path, DirEntry* entry) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.Stat(path, entry);
+}
+
+BackendStatus GatedFileSystem::ReadFile(const std::string& path, size_t maxBytes, std::string* contents) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.ReadFile(path, maxBytes, contents);
+}
+
+BackendStatus GatedFileSystem::ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                                          std::string* contents) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.ReadFileAt(path, offset, maxBytes, contents);
+}
+
+BackendStatus GatedFileSystem::Identify(const std::string& path, FileIdentity* identity) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.Identify(path, identity);
+}
+
+BackendStatus GatedRegistry::EnumerateSubKeys(RegistryRoot root, const std::string& keyPath,
+                                              std::vector<std::string>* names) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.EnumerateSubKeys(root, keyPath, names);
+}
+
+BackendStatus GatedRegistry::ReadString(RegistryRoot root, const std::string& keyPath,
+                                        const std::string& valueName, std::string* data) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.ReadString(root, keyPath, valueName, data);
+}
+
+BackendStatus GatedRegistry::ReadValues(RegistryRoot root, const std::string& keyPath,
+                                        std::vector<RegistryValue>* values) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.ReadValues(root, keyPath, values);
+}
+
+BackendStatus GatedRegistry::ReadBinaryValues(RegistryRoot root, const std::string& keyPath,
+                                              std::vector<RegistryValue>* values) {
+  if (!scheduler_->Checkpoint()) return BackendStatus::Timeout;
+  return inner_.ReadBinaryValues(root, keyPath, values);
+}
+
+// Leaked so a job finishing during module teardown never touches freed state
+IdleScheduler* g_idleScheduler = new IdleScheduler();
+
+}  // namespace
+
+// StartIdleScheduler: Start the idle-time job runner, reporting job events to callback
+Napi::Value StartIdleScheduler(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsFunction() ||
+      (info.Length() > 1 && !info[1].IsObject() && !info[1].IsUndefined())) {
+    Napi::TypeError::New(env, "Expected (callback: (event) => void, options?: { idleThresholdMs, maxCpuLoad, pollIntervalMs })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  IdleOptions options;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object object = info[1].As<Napi::Object>();
+    options.idleThresholdMs = (uint32_t)ReadNumber(object, "idleThresholdMs", options.idleThresholdMs);
+    options.maxCpuLoad = ReadNumber(object, "maxCpuLoad", options.maxCpuLoad);
+    options.pollIntervalMs = (uint32_t)ReadNumber(object, "pollIntervalMs", options.pollIntervalMs);
+    if (options.pollIntervalMs == 0) options.pollIntervalMs = kDefaultPollIntervalMs;
+  }
+
+  bool started = g_idleScheduler->Start(env, info[0].As<Napi::Function>(), options);
+  if (started) {
+    env.AddCleanupHook([]() { g_idleScheduler->Stop(); });
+  }
+  return Napi::Boolean::New(env, started);
+}
+
+// ScheduleIdleWork: Queue a rescan, or icon/metadata extraction or
+// signature verification for paths
+Napi::Value ScheduleIdleWork(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  const char* usage = "Expected (kind: 'rescan' | 'icons' | 'metadata' | 'verify', paths?: string[])";
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string kindName = info[0].As<Napi::String>().Utf8Value();
+  IdleJobKind kind;
+  if (kindName == "rescan") {
+    kind = IdleJobKind::Rescan;
+  } else if (kindName == "icons") {
+    kind = IdleJobKind::Icons;
+  } else if (kindName == "metadata") {
+    kind = IdleJobKind::Metadata;
+  } else if (kindName == "verify") {
+    kind = IdleJobKind::Verify;
+  } else {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<std::string> paths;
+  if (kind != IdleJobKind::Rescan) {
+    if (info.Length() < 2 || !info[1].IsArray()) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    Napi::Array array = info[1].As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value path = array.Get(i);
+      if (path.IsString()) paths.push_back(path.As<Napi::String>().Utf8Value());
+    }
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  uint64_t jobId = g_idleScheduler->Schedule(kind, std::move(paths));
+  result.Set("success", Napi::Boolean::New(env, jobId != 0));
+  if (jobId != 0) {
+    result.Set("jobId", Napi::Number::New(env, (double)jobId));
+  } else {
+    result.Set("error", Napi::String::New(env, "Idle scheduler is not running"));
+  }
+  return result;
+}
+
+// GetIdleState: Current idleness, load and queue state
+Napi::Value GetIdleState(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  IdleState state = g_idleScheduler->Snapshot();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("running", Napi::Boolean::New(env, state.running));
+  result.Set("idle", Napi::Boolean::New(env, state.idle));
+  result.Set("paused", Napi::Boolean::New(env, state.paused));
+  result.Set("inputSource", Napi::String::New(env, InputIdleSourceName(
+    state.inputAvailable ? GetInputIdleSource() : InputIdleSource::Unavailable)));
+  result.Set("inputIdleMs", state.inputAvailable
+    ? Napi::Value(Napi::Number::New(env, (double)state.inputIdleMs)) : env.Null());
+  result.Set("cpuLoad", state.cpuAvailable
+    ? Napi::Value(Napi::Number::New(env, state.cpuLoad)) : env.Null());
+  result.Set("pendingJobs", Napi::Number::New(env, (double)state.pendingJobs));
+  result.Set("activeJob", state.active
+    ? Napi::Value(Napi::String::New(env, IdleJobKindName(state.activeKind))) : env.Null());
+  return result;
+}
@@ -0,0 +1,13 @@
+#ifndef IDLE_SCHEDULER_H
+#define IDLE_SCHEDULER_H
+
+#include <napi.h>
+
+// Function declarations for the idle-time scheduler, which runs rescans,
+// icon extraction, metadata enrichment and signature verification only
+// while the user is away from the keyboard and the machine is lightly loaded
+Napi::Value StartIdleScheduler(const Napi::CallbackInfo& info);
+Napi::Value ScheduleIdleWork(const Napi::CallbackInfo& info);
+Napi::Value GetIdleState(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,249 @@
+#include <cstdlib>
+#include <cstring>
+#include "json-reader.h"
+
+namespace {
+
+// Manifests are flat; this only guards the recursion against hostile input
+constexpr int kMaxDepth = 64;
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : text_(text) {
+    if (text_.compare(0, 3, "\xEF\xBB\xBF") == 0) pos_ = 3;
+  }
+
+  bool Parse(JsonValue* value, std::string* error) {
+    SkipWhitespace();
+    bool ok = ParseValue(value, 0);
+    if (ok) {
+      SkipWhitespace();
+      if (pos_ != text_.size()) ok = Fail("trailing characters");
+    }
+    if (!ok) *error = error_ + " at offset " + std::to_string(pos_);
+    return ok;
+  }
+
+ private:
+  bool Fail(const char* message) {
+    if (error_.empty()) error_ = message;
+    return false;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+      pos_++;
+    }
+  }
+
+  bool Consume(const char* literal) {
+    size_t length = strlen(literal);
+    if (text_.compare(pos_, length, literal) != 0) return false;
+    pos_ += length;
+    return true;
+  }
+
+  bool ParseValue(JsonValue* value, int depth) {
+    if (depth > kMaxDepth) return Fail("nesting too deep");
+    if (pos_ >= text_.size()) return Fail("unexpected end of input");
+
+    switch (text_[pos_]) {
+      case '{': return ParseObject(value, depth);
+      case '[': return ParseArray(value, depth);
+      case '"':
+        value->type = JsonType::String;
+        return ParseString(&value->string);
+      case 't':
+      case 'f':
+        value->type = JsonType::Bool;
+        value->boolean = text_[pos_] == 't';
+        return Consume(value->boolean ? "true" : "false") || Fail("invalid literal");
+      case 'n':
+        value->type = JsonType::Null;
+        return Consume("null") || Fail("invalid literal");
+      default:
+        return ParseNumber(value);
+    }
+  }
+
+  bool ParseObject(JsonValue* value, int depth) {
+    value->type = JsonType::Object;
+    pos_++;  // '{'
+    SkipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == '}') {
+      pos_++;
+      return true;
+    }
+    while (true) {
+      SkipWhitespace();
+      if (pos_ >= text_.size() || text_[pos_] != '"') return Fail("expected member name");
+      std::pair<std::string, JsonValue> member;
+      if (!ParseString(&member.first)) return false;
+      SkipWhitespace();
+      if (pos_ >= text_.size() || text_[pos_] != ':') return Fail("expected ':'");
+      pos_++;
+      SkipWhitespace();
+      if (!ParseValue(&member.second, depth + 1)) return false;
+      value->members.push_back(std::move(member));
+      SkipWhitespace();
+      if (pos_ < text_.size() && text_[pos_] == ',') {
+        pos_++;
+        continue;
+      }
+      if (pos_ < text_.size() && text_[pos_] == '}') {
+        pos_++;
+        return true;
+      }
+      return Fail("expected ',' or '}'");
+    }
+  }
+
+  bool ParseArray(JsonValue* value, int depth) {
+    value->type = JsonType::Array;
+    pos_++;  // '['
+    SkipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == ']') {
+      pos_++;
+      return true;
+    }
+    while (true) {
+      SkipWhitespace();
+      value->items.emplace_back();
+      if (!ParseValue(&value->items.back(), depth + 1)) return false;
+      SkipWhitespace();
+      if (pos_ < text_.size() && text_[pos_] == ',') {
+        pos_++;
+        continue;
+      }
+      if (pos_ < text_.size() && text_[pos_] == ']') {
+        pos_++;
+        return true;
+      }
+      return Fail("expected ',' or ']'");
+    }
+  }
+
+  bool ParseHex4(uint32_t* code) {
+    if (pos_ + 4 > text_.size()) return Fail("truncated \\u escape");
+    *code = 0;
+    for (int i = 0; i < 4; i++) {
+      char c = text_[pos_++];
+      *code <<= 4;
+      if (c >= '0' && c <= '9') *code |= c - '0';
+      else if (c >= 'a' && c <= 'f') *code |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F') *code |= c - 'A' + 10;
+      else return Fail("invalid \\u escape");
+    }
+    return true;
+  }
+
+  static void AppendUtf8(std::string* out, uint32_t code) {
+    if (code < 0x80) {
+      *out += (char)code;
+    } else if (code < 0x800) {
+      *out += (char)(0xC0 | (code >> 6));
+      *out += (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      *out += (char)(0xE0 | (code >> 12));
+      *out += (char)(0x80 | ((code >> 6) & 0x3F));
+      *out += (char)(0x80 | (code & 0x3F));
+    } else {
+      *out += (char)(0xF0 | (code >> 18));
+      *out += (char)(0x80 | ((code >> 12) & 0x3F));
+      *out += (char)(0x80 | ((code >> 6) & 0x3F));
+      *out += (char)(0x80 | (code & 0x3F));
+    }
+  }
+
+  bool ParseString(std::string* out) {
+    pos_++;  // Opening quote
+    while (pos_ < text_.size()) {
+      char c = text_[pos_++];
+      if (c == '"') return true;
+      if ((unsigned char)c < 0x20) return Fail("control character in string");
+      if (c != '\\') {
+        *out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) break;
+      char escape = text_[pos_++];
+      switch (escape) {
+        case '"': *out += '"'; break;
+        case '\\': *out += '\\'; break;
+        case '/': *out += '/'; break;
+        case 'b': *out += '\b'; break;
+        case 'f': *out += '\f'; break;
+        case 'n': *out += '\n'; break;
+        case 'r': *out += '\r'; break;
+        case 't': *out += '\t'; break;
+        case 'u': {
+          uint32_t code = 0;
+          if (!ParseHex4(&code)) return false;
+          // Surrogate pairs arrive as two escapes
+          if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low = 0;
+            if (!Consume("\\u") || !ParseHex4(&low) || low < 0xDC00 || low > 0xDFFF) {
+              return Fail("unpaired surrogate");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          } else if (code >= 0xDC00 && code <= 0xDFFF) {
+            return Fail("unpaired surrogate");
+          }
+          AppendUtf8(out, code);
+          break;
+        }
+        default:
+          return Fail("invalid escape");
+      }
+    }
+    return Fail("unterminated string");
+  }
+
+  bool ParseNumber(JsonValue* value) {
+    size_t start = pos_;
+    if (pos_ < text_.size() && text_[pos_] == '-') pos_++;
+    auto digits = [&]() {
+      size_t first = pos_;
+      while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') pos_++;
+      return pos_ > first;
+    };
+    if (!digits()) return Fail("invalid value");
+    if (pos_ < text_.size() && text_[pos_] == '.') {
+      pos_++;
+      if (!digits()) return Fail("invalid number");
+    }
+    if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+      pos_++;
+      if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) pos_++;
+      if (!digits()) return Fail("invalid number");
+    }
+    value->type = JsonType::Number;
+    value->number = strtod(text_.substr(start, pos_ - start).c_str(), nullptr);
+    return true;
+  }
+
+  const std::string& text_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+}  // namespace
+
+const JsonValue* JsonValue::Find(const std::string& key) const {
+  if (type != JsonType::Object) return nullptr;
+  for (const auto& member : members) {
+    if (member.first == key) return &member.second;
+  }
+  return nullptr;
+}
+
+std::string JsonValue::GetString(const std::string& key, const std::string& fallback) const {
+  const JsonValue* member = Find(key);
+  return member && member->IsString() ? member->string : fallback;
+}
+
+bool ParseJson(const std::string& text, JsonValue* value, std::string* error) {
+  *value = JsonValue();
+  return JsonParser(text).Parse(value, error);
+}
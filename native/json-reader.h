@@ -0,0 +1,43 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal JSON reader for the small manifests app discovery reads off disk
+// (Scoop, Epic). Parses a whole document into a tree on any thread, without
+// touching V8, so scans can run on the executor.
+
+enum class JsonType {
+  Null,
+  Bool,
+  Number,
+  String,
+  Array,
+  Object
+};
+
+struct JsonValue {
+  JsonType type = JsonType::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<JsonValue> items;                             // Array
+  std::vector<std::pair<std::string, JsonValue>> members;   // Object, in document order
+
+  // Member lookup on objects; nullptr when absent or not an object
+  const JsonValue* Find(const std::string& key) const;
+  // Member's string value, or fallback when absent or not a string
+  std::string GetString(const std::string& key, const std::string& fallback = "") const;
+
+  bool IsString() const { return type == JsonType::String; }
+  bool IsArray() const { return type == JsonType::Array; }
+  bool IsObject() const { return type == JsonType::Object; }
+};
+
+// Standard JSON, plus a leading UTF-8 BOM as some tools write one. On
+// failure, error names the byte offset.
+bool ParseJson(const std::string& text, JsonValue* value, std::string* error);
+
+#endif
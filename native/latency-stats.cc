@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <cmath>
+#include "latency-stats.h"
+
+namespace {
+
+// Nearest-rank percentile of an ascending sample set
+double Percentile(const std::vector<double>& sorted, double percentile) {
+  if (sorted.empty()) return 0;
+  size_t rank = (size_t)std::ceil(percentile / 100.0 * sorted.size());
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+}  // namespace
+
+void LatencyRecorder::Merge(const LatencyRecorder& other) {
+  samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+}
+
+LatencySummary LatencyRecorder::Summarize() const {
+  LatencySummary summary;
+  if (samples_.empty()) return summary;
+
+  std::vector<double> sorted = samples_;
+  std::sort(sorted.begin(), sorted.end());
+
+  double total = 0;
+  for (double sample : sorted) total += sample;
+
+  summary.count = sorted.size();
+  summary.meanMs = total / sorted.size();
+  summary.p50Ms = Percentile(sorted, 50);
+  summary.p95Ms = Percentile(sorted, 95);
+  summary.p99Ms = Percentile(sorted, 99);
+  summary.p999Ms = Percentile(sorted, 99.9);
+  summary.maxMs = sorted.back();
+  return summary;
+}
+
+Napi::Object LatencySummaryToObject(Napi::Env env, const LatencySummary& summary) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, (double)summary.count));
+  result.Set("meanMs", Napi::Number::New(env, summary.meanMs));
+  result.Set("p50Ms", Napi::Number::New(env, summary.p50Ms));
+  result.Set("p95Ms", Napi::Number::New(env, summary.p95Ms));
+  result.Set("p99Ms", Napi::Number::New(env, summary.p99Ms));
+  result.Set("p999Ms", Napi::Number::New(env, summary.p999Ms));
+  result.Set("maxMs", Napi::Number::New(env, summary.maxMs));
+  return result;
+}
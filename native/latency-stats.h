@@ -0,0 +1,34 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <napi.h>
+#include <cstdint>
+#include <vector>
+
+struct LatencySummary {
+  uint64_t count = 0;
+  double meanMs = 0;
+  double p50Ms = 0;
+  double p95Ms = 0;
+  double p99Ms = 0;
+  double p999Ms = 0;
+  double maxMs = 0;
+};
+
+// Collects latency samples for percentile reporting by the native harnesses.
+// Not thread-safe: each recorder is owned by a single thread.
+class LatencyRecorder {
+ public:
+  void Add(double ms) { samples_.push_back(ms); }
+  void Merge(const LatencyRecorder& other);
+  uint64_t Count() const { return samples_.size(); }
+  LatencySummary Summarize() const;
+
+ private:
+  std::vector<double> samples_;
+};
+
+// { count, meanMs, p50Ms, p95Ms, p99Ms, p999Ms, maxMs }
+Napi::Object LatencySummaryToObject(Napi::Env env, const LatencySummary& summary);
+
+#endif
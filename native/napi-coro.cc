@@ -0,0 +1,77 @@
+#include <napi.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "napi-coro.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Timer {
+  Clock::time_point deadline;
+  uint64_t sequence;  // Keeps timers with equal deadlines in FIFO order
+  std::function<void()> fn;
+
+  bool operator>(const Timer& other) const {
+    return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+  }
+};
+
+// One thread sleeps until the earliest deadline. Callbacks run on it, so
+// they only hand work off (e.g. to the executor) and return.
+class TimerThread {
+ public:
+  void Add(uint32_t delayMs, std::function<void()> fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      timers_.push({ Clock::now() + std::chrono::milliseconds(delayMs), nextSequence_++, std::move(fn) });
+      if (!started_) {
+        started_ = true;
+        std::thread(&TimerThread::Loop, this).detach();
+      }
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (timers_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+      Clock::time_point deadline = timers_.top().deadline;
+      if (Clock::now() < deadline) {
+        // Woken early by an earlier timer being added; re-check the top
+        cv_.wait_until(lock, deadline);
+        continue;
+      }
+      std::function<void()> fn = std::move(const_cast<Timer&>(timers_.top()).fn);
+      timers_.pop();
+      lock.unlock();
+      fn();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+  uint64_t nextSequence_ = 0;
+  bool started_ = false;
+};
+
+// Leaked like the other process-lifetime services; the detached thread may
+// still be waiting at exit
+TimerThread* g_timerThread = new TimerThread();
+
+}  // namespace
+
+void RunAfter(uint32_t delayMs, std::function<void()> fn) {
+  g_timerThread->Add(delayMs, std::move(fn));
+}
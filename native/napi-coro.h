@@ -0,0 +1,200 @@
+#ifndef NAPI_CORO_H
+#define NAPI_CORO_H
+
+#include <napi.h>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <utility>
+#include "executor.h"
+#include "window-ops.h"
+
+// C++20 coroutines for promise-returning exports. An export that would
+// otherwise chain callbacks across the executor, timers, window ops and the
+// JS thread is written as one coroutine instead:
+//
+//   PromiseTask Example(Napi::Env env, Request request) {
+//     co_await ResumeOnExecutor(TaskLane::Normal);   // off the JS thread
+//     ...blocking work...
+//     co_await Delay(100);                           // on the executor again
+//     WindowOpResult op = co_await RunWindowOp("name", fn, timeoutMs);
+//     co_return ToObject(env, ...);                  // on the JS thread
+//   }
+//
+//   Napi::Value ExampleExport(const Napi::CallbackInfo& info) {
+//     return Example(info.Env(), ParseRequest(info)).Promise();
+//   }
+//
+// Rules: the first parameter is the Napi::Env; every other parameter is taken
+// by value (the frame outlives the caller's arguments); no Napi:: values are
+// held across a suspension; co_return runs on the JS thread. The body runs
+// synchronously on the JS thread up to its first suspension.
+
+class PromiseTask {
+ public:
+  struct promise_type {
+    template <typename... Args>
+    explicit promise_type(Napi::Env env, Args&...)
+      : env(env),
+        deferred(Napi::Promise::Deferred::New(env)),
+        // Keeps the event loop alive and carries resumptions back to the JS
+        // thread until the coroutine finishes
+        tsfn(Napi::ThreadSafeFunction::New(
+          env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "promiseTask", 0, 1)),
+        jsThread(std::this_thread::get_id()) {}
+
+    ~promise_type() { tsfn.Release(); }
+
+    PromiseTask get_return_object() { return PromiseTask(deferred.Promise()); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_value(Napi::Value value) { deferred.Resolve(value); }
+    // Exceptions are disabled in addon code; nothing should reach here
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    bool OnJsThread() const { return std::this_thread::get_id() == jsThread; }
+
+    Napi::Env env;
+    Napi::Promise::Deferred deferred;
+    Napi::ThreadSafeFunction tsfn;
+    std::thread::id jsThread;
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Napi::Promise Promise() const { return promise_; }
+
+ private:
+  explicit PromiseTask(Napi::Promise promise) : promise_(promise) {}
+  Napi::Promise promise_;
+};
+
+// Continue on an executor worker. Resolves to false, without suspending,
+// when the lane is full (the coroutine stays on its current thread).
+class ResumeOnExecutor {
+ public:
+  explicit ResumeOnExecutor(TaskLane lane, CancellationToken token = CancellationToken())
+    : lane_(lane), token_(token) {}
+
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    submitted_ = SharedExecutor().TrySubmit(lane_, [handle](const CancellationToken&) {
+      handle.resume();
+    }, token_);
+    return submitted_;
+  }
+  bool await_resume() const noexcept { return submitted_; }
+
+ private:
+  TaskLane lane_;
+  CancellationToken token_;
+  bool submitted_ = false;
+};
+
+// Continue on the JS thread; a no-op when already there
+class ResumeOnJsThread {
+ public:
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(PromiseTask::Handle handle) {
+    PromiseTask::promise_type& promise = handle.promise();
+    if (promise.OnJsThread()) return false;
+    // Fails only once the environment is shutting down, when there is no JS
+    // thread left to resume on; the frame is abandoned with it
+    promise.tsfn.NonBlockingCall([handle](Napi::Env, Napi::Function) { handle.resume(); });
+    return true;
+  }
+  void await_resume() const noexcept {}
+};
+
+// Run fn on the shared timer thread after delayMs
+void RunAfter(uint32_t delayMs, std::function<void()> fn);
+
+// Continue on an executor lane after delayMs. Waiting happens on the timer
+// thread, so no worker is held for the duration.
+class Delay {
+ public:
+  explicit Delay(uint32_t delayMs, TaskLane lane = TaskLane::Normal)
+    : delayMs_(delayMs), lane_(lane) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    TaskLane lane = lane_;
+    RunAfter(delayMs_, [lane, handle]() { Resume(lane, handle); });
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  static constexpr uint32_t kRetryMs = 5;
+
+  // Runs on the timer thread, which every pending timer shares, so a full
+  // lane re-arms the timer instead of blocking in Submit
+  static void Resume(TaskLane lane, std::coroutine_handle<> handle) {
+    bool submitted = SharedExecutor().TrySubmit(lane, [handle](const CancellationToken&) {
+      handle.resume();
+    });
+    if (!submitted) RunAfter(kRetryMs, [lane, handle]() { Resume(lane, handle); });
+  }
+
+  uint32_t delayMs_;
+  TaskLane lane_;
+};
+
+// Queue a window op (see window-ops.h) and continue on the JS thread once it
+// settles, with its result. May be awaited from any thread.
+class RunWindowOp {
+ public:
+  RunWindowOp(const char* name, WindowOpFn fn, uint32_t timeoutMs)
+    : name_(name), fn_(std::move(fn)), timeoutMs_(timeoutMs) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(PromiseTask::Handle handle) {
+    PromiseTask::promise_type& promise = handle.promise();
+    auto queue = [this, handle](Napi::Env env) {
+      QueueWindowOpWithCallback(env, name_, fn_, timeoutMs_,
+        [this, handle](Napi::Env, const WindowOpResult& result) {
+          result_ = result;
+          handle.resume();
+        });
+    };
+    if (promise.OnJsThread()) {
+      queue(promise.env);
+    } else {
+      promise.tsfn.NonBlockingCall([queue](Napi::Env env, Napi::Function) { queue(env); });
+    }
+  }
+  WindowOpResult await_resume() { return std::move(result_); }
+
+ private:
+  const char* name_;
+  WindowOpFn fn_;
+  uint32_t timeoutMs_;
+  WindowOpResult result_;
+};
+
+// Adapt a native callback API: start is handed a completion function, and
+// the coroutine continues on whichever thread calls it, with its value.
+// Follow with ResumeOnExecutor or ResumeOnJsThread to leave that thread.
+template <typename T>
+class AwaitCompletion {
+ public:
+  using Completion = std::function<void(T)>;
+
+  explicit AwaitCompletion(std::function<void(Completion)> start) : start_(std::move(start)) {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    start_([this, handle](T value) {
+      value_ = std::move(value);
+      handle.resume();
+    });
+  }
+  T await_resume() { return std::move(value_); }
+
+ private:
+  std::function<void(Completion)> start_;
+  T value_{};
+};
+
+#endif
@@ -0,0 +1,345 @@
+#include <cstdlib>
+#include "fake-discovery-backend.h"
+#include "helper-executables.h"
+#include "json-reader.h"
+#include "package-manager-scan.h"
+#include "stat-cache.h"
+
+namespace {
+
+// Manifests are a few KB; anything this large is not one
+constexpr size_t kMaxManifestBytes = 1024 * 1024;
+
+const char kUninstallKey[] = "SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall";
+
+// Manifests use "/" or "\" and sometimes a leading ".\"
+std::string NormalizeRelative(std::string path) {
+  for (char& c : path) {
+    if (c == '/') c = '\\';
+  }
+  while (path.compare(0, 2, ".\\") == 0) path.erase(0, 2);
+  return path;
+}
+
+std::string StemOf(const std::string& fileName) {
+  size_t dot = fileName.find_last_of('.');
+  return dot != std::string::npos ? fileName.substr(0, dot) : fileName;
+}
+
+bool ReadJsonFile(FileSystemBackend& fileSystem, const std::string& path, JsonValue* value) {
+  std::string contents;
+  std::string error;
+  return fileSystem.ReadFile(path, kMaxManifestBytes, &contents) == BackendStatus::Ok &&
+         ParseJson(contents, value, &error);
+}
+
+// A manifest field that may be overridden per architecture, as Scoop allows
+// for bin and shortcuts
+const JsonValue* ArchitectureField(const JsonValue& manifest, const std::string& architecture,
+                                   const char* field) {
+  const JsonValue* byArch = manifest.Find("architecture");
+  if (byArch) {
+    const JsonValue* preferred = byArch->Find(architecture);
+    if (preferred && preferred->Find(field)) return preferred->Find(field);
+  }
+  return manifest.Find(field);
+}
+
+void ScanScoopRoot(FileSystemBackend& fileSystem, const std::string& root,
+                   std::vector<DiscoveredApp>* apps) {
+  std::string appsDir = JoinPath(root, "apps");
+  std::vector<DirEntry> entries;
+  if (fileSystem.ListDirectory(appsDir, &entries) != BackendStatus::Ok) return;
+
+  for (const DirEntry& entry : entries) {
+    if (!entry.isDirectory || LowerAscii(entry.name) == "scoop") continue;
+    std::string current = JoinPath(JoinPath(appsDir, entry.name), "current");
+
+    JsonValue manifest;
+    if (!ReadJsonFile(fileSystem, JoinPath(current, "manifest.json"), &manifest) || !manifest.IsObject()) {
+      continue;
+    }
+    JsonValue install;
+    std::string architecture = "64bit";
+    if (ReadJsonFile(fileSystem, JoinPath(current, "install.json"), &install)) {
+      architecture = install.GetString("architecture", architecture);
+    }
+
+    // Shortcuts are [target, name, args?, icon?] and name the GUI entry points
+    size_t found = 0;
+    const JsonValue* shortcuts = ArchitectureField(manifest, architecture, "shortcuts");
+    if (shortcuts && shortcuts->IsArray()) {
+      for (const JsonValue& shortcut : shortcuts->items) {
+        if (!shortcut.IsArray() || shortcut.items.size() < 2 ||
+            !shortcut.items[0].IsString() || !shortcut.items[1].IsString()) {
+          continue;
+        }
+        std::string exePath = JoinPath(current, NormalizeRelative(shortcut.items[0].string));
+        if (!EndsWithNoCase(exePath, ".exe") || !fileSystem.Exists(exePath)) continue;
+        std::string icon;
+        if (shortcut.items.size() > 3 && shortcut.items[3].IsString()) {
+          icon = JoinPath(current, NormalizeRelative(shortcut.items[3].string));
+        }
+        apps->push_back({ "scoop_" + entry.name + "_" + std::to_string(found++),
+                          shortcut.items[1].string, exePath, icon });
+      }
+    }
+    if (found > 0) continue;
+
+    // No shortcuts: the first exe in bin (a string, or entries that are
+    // strings or [path, alias, args]) stands for the package
+    const JsonValue* bin = ArchitectureField(manifest, architecture, "bin");
+    std::vector<const JsonValue*> bins;
+    if (bin && bin->IsString()) bins.push_back(bin);
+    if (bin && bin->IsArray()) {
+      for (const JsonValue& item : bin->items) {
+        if (item.IsString()) bins.push_back(&item);
+        if (item.IsArray() && !item.items.empty() && item.items[0].IsString()) bins.push_back(&item.items[0]);
+      }
+    }
+    for (const JsonValue* target : bins) {
+      std::string exePath = JoinPath(current, NormalizeRelative(target->string));
+      if (!EndsWithNoCase(exePath, ".exe") || !fileSystem.Exists(exePath)) continue;
+      apps->push_back({ "scoop_" + entry.name, entry.name, exePath, "" });
+      break;
+    }
+  }
+}
+
+// Chocolatey shims every exe under the package folder unless <exe>.ignore
+// exists, and launches it as a GUI app when <exe>.gui exists
+void ScanChocolateyRoot(FileSystemBackend& fileSystem, const std::string& root,
+                        std::vector<DiscoveredApp>* apps) {
+  std::string libDir = JoinPath(root, "lib");
+  std::vector<DirEntry> packages;
+  if (fileSystem.ListDirectory(libDir, &packages) != BackendStatus::Ok) return;
+
+  for (const DirEntry& package : packages) {
+    if (!package.isDirectory || LowerAscii(package.name).compare(0, 10, "chocolatey") == 0) continue;
+    std::string packageDir = JoinPath(libDir, package.name);
+
+    std::string nuspec;
+    if (fileSystem.ReadFile(JoinPath(packageDir, package.name + ".nuspec"), kMaxManifestBytes,
+                            &nuspec) != BackendStatus::Ok) {
+      continue;
+    }
+    std::string id = ReadXmlElementText(nuspec, "id");
+    std::string title = ReadXmlElementText(nuspec, "title");
+    if (id.empty()) id = package.name;
+
+    // Portable packages keep their binaries in tools\, at most one folder down
+    std::string toolsDir = JoinPath(packageDir, "tools");
+    std::vector<std::string> dirs = { toolsDir };
+    std::string gui;
+    std::string matching;
+    std::string first;
+    for (size_t i = 0; i < dirs.size() && gui.empty(); i++) {
+      std::vector<DirEntry> entries;
+      if (fileSystem.ListDirectory(dirs[i], &entries) != BackendStatus::Ok) continue;
+
+      std::vector<std::string> markers;
+      for (const DirEntry& entry : entries) {
+        if (!entry.isDirectory) markers.push_back(LowerAscii(entry.name));
+        if (entry.isDirectory && i == 0) dirs.push_back(JoinPath(dirs[i], entry.name));
+      }
+      auto hasMarker = [&](const std::string& exeName, const char* suffix) {
+        std::string marker = LowerAscii(exeName) + suffix;
+        for (const std::string& name : markers) {
+          if (name == marker) return true;
+        }
+        return false;
+      };
+
+      for (const DirEntry& entry : entries) {
+        if (entry.isDirectory || !EndsWithNoCase(entry.name, ".exe")) continue;
+        if (hasMarker(entry.name, ".ignore") || IsHelperExecutable(entry.name)) continue;
+        std::string exePath = JoinPath(dirs[i], entry.name);
+        if (hasMarker(entry.name, ".gui")) {
+          gui = exePath;
+          break;
+        }
+        // "7zip.portable" ships 7zfm.exe, but "procexp" ships procexp.exe
+        std::string stem = LowerAscii(StemOf(entry.name));
+        if (matching.empty() && (stem == LowerAscii(id) || stem == LowerAscii(id.substr(0, id.find('.'))))) {
+          matching = exePath;
+        }
+        // Packages often carry their own installer next to the app
+        if (first.empty() && !LooksLikeInstaller(entry.name)) first = exePath;
+      }
+    }
+
+    std::string exePath = !gui.empty() ? gui : !matching.empty() ? matching : first;
+    if (exePath.empty()) continue;  // Installer packages: found by the registry scan
+    apps->push_back({ "choco_" + id, title.empty() ? id : title, exePath, "" });
+  }
+}
+
+void ScanWingetPortables(RegistryBackend& registry, FileSystemBackend& fileSystem,
+                         std::vector<DiscoveredApp>* apps) {
+  // Portable installs register per user by default, which the HKLM-only
+  // uninstall scan never sees
+  const RegistryRoot roots[] = { RegistryRoot::CurrentUser, RegistryRoot::LocalMachine };
+  for (RegistryRoot root : roots) {
+    std::vector<std::string> subKeyNames;
+    if (registry.EnumerateSubKeys(root, kUninstallKey, &subKeyNames) != BackendStatus::Ok) continue;
+
+    for (const std::string& subKeyName : subKeyNames) {
+      std::string subKey = std::string(kUninstallKey) + "\\" + subKeyName;
+      std::vector<RegistryValue> values;
+      if (registry.ReadValues(root, subKey, &values) != BackendStatus::Ok) continue;
+      std::string target = FindRegistryValue(values, "PortableTargetFullPath");
+      if (target.empty() || !fileSystem.Exists(target)) continue;
+      std::string displayName = FindRegistryValue(values, "DisplayName");
+      std::string packageId = FindRegistryValue(values, "WinGetPackageIdentifier");
+
+      apps->push_back({ "winget_" + (packageId.empty() ? subKeyName : packageId),
+                        displayName.empty() ? StemOf(FileNameOf(target)) : displayName, target, "" });
+    }
+  }
+}
+
+std::string DecodeXmlEntities(const std::string& text) {
+  std::string decoded;
+  decoded.reserve(text.size());
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] != '&') {
+      decoded += text[i];
+      continue;
+    }
+    size_t end = text.find(';', i);
+    if (end == std::string::npos || end - i > 10) {
+      decoded += text[i];
+      continue;
+    }
+    std::string entity = text.substr(i + 1, end - i - 1);
+    if (entity == "amp") decoded += '&';
+    else if (entity == "lt") decoded += '<';
+    else if (entity == "gt") decoded += '>';
+    else if (entity == "quot") decoded += '"';
+    else if (entity == "apos") decoded += '\'';
+    else if (entity.size() > 1 && entity[0] == '#') {
+      // Numeric references are rare in nuspec names; ASCII is enough
+      long code = entity[1] == 'x' ? strtol(entity.c_str() + 2, nullptr, 16) : strtol(entity.c_str() + 1, nullptr, 10);
+      if (code > 0 && code < 0x80) decoded += (char)code;
+    } else {
+      decoded += text.substr(i, end - i + 1);
+    }
+    i = end;
+  }
+  return decoded;
+}
+
+}  // namespace
+
+std::string ReadXmlElementText(const std::string& xml, const std::string& name) {
+  std::string open = "<" + name;
+  for (size_t pos = xml.find(open); pos != std::string::npos; pos = xml.find(open, pos + 1)) {
+    // "<id>" or "<id attr=...>", not "<identity>"
+    char next = pos + open.size() < xml.size() ? xml[pos + open.size()] : '\0';
+    if (next != '>' && next != ' ' && next != '\t' && next != '\r' && next != '\n') continue;
+    size_t start = xml.find('>', pos);
+    if (start == std::string::npos || xml[start - 1] == '/') return "";
+    size_t end = xml.find("</" + name, start);
+    if (end == std::string::npos) return "";
+
+    std::string text = DecodeXmlEntities(xml.substr(start + 1, end - start - 1));
+    size_t first = text.find_first_not_of(" \t\r\n");
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return first == std::string::npos ? "" : text.substr(first, last - first + 1);
+  }
+  return "";
+}
+
+void ScanPackageManagers(FileSystemBackend& fileSystem, RegistryBackend& registry,
+                         const PackageManagerRoots& roots, std::vector<DiscoveredApp>* apps) {
+  for (const std::string& root : roots.scoop) {
+    ScanScoopRoot(fileSystem, root, apps);
+  }
+  for (const std::string& root : roots.chocolatey) {
+    ScanChocolateyRoot(fileSystem, root, apps);
+  }
+  if (roots.winget) {
+    ScanWingetPortables(registry, fileSystem, apps);
+  }
+}
+
+namespace {
+
+bool ReadRootList(const Napi::Value& value, std::vector<std::string>* roots) {
+  if (value.IsUndefined()) return true;
+  if (!value.IsArray()) return false;
+  Napi::Array array = value.As<Napi::Array>();
+  roots->clear();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value root = array.Get(i);
+    if (!root.IsString()) return false;
+    roots->push_back(root.As<Napi::String>().Utf8Value());
+  }
+  return true;
+}
+
+}  // namespace
+
+// ScanPackageManagerApps: Find Scoop, Chocolatey and winget portable apps from
+// their manifests. With filesystem/registry fixtures the scan runs against
+// fake backends, which works on any platform.
+Napi::Value ScanPackageManagerApps(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* usage = "Expected (options?: { roots?: { scoop?: string[], chocolatey?: string[], winget?: boolean }, filesystem?, registry? })";
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  Napi::Value filesystem = options.Get("filesystem");
+  Napi::Value registry = options.Get("registry");
+  bool useFixtures = !filesystem.IsUndefined() || !registry.IsUndefined();
+
+  PackageManagerRoots roots;
+#ifdef _WIN32
+  if (!useFixtures) roots = DefaultPackageManagerRoots();
+#endif
+  Napi::Value rootOptions = options.Get("roots");
+  if (rootOptions.IsObject()) {
+    Napi::Object object = rootOptions.As<Napi::Object>();
+    Napi::Value winget = object.Get("winget");
+    if (!ReadRootList(object.Get("scoop"), &roots.scoop) ||
+        !ReadRootList(object.Get("chocolatey"), &roots.chocolatey) ||
+        (!winget.IsUndefined() && !winget.IsBoolean())) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    if (winget.IsBoolean()) roots.winget = winget.As<Napi::Boolean>().Value();
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  std::vector<DiscoveredApp> apps;
+
+  if (useFixtures) {
+    FakeFileSystem fakeFileSystem;
+    FakeRegistry fakeRegistry;
+    std::string error;
+    if (!ReadFakeFileSystem(filesystem, &fakeFileSystem, &error) ||
+        !ReadFakeRegistry(registry, &fakeRegistry, &error)) {
+      Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    ScanPackageManagers(fakeFileSystem, fakeRegistry, roots, &apps);
+  } else {
+#ifdef _WIN32
+    ScanPackageManagers(CachedLiveFileSystem(), LiveRegistry(), roots, &apps);
+#else
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("apps", Napi::Array::New(env));
+    result.Set("error", Napi::String::New(env, "Live package-manager scans need Windows; pass filesystem/registry fixtures"));
+    return result;
+#endif
+  }
+
+  result.Set("success", Napi::Boolean::New(env, true));
+  result.Set("apps", AppsToNapi(env, apps));
+  return result;
+}
@@ -0,0 +1,36 @@
+#ifndef PACKAGE_MANAGER_SCAN_H
+#define PACKAGE_MANAGER_SCAN_H
+
+#include <napi.h>
+#include <string>
+#include <vector>
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+
+// Apps installed by Scoop, Chocolatey and winget (portable installs), found
+// from each package manager's own records instead of walking directories:
+//   Scoop:      <root>\apps\<app>\current\manifest.json shortcuts, else bin
+//   Chocolatey: <root>\lib\<id>\<id>.nuspec for the name, exe shims under tools
+//   winget:     PortableTargetFullPath in HKCU/HKLM uninstall entries
+
+struct PackageManagerRoots {
+  std::vector<std::string> scoop;       // Scoop roots (user and global)
+  std::vector<std::string> chocolatey;  // Chocolatey install roots
+  bool winget = true;
+};
+
+void ScanPackageManagers(FileSystemBackend& fileSystem, RegistryBackend& registry,
+                         const PackageManagerRoots& roots, std::vector<DiscoveredApp>* apps);
+
+// Text of the first <name> element in an XML document, entities decoded;
+// enough for the flat <metadata> block of a .nuspec
+std::string ReadXmlElementText(const std::string& xml, const std::string& name);
+
+// %SCOOP% or ~\scoop, %SCOOP_GLOBAL% or %ProgramData%\scoop, and
+// %ChocolateyInstall% or %ProgramData%\chocolatey (Windows only, app-discovery.cc)
+PackageManagerRoots DefaultPackageManagerRoots();
+
+// Function declarations for package-manager discovery
+Napi::Value ScanPackageManagerApps(const Napi::CallbackInfo& info);
+
+#endif
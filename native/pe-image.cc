@@ -0,0 +1,76 @@
+#include "pe-image.h"
+
+namespace {
+
+constexpr uint16_t kDosMagic = 0x5A4D;            // "MZ"
+constexpr uint32_t kPeSignature = 0x00004550;     // "PE\0\0"
+constexpr uint16_t kOptionalMagic32 = 0x10B;
+constexpr uint16_t kOptionalMagic64 = 0x20B;
+constexpr uint16_t kFileDll = 0x2000;             // IMAGE_FILE_DLL
+constexpr uint32_t kSecurityDirectory = 4;        // IMAGE_DIRECTORY_ENTRY_SECURITY
+
+// PE fields are little-endian regardless of the host
+uint16_t ReadU16(const std::string& bytes, size_t offset) {
+  return (uint16_t)((uint8_t)bytes[offset] | ((uint8_t)bytes[offset + 1] << 8));
+}
+
+uint32_t ReadU32(const std::string& bytes, size_t offset) {
+  return (uint32_t)ReadU16(bytes, offset) | ((uint32_t)ReadU16(bytes, offset + 2) << 16);
+}
+
+}  // namespace
+
+bool ParsePeHeaders(const std::string& bytes, PeImageInfo* info) {
+  if (bytes.size() < 0x40 || ReadU16(bytes, 0) != kDosMagic) return false;
+
+  // COFF file header follows the signature; the optional header follows that
+  size_t peOffset = ReadU32(bytes, 0x3C);
+  size_t optionalOffset = peOffset + 24;
+  if (peOffset > bytes.size() || optionalOffset + 70 > bytes.size()) return false;
+  if (ReadU32(bytes, peOffset) != kPeSignature) return false;
+
+  info->machine = ReadU16(bytes, peOffset + 4);
+  info->characteristics = ReadU16(bytes, peOffset + 22);
+  size_t optionalSize = ReadU16(bytes, peOffset + 20);
+
+  uint16_t magic = ReadU16(bytes, optionalOffset);
+  if (magic != kOptionalMagic32 && magic != kOptionalMagic64) return false;
+  info->is64Bit = magic == kOptionalMagic64;
+  info->subsystem = (PeSubsystem)ReadU16(bytes, optionalOffset + 68);
+
+  // Data directories sit after the fixed fields, which are 16 bytes longer
+  // in PE32+; the security entry holds a file offset, not an RVA
+  size_t countOffset = optionalOffset + (info->is64Bit ? 108 : 92);
+  size_t directoryOffset = countOffset + 4 + kSecurityDirectory * 8;
+  if (directoryOffset + 8 <= bytes.size() && directoryOffset + 8 <= optionalOffset + optionalSize &&
+      ReadU32(bytes, countOffset) > kSecurityDirectory) {
+    info->certificateOffset = ReadU32(bytes, directoryOffset);
+    info->certificateSize = ReadU32(bytes, directoryOffset + 4);
+  }
+  return true;
+}
+
+bool IsGuiExecutable(const PeImageInfo& info) {
+  return info.subsystem == PeSubsystem::WindowsGui && (info.characteristics & kFileDll) == 0;
+}
+
+const char* PeMachineName(uint16_t machine) {
+  switch (machine) {
+    case 0x014C: return "x86";
+    case 0x8664: return "x64";
+    case 0xAA64: return "arm64";
+    case 0x01C4: return "arm";
+    case 0x0200: return "ia64";
+  }
+  return "unknown";
+}
+
+const char* PeSubsystemName(PeSubsystem subsystem) {
+  switch (subsystem) {
+    case PeSubsystem::WindowsGui: return "gui";
+    case PeSubsystem::WindowsConsole: return "console";
+    case PeSubsystem::Native: return "native";
+    case PeSubsystem::Unknown: break;
+  }
+  return "unknown";
+}
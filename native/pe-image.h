@@ -0,0 +1,41 @@
+#ifndef PE_IMAGE_H
+#define PE_IMAGE_H
+
+#include <cstdint>
+#include <string>
+
+// Just enough of the PE/COFF headers to classify an executable without
+// loading it. Parsed from the first kPeHeaderBytes of the file, so callers
+// read a single small prefix through FileSystemBackend::ReadFile.
+
+constexpr size_t kPeHeaderBytes = 4096;
+
+enum class PeSubsystem : uint16_t {
+  Unknown = 0,
+  Native = 1,
+  WindowsGui = 2,
+  WindowsConsole = 3
+};
+
+struct PeImageInfo {
+  uint16_t machine = 0;           // IMAGE_FILE_MACHINE_*
+  uint16_t characteristics = 0;   // IMAGE_FILE_*
+  bool is64Bit = false;           // PE32+ optional header
+  PeSubsystem subsystem = PeSubsystem::Unknown;
+  uint32_t certificateOffset = 0; // Security data directory (file offset)
+  uint32_t certificateSize = 0;
+};
+
+// False when the bytes are not a PE image or the headers run past them
+bool ParsePeHeaders(const std::string& bytes, PeImageInfo* info);
+
+// A PE that runs as a windowed app: GUI subsystem and not a DLL
+bool IsGuiExecutable(const PeImageInfo& info);
+
+// "x86", "x64", "arm64", ... or "unknown"
+const char* PeMachineName(uint16_t machine);
+
+// "gui", "console", "native" or "unknown"
+const char* PeSubsystemName(PeSubsystem subsystem);
+
+#endif
@@ -0,0 +1,424 @@
+#include <napi.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <tlhelp32.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#endif
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <unordered_set>
+#include "executor.h"
+#include "process-priority.h"
+
+namespace {
+
+struct PriorityOptions {
+  bool includeChildren = true;
+  std::vector<uint32_t> cores;  // Background only; empty leaves affinity unrestricted
+};
+
+struct ApplyStats {
+  uint32_t processes = 0;
+  uint32_t failed = 0;
+  std::string error;            // First failure, for reporting
+
+  void Fail(uint32_t processId, const std::string& message) {
+    failed++;
+    if (error.empty()) error = "Process " + std::to_string(processId) + ": " + message;
+  }
+};
+
+#ifdef _WIN32
+
+// Helper function to get last error as string
+std::string GetLastErrorString() {
+  DWORD error = GetLastError();
+  if (error == 0) return "";
+
+  LPSTR messageBuffer = nullptr;
+  size_t size = FormatMessageA(
+    FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+    NULL, error, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&messageBuffer, 0, NULL);
+
+  std::string message(messageBuffer, size);
+  LocalFree(messageBuffer);
+  return message;
+}
+
+uint64_t ProcessCreationTime(uint32_t processId) {
+  HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+  if (hProcess == NULL) return 0;
+  FILETIME creation, exit, kernel, user;
+  uint64_t createdAt = 0;
+  if (GetProcessTimes(hProcess, &creation, &exit, &kernel, &user)) {
+    createdAt = ((uint64_t)creation.dwHighDateTime << 32) | creation.dwLowDateTime;
+  }
+  CloseHandle(hProcess);
+  return createdAt;
+}
+
+bool SnapshotProcesses(std::vector<ProcessEntry>* processes) {
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+  if (snapshot == INVALID_HANDLE_VALUE) return false;
+
+  PROCESSENTRY32W entry = {};
+  entry.dwSize = sizeof(entry);
+  if (Process32FirstW(snapshot, &entry)) {
+    do {
+      ProcessEntry process;
+      process.processId = entry.th32ProcessID;
+      process.parentId = entry.th32ParentProcessID;
+      processes->push_back(process);
+    } while (Process32NextW(snapshot, &entry));
+  }
+  CloseHandle(snapshot);
+
+  // The snapshot has no creation times; a process that exits in between
+  // keeps 0 and drops out of the tree
+  for (ProcessEntry& process : *processes) {
+    process.createdAt = ProcessCreationTime(process.processId);
+  }
+  return true;
+}
+
+// Background mode (PROCESS_MODE_BACKGROUND_BEGIN) only applies to the calling
+// process, so another process's I/O and paging are demoted through its
+// priority class, memory priority and, where the SDK has it, EcoQoS
+void ApplyToProcess(uint32_t processId, PriorityMode mode, const PriorityOptions& options,
+                    ApplyStats* stats) {
+  HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION | PROCESS_QUERY_LIMITED_INFORMATION,
+                                FALSE, processId);
+  if (hProcess == NULL) {
+    stats->Fail(processId, GetLastErrorString());
+    return;
+  }
+
+  bool foreground = mode == PriorityMode::Foreground;
+  bool ok = true;
+
+  if (!SetPriorityClass(hProcess, foreground ? ABOVE_NORMAL_PRIORITY_CLASS : BELOW_NORMAL_PRIORITY_CLASS)) {
+    stats->Fail(processId, GetLastErrorString());
+    ok = false;
+  }
+
+  MEMORY_PRIORITY_INFORMATION memoryPriority = {};
+  memoryPriority.MemoryPriority = foreground ? MEMORY_PRIORITY_NORMAL : MEMORY_PRIORITY_BELOW_NORMAL;
+  SetProcessInformation(hProcess, ProcessMemoryPriority, &memoryPriority, sizeof(memoryPriority));
+
+#ifdef PROCESS_POWER_THROTTLING_CURRENT_VERSION
+  PROCESS_POWER_THROTTLING_STATE throttling = {};
+  throttling.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+  throttling.ControlMask = PROCESS_POWER_THROTTLING_EXECUTION_SPEED;
+  throttling.StateMask = foreground ? 0 : PROCESS_POWER_THROTTLING_EXECUTION_SPEED;
+  SetProcessInformation(hProcess, ProcessPowerThrottling, &throttling, sizeof(throttling));
+#endif
+
+  // Foreground restores every core the system offers; background confines
+  // to the requested cores that exist, or leaves affinity alone if none do
+  DWORD_PTR processMask = 0;
+  DWORD_PTR systemMask = 0;
+  if (GetProcessAffinityMask(hProcess, &processMask, &systemMask)) {
+    DWORD_PTR target = systemMask;
+    if (!foreground) {
+      DWORD_PTR requested = 0;
+      for (uint32_t core : options.cores) {
+        if (core < sizeof(DWORD_PTR) * 8) requested |= (DWORD_PTR)1 << core;
+      }
+      if (requested & systemMask) target = requested & systemMask;
+    }
+    if (target != processMask && !SetProcessAffinityMask(hProcess, target) && ok) {
+      stats->Fail(processId, GetLastErrorString());
+      ok = false;
+    }
+  }
+
+  CloseHandle(hProcess);
+  if (ok) stats->processes++;
+}
+
+#elif defined(__linux__)
+
+constexpr int kForegroundNice = -5;
+constexpr int kBackgroundNice = 10;
+
+// <linux/ioprio.h> is not shipped by every libc
+constexpr int kIoprioWhoProcess = 1;
+constexpr int kIoprioClassShift = 13;
+constexpr int kIoprioClassBestEffort = 2;
+constexpr int kIoprioClassIdle = 3;
+constexpr int kIoprioNormalLevel = 4;
+
+bool ParseProcessId(const char* name, uint32_t* processId) {
+  if (!*name) return false;
+  uint32_t value = 0;
+  for (const char* c = name; *c; c++) {
+    if (*c < '0' || *c > '9') return false;
+    value = value * 10 + (uint32_t)(*c - '0');
+  }
+  *processId = value;
+  return true;
+}
+
+std::vector<uint32_t> ListNumericEntries(const std::string& path) {
+  std::vector<uint32_t> ids;
+  DIR* dir = opendir(path.c_str());
+  if (!dir) return ids;
+  while (dirent* entry = readdir(dir)) {
+    uint32_t id;
+    if (ParseProcessId(entry->d_name, &id)) ids.push_back(id);
+  }
+  closedir(dir);
+  return ids;
+}
+
+bool SnapshotProcesses(std::vector<ProcessEntry>* processes) {
+  std::vector<uint32_t> processIds = ListNumericEntries("/proc");
+  if (processIds.empty()) return false;
+
+  for (uint32_t processId : processIds) {
+    // "pid (comm) state ppid ... starttime ..." where comm may itself
+    // contain ") "; starttime is field 22, the 20th after comm
+    std::ifstream stat("/proc/" + std::to_string(processId) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) continue;
+    size_t close = line.rfind(')');
+    if (close == std::string::npos) continue;
+    unsigned long parentId = 0;
+    unsigned long long startTime = 0;
+    char state = 0;
+    if (sscanf(line.c_str() + close + 1,
+               " %c %lu %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %llu",
+               &state, &parentId, &startTime) == 3) {
+      ProcessEntry process;
+      process.processId = processId;
+      process.parentId = (uint32_t)parentId;
+      process.createdAt = startTime;
+      processes->push_back(process);
+    }
+  }
+  return true;
+}
+
+// nice, I/O priority and affinity are per-thread on Linux, so every task of
+// the process is updated. Raising priority needs CAP_SYS_NICE or RLIMIT_NICE
+// headroom; without it the foreground boost falls back to the default nice,
+// and a thread demoted earlier stays demoted and is reported as failed.
+void ApplyToProcess(uint32_t processId, PriorityMode mode, const PriorityOptions& options,
+                    ApplyStats* stats) {
+  std::vector<uint32_t> threadIds = ListNumericEntries("/proc/" + std::to_string(processId) + "/task");
+  if (threadIds.empty()) {
+    stats->Fail(processId, "Process not found");
+    return;
+  }
+
+  bool foreground = mode == PriorityMode::Foreground;
+  int ioprio = foreground
+    ? (kIoprioClassBestEffort << kIoprioClassShift) | kIoprioNormalLevel
+    : (kIoprioClassIdle << kIoprioClassShift);
+
+  // Foreground restores the cores this process may use; background
+  // intersects that with the requested cores
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  sched_getaffinity(0, sizeof(allowed), &allowed);
+  cpu_set_t target = allowed;
+  if (!foreground && !options.cores.empty()) {
+    cpu_set_t requested;
+    CPU_ZERO(&requested);
+    for (uint32_t core : options.cores) {
+      if (core < CPU_SETSIZE && CPU_ISSET(core, &allowed)) CPU_SET(core, &requested);
+    }
+    if (CPU_COUNT(&requested) > 0) target = requested;
+  }
+
+  bool ok = true;
+  for (uint32_t threadId : threadIds) {
+    int nice = foreground ? kForegroundNice : kBackgroundNice;
+    if (setpriority(PRIO_PROCESS, threadId, nice) != 0 && errno != ESRCH) {
+      bool fellBack = foreground && (errno == EPERM || errno == EACCES) &&
+                      setpriority(PRIO_PROCESS, threadId, 0) == 0;
+      if (!fellBack && ok) {
+        stats->Fail(processId, std::string("setpriority: ") + strerror(errno));
+        ok = false;
+      }
+    }
+    if (syscall(SYS_ioprio_set, kIoprioWhoProcess, (int)threadId, ioprio) != 0 && ok && errno != ESRCH) {
+      stats->Fail(processId, std::string("ioprio_set: ") + strerror(errno));
+      ok = false;
+    }
+    if (sched_setaffinity((pid_t)threadId, sizeof(target), &target) != 0 && ok && errno != ESRCH) {
+      stats->Fail(processId, std::string("sched_setaffinity: ") + strerror(errno));
+      ok = false;
+    }
+  }
+
+  if (ok) stats->processes++;
+}
+
+#endif
+
+bool ReadOptions(const Napi::Value& value, PriorityOptions* options, std::string* error) {
+  if (value.IsUndefined() || value.IsNull()) return true;
+  if (!value.IsObject()) {
+    *error = "options must be an object";
+    return false;
+  }
+  Napi::Object object = value.As<Napi::Object>();
+
+  Napi::Value includeChildren = object.Get("includeChildren");
+  if (includeChildren.IsBoolean()) options->includeChildren = includeChildren.As<Napi::Boolean>().Value();
+
+  Napi::Value cores = object.Get("cores");
+  if (cores.IsUndefined() || cores.IsNull()) return true;
+  if (!cores.IsArray()) {
+    *error = "cores must be an array of core indices";
+    return false;
+  }
+  Napi::Array array = cores.As<Napi::Array>();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value core = array.Get(i);
+    if (!core.IsNumber()) {
+      *error = "cores must be an array of core indices";
+      return false;
+    }
+    options->cores.push_back(core.As<Napi::Number>().Uint32Value());
+  }
+  return true;
+}
+
+#if defined(_WIN32) || defined(__linux__)
+// Snapshots the tree and applies the policy on the executor, off the JS
+// thread
+class PriorityWorker : public ExecutorWorker {
+ public:
+  PriorityWorker(Napi::Env env, uint32_t processId, PriorityMode mode, PriorityOptions options)
+    : ExecutorWorker(env, TaskLane::Background),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      processId_(processId),
+      mode_(mode),
+      options_(std::move(options)) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    std::vector<uint32_t> tree = { processId_ };
+    std::vector<ProcessEntry> processes;
+    if (options_.includeChildren && SnapshotProcesses(&processes)) {
+      tree = ProcessTreeOf(processId_, processes);
+    }
+    for (uint32_t member : tree) {
+      ApplyToProcess(member, mode_, options_, &stats_);
+    }
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, stats_.failed == 0));
+    result.Set("processes", Napi::Number::New(env, stats_.processes));
+    result.Set("failed", Napi::Number::New(env, stats_.failed));
+    if (!stats_.error.empty()) {
+      result.Set("error", Napi::String::New(env, stats_.error));
+    }
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  uint32_t processId_;
+  PriorityMode mode_;
+  PriorityOptions options_;
+  ApplyStats stats_;
+};
+#endif
+
+}  // namespace
+
+std::vector<uint32_t> ProcessTreeOf(uint32_t rootProcessId, const std::vector<ProcessEntry>& processes) {
+  std::vector<uint32_t> tree = { rootProcessId };
+  auto root = std::find_if(processes.begin(), processes.end(),
+                           [&](const ProcessEntry& process) { return process.processId == rootProcessId; });
+  if (root == processes.end() || root->createdAt == 0) return tree;
+
+  std::unordered_set<uint32_t> visited = { rootProcessId };
+  std::queue<const ProcessEntry*> pending;
+  pending.push(&*root);
+
+  // Snapshots are small (hundreds of processes), so a scan per level is fine.
+  // Creation order rejects processes whose recorded parent was an earlier
+  // holder of the pid; the visited set guards against cycles regardless.
+  // Creation clocks are coarse, so a child may share its parent's tick.
+  while (!pending.empty()) {
+    const ProcessEntry* parent = pending.front();
+    pending.pop();
+    for (const ProcessEntry& entry : processes) {
+      if (entry.parentId == parent->processId && entry.createdAt != 0 &&
+          entry.createdAt >= parent->createdAt && visited.insert(entry.processId).second) {
+        tree.push_back(entry.processId);
+        pending.push(&entry);
+      }
+    }
+  }
+  return tree;
+}
+
+// SetProcessPriority: Boost or demote a tab's process tree. The snapshot
+// walks every process, so it runs on the background lane; resolves
+// { success, processes, failed, error? }.
+Napi::Value SetProcessPriority(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Expected (processId: number, mode: 'foreground' | 'background', options?: { includeChildren, cores })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t processId = info[0].As<Napi::Number>().Uint32Value();
+  std::string modeName = info[1].As<Napi::String>().Utf8Value();
+  PriorityMode mode;
+  if (modeName == "foreground") {
+    mode = PriorityMode::Foreground;
+  } else if (modeName == "background") {
+    mode = PriorityMode::Background;
+  } else {
+    Napi::TypeError::New(env, "mode must be 'foreground' or 'background'").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  PriorityOptions options;
+  std::string error;
+  if (!ReadOptions(info.Length() > 2 ? info[2] : env.Undefined(), &options, &error)) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#if defined(_WIN32) || defined(__linux__)
+  auto* worker = new PriorityWorker(env, processId, mode, std::move(options));
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+#else
+  (void)processId;
+  (void)mode;
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, false));
+  result.Set("processes", Napi::Number::New(env, 0));
+  result.Set("failed", Napi::Number::New(env, 0));
+  result.Set("error", Napi::String::New(env, "Process priority is not supported on this platform"));
+  deferred.Resolve(result);
+  return deferred.Promise();
+#endif
+}
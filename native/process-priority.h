@@ -0,0 +1,34 @@
+#ifndef PROCESS_PRIORITY_H
+#define PROCESS_PRIORITY_H
+
+#include <napi.h>
+#include <cstdint>
+#include <vector>
+
+// Scheduling policy for the process tree behind an embedded tab. The visible
+// tab is boosted; hidden tabs are demoted (CPU, I/O and memory priority where
+// the platform allows it) and optionally confined to a subset of cores.
+
+enum class PriorityMode {
+  Foreground,
+  Background
+};
+
+struct ProcessEntry {
+  uint32_t processId = 0;
+  uint32_t parentId = 0;
+  uint64_t createdAt = 0;  // Platform ticks (FILETIME, or clock ticks since boot); 0 if unknown
+};
+
+// Root process plus every descendant, breadth-first, from a process
+// snapshot. Tabs launch through launchers and helpers, so the window's own
+// process is rarely the only one doing work. A recorded parent id can
+// outlive the parent and be reused, so a process only counts as a child if
+// it was created no earlier than its parent; unknown creation times exclude
+// the process.
+std::vector<uint32_t> ProcessTreeOf(uint32_t rootProcessId, const std::vector<ProcessEntry>& processes);
+
+// Function declarations for the tab priority policy
+Napi::Value SetProcessPriority(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include "roaring-bitmap.h"
+
+namespace {
+
+bool TestBit(const std::vector<uint64_t>& bits, uint16_t low) {
+  return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+uint32_t CountBits(const std::vector<uint64_t>& bits) {
+  uint32_t count = 0;
+  for (uint64_t word : bits) count += (uint32_t)std::popcount(word);
+  return count;
+}
+
+}  // namespace
+
+RoaringBitmap RoaringBitmap::Range(uint32_t count) {
+  RoaringBitmap range;
+  for (uint64_t begin = 0; begin < count; begin += 65536) {
+    Container container;
+    container.key = (uint16_t)(begin >> 16);
+    container.cardinality = (uint32_t)std::min<uint64_t>(count - begin, 65536);
+    if (container.cardinality <= kMaxArrayCardinality) {
+      container.array.resize(container.cardinality);
+      for (uint32_t i = 0; i < container.cardinality; i++) container.array[i] = (uint16_t)i;
+    } else {
+      container.bits.assign(kBitmapWords, 0);
+      uint32_t fullWords = container.cardinality / 64;
+      std::fill(container.bits.begin(), container.bits.begin() + fullWords, ~0ull);
+      if (container.cardinality % 64) container.bits[fullWords] = (1ull << (container.cardinality % 64)) - 1;
+    }
+    range.containers_.push_back(std::move(container));
+  }
+  return range;
+}
+
+void RoaringBitmap::Add(uint32_t id) {
+  uint16_t key = (uint16_t)(id >> 16);
+  uint16_t low = (uint16_t)id;
+  // Ids usually arrive in ascending order, so check the last chunk first
+  auto it = !containers_.empty() && containers_.back().key == key
+    ? containers_.end() - 1
+    : std::lower_bound(containers_.begin(), containers_.end(), key,
+                       [](const Container& container, uint16_t k) { return container.key < k; });
+  if (it == containers_.end() || it->key != key) {
+    Container container;
+    container.key = key;
+    it = containers_.insert(it, std::move(container));
+  }
+
+  if (it->IsBitmap()) {
+    if (TestBit(it->bits, low)) return;
+    it->bits[low >> 6] |= 1ull << (low & 63);
+  } else {
+    auto position = it->array.empty() || it->array.back() < low
+      ? it->array.end()
+      : std::lower_bound(it->array.begin(), it->array.end(), low);
+    if (position != it->array.end() && *position == low) return;
+    it->array.insert(position, low);
+  }
+  it->cardinality++;
+  Normalize(&*it);
+}
+
+bool RoaringBitmap::Contains(uint32_t id) const {
+  uint16_t key = (uint16_t)(id >> 16);
+  auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                             [](const Container& container, uint16_t k) { return container.key < k; });
+  if (it == containers_.end() || it->key != key) return false;
+  if (it->IsBitmap()) return TestBit(it->bits, (uint16_t)id);
+  return std::binary_search(it->array.begin(), it->array.end(), (uint16_t)id);
+}
+
+uint64_t RoaringBitmap::Cardinality() const {
+  uint64_t count = 0;
+  for (const Container& container : containers_) count += container.cardinality;
+  return count;
+}
+
+size_t RoaringBitmap::SizeInBytes() const {
+  size_t bytes = sizeof(*this) + containers_.capacity() * sizeof(Container);
+  for (const Container& container : containers_) {
+    bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+void RoaringBitmap::ToVector(std::vector<uint32_t>* ids, uint64_t offset, uint64_t limit) const {
+  for (const Container& container : containers_) {
+    if (limit == 0) return;
+    // Whole chunks before offset are skipped by count
+    if (offset >= container.cardinality) {
+      offset -= container.cardinality;
+      continue;
+    }
+    uint32_t high = (uint32_t)container.key << 16;
+    auto emit = [&](uint16_t low) {
+      if (offset > 0) {
+        offset--;
+      } else if (limit > 0) {
+        ids->push_back(high | low);
+        limit--;
+      }
+    };
+    if (container.IsBitmap()) {
+      for (size_t word = 0; word < kBitmapWords && limit > 0; word++) {
+        for (uint64_t bits = container.bits[word]; bits != 0 && limit > 0; bits &= bits - 1) {
+          emit((uint16_t)(word * 64 + std::countr_zero(bits)));
+        }
+      }
+    } else {
+      for (size_t i = 0; i < container.array.size() && limit > 0; i++) emit(container.array[i]);
+    }
+  }
+}
+
+RoaringBitmap RoaringBitmap::And(const RoaringBitmap& a, const RoaringBitmap& b) {
+  RoaringBitmap result;
+  size_t i = 0, j = 0;
+  while (i < a.containers_.size() && j < b.containers_.size()) {
+    if (a.containers_[i].key < b.containers_[j].key) {
+      i++;
+    } else if (b.containers_[j].key < a.containers_[i].key) {
+      j++;
+    } else {
+      Container container = Intersect(a.containers_[i++], b.containers_[j++]);
+      if (container.cardinality > 0) result.containers_.push_back(std::move(container));
+    }
+  }
+  return result;
+}
+
+RoaringBitmap RoaringBitmap::Or(const RoaringBitmap& a, const RoaringBitmap& b) {
+  RoaringBitmap result;
+  size_t i = 0, j = 0;
+  while (i < a.containers_.size() || j < b.containers_.size()) {
+    if (j == b.containers_.size() || (i < a.containers_.size() && a.containers_[i].key < b.containers_[j].key)) {
+      result.containers_.push_back(a.containers_[i++]);
+    } else if (i == a.containers_.size() || b.containers_[j].key < a.containers_[i].key) {
+      result.containers_.push_back(b.containers_[j++]);
+    } else {
+      result.containers_.push_back(Union(a.containers_[i++], b.containers_[j++]));
+    }
+  }
+  return result;
+}
+
+RoaringBitmap RoaringBitmap::AndNot(const RoaringBitmap& a, const RoaringBitmap& b) {
+  RoaringBitmap result;
+  size_t j = 0;
+  for (const Container& container : a.containers_) {
+    while (j < b.containers_.size() && b.containers_[j].key < container.key) j++;
+    if (j == b.containers_.size() || b.containers_[j].key != container.key) {
+      result.containers_.push_back(container);
+      continue;
+    }
+    Container difference = Difference(container, b.containers_[j]);
+    if (difference.cardinality > 0) result.containers_.push_back(std::move(difference));
+  }
+  return result;
+}
+
+uint64_t RoaringBitmap::AndCardinality(const RoaringBitmap& a, const RoaringBitmap& b) {
+  uint64_t count = 0;
+  size_t i = 0, j = 0;
+  while (i < a.containers_.size() && j < b.containers_.size()) {
+    if (a.containers_[i].key < b.containers_[j].key) {
+      i++;
+    } else if (b.containers_[j].key < a.containers_[i].key) {
+      j++;
+    } else {
+      count += IntersectCount(a.containers_[i++], b.containers_[j++]);
+    }
+  }
+  return count;
+}
+
+void RoaringBitmap::ToBitmap(Container* container) {
+  if (container->IsBitmap()) return;
+  container->bits.assign(kBitmapWords, 0);
+  for (uint16_t low : container->array) container->bits[low >> 6] |= 1ull << (low & 63);
+  container->array.clear();
+  container->array.shrink_to_fit();
+}
+
+void RoaringBitmap::Normalize(Container* container) {
+  if (container->IsBitmap() && container->cardinality <= kMaxArrayCardinality) {
+    container->array.clear();
+    container->array.reserve(container->cardinality);
+    for (size_t word = 0; word < kBitmapWords; word++) {
+      for (uint64_t bits = container->bits[word]; bits != 0; bits &= bits - 1) {
+        container->array.push_back((uint16_t)(word * 64 + std::countr_zero(bits)));
+      }
+    }
+    container->bits.clear();
+    container->bits.shrink_to_fit();
+  } else if (!container->IsBitmap() && container->cardinality > kMaxArrayCardinality) {
+    ToBitmap(container);
+  }
+}
+
+RoaringBitmap::Container RoaringBitmap::Intersect(const Container& a, const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (a.IsBitmap() && b.IsBitmap()) {
+    result.bits.resize(kBitmapWords);
+    for (size_t word = 0; word < kBitmapWords; word++) result.bits[word] = a.bits[word] & b.bits[word];
+    result.cardinality = CountBits(result.bits);
+    Normalize(&result);
+  } else if (a.IsBitmap() || b.IsBitmap()) {
+    const Container& sparse = a.IsBitmap() ? b : a;
+    const Container& dense = a.IsBitmap() ? a : b;
+    for (uint16_t low : sparse.array) {
+      if (TestBit(dense.bits, low)) result.array.push_back(low);
+    }
+    result.cardinality = (uint32_t)result.array.size();
+  } else {
+    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                          std::back_inserter(result.array));
+    result.cardinality = (uint32_t)result.array.size();
+  }
+  return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::Union(const Container& a, const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (!a.IsBitmap() && !b.IsBitmap()) {
+    std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                   std::back_inserter(result.array));
+    result.cardinality = (uint32_t)result.array.size();
+    Normalize(&result);
+    return result;
+  }
+
+  result = a.IsBitmap() ? a : b;
+  const Container& other = a.IsBitmap() ? b : a;
+  if (other.IsBitmap()) {
+    for (size_t word = 0; word < kBitmapWords; word++) result.bits[word] |= other.bits[word];
+  } else {
+    for (uint16_t low : other.array) result.bits[low >> 6] |= 1ull << (low & 63);
+  }
+  result.cardinality = CountBits(result.bits);
+  return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::Difference(const Container& a, const Container& b) {
+  Container result;
+  result.key = a.key;
+  if (!a.IsBitmap()) {
+    if (b.IsBitmap()) {
+      for (uint16_t low : a.array) {
+        if (!TestBit(b.bits, low)) result.array.push_back(low);
+      }
+    } else {
+      std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                          std::back_inserter(result.array));
+    }
+    result.cardinality = (uint32_t)result.array.size();
+    return result;
+  }
+
+  result.bits = a.bits;
+  if (b.IsBitmap()) {
+    for (size_t word = 0; word < kBitmapWords; word++) result.bits[word] &= ~b.bits[word];
+  } else {
+    for (uint16_t low : b.array) result.bits[low >> 6] &= ~(1ull << (low & 63));
+  }
+  result.cardinality = CountBits(result.bits);
+  Normalize(&result);
+  return result;
+}
+
+uint32_t RoaringBitmap::IntersectCount(const Container& a, const Container& b) {
+  uint32_t count = 0;
+  if (a.IsBitmap() && b.IsBitmap()) {
+    for (size_t word = 0; word < kBitmapWords; word++) count += (uint32_t)std::popcount(a.bits[word] & b.bits[word]);
+  } else if (a.IsBitmap() || b.IsBitmap()) {
+    const Container& sparse = a.IsBitmap() ? b : a;
+    const Container& dense = a.IsBitmap() ? a : b;
+    for (uint16_t low : sparse.array) count += TestBit(dense.bits, low) ? 1 : 0;
+  } else {
+    size_t i = 0, j = 0;
+    while (i < a.array.size() && j < b.array.size()) {
+      if (a.array[i] < b.array[j]) {
+        i++;
+      } else if (b.array[j] < a.array[i]) {
+        j++;
+      } else {
+        count++;
+        i++;
+        j++;
+      }
+    }
+  }
+  return count;
+}
@@ -0,0 +1,58 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed set of 32-bit ids in the Roaring layout: ids are split by
+// their high 16 bits into chunks of up to 65536, and each chunk is stored
+// as a sorted array of low halves while sparse (at most 4096 ids, 8 KB) or
+// as a 65536-bit bitmap (also 8 KB) once dense. Set operations work chunk
+// by chunk, so their cost follows the size of the sets rather than of the
+// id space. No run containers: catalog ids are dense, so chunks go from
+// sparse arrays straight to bitmaps.
+class RoaringBitmap {
+ public:
+  // Ids 0..count-1
+  static RoaringBitmap Range(uint32_t count);
+
+  void Add(uint32_t id);
+  bool Contains(uint32_t id) const;
+  bool Empty() const { return containers_.empty(); }
+  uint64_t Cardinality() const;
+  size_t SizeInBytes() const;
+
+  // Ascending ids, skipping offset of them and stopping after limit
+  void ToVector(std::vector<uint32_t>* ids, uint64_t offset = 0, uint64_t limit = UINT64_MAX) const;
+
+  static RoaringBitmap And(const RoaringBitmap& a, const RoaringBitmap& b);
+  static RoaringBitmap Or(const RoaringBitmap& a, const RoaringBitmap& b);
+  static RoaringBitmap AndNot(const RoaringBitmap& a, const RoaringBitmap& b);
+  // Cardinality(And(a, b)) without building the intersection
+  static uint64_t AndCardinality(const RoaringBitmap& a, const RoaringBitmap& b);
+
+ private:
+  static constexpr size_t kMaxArrayCardinality = 4096;
+  static constexpr size_t kBitmapWords = 65536 / 64;
+
+  struct Container {
+    uint16_t key = 0;               // High 16 bits of every id in it
+    uint32_t cardinality = 0;
+    std::vector<uint16_t> array;    // Sorted low halves, while sparse
+    std::vector<uint64_t> bits;     // kBitmapWords words, once dense
+
+    bool IsBitmap() const { return !bits.empty(); }
+  };
+
+  static void Normalize(Container* container);
+  static void ToBitmap(Container* container);
+  static Container Intersect(const Container& a, const Container& b);
+  static Container Union(const Container& a, const Container& b);
+  static Container Difference(const Container& a, const Container& b);
+  static uint32_t IntersectCount(const Container& a, const Container& b);
+
+  std::vector<Container> containers_;  // Sorted by key; none empty
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include "sim-window-system.h"
+
+SimWindowSystem::SimWindow* SimWindowSystem::Find(uint64_t handle) {
+  auto it = windows_.find(handle);
+  return it == windows_.end() ? nullptr : &it->second;
+}
+
+WindowOpStatus SimWindowSystem::Fail() {
+  counters_.failedCalls++;
+  return WindowOpStatus::InvalidWindow;
+}
+
+bool SimWindowSystem::InjectFault(const char* op, WindowOpStatus* status) {
+  if (!faults_) return false;
+  BackendStatus injected = faults_->Inject(std::string("window:") + op);
+  if (injected == BackendStatus::Ok) return false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  counters_.failedCalls++;
+  *status = injected == BackendStatus::Timeout ? WindowOpStatus::Hung : WindowOpStatus::Failed;
+  return true;
+}
+
+void SimWindowSystem::Apply(const TraceRecord& record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (record.type == TraceEventType::WindowCreate) {
+    SimWindow& window = windows_[record.handle];
+    window = SimWindow();
+    window.info.handle = record.handle;
+    window.info.processId = record.processId;
+    window.info.className = record.className;
+    window.info.title = record.text;
+    ApplyTraceFlags(record.flags, &window.info);
+    order_.push_back(record.handle);
+    return;
+  }
+
+  SimWindow* window = Find(record.handle);
+  if (!window) return;
+
+  switch (record.type) {
+    case TraceEventType::WindowShow:
+      window->info.visible = true;
+      break;
+    case TraceEventType::WindowHide:
+      window->info.visible = false;
+      break;
+    case TraceEventType::WindowTitle:
+      window->info.title = record.text;
+      break;
+    case TraceEventType::WindowReparent:
+      window->embeddedIn = record.parent;
+      window->info.hasParent = record.parent != 0;
+      break;
+    case TraceEventType::WindowStyle: {
+      bool visible = window->info.visible;
+      ApplyTraceFlags(record.flags, &window->info);
+      window->info.visible = visible;
+      break;
+    }
+    case TraceEventType::WindowDestroy:
+      windows_.erase(record.handle);
+      order_.erase(std::remove(order_.begin(), order_.end(), record.handle), order_.end());
+      break;
+    default:
+      break;
+  }
+}
+
+uint64_t SimWindowSystem::AddWindow(uint32_t processId, const std::string& className,
+                                    const std::string& title, bool visible) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t handle = nextHandle_;
+  nextHandle_ += 4;  // Real handles are multiples of four, too
+
+  SimWindow& window = windows_[handle];
+  window.info.handle = handle;
+  window.info.processId = processId;
+  window.info.className = className;
+  window.info.title = title;
+  window.info.visible = visible;
+  window.info.framed = true;
+  order_.push_back(handle);
+  return handle;
+}
+
+void SimWindowSystem::RemoveWindow(uint64_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (windows_.erase(handle)) {
+    order_.erase(std::remove(order_.begin(), order_.end(), handle), order_.end());
+  }
+}
+
+bool SimWindowSystem::Exists(uint64_t handle) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return windows_.count(handle) != 0;
+}
+
+std::vector<WindowCandidate> SimWindowSystem::EnumerateProcessWindows(uint32_t processId) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<WindowCandidate> result;
+  for (uint64_t handle : order_) {
+    const SimWindow& window = windows_.at(handle);
+    if (window.info.processId == processId && window.embeddedIn == 0) {
+      result.push_back(window.info);
+    }
+  }
+  return result;
+}
+
+WindowOpStatus SimWindowSystem::Embed(uint64_t handle, uint64_t parent, int32_t x, int32_t y,
+                                      int32_t width, int32_t height) {
+  WindowOpStatus injected;
+  if (InjectFault("embed", &injected)) return injected;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  SimWindow* window = Find(handle);
+  if (!window) return Fail();
+  counters_.reparentCalls++;
+  counters_.geometryCalls++;
+  window->embeddedIn = parent;
+  window->info.hasParent = true;
+  window->info.visible = true;
+  window->x = x;
+  window->y = y;
+  window->width = width;
+  window->height = height;
+  return WindowOpStatus::Ok;
+}
+
+WindowOpStatus SimWindowSystem::SetGeometry(uint64_t handle, int32_t x, int32_t y,
+                                            int32_t width, int32_t height) {
+  WindowOpStatus injected;
+  if (InjectFault("resize", &injected)) return injected;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  SimWindow* window = Find(handle);
+  if (!window) return Fail();
+  counters_.geometryCalls++;
+  window->x = x;
+  window->y = y;
+  window->width = width;
+  window->height = height;
+  window->info.visible = true;
+  return WindowOpStatus::Ok;
+}
+
+WindowOpStatus SimWindowSystem::Move(uint64_t handle, int32_t x, int32_t y) {
+  WindowOpStatus injected;
+  if (InjectFault("move", &injected)) return injected;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  SimWindow* window = Find(handle);
+  if (!window) return Fail();
+  counters_.geometryCalls++;
+  window->x = x;
+  window->y = y;
+  window->info.visible = true;
+  return WindowOpStatus::Ok;
+}
+
+WindowOpStatus SimWindowSystem::Show(uint64_t handle, bool show) {
+  WindowOpStatus injected;
+  if (InjectFault("show", &injected)) return injected;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  SimWindow* window = Find(handle);
+  if (!window) return Fail();
+  counters_.showCalls++;
+  window->info.visible = show;
+  return WindowOpStatus::Ok;
+}
+
+WindowOpStatus SimWindowSystem::Unparent(uint64_t handle) {
+  WindowOpStatus injected;
+  if (InjectFault("unparent", &injected)) return injected;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  SimWindow* window = Find(handle);
+  if (!window) return Fail();
+  counters_.reparentCalls++;
+  window->embeddedIn = 0;
+  window->info.hasParent = false;
+  return WindowOpStatus::Ok;
+}
+
+WindowOpStatus SimWindowSystem::ApplyOp(const TraceRecord& record) {
+  switch (record.op) {
+    case TraceWindowOp::Embed:
+      return Embed(record.handle, record.parent, record.x, record.y, record.width, record.height);
+    case TraceWindowOp::Resize:
+      return SetGeometry(record.handle, record.x, record.y, record.width, record.height);
+    case TraceWindowOp::Move:
+      return Move(record.handle, record.x, record.y);
+    case TraceWindowOp::Show:
+      return Show(record.handle, true);
+    case TraceWindowOp::Hide:
+      return Show(record.handle, false);
+    case TraceWindowOp::Unparent:
+      return Unparent(record.handle);
+  }
+  return WindowOpStatus::Failed;
+}
+
+SimWindowSystem::Counters SimWindowSystem::GetCounters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return counters_;
+}
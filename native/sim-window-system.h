@@ -0,0 +1,80 @@
+#ifndef SIM_WINDOW_SYSTEM_H
+#define SIM_WINDOW_SYSTEM_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fault-injection.h"
+#include "window-model.h"
+#include "window-ops.h"
+#include "window-trace.h"
+
+// In-memory stand-in for the desktop window manager. Trace replay drives it
+// instead of Win32 so window discovery and embed flows can be reproduced and
+// benchmarked deterministically on any platform. Thread-safe.
+class SimWindowSystem {
+ public:
+  struct Counters {
+    uint64_t geometryCalls = 0;
+    uint64_t reparentCalls = 0;
+    uint64_t showCalls = 0;
+    uint64_t failedCalls = 0;
+  };
+
+  // Route window calls through a fault injector, keyed "window:<op>" (embed,
+  // resize, move, show, unparent). Not owned; set before use.
+  void SetFaultInjector(FaultInjector* faults) { faults_ = faults; }
+
+  // Apply a recorded window event (create, show, title, reparent, destroy...)
+  void Apply(const TraceRecord& record);
+
+  // Create a synthetic top-level window and return its handle
+  uint64_t AddWindow(uint32_t processId, const std::string& className,
+                     const std::string& title, bool visible);
+  void RemoveWindow(uint64_t handle);
+  bool Exists(uint64_t handle) const;
+
+  // Top-level windows of a process in creation order, as EnumWindows would
+  // report them (windows reparented into the host are children, not listed)
+  std::vector<WindowCandidate> EnumerateProcessWindows(uint32_t processId) const;
+
+  // Operations mirroring the Win32 calls made by the window-ops thread
+  WindowOpStatus Embed(uint64_t handle, uint64_t parent, int32_t x, int32_t y,
+                       int32_t width, int32_t height);
+  WindowOpStatus SetGeometry(uint64_t handle, int32_t x, int32_t y, int32_t width, int32_t height);
+  WindowOpStatus Move(uint64_t handle, int32_t x, int32_t y);
+  WindowOpStatus Show(uint64_t handle, bool show);
+  WindowOpStatus Unparent(uint64_t handle);
+
+  // Re-issue a recorded TraceEventType::WindowOp
+  WindowOpStatus ApplyOp(const TraceRecord& record);
+
+  Counters GetCounters() const;
+
+ private:
+  struct SimWindow {
+    WindowCandidate info;
+    uint64_t embeddedIn = 0;  // Host window after SetParent, 0 if top-level
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+  };
+
+  // Caller holds mutex_
+  SimWindow* Find(uint64_t handle);
+  WindowOpStatus Fail();
+  // Not under mutex_: injected latency must not serialise other calls
+  bool InjectFault(const char* op, WindowOpStatus* status);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, SimWindow> windows_;
+  std::vector<uint64_t> order_;  // Creation order, for enumeration
+  uint64_t nextHandle_ = 0x10000;
+  Counters counters_;
+  FaultInjector* faults_ = nullptr;
+};
+
+#endif
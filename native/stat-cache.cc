@@ -0,0 +1,328 @@
+#include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fake-discovery-backend.h"
+#include "stat-cache.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Stats per executor task; large enough to amortize the task, small enough
+// that a slow drive does not hold up the other batches
+constexpr size_t kStatBatchSize = 32;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Each distinct path (case-insensitive) statted once, in parallel batches
+void StatBatch(FileSystemBackend& fileSystem, const std::vector<std::string>& paths, TaskLane lane,
+               std::vector<BackendStatus>* statuses, std::vector<DirEntry>* entries) {
+  std::unordered_map<std::string, size_t> indexByPath;
+  std::vector<size_t> distinct;  // Index into paths of each distinct path's first occurrence
+  std::vector<size_t> slot(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    auto inserted = indexByPath.emplace(LowerAscii(paths[i]), distinct.size());
+    if (inserted.second) distinct.push_back(i);
+    slot[i] = inserted.first->second;
+  }
+
+  std::vector<BackendStatus> distinctStatuses(distinct.size(), BackendStatus::NotFound);
+  std::vector<DirEntry> distinctEntries(distinct.size());
+  std::vector<std::function<void()>> tasks;
+  for (size_t begin = 0; begin < distinct.size(); begin += kStatBatchSize) {
+    size_t end = std::min(begin + kStatBatchSize, distinct.size());
+    tasks.push_back([&, begin, end]() {
+      for (size_t i = begin; i < end; i++) {
+        distinctStatuses[i] = fileSystem.Stat(paths[distinct[i]], &distinctEntries[i]);
+      }
+    });
+  }
+  RunParallel(std::move(tasks), lane);
+
+  statuses->resize(paths.size());
+  if (entries) entries->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    (*statuses)[i] = distinctStatuses[slot[i]];
+    if (entries) (*entries)[i] = distinctEntries[slot[i]];
+  }
+}
+
+Napi::Object StatCacheStatsToNapi(Napi::Env env, const StatCacheStats& stats) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("entries", Napi::Number::New(env, (double)stats.entries));
+  result.Set("hits", Napi::Number::New(env, (double)stats.hits));
+  result.Set("negativeHits", Napi::Number::New(env, (double)stats.negativeHits));
+  result.Set("probes", Napi::Number::New(env, (double)stats.probes));
+  result.Set("joinedProbes", Napi::Number::New(env, (double)stats.joinedProbes));
+  result.Set("seeded", Napi::Number::New(env, (double)stats.seeded));
+  return result;
+}
+
+// Stats paths on the executor through a stat cache: the shared live one, or
+// one over a fixture
+class StatPathsWorker : public ExecutorWorker {
+ public:
+  StatPathsWorker(Napi::Env env, std::vector<std::string> paths)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      paths_(std::move(paths)) {}
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    Napi::Value filesystem = options.Get("filesystem");
+    useFixtures_ = !filesystem.IsUndefined();
+    if (!useFixtures_) return true;
+    return ReadFakeFileSystem(filesystem, &fileSystem_, error);
+  }
+
+  bool UsesFixtures() const { return useFixtures_; }
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    Clock::time_point start = Clock::now();
+    if (useFixtures_) {
+      CachedStatFileSystem cached(fileSystem_);
+      StatBatch(cached, paths_, TaskLane::Normal, &statuses_, &entries_);
+      stats_ = cached.GetStats();
+    } else {
+#ifdef _WIN32
+      StatBatch(CachedLiveFileSystem(), paths_, TaskLane::Normal, &statuses_, &entries_);
+      stats_ = CachedLiveFileSystem().GetStats();
+#endif
+    }
+    elapsedMs_ = MillisecondsSince(start);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Array results = Napi::Array::New(env, paths_.size());
+    for (size_t i = 0; i < paths_.size(); i++) {
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("path", Napi::String::New(env, paths_[i]));
+      entry.Set("exists", Napi::Boolean::New(env, statuses_[i] == BackendStatus::Ok));
+      if (statuses_[i] == BackendStatus::Ok) {
+        entry.Set("isDirectory", Napi::Boolean::New(env, entries_[i].isDirectory));
+        entry.Set("size", Napi::Number::New(env, (double)entries_[i].size));
+        entry.Set("mtimeMs", Napi::Number::New(env, (double)entries_[i].mtimeMs));
+      } else if (statuses_[i] != BackendStatus::NotFound) {
+        // Exists is unknown rather than false
+        entry.Set("error", Napi::String::New(env, BackendStatusName(statuses_[i])));
+      }
+      results.Set((uint32_t)i, entry);
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("results", results);
+    result.Set("cache", StatCacheStatsToNapi(env, stats_));
+    result.Set("elapsedMs", Napi::Number::New(env, elapsedMs_));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::vector<std::string> paths_;
+  bool useFixtures_ = false;
+  FakeFileSystem fileSystem_;
+  std::vector<BackendStatus> statuses_;
+  std::vector<DirEntry> entries_;
+  StatCacheStats stats_;
+  double elapsedMs_ = 0;
+};
+
+}  // namespace
+
+BackendStatus CachedStatFileSystem::ListDirectory(const std::string& path, std::vector<DirEntry>* entries) {
+  BackendStatus status = inner_.ListDirectory(path, entries);
+  if (status != BackendStatus::Ok) return status;
+
+  // A listing is a fresh stat of every child: FindExePath lists the install
+  // folder and the validate stage then stats the exe it picked. Only exes
+  // are kept, so deep walks do not flush the cache with files never statted.
+  Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const DirEntry& entry : *entries) {
+    if (entry.isDirectory || !EndsWithNoCase(entry.name, ".exe")) continue;
+    StoreLocked(LowerAscii(JoinPath(path, entry.name)), BackendStatus::Ok, entry, now);
+    stats_.seeded++;
+  }
+  return status;
+}
+
+BackendStatus CachedStatFileSystem::Stat(const std::string& path, DirEntry* entry) {
+  std::string key = LowerAscii(path);
+  std::shared_ptr<Probe> probe;
+  bool owner = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto cached = cache_.find(key);
+    if (cached != cache_.end()) {
+      if (Clock::now() < cached->second.expires) {
+        stats_.hits++;
+        if (cached->second.status == BackendStatus::NotFound) stats_.negativeHits++;
+        *entry = cached->second.entry;
+        return cached->second.status;
+      }
+      cache_.erase(cached);
+    }
+    auto inFlight = inFlight_.find(key);
+    if (inFlight != inFlight_.end()) {
+      probe = inFlight->second;
+      stats_.joinedProbes++;
+    } else {
+      probe = std::make_shared<Probe>();
+      inFlight_.emplace(key, probe);
+      owner = true;
+      stats_.probes++;
+    }
+  }
+
+  if (owner) {
+    DirEntry result;
+    BackendStatus status = inner_.Stat(path, &result);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Errors are transient (a locked file, a drive waking up), and scans
+      // compare directory mtimes to spot changes, so only files and
+      // not-found are remembered
+      if ((status == BackendStatus::Ok && !result.isDirectory) || status == BackendStatus::NotFound) {
+        StoreLocked(key, status, result, Clock::now());
+      }
+      probe->status = status;
+      probe->entry = result;
+      probe->done = true;
+      inFlight_.erase(key);
+    }
+    probeDone_.notify_all();
+  } else {
+    std::unique_lock<std::mutex> lock(mutex_);
+    probeDone_.wait(lock, [&probe]() { return probe->done; });
+  }
+
+  *entry = probe->entry;
+  return probe->status;
+}
+
+BackendStatus CachedStatFileSystem::ReadFile(const std::string& path, size_t maxBytes, std::string* contents) {
+  return inner_.ReadFile(path, maxBytes, contents);
+}
+
+BackendStatus CachedStatFileSystem::ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                                               std::string* contents) {
+  return inner_.ReadFileAt(path, offset, maxBytes, contents);
+}
+
+BackendStatus CachedStatFileSystem::Identify(const std::string& path, FileIdentity* identity) {
+  return inner_.Identify(path, identity);
+}
+
+void CachedStatFileSystem::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+}
+
+StatCacheStats CachedStatFileSystem::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  StatCacheStats stats = stats_;
+  stats.entries = cache_.size();
+  return stats;
+}
+
+void CachedStatFileSystem::StoreLocked(const std::string& key, BackendStatus status, const DirEntry& entry,
+                                       Clock::time_point now) {
+  if (cache_.size() >= options_.maxEntries && cache_.find(key) == cache_.end()) {
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      it = now < it->second.expires ? std::next(it) : cache_.erase(it);
+    }
+    // Still full of live entries: start over rather than track recency
+    if (cache_.size() >= options_.maxEntries) cache_.clear();
+  }
+  uint32_t ttlMs = status == BackendStatus::Ok ? options_.positiveTtlMs : options_.negativeTtlMs;
+  CachedStat& cached = cache_[key];
+  cached.status = status;
+  cached.entry = entry;
+  cached.expires = now + std::chrono::milliseconds(ttlMs);
+}
+
+void ExistsBatch(FileSystemBackend& fileSystem, const std::vector<std::string>& paths, TaskLane lane,
+                 std::vector<char>* exists) {
+  std::vector<BackendStatus> statuses;
+  StatBatch(fileSystem, paths, lane, &statuses, nullptr);
+  exists->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) (*exists)[i] = statuses[i] == BackendStatus::Ok ? 1 : 0;
+}
+
+#ifdef _WIN32
+CachedStatFileSystem& CachedLiveFileSystem() {
+  static CachedStatFileSystem* fileSystem = new CachedStatFileSystem(LiveFileSystem());
+  return *fileSystem;
+}
+#endif
+
+// StatPaths: Stat many paths concurrently through the shared stat cache.
+// Resolves { success, results: [{ path, exists, isDirectory?, size?,
+// mtimeMs?, error? }], cache, elapsedMs }.
+Napi::Value StatPaths(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const char* usage = "Expected (paths: string[], options?: { filesystem?: object })";
+
+  if (info.Length() < 1 || !info[0].IsArray() ||
+      (info.Length() > 1 && !info[1].IsObject() && !info[1].IsUndefined())) {
+    Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Array array = info[0].As<Napi::Array>();
+  std::vector<std::string> paths;
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value value = array.Get(i);
+    if (!value.IsString()) {
+      Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    paths.push_back(value.As<Napi::String>().Utf8Value());
+  }
+  Napi::Object options = info.Length() > 1 && info[1].IsObject()
+    ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+
+  auto* worker = new StatPathsWorker(env, std::move(paths));
+  std::string error;
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifndef _WIN32
+  if (!worker->UsesFixtures()) {
+    delete worker;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("error", Napi::String::New(env, "Live stats need Windows; pass a filesystem fixture"));
+    deferred.Resolve(result);
+    return deferred.Promise();
+  }
+#endif
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
+
+// GetStatCacheStats: Counters of the shared live stat cache
+Napi::Value GetStatCacheStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+#ifdef _WIN32
+  return StatCacheStatsToNapi(env, CachedLiveFileSystem().GetStats());
+#else
+  return StatCacheStatsToNapi(env, StatCacheStats());
+#endif
+}
@@ -0,0 +1,97 @@
+#ifndef STAT_CACHE_H
+#define STAT_CACHE_H
+
+#include <napi.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "discovery-backend.h"
+#include "executor.h"
+
+// Discovery stats the same exes many times: the uninstall scan's
+// UninstallString fallback, the validate stage, registered-app lookups,
+// catalog imports and the next rescan. On cold caches or roaming drives each
+// probe can take milliseconds, so this backend answers Stat from a shared
+// cache and sends each path to the inner backend at most once at a time:
+// concurrent callers for a path wait on the probe already in flight.
+// Found files and not-found paths are kept for separate TTLs; directories
+// (whose mtimes scans compare) and errors such as access denied or a timeout
+// are not cached. Listings seed found entries for the exes in them.
+// Thread-safe.
+
+struct StatCacheOptions {
+  uint32_t positiveTtlMs = 10 * 60 * 1000;
+  uint32_t negativeTtlMs = 2 * 60 * 1000;  // Installs make missing files appear
+  size_t maxEntries = 65536;
+};
+
+struct StatCacheStats {
+  size_t entries = 0;
+  uint64_t hits = 0;
+  uint64_t negativeHits = 0;   // Hits that answered NotFound
+  uint64_t probes = 0;         // Stats sent to the inner backend
+  uint64_t joinedProbes = 0;   // Callers that waited on another's probe
+  uint64_t seeded = 0;         // Exe entries added from listings
+};
+
+class CachedStatFileSystem : public FileSystemBackend {
+ public:
+  explicit CachedStatFileSystem(FileSystemBackend& inner, StatCacheOptions options = StatCacheOptions())
+    : inner_(inner), options_(options) {}
+
+  BackendStatus ListDirectory(const std::string& path, std::vector<DirEntry>* entries) override;
+  BackendStatus Stat(const std::string& path, DirEntry* entry) override;
+  BackendStatus ReadFile(const std::string& path, size_t maxBytes, std::string* contents) override;
+  BackendStatus ReadFileAt(const std::string& path, uint64_t offset, size_t maxBytes,
+                           std::string* contents) override;
+  BackendStatus Identify(const std::string& path, FileIdentity* identity) override;
+
+  void Clear();
+  StatCacheStats GetStats();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct CachedStat {
+    BackendStatus status = BackendStatus::Ok;
+    DirEntry entry;
+    Clock::time_point expires;
+  };
+
+  struct Probe {
+    bool done = false;
+    BackendStatus status = BackendStatus::Ok;
+    DirEntry entry;
+  };
+
+  // Caller holds mutex_
+  void StoreLocked(const std::string& key, BackendStatus status, const DirEntry& entry, Clock::time_point now);
+
+  FileSystemBackend& inner_;
+  StatCacheOptions options_;
+  std::mutex mutex_;
+  std::condition_variable probeDone_;
+  std::unordered_map<std::string, CachedStat> cache_;                // Lowercased path -> result
+  std::unordered_map<std::string, std::shared_ptr<Probe>> inFlight_;  // Lowercased path -> probe
+  StatCacheStats stats_;
+};
+
+// Existence of every path, checked concurrently in batches on the executor.
+// Duplicates are checked once. exists[i] is 1 when paths[i] exists.
+void ExistsBatch(FileSystemBackend& fileSystem, const std::vector<std::string>& paths, TaskLane lane,
+                 std::vector<char>* exists);
+
+// LiveFileSystem() behind a shared stat cache; what live discovery scans use
+// (Windows only)
+CachedStatFileSystem& CachedLiveFileSystem();
+
+// Function declarations for the batch stat service
+Napi::Value StatPaths(const Napi::CallbackInfo& info);
+Napi::Value GetStatCacheStats(const Napi::CallbackInfo& info);
+
+#endif
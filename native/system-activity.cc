@@ -0,0 +1,150 @@
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <dlfcn.h>
+#include <fstream>
+#include <mutex>
+#include <string>
+#endif
+#include "system-activity.h"
+
+namespace {
+
+#ifdef _WIN32
+
+uint64_t FileTimeToTicks(const FILETIME& time) {
+  return ((uint64_t)time.dwHighDateTime << 32) | time.dwLowDateTime;
+}
+
+#elif defined(__linux__)
+
+// Layout of XScreenSaverInfo from <X11/extensions/scrnsaver.h>. libX11 and
+// libXss are opened at runtime so the addon neither links nor requires them.
+struct XssInfo {
+  unsigned long window;
+  int state;
+  int kind;
+  unsigned long tilOrSince;
+  unsigned long idle;
+  unsigned long eventMask;
+};
+
+typedef void* (*XOpenDisplayFn)(const char*);
+typedef unsigned long (*XDefaultRootWindowFn)(void*);
+typedef XssInfo* (*XssAllocInfoFn)();
+typedef int (*XssQueryInfoFn)(void*, unsigned long, XssInfo*);
+
+// One display connection, only used under mutex
+struct X11Idle {
+  std::mutex mutex;
+  bool loaded = false;
+  void* display = nullptr;
+  unsigned long root = 0;
+  XssInfo* info = nullptr;
+  XssQueryInfoFn queryInfo = nullptr;
+
+  // Caller holds mutex
+  bool Load() {
+    if (loaded) return display != nullptr;
+    loaded = true;
+
+    void* x11 = dlopen("libX11.so.6", RTLD_LAZY | RTLD_LOCAL);
+    void* xss = dlopen("libXss.so.1", RTLD_LAZY | RTLD_LOCAL);
+    if (!x11 || !xss) return false;
+
+    auto openDisplay = (XOpenDisplayFn)dlsym(x11, "XOpenDisplay");
+    auto defaultRoot = (XDefaultRootWindowFn)dlsym(x11, "XDefaultRootWindow");
+    auto allocInfo = (XssAllocInfoFn)dlsym(xss, "XScreenSaverAllocInfo");
+    queryInfo = (XssQueryInfoFn)dlsym(xss, "XScreenSaverQueryInfo");
+    if (!openDisplay || !defaultRoot || !allocInfo || !queryInfo) return false;
+
+    void* opened = openDisplay(nullptr);
+    if (!opened) return false;
+    info = allocInfo();
+    if (!info) return false;
+    root = defaultRoot(opened);
+    display = opened;
+    return true;
+  }
+};
+
+// Leaked: queried from the idle scheduler thread until process exit
+X11Idle* g_x11 = new X11Idle();
+
+#endif
+
+}  // namespace
+
+bool QueryInputIdleMs(uint64_t* idleMs) {
+#ifdef _WIN32
+  LASTINPUTINFO lastInput = {};
+  lastInput.cbSize = sizeof(lastInput);
+  if (!GetLastInputInfo(&lastInput)) return false;
+  // Both are 32-bit tick counts; unsigned subtraction handles the 49-day wrap
+  *idleMs = (DWORD)(GetTickCount() - lastInput.dwTime);
+  return true;
+#elif defined(__linux__)
+  std::lock_guard<std::mutex> lock(g_x11->mutex);
+  if (!g_x11->Load()) return false;
+  if (!g_x11->queryInfo(g_x11->display, g_x11->root, g_x11->info)) return false;
+  *idleMs = g_x11->info->idle;
+  return true;
+#else
+  (void)idleMs;
+  return false;
+#endif
+}
+
+InputIdleSource GetInputIdleSource() {
+  uint64_t ignored;
+  if (!QueryInputIdleMs(&ignored)) return InputIdleSource::Unavailable;
+#ifdef _WIN32
+  return InputIdleSource::Win32;
+#else
+  return InputIdleSource::X11;
+#endif
+}
+
+const char* InputIdleSourceName(InputIdleSource source) {
+  switch (source) {
+    case InputIdleSource::Unavailable: return "unavailable";
+    case InputIdleSource::Win32: return "win32";
+    case InputIdleSource::X11: return "x11";
+  }
+  return "unavailable";
+}
+
+bool CpuLoadSampler::Sample(double* busyFraction) {
+  uint64_t busy = 0;
+  uint64_t total = 0;
+
+#ifdef _WIN32
+  FILETIME idleTime, kernelTime, userTime;
+  if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) return false;
+  // Kernel time includes idle time
+  total = FileTimeToTicks(kernelTime) + FileTimeToTicks(userTime);
+  busy = total - FileTimeToTicks(idleTime);
+#elif defined(__linux__)
+  // cpu  user nice system idle iowait irq softirq steal ...
+  std::ifstream stat("/proc/stat");
+  std::string label;
+  uint64_t values[8] = {};
+  if (!(stat >> label) || label != "cpu") return false;
+  for (uint64_t& value : values) {
+    if (!(stat >> value)) break;
+  }
+  for (uint64_t value : values) total += value;
+  busy = total - values[3] - values[4];
+#else
+  return false;
+#endif
+
+  bool ready = primed_ && total > lastTotal_ && busy >= lastBusy_;
+  if (ready) {
+    *busyFraction = (double)(busy - lastBusy_) / (double)(total - lastTotal_);
+  }
+  lastBusy_ = busy;
+  lastTotal_ = total;
+  primed_ = true;
+  return ready;
+}
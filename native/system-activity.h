@@ -0,0 +1,33 @@
+#ifndef SYSTEM_ACTIVITY_H
+#define SYSTEM_ACTIVITY_H
+
+#include <cstdint>
+
+// User input idleness and CPU load, used to decide when background work may
+// run. Both are cheap enough to query between individual filesystem calls.
+
+enum class InputIdleSource {
+  Unavailable,
+  Win32,   // GetLastInputInfo
+  X11      // MIT-SCREEN-SAVER extension, loaded at runtime
+};
+
+// Milliseconds since the last keyboard/mouse input in the user's session.
+// Returns false when no source is available (e.g. Wayland without X).
+bool QueryInputIdleMs(uint64_t* idleMs);
+InputIdleSource GetInputIdleSource();
+const char* InputIdleSourceName(InputIdleSource source);
+
+// System-wide CPU busy fraction (0..1) between consecutive samples
+class CpuLoadSampler {
+ public:
+  // Returns false until two samples exist or when counters are unavailable
+  bool Sample(double* busyFraction);
+
+ private:
+  uint64_t lastBusy_ = 0;
+  uint64_t lastTotal_ = 0;
+  bool primed_ = false;
+};
+
+#endif
@@ -0,0 +1,313 @@
+#include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "executor.h"
+#include "fake-discovery-backend.h"
+#include "user-assist.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr size_t kWin7RecordBytes = 72;
+constexpr size_t kXpRecordBytes = 16;
+constexpr uint32_t kXpCountBase = 5;  // XP counts start at 5
+
+// 100ns intervals between 1601-01-01 and 1970-01-01
+constexpr uint64_t kFileTimeUnixEpoch = 116444736000000000ULL;
+
+// Known folders UserAssist writes in place of a path prefix, as catalog
+// tokens. Library folders (Desktop, Downloads) assume the default location
+// under the profile.
+struct KnownFolder {
+  const char* guid;
+  const char* folder;
+};
+
+const KnownFolder kKnownFolders[] = {
+  { "{6D809377-6AF0-444B-8957-A3773F02200E}", "%ProgramFiles%" },            // ProgramFilesX64
+  { "{905E63B6-C1BF-494E-B29C-65B732D3D21A}", "%ProgramFiles%" },            // ProgramFiles
+  { "{7C5A40EF-A0FB-4BFC-874A-C0F2E0B9FA8E}", "%ProgramFiles(x86)%" },       // ProgramFilesX86
+  { "{F7F1ED05-9F6D-47A2-AAAE-29D317C6F066}", "%ProgramFiles%\\Common Files" },
+  { "{DE974D24-D9C6-4D3E-BF91-F4455120B917}", "%ProgramFiles(x86)%\\Common Files" },
+  { "{1AC14E77-02E7-4E5D-B744-2EB1AE5198B7}", "%SystemRoot%\\System32" },    // System
+  { "{D65231B0-B2F1-4857-A4CE-A8E7C6EA7D27}", "%SystemRoot%\\SysWOW64" },    // SystemX86
+  { "{F38BF404-1D43-42F2-9305-67DE0B28FC23}", "%SystemRoot%" },              // Windows
+  { "{62AB5D82-FDC1-4DC3-A9DD-070D1D495D97}", "%ProgramData%" },
+  { "{F1B32785-6FBA-4FCF-9D55-7B8E7F157091}", "%LOCALAPPDATA%" },
+  { "{3EB685DB-65F9-4CF6-A03A-E3EF65729F3D}", "%APPDATA%" },
+  { "{5E6C858F-0E22-4760-9AFE-EA3317B67173}", "%USERPROFILE%" },
+  { "{B4BFCC3A-DB2C-424C-B029-7FE99A87C641}", "%USERPROFILE%\\Desktop" },
+  { "{374DE290-123F-4565-9164-39C4925E467B}", "%USERPROFILE%\\Downloads" },
+  { "{FDD39AD0-238F-46AF-ADB4-6C85480369C7}", "%USERPROFILE%\\Documents" },
+};
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint32_t ReadU32(const std::string& bytes, size_t offset) {
+  return (uint32_t)(uint8_t)bytes[offset] | ((uint32_t)(uint8_t)bytes[offset + 1] << 8) |
+         ((uint32_t)(uint8_t)bytes[offset + 2] << 16) | ((uint32_t)(uint8_t)bytes[offset + 3] << 24);
+}
+
+int64_t FileTimeToUnixMs(const std::string& bytes, size_t offset) {
+  uint64_t ticks = (uint64_t)ReadU32(bytes, offset) | ((uint64_t)ReadU32(bytes, offset + 4) << 32);
+  if (ticks < kFileTimeUnixEpoch) return 0;
+  return (int64_t)((ticks - kFileTimeUnixEpoch) / 10000);
+}
+
+bool IsAbsolutePath(const std::string& path) {
+  return (path.size() > 2 && path[1] == ':' && (path[2] == '\\' || path[2] == '/')) ||
+         path.compare(0, 2, "\\\\") == 0;
+}
+
+// Reads UserAssist on the executor: the live HKCU, or a registry fixture.
+// With catalog paths, keeps the entries that name one and reports its row.
+class UserAssistWorker : public ExecutorWorker {
+ public:
+  UserAssistWorker(Napi::Env env, CatalogRoots roots)
+    : ExecutorWorker(env, TaskLane::Background),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      roots_(std::move(roots)) {}
+
+  // Populate from options on the JS thread; returns false with error set
+  bool Configure(const Napi::Object& options, std::string* error) {
+    Napi::Value paths = options.Get("paths");
+    if (!paths.IsUndefined()) {
+      if (!paths.IsArray()) {
+        *error = "paths must be an array of catalog exe paths";
+        return false;
+      }
+      matchPaths_ = true;
+      Napi::Array array = paths.As<Napi::Array>();
+      for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value path = array.Get(i);
+        if (path.IsString()) rowByPath_.emplace(LowerAscii(path.As<Napi::String>().Utf8Value()), i);
+      }
+    }
+
+    Napi::Value registry = options.Get("registry");
+    useFixtures_ = !registry.IsUndefined();
+    if (!useFixtures_) return true;
+    return ReadFakeRegistry(registry, &registry_, error);
+  }
+
+  bool UsesFixtures() const { return useFixtures_; }
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    Clock::time_point start = Clock::now();
+    if (useFixtures_) {
+      status_ = ReadUserAssist(registry_, roots_, &entries_, &skipped_);
+    } else {
+#ifdef _WIN32
+      status_ = ReadUserAssist(LiveRegistry(), roots_, &entries_, &skipped_);
+#endif
+    }
+
+    if (matchPaths_) {
+      std::vector<UserAssistEntry> matched;
+      for (UserAssistEntry& entry : entries_) {
+        auto it = rowByPath_.find(LowerAscii(entry.path));
+        if (it == rowByPath_.end()) {
+          unmatched_++;
+          continue;
+        }
+        rows_.push_back(it->second);
+        matched.push_back(std::move(entry));
+      }
+      entries_ = std::move(matched);
+    }
+    elapsedMs_ = MillisecondsSince(start);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    // No UserAssist key just means no history yet
+    if (status_ != BackendStatus::Ok && status_ != BackendStatus::NotFound) {
+      result.Set("success", Napi::Boolean::New(env, false));
+      result.Set("error", Napi::String::New(env, std::string("UserAssist read failed: ") + BackendStatusName(status_)));
+      deferred_.Resolve(result);
+      return;
+    }
+
+    Napi::Array entries = Napi::Array::New(env, entries_.size());
+    for (size_t i = 0; i < entries_.size(); i++) {
+      const UserAssistEntry& entry = entries_[i];
+      Napi::Object item = Napi::Object::New(env);
+      item.Set("path", Napi::String::New(env, entry.path));
+      item.Set("runCount", Napi::Number::New(env, entry.runCount));
+      item.Set("focusCount", Napi::Number::New(env, entry.focusCount));
+      item.Set("focusMs", Napi::Number::New(env, (double)entry.focusMs));
+      item.Set("lastRunMs", Napi::Number::New(env, (double)entry.lastRunMs));
+      if (matchPaths_) item.Set("row", Napi::Number::New(env, rows_[i]));
+      entries.Set((uint32_t)i, item);
+    }
+
+    result.Set("success", Napi::Boolean::New(env, true));
+    result.Set("entries", entries);
+    result.Set("skipped", Napi::Number::New(env, (double)skipped_));
+    if (matchPaths_) result.Set("unmatched", Napi::Number::New(env, (double)unmatched_));
+    result.Set("elapsedMs", Napi::Number::New(env, elapsedMs_));
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  CatalogRoots roots_;
+  bool matchPaths_ = false;
+  std::unordered_map<std::string, uint32_t> rowByPath_;  // Lowercased path -> first row
+  bool useFixtures_ = false;
+  FakeRegistry registry_;
+  BackendStatus status_ = BackendStatus::Ok;
+  std::vector<UserAssistEntry> entries_;
+  std::vector<uint32_t> rows_;
+  size_t skipped_ = 0;
+  size_t unmatched_ = 0;
+  double elapsedMs_ = 0;
+};
+
+}  // namespace
+
+std::string Rot13(const std::string& text) {
+  std::string decoded = text;
+  for (char& c : decoded) {
+    if (c >= 'a' && c <= 'z') {
+      c = (char)('a' + (c - 'a' + 13) % 26);
+    } else if (c >= 'A' && c <= 'Z') {
+      c = (char)('A' + (c - 'A' + 13) % 26);
+    }
+  }
+  return decoded;
+}
+
+bool ParseUserAssistCounters(const std::string& data, UserAssistEntry* entry) {
+  if (data.size() >= kWin7RecordBytes) {
+    entry->runCount = ReadU32(data, 4);
+    entry->focusCount = ReadU32(data, 8);
+    entry->focusMs = ReadU32(data, 12);
+    entry->lastRunMs = FileTimeToUnixMs(data, 60);
+    return true;
+  }
+  if (data.size() == kXpRecordBytes) {
+    uint32_t count = ReadU32(data, 4);
+    entry->runCount = count > kXpCountBase ? count - kXpCountBase : 0;
+    entry->lastRunMs = FileTimeToUnixMs(data, 8);
+    return true;
+  }
+  return false;
+}
+
+bool ExpandUserAssistPath(const std::string& name, const CatalogRoots& roots, std::string* path) {
+  if (!EndsWithNoCase(name, ".exe")) return false;
+
+  std::string candidate = name;
+  if (!name.empty() && name[0] == '{') {
+    size_t close = name.find('}');
+    if (close == std::string::npos) return false;
+    std::string guid = LowerAscii(name.substr(0, close + 1));
+    const char* folder = nullptr;
+    for (const KnownFolder& known : kKnownFolders) {
+      if (LowerAscii(known.guid) == guid) folder = known.folder;
+    }
+    if (!folder) return false;
+    candidate = folder + name.substr(close + 1);
+  }
+  return ExpandCatalogPath(candidate, roots, path) && IsAbsolutePath(*path);
+}
+
+BackendStatus ReadUserAssist(RegistryBackend& registry, const CatalogRoots& roots,
+                             std::vector<UserAssistEntry>* entries, size_t* skipped) {
+  std::vector<std::string> guids;
+  BackendStatus status = registry.EnumerateSubKeys(RegistryRoot::CurrentUser, kUserAssistKey, &guids);
+  if (status != BackendStatus::Ok) return status;
+
+  std::unordered_map<std::string, size_t> indexByPath;
+  for (const std::string& guid : guids) {
+    std::vector<RegistryValue> values;
+    std::string countKey = std::string(kUserAssistKey) + "\\" + guid + "\\Count";
+    if (registry.ReadBinaryValues(RegistryRoot::CurrentUser, countKey, &values) != BackendStatus::Ok) continue;
+
+    for (const RegistryValue& value : values) {
+      UserAssistEntry entry;
+      if (!ExpandUserAssistPath(Rot13(value.name), roots, &entry.path) ||
+          !ParseUserAssistCounters(value.data, &entry) ||
+          (entry.runCount == 0 && entry.focusCount == 0)) {
+        (*skipped)++;
+        continue;
+      }
+
+      // An exe started both directly and through a shortcut appears once
+      // per GUID
+      auto inserted = indexByPath.emplace(LowerAscii(entry.path), entries->size());
+      if (inserted.second) {
+        entries->push_back(std::move(entry));
+        continue;
+      }
+      UserAssistEntry& merged = (*entries)[inserted.first->second];
+      merged.runCount += entry.runCount;
+      merged.focusCount += entry.focusCount;
+      merged.focusMs += entry.focusMs;
+      merged.lastRunMs = std::max(merged.lastRunMs, entry.lastRunMs);
+    }
+  }
+
+  std::sort(entries->begin(), entries->end(), [](const UserAssistEntry& a, const UserAssistEntry& b) {
+    if (a.runCount != b.runCount) return a.runCount > b.runCount;
+    return a.lastRunMs > b.lastRunMs;
+  });
+  return BackendStatus::Ok;
+}
+
+// ReadUserAssistHistory: Decode Explorer's UserAssist launch history for
+// seeding the launch ranking. With paths (the catalog's exe paths) only
+// entries naming one are returned, each with its row. Resolves { success,
+// entries: [{ path, runCount, focusCount, focusMs, lastRunMs, row? }],
+// skipped, unmatched?, elapsedMs }.
+Napi::Value ReadUserAssistHistory(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { paths?: string[], roots?, registry? })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  Napi::Object options = info.Length() > 0 && info[0].IsObject()
+    ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+  CatalogRoots roots;
+  std::string error;
+  if (!ReadCatalogRoots(options.Get("roots"), &roots, &error)) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto* worker = new UserAssistWorker(env, std::move(roots));
+  if (!worker->Configure(options, &error)) {
+    delete worker;
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+#ifndef _WIN32
+  if (!worker->UsesFixtures()) {
+    delete worker;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, false));
+    result.Set("error", Napi::String::New(env, "Live UserAssist reads need Windows; pass a registry fixture"));
+    deferred.Resolve(result);
+    return deferred.Promise();
+  }
+#endif
+
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
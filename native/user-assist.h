@@ -0,0 +1,49 @@
+#ifndef USER_ASSIST_H
+#define USER_ASSIST_H
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "catalog.h"
+#include "discovery-backend.h"
+
+// Explorer's per-user launch history: a run count, focus time and last-run
+// time for each program the user started from the shell, under
+// HKCU\...\Explorer\UserAssist\{GUID}\Count. Value names are ROT13-encoded
+// paths, often starting with a known-folder GUID in place of the folder;
+// data is a binary counter record. Read once to seed the launch ranking so
+// a fresh install already orders apps by what the user runs.
+
+constexpr const char* kUserAssistKey = "Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\UserAssist";
+
+struct UserAssistEntry {
+  std::string path;  // Expanded exe path
+  uint32_t runCount = 0;
+  uint32_t focusCount = 0;
+  uint64_t focusMs = 0;
+  int64_t lastRunMs = 0;  // Unix epoch milliseconds; 0 when not recorded
+};
+
+// Letters rotated by 13; everything else unchanged
+std::string Rot13(const std::string& text);
+
+// Counters from a Windows 7+ (72-byte) or XP (16-byte) record
+bool ParseUserAssistCounters(const std::string& data, UserAssistEntry* entry);
+
+// A decoded value name as a path on this machine, with a leading
+// known-folder GUID replaced by its folder from roots (catalog tokens).
+// False for names that are not exe paths, such as AppUserModelIDs and
+// shortcuts, or that start in a folder roots does not define.
+bool ExpandUserAssistPath(const std::string& name, const CatalogRoots& roots, std::string* path);
+
+// Every exe entry under each UserAssist GUID, merged by path (counts
+// summed, latest run kept), most run first. skipped counts values that are
+// not exe paths or did not parse.
+BackendStatus ReadUserAssist(RegistryBackend& registry, const CatalogRoots& roots,
+                             std::vector<UserAssistEntry>* entries, size_t* skipped);
+
+// Function declarations for UserAssist import
+Napi::Value ReadUserAssistHistory(const Napi::CallbackInfo& info);
+
+#endif
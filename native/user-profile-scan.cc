@@ -0,0 +1,169 @@
+#include <chrono>
+#include "helper-executables.h"
+#include "pe-image.h"
+#include "user-profile-scan.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Folders that hold thousands of files and never a portable app
+bool IsSkippedDirectory(const std::string& name) {
+  if (name.empty() || name[0] == '.' || name[0] == '$') return true;
+  std::string lower = LowerAscii(name);
+  return lower == "node_modules" || lower == "__pycache__" || lower == "site-packages" ||
+         lower == "venv" || lower == "obj";
+}
+
+bool IsCandidateExe(const std::string& name) {
+  // Downloads is mostly installers, which are GUI executables too
+  return EndsWithNoCase(name, ".exe") && !IsHelperExecutable(name) && !LooksLikeInstaller(name);
+}
+
+bool IsUnderRoot(const std::string& key, const std::string& rootKey) {
+  if (key.compare(0, rootKey.size(), rootKey) != 0) return false;
+  return key.size() == rootKey.size() || key[rootKey.size()] == '\\' || rootKey.back() == '\\';
+}
+
+}  // namespace
+
+void ProfileScanCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  directories_.clear();
+}
+
+size_t ProfileScanCache::DirectoryCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return directories_.size();
+}
+
+void ScanUserProfileRoots(FileSystemBackend& fileSystem, const std::vector<std::string>& roots,
+                          const ProfileScanBudget& budget, ProfileScanCache* cache,
+                          std::vector<DiscoveredApp>* apps, std::vector<ProfileRootStats>* stats) {
+  using CachedExe = ProfileScanCache::CachedExe;
+  using CachedDirectory = ProfileScanCache::CachedDirectory;
+
+  std::lock_guard<std::mutex> lock(cache->mutex_);
+  uint64_t generation = ++cache->generation_;
+  size_t index = 0;
+
+  auto addApp = [&](const std::string& dirPath, const std::string& fileName) {
+    std::string name = fileName.substr(0, fileName.size() - 4);  // Drop ".exe"
+    apps->push_back({ name + "_user_" + std::to_string(index++), name, JoinPath(dirPath, fileName), "" });
+  };
+
+  for (const std::string& root : roots) {
+    ProfileRootStats rootStats;
+    rootStats.root = root;
+    Clock::time_point start = Clock::now();
+    bool exhausted = false;
+
+    auto overBudget = [&]() {
+      if (!exhausted && (rootStats.entries >= budget.maxEntries || MillisecondsSince(start) >= budget.maxMs)) {
+        exhausted = true;
+      }
+      return exhausted;
+    };
+
+    // Depth-first, so a budget cut keeps whole subtrees rather than a thin
+    // layer of every folder; unchanged folders cost one Stat
+    std::vector<std::pair<std::string, uint32_t>> pending = { { root, 0 } };
+    while (!pending.empty() && !overBudget()) {
+      auto [dirPath, depth] = pending.back();
+      pending.pop_back();
+
+      DirEntry dirInfo;
+      if (fileSystem.Stat(dirPath, &dirInfo) != BackendStatus::Ok || !dirInfo.isDirectory) continue;
+      rootStats.entries++;
+
+      std::string key = LowerAscii(dirPath);
+      auto cached = cache->directories_.find(key);
+      std::vector<std::string> subdirectories;
+
+      if (cached != cache->directories_.end() && dirInfo.mtimeMs != 0 &&
+          cached->second.mtimeMs == dirInfo.mtimeMs) {
+        rootStats.directoriesUnchanged++;
+        cached->second.generation = generation;
+        for (const CachedExe& exe : cached->second.executables) {
+          if (exe.isApp) addApp(dirPath, exe.name);
+        }
+        subdirectories = cached->second.subdirectories;
+      } else {
+        std::vector<DirEntry> entries;
+        if (fileSystem.ListDirectory(dirPath, &entries) != BackendStatus::Ok) continue;
+        rootStats.directoriesListed++;
+        rootStats.entries += (uint32_t)entries.size();
+
+        CachedDirectory directory;
+        directory.mtimeMs = dirInfo.mtimeMs;
+        directory.generation = generation;
+        for (const DirEntry& entry : entries) {
+          // Junctions and symlinks can loop or lead off the profile entirely
+          if (entry.isReparsePoint) continue;
+          if (entry.isDirectory) {
+            if (!IsSkippedDirectory(entry.name)) directory.subdirectories.push_back(entry.name);
+            continue;
+          }
+          if (!IsCandidateExe(entry.name)) continue;
+
+          CachedExe exe = { entry.name, entry.size, entry.mtimeMs, false };
+          const CachedExe* previous = nullptr;
+          if (cached != cache->directories_.end()) {
+            for (const CachedExe& candidate : cached->second.executables) {
+              if (candidate.name == entry.name) previous = &candidate;
+            }
+          }
+          if (previous && previous->size == exe.size && previous->mtimeMs == exe.mtimeMs) {
+            exe.isApp = previous->isApp;
+          } else {
+            if (overBudget()) break;
+            std::string header;
+            PeImageInfo image;
+            rootStats.headerReads++;
+            rootStats.entries++;
+            exe.isApp = fileSystem.ReadFile(JoinPath(dirPath, entry.name), kPeHeaderBytes, &header) == BackendStatus::Ok &&
+                        ParsePeHeaders(header, &image) && IsGuiExecutable(image);
+          }
+          if (exe.isApp) addApp(dirPath, exe.name);
+          directory.executables.push_back(std::move(exe));
+        }
+
+        subdirectories = directory.subdirectories;
+        // A directory cut short by the budget is not remembered, so the next
+        // scan lists it again instead of trusting a partial classification
+        if (!exhausted) cache->directories_[key] = std::move(directory);
+      }
+
+      if (depth < budget.maxDepth) {
+        for (auto it = subdirectories.rbegin(); it != subdirectories.rend(); ++it) {
+          pending.push_back({ JoinPath(dirPath, *it), depth + 1 });
+        }
+      }
+    }
+
+    rootStats.complete = pending.empty() && !exhausted;
+    rootStats.elapsedMs = MillisecondsSince(start);
+
+    // Only a complete walk proves that unvisited entries are gone
+    if (rootStats.complete) {
+      std::string rootKey = LowerAscii(root);
+      for (auto it = cache->directories_.begin(); it != cache->directories_.end();) {
+        if (it->second.generation != generation && IsUnderRoot(it->first, rootKey)) {
+          it = cache->directories_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    if (stats) stats->push_back(std::move(rootStats));
+  }
+}
+
+ProfileScanCache& SharedProfileScanCache() {
+  static ProfileScanCache* cache = new ProfileScanCache();
+  return *cache;
+}
@@ -0,0 +1,82 @@
+#ifndef USER_PROFILE_SCAN_H
+#define USER_PROFILE_SCAN_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "discovery-backend.h"
+#include "discovery-scan.h"
+
+// Portable apps kept in user folders (Desktop, Downloads, Documents\Tools).
+// These trees are large and unstructured, so each root is walked under an
+// entry/time budget, only GUI-subsystem PE files count as apps, and a
+// per-directory cache lets later scans skip folders whose mtime is unchanged.
+
+constexpr uint32_t kDefaultProfileMaxEntries = 20000;
+constexpr uint32_t kDefaultProfileMaxMs = 1500;
+constexpr uint32_t kDefaultProfileMaxDepth = 3;
+
+struct ProfileScanBudget {
+  uint32_t maxEntries = kDefaultProfileMaxEntries;  // Listed entries plus PE header reads, per root
+  uint32_t maxMs = kDefaultProfileMaxMs;            // Per root
+  uint32_t maxDepth = kDefaultProfileMaxDepth;      // Directory levels below the root
+};
+
+struct ProfileRootStats {
+  std::string root;
+  bool complete = false;             // False when the budget ran out first
+  uint32_t entries = 0;
+  uint32_t headerReads = 0;
+  uint32_t directoriesListed = 0;
+  uint32_t directoriesUnchanged = 0;
+  double elapsedMs = 0;
+};
+
+// What a previous scan learned about each directory. A directory's mtime
+// changes when entries are added, removed or renamed in it (not below it), so
+// an unchanged mtime means its listing and app classifications still hold.
+// Thread-safe; scans sharing a cache run one at a time.
+class ProfileScanCache {
+ public:
+  void Clear();
+  size_t DirectoryCount();
+
+ private:
+  friend void ScanUserProfileRoots(FileSystemBackend&, const std::vector<std::string>&,
+                                   const ProfileScanBudget&, ProfileScanCache*,
+                                   std::vector<DiscoveredApp>*, std::vector<ProfileRootStats>*);
+
+  struct CachedExe {
+    std::string name;
+    uint64_t size = 0;
+    int64_t mtimeMs = 0;
+    bool isApp = false;
+  };
+
+  struct CachedDirectory {
+    int64_t mtimeMs = 0;
+    uint64_t generation = 0;
+    std::vector<std::string> subdirectories;
+    std::vector<CachedExe> executables;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, CachedDirectory> directories_;  // Lowercased path -> entry
+  uint64_t generation_ = 0;
+};
+
+// GUI executables below each root, within the budget. stats is optional.
+void ScanUserProfileRoots(FileSystemBackend& fileSystem, const std::vector<std::string>& roots,
+                          const ProfileScanBudget& budget, ProfileScanCache* cache,
+                          std::vector<DiscoveredApp>* apps, std::vector<ProfileRootStats>* stats);
+
+// Cache shared by scanUserApps and idle rescans
+ProfileScanCache& SharedProfileScanCache();
+
+// Desktop, Downloads and Documents\Tools from the known-folder paths, so
+// redirected folders are followed (Windows only, app-discovery.cc)
+std::vector<std::string> DefaultUserProfileRoots();
+
+#endif
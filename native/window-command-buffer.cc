@@ -0,0 +1,162 @@
+#include <cstring>
+#include <unordered_map>
+#include "window-command-buffer.h"
+
+namespace {
+
+const char kFrameMagic[4] = { 'W', 'C', 'M', 'D' };
+const char kRingMagic[4] = { 'W', 'C', 'R', 'G' };
+
+// Explicit byte order so the format does not depend on the host
+uint16_t ReadU16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void WriteU16(uint8_t* p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+void WriteU32(uint8_t* p, uint32_t value) {
+  for (int i = 0; i < 4; i++) p[i] = (uint8_t)(value >> (8 * i));
+}
+
+bool IsGeometryOp(WindowCommandOp op) {
+  return op == WindowCommandOp::Move || op == WindowCommandOp::SetRect;
+}
+
+}  // namespace
+
+bool ParseWindowCommandFrame(const uint8_t* data, size_t length, WindowCommandFrame* frame,
+                             std::string* error) {
+  if (length < kWindowCommandHeaderBytes || memcmp(data, kFrameMagic, 4) != 0) {
+    *error = "Not a window command frame";
+    return false;
+  }
+  uint16_t version = ReadU16(data + 4);
+  if (version != kWindowCommandVersion) {
+    *error = "Unsupported window command version " + std::to_string(version);
+    return false;
+  }
+  uint16_t count = ReadU16(data + 6);
+  if (length < kWindowCommandHeaderBytes + (size_t)count * kWindowCommandBytes) {
+    *error = "Truncated window command frame";
+    return false;
+  }
+
+  frame->frameId = ReadU32(data + 8);
+  frame->commands.clear();
+  frame->commands.reserve(count);
+  const uint8_t* p = data + kWindowCommandHeaderBytes;
+  for (uint16_t i = 0; i < count; i++, p += kWindowCommandBytes) {
+    uint8_t op = p[4];
+    if (op < (uint8_t)WindowCommandOp::Move || op > (uint8_t)WindowCommandOp::Hide) {
+      *error = "Unknown window command op " + std::to_string(op) + " at index " + std::to_string(i);
+      return false;
+    }
+    WindowCommand command;
+    command.index = i;
+    command.slot = ReadU32(p);
+    command.op = (WindowCommandOp)op;
+    command.x = (int32_t)ReadU32(p + 8);
+    command.y = (int32_t)ReadU32(p + 12);
+    command.width = (int32_t)ReadU32(p + 16);
+    command.height = (int32_t)ReadU32(p + 20);
+    frame->commands.push_back(command);
+  }
+  return true;
+}
+
+std::vector<WindowCommand> CoalesceWindowCommands(const WindowCommandFrame& frame,
+                                                  std::vector<WindowCommand>* superseded) {
+  std::vector<WindowCommand> merged = frame.commands;
+  std::vector<bool> live(merged.size(), true);
+  // Slot -> index in merged of the command currently standing for it
+  std::unordered_map<uint32_t, size_t> lastGeometry;
+  std::unordered_map<uint32_t, size_t> lastVisibility;
+
+  for (size_t i = 0; i < merged.size(); i++) {
+    WindowCommand& command = merged[i];
+    auto& last = IsGeometryOp(command.op) ? lastGeometry : lastVisibility;
+    auto it = last.find(command.slot);
+    if (it == last.end()) {
+      last[command.slot] = i;
+      continue;
+    }
+    const WindowCommand& previous = merged[it->second];
+    if (command.op == WindowCommandOp::Move && previous.op == WindowCommandOp::SetRect) {
+      command.op = WindowCommandOp::SetRect;
+      command.width = previous.width;
+      command.height = previous.height;
+    }
+    live[it->second] = false;
+    it->second = i;
+  }
+
+  std::vector<WindowCommand> effective;
+  effective.reserve(merged.size());
+  for (size_t i = 0; i < merged.size(); i++) {
+    if (live[i]) {
+      effective.push_back(merged[i]);
+    } else if (superseded) {
+      superseded->push_back(frame.commands[i]);
+    }
+  }
+  return effective;
+}
+
+size_t CompletionRingBytes(uint32_t capacity) {
+  return kCompletionRingHeaderBytes + (size_t)capacity * kCompletionRecordBytes;
+}
+
+void InitCompletionRing(uint8_t* ring, uint32_t capacity) {
+  memset(ring, 0, CompletionRingBytes(capacity));
+  memcpy(ring, kRingMagic, 4);
+  WriteU32(ring + 4, capacity);
+}
+
+bool CompletionRingWritten(const uint8_t* ring, size_t length, uint32_t* written) {
+  if (length < kCompletionRingHeaderBytes || memcmp(ring, kRingMagic, 4) != 0) return false;
+  uint32_t capacity = ReadU32(ring + 4);
+  if (capacity == 0 || length < CompletionRingBytes(capacity)) return false;
+  *written = ReadU32(ring + 8);
+  return true;
+}
+
+bool AppendCompletion(uint8_t* ring, size_t length, const WindowCommandCompletion& completion) {
+  uint32_t written = 0;
+  if (!CompletionRingWritten(ring, length, &written)) return false;
+  uint32_t capacity = ReadU32(ring + 4);
+
+  uint8_t* p = ring + kCompletionRingHeaderBytes + (size_t)(written % capacity) * kCompletionRecordBytes;
+  const WindowCommand& command = completion.command;
+  WriteU32(p, completion.frameId);
+  WriteU16(p + 4, command.index);
+  p[6] = (uint8_t)command.op;
+  p[7] = (uint8_t)completion.status;
+  WriteU32(p + 8, command.slot);
+  WriteU32(p + 12, completion.elapsedUs);
+  WriteU32(p + 16, (uint32_t)command.x);
+  WriteU32(p + 20, (uint32_t)command.y);
+  WriteU32(p + 24, (uint32_t)command.width);
+  WriteU32(p + 28, (uint32_t)command.height);
+  WriteU32(ring + 8, written + 1);
+  return true;
+}
+
+const char* WindowCommandStatusName(WindowCommandStatus status) {
+  switch (status) {
+    case WindowCommandStatus::Ok: return "ok";
+    case WindowCommandStatus::Failed: return "failed";
+    case WindowCommandStatus::InvalidWindow: return "invalid";
+    case WindowCommandStatus::Hung: return "hung";
+    case WindowCommandStatus::Timeout: return "timeout";
+    case WindowCommandStatus::Superseded: return "superseded";
+    case WindowCommandStatus::UnknownSlot: return "unknown-slot";
+  }
+  return "failed";
+}
@@ -0,0 +1,90 @@
+#ifndef WINDOW_COMMAND_BUFFER_H
+#define WINDOW_COMMAND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Packed window commands the renderer batches per animation frame and posts
+// over a MessagePort, so a frame's geometry and visibility changes cost one
+// message and one window-ops job instead of an IPC round trip each.
+//
+// Frame layout, little-endian:
+//   u32 magic "WCMD", u16 version, u16 command count, u32 frame id, u32 reserved
+//   then 24-byte commands: u32 slot, u8 op, u8 reserved, u16 reserved,
+//   i32 x, i32 y, i32 width, i32 height
+// Slots are small integers the main process binds to embedded windows.
+//
+// Completion ring, a JS-owned ArrayBuffer the addon appends to:
+//   u32 magic "WCRG", u32 capacity, u32 records written (wraps), u32 reserved
+//   then 32-byte records at (written % capacity): u32 frame id, u16 command
+//   index, u8 op, u8 status, u32 slot, u32 elapsed microseconds,
+//   i32 x, i32 y, i32 width, i32 height (the geometry actually applied)
+
+constexpr uint16_t kWindowCommandVersion = 1;
+constexpr size_t kWindowCommandHeaderBytes = 16;
+constexpr size_t kWindowCommandBytes = 24;
+constexpr size_t kCompletionRingHeaderBytes = 16;
+constexpr size_t kCompletionRecordBytes = 32;
+
+enum class WindowCommandOp : uint8_t {
+  Move = 1,   // x, y; keeps the size
+  SetRect,    // x, y, width, height
+  Show,
+  Hide
+};
+
+// The first five values match WindowOpStatus
+enum class WindowCommandStatus : uint8_t {
+  Ok = 0,
+  Failed,
+  InvalidWindow,
+  Hung,
+  Timeout,
+  Superseded,   // Folded into a later command for the same slot in the frame
+  UnknownSlot
+};
+
+struct WindowCommand {
+  uint16_t index = 0;  // Position in the frame, reported back in completions
+  uint32_t slot = 0;
+  WindowCommandOp op = WindowCommandOp::Move;
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t width = 0;
+  int32_t height = 0;
+};
+
+struct WindowCommandFrame {
+  uint32_t frameId = 0;
+  std::vector<WindowCommand> commands;
+};
+
+struct WindowCommandCompletion {
+  uint32_t frameId = 0;
+  WindowCommand command;
+  WindowCommandStatus status = WindowCommandStatus::Ok;
+  uint32_t elapsedUs = 0;
+};
+
+bool ParseWindowCommandFrame(const uint8_t* data, size_t length, WindowCommandFrame* frame,
+                             std::string* error);
+
+// Reduce a frame to at most one geometry and one visibility command per slot,
+// keeping the last of each. A Move after a SetRect becomes a SetRect with the
+// new position. Commands folded away are returned in superseded.
+std::vector<WindowCommand> CoalesceWindowCommands(const WindowCommandFrame& frame,
+                                                  std::vector<WindowCommand>* superseded);
+
+size_t CompletionRingBytes(uint32_t capacity);
+void InitCompletionRing(uint8_t* ring, uint32_t capacity);
+// Records written so far, or false if ring is not an initialized ring
+bool CompletionRingWritten(const uint8_t* ring, size_t length, uint32_t* written);
+// Overwrites the oldest record once the ring is full; readers detect the
+// overrun from the written count
+bool AppendCompletion(uint8_t* ring, size_t length, const WindowCommandCompletion& completion);
+
+const char* WindowCommandStatusName(WindowCommandStatus status);
+
+#endif
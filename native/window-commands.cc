@@ -0,0 +1,313 @@
+#include <napi.h>
+#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "hang-watchdog.h"
+#include "window-command-buffer.h"
+#include "window-commands.h"
+#include "window-ops.h"
+#include "window-trace.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint32_t kDefaultRingCapacity = 1024;
+constexpr uint32_t kMaxRingCapacity = 65536;
+
+// Status of a command the worker had not reached when the batch settled
+constexpr uint8_t kPending = 0xFF;
+
+// One frame's surviving commands, shared with the window-ops worker. A worker
+// abandoned mid-batch may still be writing, so per-command results are atomics
+// and the batch outlives the promise.
+struct CommandBatch {
+  uint32_t frameId = 0;
+  std::vector<WindowCommand> commands;
+  std::vector<HWND> windows;
+  std::unique_ptr<std::atomic<uint8_t>[]> statuses;
+  std::unique_ptr<std::atomic<uint32_t>[]> elapsedUs;
+  std::mutex errorMutex;
+  std::string error;  // First failure
+};
+
+// Slot bindings and the ring are only used on the JS thread
+std::unordered_map<uint32_t, HWND> g_slots;
+Napi::ObjectReference* g_ring = nullptr;
+
+TraceWindowOp TraceOpFor(WindowCommandOp op) {
+  switch (op) {
+    case WindowCommandOp::Move: return TraceWindowOp::Move;
+    case WindowCommandOp::SetRect: return TraceWindowOp::Resize;
+    case WindowCommandOp::Show: return TraceWindowOp::Show;
+    case WindowCommandOp::Hide: return TraceWindowOp::Hide;
+  }
+  return TraceWindowOp::Resize;
+}
+
+// Only non-blocking calls: SWP_ASYNCWINDOWPOS and ShowWindowAsync post to
+// the app's thread, so one slow app cannot hold up the rest of the frame
+WindowCommandStatus ApplyCommand(HWND hwnd, const WindowCommand& command, std::string* error) {
+  if (!IsWindow(hwnd)) {
+    return WindowCommandStatus::InvalidWindow;
+  }
+  if (IsHungAppWindow(hwnd) || IsWindowMarkedHung((uintptr_t)hwnd)) {
+    return WindowCommandStatus::Hung;
+  }
+
+  // Visibility is left to explicit Show/Hide commands, unlike resizeWindow
+  const UINT positionFlags = SWP_NOZORDER | SWP_NOACTIVATE | SWP_ASYNCWINDOWPOS;
+  SetLastError(0);
+  BOOL success = TRUE;
+  switch (command.op) {
+    case WindowCommandOp::Move:
+      success = SetWindowPos(hwnd, NULL, command.x, command.y, 0, 0, positionFlags | SWP_NOSIZE);
+      break;
+    case WindowCommandOp::SetRect:
+      success = SetWindowPos(hwnd, NULL, command.x, command.y, command.width, command.height, positionFlags);
+      break;
+    case WindowCommandOp::Show:
+    case WindowCommandOp::Hide:
+      // Returns the previous visibility, so FALSE alone is not a failure
+      success = ShowWindowAsync(hwnd, command.op == WindowCommandOp::Show ? SW_SHOW : SW_HIDE) ||
+        GetLastError() == 0;
+      break;
+  }
+
+  if (!success) {
+    *error = "Window command failed (error " + std::to_string(GetLastError()) + ")";
+    return WindowCommandStatus::Failed;
+  }
+  return WindowCommandStatus::Ok;
+}
+
+WindowOpResult RunBatch(const std::shared_ptr<CommandBatch>& batch) {
+  for (size_t i = 0; i < batch->commands.size(); i++) {
+    const WindowCommand& command = batch->commands[i];
+    HWND hwnd = batch->windows[i];
+    auto start = Clock::now();
+    std::string error;
+    WindowCommandStatus status = ApplyCommand(hwnd, command, &error);
+    uint64_t durationUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - start).count();
+
+    batch->elapsedUs[i] = (uint32_t)durationUs;
+    batch->statuses[i] = (uint8_t)status;
+    if (!error.empty()) {
+      std::lock_guard<std::mutex> lock(batch->errorMutex);
+      if (batch->error.empty()) batch->error = error;
+    }
+    TraceWindowCall(TraceOpFor(command.op), (uint64_t)(uintptr_t)hwnd, 0, command.x, command.y,
+                    command.width, command.height, (uint8_t)status, durationUs);
+  }
+  // Per-command failures are reported through the ring, not the batch status
+  return {};
+}
+
+// Write every command's completion, in frame order, and resolve the frame's
+// promise with a summary pointing at the records
+void SettleBatch(Napi::Env env, Napi::Promise::Deferred deferred, CommandBatch& batch,
+                 std::vector<WindowCommandCompletion> completions, const WindowOpResult& opResult) {
+  uint32_t applied = 0;
+  uint32_t failed = 0;
+  uint32_t superseded = 0;
+  for (size_t i = 0; i < batch.commands.size(); i++) {
+    uint8_t status = batch.statuses[i];
+    WindowCommandCompletion completion;
+    completion.frameId = batch.frameId;
+    completion.command = batch.commands[i];
+    completion.status = status != kPending ? (WindowCommandStatus)status :
+      opResult.status == WindowOpStatus::Timeout ? WindowCommandStatus::Timeout : WindowCommandStatus::Failed;
+    completion.elapsedUs = batch.elapsedUs[i];
+    completions.push_back(completion);
+  }
+  std::sort(completions.begin(), completions.end(),
+            [](const WindowCommandCompletion& a, const WindowCommandCompletion& b) {
+              return a.command.index < b.command.index;
+            });
+
+  Napi::Object result = Napi::Object::New(env);
+  uint32_t firstRecord = 0;
+  bool recorded = false;
+  if (g_ring) {
+    Napi::ArrayBuffer ring = g_ring->Value().As<Napi::ArrayBuffer>();
+    uint8_t* data = (uint8_t*)ring.Data();
+    recorded = CompletionRingWritten(data, ring.ByteLength(), &firstRecord);
+    for (const WindowCommandCompletion& completion : completions) {
+      if (recorded) AppendCompletion(data, ring.ByteLength(), completion);
+    }
+  }
+  for (const WindowCommandCompletion& completion : completions) {
+    if (completion.status == WindowCommandStatus::Ok) {
+      applied++;
+    } else if (completion.status == WindowCommandStatus::Superseded) {
+      superseded++;
+    } else {
+      failed++;
+    }
+  }
+
+  result.Set("success", Napi::Boolean::New(env, failed == 0));
+  result.Set("frameId", Napi::Number::New(env, batch.frameId));
+  result.Set("applied", Napi::Number::New(env, applied));
+  result.Set("failed", Napi::Number::New(env, failed));
+  result.Set("superseded", Napi::Number::New(env, superseded));
+  result.Set("status", Napi::String::New(env, WindowOpStatusName(opResult.status)));
+  {
+    std::lock_guard<std::mutex> lock(batch.errorMutex);
+    std::string error = !opResult.error.empty() ? opResult.error : batch.error;
+    if (!error.empty()) result.Set("error", Napi::String::New(env, error));
+  }
+  result.Set("elapsedMs", Napi::Number::New(env, opResult.elapsedMs));
+  // Records [firstRecord, firstRecord + records) of the completion ring
+  if (recorded) {
+    result.Set("firstRecord", Napi::Number::New(env, firstRecord));
+    result.Set("records", Napi::Number::New(env, (double)completions.size()));
+  }
+  deferred.Resolve(result);
+}
+
+Napi::Value ResolvedFailure(Napi::Env env, const std::string& error) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, false));
+  result.Set("error", Napi::String::New(env, error));
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  deferred.Resolve(result);
+  return deferred.Promise();
+}
+
+}  // namespace
+
+// CreateWindowCommandRing: Allocate the completion ring that applyWindowCommands
+// appends to, replacing any previous one
+Napi::Value CreateWindowCommandRing(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  uint32_t capacity = kDefaultRingCapacity;
+  if (info.Length() > 0 && info[0].IsNumber()) {
+    capacity = info[0].As<Napi::Number>().Uint32Value();
+  }
+  if (capacity == 0 || capacity > kMaxRingCapacity) {
+    Napi::TypeError::New(env, "Expected (capacity?: number) between 1 and 65536").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Allocated by V8 rather than wrapped external memory, which Electron's
+  // memory cage does not allow
+  Napi::ArrayBuffer ring = Napi::ArrayBuffer::New(env, CompletionRingBytes(capacity));
+  InitCompletionRing((uint8_t*)ring.Data(), capacity);
+
+  delete g_ring;
+  g_ring = new Napi::ObjectReference(Napi::Persistent(ring));
+  return ring;
+}
+
+// BindWindowCommandSlot: Route commands for a slot to a window
+Napi::Value BindWindowCommandSlot(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (slot: number, hwnd: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  g_slots[info[0].As<Napi::Number>().Uint32Value()] =
+    (HWND)(intptr_t)info[1].As<Napi::Number>().Int64Value();
+  return env.Undefined();
+}
+
+// UnbindWindowCommandSlot: Commands for the slot complete as "unknown-slot"
+Napi::Value UnbindWindowCommandSlot(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (slot: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  g_slots.erase(info[0].As<Napi::Number>().Uint32Value());
+  return env.Undefined();
+}
+
+// ApplyWindowCommands: Decode a command frame and apply it as one job on the
+// window-ops thread. Resolves { success, frameId, applied, failed, superseded,
+// status, error?, elapsedMs, firstRecord, records } once every command's
+// completion is in the ring; never rejects.
+Napi::Value ApplyWindowCommands(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !(info[0].IsArrayBuffer() || info[0].IsTypedArray())) {
+    Napi::TypeError::New(env, "Expected (frame: ArrayBuffer | TypedArray, timeoutMs?: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const uint8_t* data;
+  size_t length;
+  if (info[0].IsArrayBuffer()) {
+    Napi::ArrayBuffer buffer = info[0].As<Napi::ArrayBuffer>();
+    data = (const uint8_t*)buffer.Data();
+    length = buffer.ByteLength();
+  } else {
+    Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+    data = (const uint8_t*)array.ArrayBuffer().Data() + array.ByteOffset();
+    length = array.ByteLength();
+  }
+  uint32_t timeoutMs = WindowOpTimeoutArg(info, 1);
+
+  if (!g_ring) {
+    return ResolvedFailure(env, "No completion ring; call createWindowCommandRing first");
+  }
+
+  // The frame comes from the renderer; reject malformed input before any of
+  // it reaches a window
+  WindowCommandFrame frame;
+  std::string error;
+  if (!ParseWindowCommandFrame(data, length, &frame, &error)) {
+    return ResolvedFailure(env, error);
+  }
+
+  std::vector<WindowCommand> superseded;
+  std::vector<WindowCommand> effective = CoalesceWindowCommands(frame, &superseded);
+
+  std::vector<WindowCommandCompletion> completions;
+  for (const WindowCommand& command : superseded) {
+    completions.push_back({ frame.frameId, command, WindowCommandStatus::Superseded, 0 });
+  }
+
+  auto batch = std::make_shared<CommandBatch>();
+  batch->frameId = frame.frameId;
+  for (const WindowCommand& command : effective) {
+    auto it = g_slots.find(command.slot);
+    if (it == g_slots.end()) {
+      completions.push_back({ frame.frameId, command, WindowCommandStatus::UnknownSlot, 0 });
+      continue;
+    }
+    batch->commands.push_back(command);
+    batch->windows.push_back(it->second);
+  }
+  size_t count = batch->commands.size();
+  batch->statuses.reset(new std::atomic<uint8_t>[count]);
+  batch->elapsedUs.reset(new std::atomic<uint32_t>[count]);
+  for (size_t i = 0; i < count; i++) {
+    batch->statuses[i] = kPending;
+    batch->elapsedUs[i] = 0;
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  if (count == 0) {
+    SettleBatch(env, deferred, *batch, std::move(completions), {});
+    return deferred.Promise();
+  }
+
+  QueueWindowOpWithCallback(env, "windowCommands", [batch]() { return RunBatch(batch); }, timeoutMs,
+    [deferred, batch, completions](Napi::Env env, const WindowOpResult& result) {
+      SettleBatch(env, deferred, *batch, completions, result);
+    });
+  return deferred.Promise();
+}
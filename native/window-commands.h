@@ -0,0 +1,13 @@
+#ifndef WINDOW_COMMANDS_H
+#define WINDOW_COMMANDS_H
+
+#include <napi.h>
+
+// Function declarations for batched window commands (format in
+// window-command-buffer.h)
+Napi::Value CreateWindowCommandRing(const Napi::CallbackInfo& info);
+Napi::Value BindWindowCommandSlot(const Napi::CallbackInfo& info);
+Napi::Value UnbindWindowCommandSlot(const Napi::CallbackInfo& info);
+Napi::Value ApplyWindowCommands(const Napi::CallbackInfo& info);
+
+#endif
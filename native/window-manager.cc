@@ -1,10 +1,37 @@
 #include <napi.h>
+#ifdef _WIN32
 #include <windows.h>
 #include <psapi.h>
 #include <tlhelp32.h>
+#endif
+#include <chrono>
 #include <string>
 #include <vector>
 #include "app-discovery.h"
+#include "hang-watchdog.h"
+#include "window-readiness.h"
+#include "window-ops.h"
+#include "window-model.h"
+#include "window-trace.h"
+#include "window-trace-replay.h"
+#include "window-stress.h"
+#include "discovery-benchmark.h"
+#include "process-priority.h"
+#include "idle-scheduler.h"
+#include "executor.h"
+#include "napi-coro.h"
+#include "window-commands.h"
+#include "package-manager-scan.h"
+#include "game-library-scan.h"
+#include "discovery-sources.h"
+#include "discovery-pipeline.h"
+#include "catalog.h"
+#include "stat-cache.h"
+#include "authenticode.h"
+#include "facet-index.h"
+#include "user-assist.h"
+
+#ifdef _WIN32
 
 // Helper function to convert std::string to Napi::String
 static Napi::String StringToNapi(const Napi::Env& env, const std::string& str) {
@@ -27,14 +54,35 @@ std::string GetLastErrorString() {
   return message;
 }
 
+// Helper function to capture the properties the main-window heuristic uses
+static WindowCandidate DescribeWindow(HWND hwnd, DWORD processId) {
+  WindowCandidate window;
+  window.handle = (uint64_t)(uintptr_t)hwnd;
+  window.processId = processId;
+  
+  char className[256];
+  int length = GetClassNameA(hwnd, className, sizeof(className));
+  window.className.assign(className, length > 0 ? length : 0);
+  
+  char title[256];
+  length = GetWindowTextA(hwnd, title, sizeof(title));
+  window.title.assign(title, length > 0 ? length : 0);
+  
+  LONG style = GetWindowLong(hwnd, GWL_STYLE);
+  LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
+  window.visible = IsWindowVisible(hwnd) != FALSE;
+  window.hasParent = GetParent(hwnd) != NULL;
+  window.framed = (style & WS_CAPTION) || (style & WS_BORDER);
+  window.toolWindow = (exStyle & WS_EX_TOOLWINDOW) != 0;
+  return window;
+}
+
 // Helper function to find main window of a process
 HWND FindMainWindow(DWORD processId) {
-  HWND hwnd = NULL;
   struct EnumData {
     DWORD processId;
-    HWND hwnd;
-    HWND bestHwnd; // Fallback: any window from process
-  } enumData = { processId, NULL, NULL };
+    std::vector<WindowCandidate> windows;
+  } enumData = { processId, {} };
   
   EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
     EnumData* data = (EnumData*)lParam;
@@ -42,63 +90,36 @@ HWND FindMainWindow(DWORD processId) {
     GetWindowThreadProcessId(hwnd, &windowProcessId);
     
     if (windowProcessId == data->processId) {
-      char className[256];
-      GetClassNameA(hwnd, className, sizeof(className));
-      
-      // Skip system windows
-      if (strcmp(className, "Shell_TrayWnd") == 0 ||
-          strcmp(className, "Button") == 0 ||
-          strcmp(className, "Progman") == 0 ||
-          strcmp(className, "Shell_SecondaryTrayWnd") == 0) {
-        return TRUE; // Continue
-      }
-      
-      // Prefer visible windows with no parent (main windows)
-      if (IsWindowVisible(hwnd) && GetParent(hwnd) == NULL) {
-        // Check if it has a title or caption style (likely a real app window)
-        char title[256];
-        GetWindowTextA(hwnd, title, sizeof(title));
-        LONG style = GetWindowLong(hwnd, GWL_STYLE);
-        if (strlen(title) > 0 || (style & WS_CAPTION) || (style & WS_BORDER)) {
-          data->hwnd = hwnd;
-          return FALSE; // Stop enumeration - found good window
-        }
-      }
-      
-      // Store any window from this process as fallback (even if not visible yet)
-      if (data->bestHwnd == NULL && IsWindow(hwnd)) {
-        // Skip tool windows and popups
-        LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
-        if (!(exStyle & WS_EX_TOOLWINDOW)) {
-          data->bestHwnd = hwnd;
-        }
-      }
+      data->windows.push_back(DescribeWindow(hwnd, windowProcessId));
     }
     return TRUE; // Continue enumeration
   }, (LPARAM)&enumData);
   
-  // Return best match, or fallback to any window
-  return enumData.hwnd ? enumData.hwnd : enumData.bestHwnd;
+  // Selection is platform-neutral (window-model.cc) so trace replay can run it
+  TraceWindowSnapshot(enumData.windows);
+  return (HWND)(uintptr_t)SelectMainWindow(enumData.windows);
 }
 
-// LaunchApplication: Launch an app and return process ID and window handle
-Napi::Object LaunchApplication(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (exePath: string, parentHWND: number)").ThrowAsJavaScriptException();
-    return Napi::Object::New(env);
-  }
-  
-  std::string exePath = info[0].As<Napi::String>().Utf8Value();
-  intptr_t parentHWND = info[1].As<Napi::Number>().Int64Value();
-  
-  Napi::Object result = Napi::Object::New(env);
-  
-  // Launch process
+// Helper function to record a window op's call and outcome in the active trace
+static WindowOpFn Traced(TraceWindowOp op, HWND hwnd, HWND parent, int x, int y,
+                         int width, int height, WindowOpFn fn) {
+  return [=]() -> WindowOpResult {
+    auto start = std::chrono::steady_clock::now();
+    WindowOpResult result = fn();
+    auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+    TraceWindowCall(op, (uint64_t)(uintptr_t)hwnd, (uint64_t)(uintptr_t)parent,
+                    x, y, width, height, (uint8_t)result.status, (uint64_t)durationUs);
+    return result;
+  };
+}
+
+// Helper function to start a process from a command line; the caller owns
+// pi->hProcess (the thread handle is already closed)
+static bool StartProcess(const std::string& exePath, PROCESS_INFORMATION* pi, std::string* error) {
   STARTUPINFOA si = {0};
   si.cb = sizeof(si);
-  PROCESS_INFORMATION pi = {0};
+  *pi = {0};
   
   char* cmdLine = new char[exePath.length() + 1];
   strcpy_s(cmdLine, exePath.length() + 1, exePath.c_str());
@@ -113,19 +134,42 @@ Napi::Object LaunchApplication(const Napi::CallbackInfo& info) {
     NULL,           // Environment
     NULL,           // Current directory
     &si,            // Startup info
-    &pi             // Process information
+    pi              // Process information
   );
   
   delete[] cmdLine;
   
   if (!success) {
+    *error = "Failed to launch process: " + GetLastErrorString();
+    return false;
+  }
+  
+  CloseHandle(pi->hThread);
+  TraceLaunch(pi->dwProcessId, exePath);
+  return true;
+}
+
+// LaunchApplication: Launch an app and return process ID and window handle
+Napi::Object LaunchApplication(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (exePath: string, parentHWND: number)").ThrowAsJavaScriptException();
+    return Napi::Object::New(env);
+  }
+  
+  std::string exePath = info[0].As<Napi::String>().Utf8Value();
+  
+  Napi::Object result = Napi::Object::New(env);
+  
+  PROCESS_INFORMATION pi;
+  std::string error;
+  if (!StartProcess(exePath, &pi, &error)) {
     result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Failed to launch process: " + GetLastErrorString()));
+    result.Set("error", StringToNapi(env, error));
     return result;
   }
   
-  CloseHandle(pi.hThread);
-  
   // Return immediately - let JS handle the waiting
   result.Set("success", Napi::Boolean::New(env, true));
   result.Set("processId", Napi::Number::New(env, pi.dwProcessId));
@@ -134,14 +178,116 @@ Napi::Object LaunchApplication(const Napi::CallbackInfo& info) {
   return result;
 }
 
-// EmbedWindow: Embed a window into parent window
-Napi::Object EmbedWindow(const Napi::CallbackInfo& info) {
+// Helper function to check that a window is still pumping messages before
+// making synchronous cross-process calls (SetParent, SetWindowLong) into it
+static bool IsWindowResponsive(HWND hwnd, UINT timeoutMs) {
+  DWORD_PTR ignored = 0;
+  return SendMessageTimeoutW(hwnd, WM_NULL, 0, 0, SMTO_ABORTIFHUNG | SMTO_BLOCK,
+                             timeoutMs, &ignored) != 0;
+}
+
+// Bounded wait for the responsiveness probe before a synchronous call
+static const UINT kResponsiveProbeMs = 250;
+
+// Helper function to build the embed operation shared by EmbedWindow and
+// LaunchAndEmbed (runs on the window-ops thread)
+static WindowOpFn MakeEmbedOp(HWND hwnd, HWND parentHWND, int x, int y, int width, int height) {
+  return Traced(TraceWindowOp::Embed, hwnd, parentHWND, x, y, width, height, [=]() -> WindowOpResult {
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Invalid window handle" };
+    }
+    
+    // SetParent and SetWindowLong block on the app's UI thread, so make sure
+    // it is answering messages before committing to them
+    if (!IsWindowResponsive(hwnd, kResponsiveProbeMs)) {
+      return { WindowOpStatus::Hung, "Window is not responding" };
+    }
+    
+    // First, ensure window is visible and not minimized
+    ShowWindowAsync(hwnd, SW_SHOW);
+    SetForegroundWindow(hwnd);
+    
+    // Reparent window (this is what actually embeds it)
+    SetLastError(0);
+    HWND oldParent = SetParent(hwnd, parentHWND);
+    if (oldParent == NULL && GetLastError() != 0) {
+      DWORD error = GetLastError();
+      // ERROR_INVALID_PARAMETER (87) might mean the app refuses embedding
+      if (error == 87) {
+        return { WindowOpStatus::Failed, "Application refuses window embedding (security restriction)" };
+      }
+      return { WindowOpStatus::Failed, "Failed to set parent: " + GetLastErrorString() };
+    }
+    TraceWindowReparent((uint64_t)(uintptr_t)hwnd, (uint64_t)(uintptr_t)parentHWND);
+    
+    // Verify window still exists after SetParent (some apps close when reparented)
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Window closed immediately after embedding (app may not support embedding)" };
+    }
+    
+    // Modify window styles more carefully - only after successful reparenting
+    // First, try minimal changes to avoid triggering app security checks
+    LONG originalStyle = GetWindowLongW(hwnd, GWL_STYLE);
+    LONG originalExStyle = GetWindowLongW(hwnd, GWL_EXSTYLE);
+    
+    // Try to modify styles gradually - some apps close if we change too much at once
+    LONG style = originalStyle;
+    LONG exStyle = originalExStyle;
+    
+    // Remove minimize/maximize buttons and system menu, but keep caption for title bar
+    // Keep WS_CAPTION to show title bar
+    style &= ~(WS_THICKFRAME | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU | WS_POPUP);
+    style |= WS_CHILD | WS_VISIBLE;
+    
+    // Only add caption if it wasn't there, to preserve original look
+    if (originalStyle & WS_CAPTION) {
+      style |= WS_CAPTION | WS_BORDER;
+    } else {
+      // If no caption originally, add border for visual separation
+      style |= WS_BORDER;
+    }
+    
+    exStyle &= ~(WS_EX_DLGMODALFRAME | WS_EX_WINDOWEDGE | WS_EX_CLIENTEDGE | WS_EX_STATICEDGE);
+    
+    // Apply style changes
+    SetWindowLongW(hwnd, GWL_STYLE, style);
+    SetWindowLongW(hwnd, GWL_EXSTYLE, exStyle);
+    
+    // Verify window still exists after style changes
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Window closed after style modification (app may not support embedding)" };
+    }
+    
+    // Position and resize window. SWP_ASYNCWINDOWPOS posts the request to the
+    // app's thread instead of waiting for it to process WM_WINDOWPOSCHANGING.
+    BOOL posSuccess = SetWindowPos(
+      hwnd,
+      HWND_TOP,
+      x, y,
+      width, height,
+      SWP_SHOWWINDOW | SWP_FRAMECHANGED | SWP_NOZORDER | SWP_ASYNCWINDOWPOS
+    );
+    
+    if (!posSuccess) {
+      return { WindowOpStatus::Failed, "Failed to position window: " + GetLastErrorString() };
+    }
+    
+    // Queue a repaint without forcing a synchronous WM_PAINT round trip
+    ShowWindowAsync(hwnd, SW_SHOW);
+    RedrawWindow(hwnd, NULL, NULL, RDW_INVALIDATE | RDW_ERASE | RDW_FRAME | RDW_ALLCHILDREN);
+    
+    return {};
+  });
+}
+
+// EmbedWindow: Embed a window into parent window (runs on the window-ops thread)
+Napi::Value EmbedWindow(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   if (info.Length() < 6 || !info[0].IsNumber() || !info[1].IsNumber() ||
       !info[2].IsNumber() || !info[3].IsNumber() || !info[4].IsNumber() || !info[5].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (hwnd: number, parentHWND: number, x: number, y: number, width: number, height: number)").ThrowAsJavaScriptException();
-    return Napi::Object::New(env);
+    Napi::TypeError::New(env, "Expected (hwnd: number, parentHWND: number, x: number, y: number, width: number, height: number, timeoutMs?: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
   
   HWND hwnd = (HWND)(intptr_t)info[0].As<Napi::Number>().Int64Value();
@@ -150,155 +296,215 @@ Napi::Object EmbedWindow(const Napi::CallbackInfo& info) {
   int y = info[3].As<Napi::Number>().Int32Value();
   int width = info[4].As<Napi::Number>().Int32Value();
   int height = info[5].As<Napi::Number>().Int32Value();
+  uint32_t timeoutMs = WindowOpTimeoutArg(info, 6);
   
+  return QueueWindowOp(env, "embedWindow", MakeEmbedOp(hwnd, parentHWND, x, y, width, height), timeoutMs);
+}
+
+// Defaults for LaunchAndEmbed's options; match the JS polling it replaces
+static const uint32_t kDefaultWindowWaitMs = 30000;
+static const uint32_t kDefaultWindowPollMs = 500;
+
+struct LaunchEmbedRequest {
+  std::string exePath;
+  HWND parentHWND;
+  int x, y, width, height;
+  uint32_t windowWaitMs = kDefaultWindowWaitMs;
+  uint32_t windowPollMs = kDefaultWindowPollMs;
+  uint32_t readyTimeoutMs = kDefaultReadyTimeoutMs;
+  uint32_t embedTimeoutMs = kDefaultWindowOpTimeoutMs;
+};
+
+// Accumulated as the pipeline advances; stage names the step that failed
+struct LaunchEmbedOutcome {
+  bool success = false;
+  const char* stage = "launch";
+  std::string error;
+  const char* status = nullptr;  // Window-op status when the embed step ran
+  DWORD processId = 0;
+  HANDLE processHandle = NULL;
+  HWND hwnd = NULL;
+  bool readinessChecked = false;
+  ReadinessResult readiness;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+// Helper function to convert a launch-and-embed outcome to its JS result
+static Napi::Object LaunchEmbedResultToObject(Napi::Env env, const LaunchEmbedOutcome& outcome) {
   Napi::Object result = Napi::Object::New(env);
-  
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Invalid window handle"));
-    return result;
+  result.Set("success", Napi::Boolean::New(env, outcome.success));
+  result.Set("stage", Napi::String::New(env, outcome.success ? "done" : outcome.stage));
+  if (!outcome.success) {
+    result.Set("error", StringToNapi(env, outcome.error));
   }
-  
-  // First, ensure window is visible and not minimized
-  ShowWindow(hwnd, SW_SHOW);
-  BringWindowToTop(hwnd);
-  SetForegroundWindow(hwnd);
-  
-  // Reparent window (this is what actually embeds it)
-  HWND oldParent = SetParent(hwnd, parentHWND);
-  if (oldParent == NULL && GetLastError() != 0) {
-    DWORD error = GetLastError();
-    // ERROR_INVALID_PARAMETER (87) might mean the app refuses embedding
-    if (error == 87) {
-      result.Set("success", Napi::Boolean::New(env, false));
-      result.Set("error", StringToNapi(env, "Application refuses window embedding (security restriction)"));
-      return result;
-    }
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Failed to set parent: " + GetLastErrorString()));
-    return result;
+  if (outcome.status) {
+    result.Set("status", Napi::String::New(env, outcome.status));
   }
-  
-  // Verify window still exists after SetParent (some apps close when reparented)
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Window closed immediately after embedding (app may not support embedding)"));
-    return result;
+  if (outcome.processId != 0) {
+    result.Set("processId", Napi::Number::New(env, outcome.processId));
+    result.Set("processHandle", Napi::Number::New(env, (intptr_t)outcome.processHandle));
   }
-  
-  // Modify window styles more carefully - only after successful reparenting
-  // First, try minimal changes to avoid triggering app security checks
-  LONG originalStyle = GetWindowLongW(hwnd, GWL_STYLE);
-  LONG originalExStyle = GetWindowLongW(hwnd, GWL_EXSTYLE);
-  
-  // Check if window is still valid after SetParent
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Window closed immediately after SetParent (app security restriction)"));
-    return result;
+  if (outcome.hwnd != NULL) {
+    result.Set("hwnd", Napi::Number::New(env, (intptr_t)outcome.hwnd));
   }
-  
-  // Try to modify styles gradually - some apps close if we change too much at once
-  LONG style = originalStyle;
-  LONG exStyle = originalExStyle;
-  
-  // Remove minimize/maximize buttons and system menu, but keep caption for title bar
-  // Keep WS_CAPTION to show title bar
-  style &= ~(WS_THICKFRAME | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU | WS_POPUP);
-  style |= WS_CHILD | WS_VISIBLE;
-  
-  // Only add caption if it wasn't there, to preserve original look
-  if (originalStyle & WS_CAPTION) {
-    style |= WS_CAPTION | WS_BORDER;
-  } else {
-    // If no caption originally, add border for visual separation
-    style |= WS_BORDER;
-  }
-  
-  exStyle &= ~(WS_EX_DLGMODALFRAME | WS_EX_WINDOWEDGE | WS_EX_CLIENTEDGE | WS_EX_STATICEDGE);
-  
-  // Apply style changes
-  SetWindowLongW(hwnd, GWL_STYLE, style);
-  SetWindowLongW(hwnd, GWL_EXSTYLE, exStyle);
-  
-  // Verify window still exists after style changes
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Window closed after style modification (app may not support embedding)"));
-    return result;
+  if (outcome.readinessChecked) {
+    result.Set("readiness", ReadinessResultToObject(env, outcome.readiness));
   }
+  result.Set("elapsedMs", Napi::Number::New(env, std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - outcome.start).count()));
+  return result;
+}
+
+// Launch -> wait for the main window -> wait for readiness -> embed, as one
+// coroutine. Blocking steps run on the executor, waits hold no thread, and
+// the embed goes through the window-ops thread like EmbedWindow.
+static PromiseTask LaunchAndEmbedTask(Napi::Env env, LaunchEmbedRequest request) {
+  LaunchEmbedOutcome outcome;
+  
+  do {
+    // CreateProcess can take tens of milliseconds (AV scans, shims)
+    if (!co_await ResumeOnExecutor(TaskLane::Interactive)) {
+      outcome.error = "Executor queue is full";
+      break;
+    }
+    PROCESS_INFORMATION pi;
+    if (!StartProcess(request.exePath, &pi, &outcome.error)) break;
+    outcome.processId = pi.dwProcessId;
+    outcome.processHandle = pi.hProcess;
+    
+    outcome.stage = "window";
+    auto windowDeadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(request.windowWaitMs);
+    while (true) {
+      co_await Delay(request.windowPollMs, TaskLane::Interactive);
+      
+      auto start = std::chrono::steady_clock::now();
+      HWND hwnd = FindMainWindow(outcome.processId);
+      auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+      TraceFindMainWindow(outcome.processId, (uint64_t)(uintptr_t)hwnd, (uint64_t)durationUs);
+      
+      if (hwnd != NULL && IsWindow(hwnd)) {
+        outcome.hwnd = hwnd;
+        break;
+      }
+      // A process that has exited will never show a window
+      if (WaitForSingleObject(outcome.processHandle, 0) == WAIT_OBJECT_0) {
+        outcome.error = "Process exited before showing a window";
+        break;
+      }
+      if (std::chrono::steady_clock::now() >= windowDeadline) {
+        outcome.error = "Window not found";
+        break;
+      }
+    }
+    if (outcome.hwnd == NULL) break;
+    
+    outcome.stage = "ready";
+    HWND hwnd = outcome.hwnd;
+    DWORD processId = outcome.processId;
+    uint32_t readyTimeoutMs = request.readyTimeoutMs;
+    outcome.readiness = co_await AwaitCompletion<ReadinessResult>(
+      [hwnd, processId, readyTimeoutMs](AwaitCompletion<ReadinessResult>::Completion complete) {
+        DetectWindowReadiness((uintptr_t)hwnd, processId, readyTimeoutMs, kDefaultTitleStableMs,
+          [complete](const ReadinessResult& result) { complete(result); });
+      });
+    outcome.readinessChecked = true;
+    if (outcome.readiness.windowClosed) {
+      outcome.error = "Window closed before it became ready";
+      break;
+    }
+    
+    outcome.stage = "embed";
+    WindowOpResult embed = co_await RunWindowOp("embedWindow",
+      MakeEmbedOp(hwnd, request.parentHWND, request.x, request.y, request.width, request.height),
+      request.embedTimeoutMs);
+    outcome.status = WindowOpStatusName(embed.status);
+    if (embed.status != WindowOpStatus::Ok) {
+      outcome.error = embed.error;
+      break;
+    }
+    
+    outcome.success = true;
+  } while (false);
   
-  // Position and resize window
-  BOOL posSuccess = SetWindowPos(
-    hwnd,
-    HWND_TOP,
-    x, y,
-    width, height,
-    SWP_SHOWWINDOW | SWP_FRAMECHANGED | SWP_NOZORDER
-  );
+  co_await ResumeOnJsThread();
+  co_return LaunchEmbedResultToObject(env, outcome);
+}
+
+// Helper function to read an optional numeric option
+static uint32_t Uint32Option(const Napi::Object& options, const char* name, uint32_t fallback) {
+  Napi::Value value = options.Get(name);
+  return value.IsNumber() ? value.As<Napi::Number>().Uint32Value() : fallback;
+}
+
+// LaunchAndEmbed: Launch an app, wait for its main window to become ready and
+// embed it. Resolves { success, stage, error?, status?, processId?,
+// processHandle?, hwnd?, readiness?, elapsedMs }; never rejects. The process
+// is left running on failure so the caller decides whether to terminate it.
+Napi::Value LaunchAndEmbed(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
   
-  if (!posSuccess) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Failed to position window: " + GetLastErrorString()));
-    return result;
+  if (info.Length() < 6 || !info[0].IsString() || !info[1].IsNumber() || !info[2].IsNumber() ||
+      !info[3].IsNumber() || !info[4].IsNumber() || !info[5].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (exePath: string, parentHWND: number, x: number, y: number, width: number, height: number, options?: { windowWaitMs, windowPollMs, readyTimeoutMs, embedTimeoutMs })").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
   
-  // Verify window is still valid after all operations
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Window closed during embedding process"));
-    return result;
+  LaunchEmbedRequest request;
+  request.exePath = info[0].As<Napi::String>().Utf8Value();
+  request.parentHWND = (HWND)(intptr_t)info[1].As<Napi::Number>().Int64Value();
+  request.x = info[2].As<Napi::Number>().Int32Value();
+  request.y = info[3].As<Napi::Number>().Int32Value();
+  request.width = info[4].As<Napi::Number>().Int32Value();
+  request.height = info[5].As<Napi::Number>().Int32Value();
+  if (info.Length() > 6 && info[6].IsObject()) {
+    Napi::Object options = info[6].As<Napi::Object>();
+    request.windowWaitMs = Uint32Option(options, "windowWaitMs", request.windowWaitMs);
+    request.windowPollMs = Uint32Option(options, "windowPollMs", request.windowPollMs);
+    request.readyTimeoutMs = Uint32Option(options, "readyTimeoutMs", request.readyTimeoutMs);
+    request.embedTimeoutMs = Uint32Option(options, "embedTimeoutMs", request.embedTimeoutMs);
   }
   
-  // Force repaint and ensure visibility
-  ShowWindow(hwnd, SW_SHOW);
-  BringWindowToTop(hwnd);
-  InvalidateRect(hwnd, NULL, TRUE);
-  UpdateWindow(hwnd);
-  RedrawWindow(hwnd, NULL, NULL, RDW_UPDATENOW | RDW_ALLCHILDREN);
-  
-  result.Set("success", Napi::Boolean::New(env, true));
-  return result;
+  return LaunchAndEmbedTask(env, std::move(request)).Promise();
 }
 
 // ShowWindow: Show or hide a window
-Napi::Object ShowWindowNative(const Napi::CallbackInfo& info) {
+Napi::Value ShowWindowNative(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBoolean()) {
-    Napi::TypeError::New(env, "Expected (hwnd: number, show: boolean)").ThrowAsJavaScriptException();
-    return Napi::Object::New(env);
+    Napi::TypeError::New(env, "Expected (hwnd: number, show: boolean, timeoutMs?: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
   
   HWND hwnd = (HWND)(intptr_t)info[0].As<Napi::Number>().Int64Value();
   bool show = info[1].As<Napi::Boolean>().Value();
+  uint32_t timeoutMs = WindowOpTimeoutArg(info, 2);
   
-  Napi::Object result = Napi::Object::New(env);
-  
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Invalid window handle"));
-    return result;
-  }
-  
-  BOOL success = ::ShowWindow(hwnd, show ? SW_SHOW : SW_HIDE);
-  
-  result.Set("success", Napi::Boolean::New(env, success != FALSE));
-  if (!success) {
-    result.Set("error", StringToNapi(env, GetLastErrorString()));
-  }
-  
-  return result;
+  return QueueWindowOp(env, "showWindow", Traced(show ? TraceWindowOp::Show : TraceWindowOp::Hide, hwnd, NULL, 0, 0, 0, 0, [=]() -> WindowOpResult {
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Invalid window handle" };
+    }
+    if (IsHungAppWindow(hwnd) || IsWindowMarkedHung((uintptr_t)hwnd)) {
+      return { WindowOpStatus::Hung, "Window is not responding" };
+    }
+    
+    if (!ShowWindowAsync(hwnd, show ? SW_SHOW : SW_HIDE) && GetLastError() != 0) {
+      return { WindowOpStatus::Failed, GetLastErrorString() };
+    }
+    return {};
+  }), timeoutMs);
 }
 
 // ResizeWindow: Resize and position a window
-Napi::Object ResizeWindow(const Napi::CallbackInfo& info) {
+Napi::Value ResizeWindow(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   if (info.Length() < 5 || !info[0].IsNumber() || !info[1].IsNumber() ||
       !info[2].IsNumber() || !info[3].IsNumber() || !info[4].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (hwnd: number, x: number, y: number, width: number, height: number)").ThrowAsJavaScriptException();
-    return Napi::Object::New(env);
+    Napi::TypeError::New(env, "Expected (hwnd: number, x: number, y: number, width: number, height: number, timeoutMs?: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
   
   HWND hwnd = (HWND)(intptr_t)info[0].As<Napi::Number>().Int64Value();
@@ -306,116 +512,108 @@ Napi::Object ResizeWindow(const Napi::CallbackInfo& info) {
   int y = info[2].As<Napi::Number>().Int32Value();
   int width = info[3].As<Napi::Number>().Int32Value();
   int height = info[4].As<Napi::Number>().Int32Value();
+  uint32_t timeoutMs = WindowOpTimeoutArg(info, 5);
   
-  Napi::Object result = Napi::Object::New(env);
-  
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Invalid window handle"));
-    return result;
-  }
-  
-  BOOL success = SetWindowPos(
-    hwnd,
-    HWND_TOP,
-    x, y,
-    width, height,
-    SWP_SHOWWINDOW
-  );
-  
-  result.Set("success", Napi::Boolean::New(env, success != FALSE));
-  if (!success) {
-    result.Set("error", StringToNapi(env, GetLastErrorString()));
-  }
-  
-  return result;
+  return QueueWindowOp(env, "resizeWindow", Traced(TraceWindowOp::Resize, hwnd, NULL, x, y, width, height, [=]() -> WindowOpResult {
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Invalid window handle" };
+    }
+    if (IsHungAppWindow(hwnd) || IsWindowMarkedHung((uintptr_t)hwnd)) {
+      return { WindowOpStatus::Hung, "Window is not responding" };
+    }
+    
+    BOOL success = SetWindowPos(
+      hwnd,
+      HWND_TOP,
+      x, y,
+      width, height,
+      SWP_SHOWWINDOW | SWP_ASYNCWINDOWPOS
+    );
+    
+    if (!success) {
+      return { WindowOpStatus::Failed, GetLastErrorString() };
+    }
+    return {};
+  }), timeoutMs);
 }
 
 // MoveWindowNative: Move a window to new position (without resizing)
-Napi::Object MoveWindowNative(const Napi::CallbackInfo& info) {
+Napi::Value MoveWindowNative(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (hwnd: number, x: number, y: number)").ThrowAsJavaScriptException();
-    return Napi::Object::New(env);
+    Napi::TypeError::New(env, "Expected (hwnd: number, x: number, y: number, timeoutMs?: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
   
   HWND hwnd = (HWND)(intptr_t)info[0].As<Napi::Number>().Int64Value();
   int x = info[1].As<Napi::Number>().Int32Value();
   int y = info[2].As<Napi::Number>().Int32Value();
+  uint32_t timeoutMs = WindowOpTimeoutArg(info, 3);
   
-  Napi::Object result = Napi::Object::New(env);
-  
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Invalid window handle"));
-    return result;
-  }
-  
-  // Get current window size to preserve it
-  RECT rect;
-  if (!GetWindowRect(hwnd, &rect)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Failed to get window size: " + GetLastErrorString()));
-    return result;
-  }
-  
-  int width = rect.right - rect.left;
-  int height = rect.bottom - rect.top;
-  
-  BOOL success = SetWindowPos(
-    hwnd,
-    HWND_TOP,
-    x, y,
-    width, height,
-    SWP_NOSIZE | SWP_SHOWWINDOW
-  );
-  
-  result.Set("success", Napi::Boolean::New(env, success != FALSE));
-  if (!success) {
-    result.Set("error", StringToNapi(env, GetLastErrorString()));
-  }
-  
-  return result;
+  return QueueWindowOp(env, "moveWindow", Traced(TraceWindowOp::Move, hwnd, NULL, x, y, 0, 0, [=]() -> WindowOpResult {
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Invalid window handle" };
+    }
+    if (IsHungAppWindow(hwnd) || IsWindowMarkedHung((uintptr_t)hwnd)) {
+      return { WindowOpStatus::Hung, "Window is not responding" };
+    }
+    
+    // SWP_NOSIZE keeps the current size, so no GetWindowRect round trip is needed
+    BOOL success = SetWindowPos(
+      hwnd,
+      HWND_TOP,
+      x, y,
+      0, 0,
+      SWP_NOSIZE | SWP_SHOWWINDOW | SWP_ASYNCWINDOWPOS
+    );
+    
+    if (!success) {
+      return { WindowOpStatus::Failed, GetLastErrorString() };
+    }
+    return {};
+  }), timeoutMs);
 }
 
 // UnparentWindow: Restore window to desktop
-Napi::Object UnparentWindow(const Napi::CallbackInfo& info) {
+Napi::Value UnparentWindow(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (hwnd: number)").ThrowAsJavaScriptException();
-    return Napi::Object::New(env);
+    Napi::TypeError::New(env, "Expected (hwnd: number, timeoutMs?: number)").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
   
   HWND hwnd = (HWND)(intptr_t)info[0].As<Napi::Number>().Int64Value();
+  uint32_t timeoutMs = WindowOpTimeoutArg(info, 1);
   
-  Napi::Object result = Napi::Object::New(env);
-  
-  if (!IsWindow(hwnd)) {
-    result.Set("success", Napi::Boolean::New(env, false));
-    result.Set("error", StringToNapi(env, "Invalid window handle"));
-    return result;
-  }
-  
-  // Restore window styles
-  LONG style = GetWindowLongW(hwnd, GWL_STYLE);
-  style &= ~WS_CHILD;
-  style |= (WS_CAPTION | WS_THICKFRAME | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU);
-  SetWindowLongW(hwnd, GWL_STYLE, style);
-  
-  // Unparent
-  HWND oldParent = SetParent(hwnd, NULL);
-  
-  // Restore window position
-  SetWindowPos(hwnd, NULL, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
-  
-  result.Set("success", Napi::Boolean::New(env, oldParent != NULL || GetLastError() == 0));
-  if (oldParent == NULL && GetLastError() != 0) {
-    result.Set("error", StringToNapi(env, GetLastErrorString()));
-  }
-  
-  return result;
+  return QueueWindowOp(env, "unparentWindow", Traced(TraceWindowOp::Unparent, hwnd, NULL, 0, 0, 0, 0, [=]() -> WindowOpResult {
+    if (!IsWindow(hwnd)) {
+      return { WindowOpStatus::InvalidWindow, "Invalid window handle" };
+    }
+    if (!IsWindowResponsive(hwnd, kResponsiveProbeMs)) {
+      return { WindowOpStatus::Hung, "Window is not responding" };
+    }
+    
+    // Restore window styles
+    LONG style = GetWindowLongW(hwnd, GWL_STYLE);
+    style &= ~WS_CHILD;
+    style |= (WS_CAPTION | WS_THICKFRAME | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SYSMENU);
+    SetWindowLongW(hwnd, GWL_STYLE, style);
+    
+    // Unparent
+    SetLastError(0);
+    HWND oldParent = SetParent(hwnd, NULL);
+    if (oldParent == NULL && GetLastError() != 0) {
+      return { WindowOpStatus::Failed, GetLastErrorString() };
+    }
+    TraceWindowReparent((uint64_t)(uintptr_t)hwnd, 0);
+    
+    // Restore window frame
+    SetWindowPos(hwnd, NULL, 0, 0, 0, 0,
+                 SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED | SWP_ASYNCWINDOWPOS);
+    return {};
+  }), timeoutMs);
 }
 
 // TerminateProcess: Terminate a process
@@ -463,6 +661,7 @@ Napi::Object GetWindowInfoNative(const Napi::CallbackInfo& info) {
   Napi::Object result = Napi::Object::New(env);
   
   if (!IsWindow(hwnd)) {
+    TraceWindowDestroy((uint64_t)(uintptr_t)hwnd);
     result.Set("success", Napi::Boolean::New(env, false));
     result.Set("error", StringToNapi(env, "Invalid window handle"));
     return result;
@@ -512,7 +711,11 @@ Napi::Object GetMainWindowAPI(const Napi::CallbackInfo& info) {
   
   Napi::Object result = Napi::Object::New(env);
   
+  auto start = std::chrono::steady_clock::now();
   HWND hwnd = FindMainWindow(processId);
+  auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start).count();
+  TraceFindMainWindow(processId, (uint64_t)(uintptr_t)hwnd, (uint64_t)durationUs);
   
   if (hwnd != NULL && IsWindow(hwnd)) {
     result.Set("success", Napi::Boolean::New(env, true));
@@ -524,12 +727,99 @@ Napi::Object GetMainWindowAPI(const Napi::CallbackInfo& info) {
   return result;
 }
 
+#endif  // _WIN32
+
 // Initialize module
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  // Cross-process window calls run on a dedicated thread (window-ops.cc)
+  InitWindowOps(env);
+  
+  // Window-system trace recording and replay (defined in window-trace-replay.cc).
+  // Replay runs against the simulated window system, so it works on any platform.
+  exports.Set(Napi::String::New(env, "startWindowTrace"),
+              Napi::Function::New(env, StartWindowTrace));
+  exports.Set(Napi::String::New(env, "stopWindowTrace"),
+              Napi::Function::New(env, StopWindowTrace));
+  exports.Set(Napi::String::New(env, "replayWindowTrace"),
+              Napi::Function::New(env, ReplayWindowTrace));
+  
+  // Embedded-tab stress harness on the simulated window system (defined in window-stress.cc)
+  exports.Set(Napi::String::New(env, "runWindowStress"),
+              Napi::Function::New(env, RunWindowStress));
+  
+  // Discovery/embed benchmark over fault-injected fake backends (defined in discovery-benchmark.cc)
+  exports.Set(Napi::String::New(env, "runDiscoveryBenchmark"),
+              Napi::Function::New(env, RunDiscoveryBenchmark));
+  
+  // Foreground-boost / background priority policy for tab process trees (defined in process-priority.cc)
+  exports.Set(Napi::String::New(env, "setProcessPriority"),
+              Napi::Function::New(env, SetProcessPriority));
+  
+  // Idle-time rescans and enrichment (defined in idle-scheduler.cc)
+  exports.Set(Napi::String::New(env, "startIdleScheduler"),
+              Napi::Function::New(env, StartIdleScheduler));
+  exports.Set(Napi::String::New(env, "scheduleIdleWork"),
+              Napi::Function::New(env, ScheduleIdleWork));
+  exports.Set(Napi::String::New(env, "getIdleState"),
+              Napi::Function::New(env, GetIdleState));
+  
+  // Scoop/Chocolatey/winget apps from package manifests, live or over fixtures
+  // (defined in package-manager-scan.cc)
+  exports.Set(Napi::String::New(env, "scanPackageManagerApps"),
+              Napi::Function::New(env, ScanPackageManagerApps));
+  
+  // Steam/Epic/GOG games from store manifests, live or over fixtures
+  // (defined in game-library-scan.cc)
+  exports.Set(Napi::String::New(env, "scanGameLibraryApps"),
+              Napi::Function::New(env, ScanGameLibraryApps));
+  
+  // Every discovery source, scheduled by cost and freshness and merged by
+  // precedence (defined in discovery-sources.cc)
+  exports.Set(Napi::String::New(env, "discoverApps"),
+              Napi::Function::New(env, DiscoverApps));
+  
+  // Uninstall-entry discovery as a staged pipeline, with per-stage throughput
+  // and queue occupancy (defined in discovery-pipeline.cc)
+  exports.Set(Napi::String::New(env, "runDiscoveryPipeline"),
+              Napi::Function::New(env, RunDiscoveryPipeline));
+  
+  // Portable discovery catalogs for seeding imaged machines (defined in catalog.cc)
+  exports.Set(Napi::String::New(env, "exportCatalog"),
+              Napi::Function::New(env, ExportCatalog));
+  exports.Set(Napi::String::New(env, "importCatalog"),
+              Napi::Function::New(env, ImportCatalog));
+  
+  // Batch stats through the shared stat cache (defined in stat-cache.cc)
+  exports.Set(Napi::String::New(env, "statPaths"),
+              Napi::Function::New(env, StatPaths));
+  exports.Set(Napi::String::New(env, "getStatCacheStats"),
+              Napi::Function::New(env, GetStatCacheStats));
+  
+  // Authenticode signers from PE certificate tables (defined in authenticode.cc)
+  exports.Set(Napi::String::New(env, "readSigners"),
+              Napi::Function::New(env, ReadSigners));
+  
+  // Bitmap facet indexes over catalog rows (defined in facet-index.cc)
+  exports.Set(Napi::String::New(env, "buildFacetIndex"),
+              Napi::Function::New(env, BuildFacetIndex));
+  exports.Set(Napi::String::New(env, "queryFacetIndex"),
+              Napi::Function::New(env, QueryFacetIndex));
+  
+  // UserAssist launch history (defined in user-assist.cc)
+  exports.Set(Napi::String::New(env, "readUserAssist"),
+              Napi::Function::New(env, ReadUserAssistHistory));
+  
+  // Shared task executor diagnostics (defined in executor.cc)
+  exports.Set(Napi::String::New(env, "getExecutorStats"),
+              Napi::Function::New(env, GetExecutorStats));
+  
+#ifdef _WIN32
   exports.Set(Napi::String::New(env, "launchApplication"),
               Napi::Function::New(env, LaunchApplication));
   exports.Set(Napi::String::New(env, "embedWindow"),
               Napi::Function::New(env, EmbedWindow));
+  exports.Set(Napi::String::New(env, "launchAndEmbed"),
+              Napi::Function::New(env, LaunchAndEmbed));
   exports.Set(Napi::String::New(env, "showWindow"),
               Napi::Function::New(env, ShowWindowNative));
   exports.Set(Napi::String::New(env, "resizeWindow"),
@@ -545,15 +835,42 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set(Napi::String::New(env, "getMainWindow"),
               Napi::Function::New(env, GetMainWindowAPI));
   
+  // Hung-window watchdog (defined in hang-watchdog.cc)
+  exports.Set(Napi::String::New(env, "startHangWatchdog"),
+              Napi::Function::New(env, StartHangWatchdog));
+  exports.Set(Napi::String::New(env, "watchWindow"),
+              Napi::Function::New(env, WatchWindow));
+  exports.Set(Napi::String::New(env, "unwatchWindow"),
+              Napi::Function::New(env, UnwatchWindow));
+  
+  // Batched window commands from the renderer (defined in window-commands.cc)
+  exports.Set(Napi::String::New(env, "createWindowCommandRing"),
+              Napi::Function::New(env, CreateWindowCommandRing));
+  exports.Set(Napi::String::New(env, "bindWindowCommandSlot"),
+              Napi::Function::New(env, BindWindowCommandSlot));
+  exports.Set(Napi::String::New(env, "unbindWindowCommandSlot"),
+              Napi::Function::New(env, UnbindWindowCommandSlot));
+  exports.Set(Napi::String::New(env, "applyWindowCommands"),
+              Napi::Function::New(env, ApplyWindowCommands));
+  
+  // First-paint readiness detection (defined in window-readiness.cc)
+  exports.Set(Napi::String::New(env, "waitForWindowReady"),
+              Napi::Function::New(env, WaitForWindowReady));
+  
   // App discovery functions (defined in app-discovery.cc)
   exports.Set(Napi::String::New(env, "scanRegistry"),
               Napi::Function::New(env, ScanRegistry));
+  exports.Set(Napi::String::New(env, "scanRegisteredApps"),
+              Napi::Function::New(env, ScanRegisteredApps));
   exports.Set(Napi::String::New(env, "scanProgramFiles"),
               Napi::Function::New(env, ScanProgramFiles));
   exports.Set(Napi::String::New(env, "scanSystemApps"),
               Napi::Function::New(env, ScanSystemApps));
+  exports.Set(Napi::String::New(env, "scanUserApps"),
+              Napi::Function::New(env, ScanUserApps));
   exports.Set(Napi::String::New(env, "extractAppIcon"),
               Napi::Function::New(env, ExtractAppIcon));
+#endif
   
   return exports;
 }
@@ -0,0 +1,38 @@
+#include "window-model.h"
+
+// Shell and control classes that can share a process with the real app window
+static bool IsSystemWindowClass(const std::string& className) {
+  static const char* const kSystemClasses[] = {
+    "Shell_TrayWnd",
+    "Button",
+    "Progman",
+    "Shell_SecondaryTrayWnd"
+  };
+  for (const char* systemClass : kSystemClasses) {
+    if (className == systemClass) return true;
+  }
+  return false;
+}
+
+uint64_t SelectMainWindow(const std::vector<WindowCandidate>& windows) {
+  uint64_t fallback = 0;
+
+  for (const WindowCandidate& window : windows) {
+    // Skip system windows
+    if (IsSystemWindowClass(window.className)) continue;
+
+    // Prefer visible windows with no parent that have a title or caption
+    // style (likely a real app window)
+    if (window.visible && !window.hasParent &&
+        (!window.title.empty() || window.framed)) {
+      return window.handle;
+    }
+
+    // Remember the first non-tool window as fallback (even if not visible yet)
+    if (fallback == 0 && !window.toolWindow) {
+      fallback = window.handle;
+    }
+  }
+
+  return fallback;
+}
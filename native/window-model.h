@@ -0,0 +1,28 @@
+#ifndef WINDOW_MODEL_H
+#define WINDOW_MODEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Platform-neutral description of a top-level window, as seen while
+// searching for a launched process's main window. Filled from EnumWindows on
+// Windows and from the simulated window system during trace replay.
+struct WindowCandidate {
+  uint64_t handle = 0;
+  uint32_t processId = 0;
+  std::string className;
+  std::string title;
+  bool visible = false;
+  bool hasParent = false;
+  bool framed = false;      // WS_CAPTION or WS_BORDER
+  bool toolWindow = false;  // WS_EX_TOOLWINDOW
+};
+
+// Pick the main window from a process's windows in enumeration (z) order.
+// Prefers the first visible, unparented window that has a title or frame,
+// falling back to the first window that is not a tool window. Returns 0 if
+// nothing qualifies.
+uint64_t SelectMainWindow(const std::vector<WindowCandidate>& windows);
+
+#endif
@@ -0,0 +1,251 @@
+#include <napi.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "window-ops.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Workers left blocked inside a hung application are detached and replaced.
+// Past this many, queued operations time out until one of them comes back.
+constexpr int kMaxAbandonedWorkers = 4;
+
+struct PendingOp {
+  std::string name;
+  WindowOpFn fn;
+  WindowOpCallback onSettled;  // Only called on the JS thread
+  Clock::time_point queuedAt;
+  Clock::time_point deadline;
+  std::atomic<bool> settled{false};
+  WindowOpResult result;
+};
+
+using PendingOpPtr = std::shared_ptr<PendingOp>;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+Napi::Object ResultToObject(Napi::Env env, const WindowOpResult& opResult) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, opResult.status == WindowOpStatus::Ok));
+  result.Set("status", Napi::String::New(env, WindowOpStatusName(opResult.status)));
+  if (!opResult.error.empty()) {
+    result.Set("error", Napi::String::New(env, opResult.error));
+  }
+  result.Set("elapsedMs", Napi::Number::New(env, opResult.elapsedMs));
+  return result;
+}
+
+// Single worker thread that owns every cross-process window call, plus a
+// supervisor that enforces per-operation deadlines. When the running operation
+// overruns its deadline the worker is assumed to be stuck in a synchronous
+// message to a hung window: its promise settles as "timeout", the thread is
+// abandoned, and a fresh worker takes over the rest of the queue.
+class WindowOpsQueue {
+ public:
+  void Start(Napi::Env env) {
+    tsfn_ = Napi::ThreadSafeFunction::New(
+      env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "windowOps", 0, 1);
+    tsfn_.Unref(env);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_ = true;
+    SpawnWorker();
+    supervisor_ = std::thread(&WindowOpsQueue::SupervisorLoop, this);
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!started_ || stopping_) return;
+      stopping_ = true;
+    }
+    workCv_.notify_all();
+    supervisorCv_.notify_all();
+    if (supervisor_.joinable()) supervisor_.join();
+    tsfn_.Release();
+  }
+
+  bool Push(PendingOpPtr op) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!started_ || stopping_) return false;
+      queue_.push_back(std::move(op));
+    }
+    workCv_.notify_one();
+    supervisorCv_.notify_one();
+    return true;
+  }
+
+ private:
+  // Caller holds mutex_. Workers are always detached: one may be blocked
+  // indefinitely inside a foreign window procedure and must never be joined.
+  void SpawnWorker() {
+    workerActive_ = true;
+    std::thread(&WindowOpsQueue::WorkerLoop, this, generation_).detach();
+  }
+
+  void WorkerLoop(uint64_t generation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      workCv_.wait(lock, [&] {
+        return stopping_ || generation != generation_ || !queue_.empty();
+      });
+      if (stopping_ || generation != generation_) break;
+
+      PendingOpPtr op = queue_.front();
+      queue_.pop_front();
+      if (op->settled) continue;  // Timed out while still queued
+
+      running_ = op;
+      lock.unlock();
+      WindowOpResult result = op->fn();
+      Settle(op, std::move(result));
+      lock.lock();
+
+      if (generation != generation_) {
+        // Abandoned while blocked. Step back in if the replacement was never
+        // spawned because too many workers were already stuck.
+        abandoned_--;
+        if (stopping_ || workerActive_) return;
+        generation = generation_;
+        workerActive_ = true;
+        continue;
+      }
+      running_.reset();
+    }
+    if (generation == generation_) workerActive_ = false;
+  }
+
+  void SupervisorLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+      Clock::time_point now = Clock::now();
+      Clock::time_point next = Clock::time_point::max();
+
+      for (const PendingOpPtr& op : queue_) {
+        if (op->settled) continue;
+        if (op->deadline <= now) {
+          Settle(op, { WindowOpStatus::Timeout,
+                       op->name + " timed out waiting for the window-ops thread" });
+        } else if (op->deadline < next) {
+          next = op->deadline;
+        }
+      }
+
+      if (running_ && !running_->settled) {
+        if (running_->deadline <= now) {
+          Settle(running_, { WindowOpStatus::Timeout,
+                             running_->name + " timed out: window is not responding" });
+          running_.reset();
+          generation_++;
+          workerActive_ = false;
+          abandoned_++;
+          if (abandoned_ <= kMaxAbandonedWorkers) {
+            SpawnWorker();
+          }
+          workCv_.notify_all();
+          continue;
+        }
+        if (running_->deadline < next) next = running_->deadline;
+      }
+
+      if (next == Clock::time_point::max()) {
+        supervisorCv_.wait(lock);
+      } else {
+        supervisorCv_.wait_until(lock, next);
+      }
+    }
+  }
+
+  void Settle(const PendingOpPtr& op, WindowOpResult result) {
+    if (op->settled.exchange(true)) return;
+    op->result = std::move(result);
+    op->result.elapsedMs = MillisecondsSince(op->queuedAt);
+
+    auto* data = new PendingOpPtr(op);
+    napi_status status = tsfn_.BlockingCall(data, [](Napi::Env env, Napi::Function, PendingOpPtr* data) {
+      PendingOp& op = **data;
+      op.onSettled(env, op.result);
+      delete data;
+    });
+    if (status != napi_ok) {
+      delete data;
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable workCv_;
+  std::condition_variable supervisorCv_;
+  std::deque<PendingOpPtr> queue_;
+  PendingOpPtr running_;
+  uint64_t generation_ = 0;
+  int abandoned_ = 0;
+  bool workerActive_ = false;
+  bool started_ = false;
+  bool stopping_ = false;
+  std::thread supervisor_;
+  Napi::ThreadSafeFunction tsfn_;
+};
+
+// Intentionally leaked: abandoned workers may still touch it after the
+// environment has been torn down.
+WindowOpsQueue* g_windowOps = new WindowOpsQueue();
+
+}  // namespace
+
+const char* WindowOpStatusName(WindowOpStatus status) {
+  switch (status) {
+    case WindowOpStatus::Ok: return "ok";
+    case WindowOpStatus::Failed: return "failed";
+    case WindowOpStatus::InvalidWindow: return "invalid";
+    case WindowOpStatus::Hung: return "hung";
+    case WindowOpStatus::Timeout: return "timeout";
+  }
+  return "failed";
+}
+
+void InitWindowOps(Napi::Env env) {
+  g_windowOps->Start(env);
+  env.AddCleanupHook([]() { g_windowOps->Stop(); });
+}
+
+void QueueWindowOpWithCallback(Napi::Env env, const char* name, WindowOpFn fn,
+                               uint32_t timeoutMs, WindowOpCallback onSettled) {
+  auto op = std::make_shared<PendingOp>();
+  op->name = name;
+  op->fn = std::move(fn);
+  op->onSettled = std::move(onSettled);
+  op->queuedAt = Clock::now();
+  op->deadline = op->queuedAt + std::chrono::milliseconds(timeoutMs);
+
+  if (!g_windowOps->Push(op)) {
+    op->settled = true;
+    op->result = { WindowOpStatus::Failed, "Window-ops thread is not running" };
+    op->onSettled(env, op->result);
+  }
+}
+
+Napi::Promise QueueWindowOp(Napi::Env env, const char* name, WindowOpFn fn, uint32_t timeoutMs) {
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  QueueWindowOpWithCallback(env, name, std::move(fn), timeoutMs,
+    [deferred](Napi::Env env, const WindowOpResult& result) {
+      deferred.Resolve(ResultToObject(env, result));
+    });
+  return deferred.Promise();
+}
+
+uint32_t WindowOpTimeoutArg(const Napi::CallbackInfo& info, size_t index) {
+  if (info.Length() > index && info[index].IsNumber()) {
+    uint32_t timeoutMs = info[index].As<Napi::Number>().Uint32Value();
+    if (timeoutMs > 0) return timeoutMs;
+  }
+  return kDefaultWindowOpTimeoutMs;
+}
@@ -0,0 +1,52 @@
+#ifndef WINDOW_OPS_H
+#define WINDOW_OPS_H
+
+#include <napi.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Outcome of a cross-process window operation run on the window-ops thread
+enum class WindowOpStatus {
+  Ok,
+  Failed,
+  InvalidWindow,
+  Hung,
+  Timeout
+};
+
+struct WindowOpResult {
+  WindowOpStatus status = WindowOpStatus::Ok;
+  std::string error;
+  double elapsedMs = 0;
+};
+
+using WindowOpFn = std::function<WindowOpResult()>;
+using WindowOpCallback = std::function<void(Napi::Env, const WindowOpResult&)>;
+
+// Default budget for a single window operation before its promise settles
+// with status "timeout"
+constexpr uint32_t kDefaultWindowOpTimeoutMs = 2000;
+
+// Start the window-ops worker and its supervisor. Called once from Init.
+void InitWindowOps(Napi::Env env);
+
+// Queue fn on the window-ops worker thread and return a promise that resolves
+// with { success, status, error?, elapsedMs }. The promise never rejects: an
+// operation that is still running when timeoutMs elapses settles as "timeout",
+// and the worker stuck inside it is abandoned and replaced so later operations
+// are not queued behind a hung application.
+Napi::Promise QueueWindowOp(Napi::Env env, const char* name, WindowOpFn fn, uint32_t timeoutMs);
+
+// Same queueing and deadline handling as QueueWindowOp, but onSettled is
+// called on the JS thread instead of settling a promise. Lets native callers
+// (e.g. the stress harness) issue operations without a promise per call.
+void QueueWindowOpWithCallback(Napi::Env env, const char* name, WindowOpFn fn,
+                               uint32_t timeoutMs, WindowOpCallback onSettled);
+
+// Read an optional trailing timeoutMs argument, falling back to the default
+uint32_t WindowOpTimeoutArg(const Napi::CallbackInfo& info, size_t index);
+
+const char* WindowOpStatusName(WindowOpStatus status);
+
+#endif
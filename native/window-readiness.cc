@@ -0,0 +1,204 @@
+#include <napi.h>
+#include <windows.h>
+#include <dwmapi.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include "window-readiness.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// How often signals that have no event (input idle, update region) are
+// re-checked while waiting for window events
+constexpr DWORD kPollIntervalMs = 16;
+
+struct ReadinessRequest {
+  HWND hwnd;
+  DWORD processId;
+  uint32_t timeoutMs;
+  uint32_t titleStableMs;
+  std::function<void(const ReadinessResult&)> onDone;
+  ReadinessResult result;
+};
+
+// State shared with the WinEvent callback, which only receives events
+// (no user pointer) on the thread that installed the hook
+struct HookState {
+  HWND hwnd;
+  bool showSeen = false;
+  Clock::time_point lastTitleChange;
+};
+
+thread_local HookState* t_hookState = nullptr;
+
+void CALLBACK OnWinEvent(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject,
+                         LONG idChild, DWORD, DWORD) {
+  if (!t_hookState || hwnd != t_hookState->hwnd ||
+      idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+    return;
+  }
+  if (event == EVENT_OBJECT_SHOW) {
+    t_hookState->showSeen = true;
+  } else if (event == EVENT_OBJECT_NAMECHANGE) {
+    t_hookState->lastTitleChange = Clock::now();
+  }
+}
+
+bool IsCloaked(HWND hwnd) {
+  // UWP and some Chromium windows stay cloaked by DWM until their first frame
+  DWORD cloaked = 0;
+  return SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) &&
+    cloaked != 0;
+}
+
+std::wstring ReadTitle(HWND hwnd) {
+  wchar_t title[256];
+  int length = GetWindowTextW(hwnd, title, sizeof(title) / sizeof(wchar_t));
+  return std::wstring(title, length > 0 ? length : 0);
+}
+
+// Runs on a dedicated thread: installs an out-of-context WinEvent hook for
+// the owning process and pumps messages until every readiness signal is seen,
+// the window goes away, or the cap elapses.
+void DetectReadiness(ReadinessRequest* request) {
+  Clock::time_point start = Clock::now();
+  Clock::time_point deadline = start + std::chrono::milliseconds(request->timeoutMs);
+  HWND hwnd = request->hwnd;
+
+  HookState hookState;
+  hookState.hwnd = hwnd;
+  hookState.lastTitleChange = start;
+  t_hookState = &hookState;
+
+  HWINEVENTHOOK hook = SetWinEventHook(
+    EVENT_OBJECT_SHOW, EVENT_OBJECT_NAMECHANGE, NULL, OnWinEvent,
+    request->processId, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+
+  HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | SYNCHRONIZE, FALSE, request->processId);
+  std::wstring title = ReadTitle(hwnd);
+  ReadinessSignals& signals = request->result.signals;
+
+  while (true) {
+    MSG msg;
+    while (PeekMessageW(&msg, NULL, 0, 0, PM_REMOVE)) {
+      DispatchMessageW(&msg);
+    }
+
+    Clock::time_point now = Clock::now();
+    if (!IsWindow(hwnd)) {
+      request->result.windowClosed = true;
+      break;
+    }
+
+    // Titles are also polled: not every app raises NAMECHANGE for caption
+    // updates made before the hook was installed
+    std::wstring currentTitle = ReadTitle(hwnd);
+    if (currentTitle != title) {
+      title = currentTitle;
+      hookState.lastTitleChange = now;
+    }
+
+    signals.shown = hookState.showSeen || IsWindowVisible(hwnd);
+    // A visible, uncloaked window with no pending update region has painted
+    signals.painted = signals.shown && !IsCloaked(hwnd) && !GetUpdateRect(hwnd, NULL, FALSE);
+    if (!signals.inputIdle) {
+      // WAIT_FAILED means no message queue to wait on (e.g. console apps)
+      DWORD idle = hProcess ? WaitForInputIdle(hProcess, 0) : WAIT_FAILED;
+      signals.inputIdle = idle == 0 || idle == WAIT_FAILED;
+    }
+    signals.titleStable =
+      now - hookState.lastTitleChange >= std::chrono::milliseconds(request->titleStableMs);
+
+    if (signals.All()) break;
+    if (now >= deadline) {
+      request->result.timedOut = true;
+      break;
+    }
+
+    MsgWaitForMultipleObjects(0, NULL, FALSE, kPollIntervalMs, QS_ALLINPUT);
+  }
+
+  if (hProcess) CloseHandle(hProcess);
+  if (hook) UnhookWinEvent(hook);
+  t_hookState = nullptr;
+
+  request->result.elapsedMs =
+    std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  request->onDone(request->result);
+  delete request;
+}
+
+uint32_t ReadOption(const Napi::Object& options, const char* name, uint32_t fallback) {
+  Napi::Value value = options.Get(name);
+  return value.IsNumber() ? value.As<Napi::Number>().Uint32Value() : fallback;
+}
+
+}  // namespace
+
+void DetectWindowReadiness(uintptr_t hwnd, uint32_t processId, uint32_t timeoutMs,
+                           uint32_t titleStableMs, std::function<void(const ReadinessResult&)> onDone) {
+  auto* request = new ReadinessRequest{
+    (HWND)hwnd, processId, timeoutMs, titleStableMs, std::move(onDone), {}
+  };
+  std::thread(DetectReadiness, request).detach();
+}
+
+Napi::Object ReadinessResultToObject(Napi::Env env, const ReadinessResult& result) {
+  Napi::Object value = Napi::Object::New(env);
+  value.Set("success", Napi::Boolean::New(env, !result.windowClosed));
+  if (result.windowClosed) {
+    value.Set("error", Napi::String::New(env, "Window closed before it became ready"));
+  }
+  value.Set("ready", Napi::Boolean::New(env, result.signals.All()));
+  value.Set("timedOut", Napi::Boolean::New(env, result.timedOut));
+  value.Set("elapsedMs", Napi::Number::New(env, result.elapsedMs));
+
+  Napi::Object signals = Napi::Object::New(env);
+  signals.Set("shown", Napi::Boolean::New(env, result.signals.shown));
+  signals.Set("painted", Napi::Boolean::New(env, result.signals.painted));
+  signals.Set("inputIdle", Napi::Boolean::New(env, result.signals.inputIdle));
+  signals.Set("titleStable", Napi::Boolean::New(env, result.signals.titleStable));
+  value.Set("signals", signals);
+  return value;
+}
+
+// WaitForWindowReady: Resolve once a window is shown, painted, input-idle and
+// has a stable title, or when options.timeoutMs (the cap) elapses
+Napi::Value WaitForWindowReady(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (hwnd: number, processId: number, options?: { timeoutMs, titleStableMs })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  uint32_t timeoutMs = kDefaultReadyTimeoutMs;
+  uint32_t titleStableMs = kDefaultTitleStableMs;
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    timeoutMs = ReadOption(options, "timeoutMs", timeoutMs);
+    titleStableMs = ReadOption(options, "titleStableMs", titleStableMs);
+  }
+
+  uintptr_t hwnd = (uintptr_t)info[0].As<Napi::Number>().Int64Value();
+  uint32_t processId = info[1].As<Napi::Number>().Uint32Value();
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+    env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "windowReadiness", 0, 1);
+
+  DetectWindowReadiness(hwnd, processId, timeoutMs, titleStableMs,
+    [deferred, tsfn](const ReadinessResult& result) mutable {
+      auto* settled = new ReadinessResult(result);
+      tsfn.BlockingCall(settled, [deferred](Napi::Env env, Napi::Function, ReadinessResult* result) {
+        deferred.Resolve(ReadinessResultToObject(env, *result));
+        delete result;
+      });
+      tsfn.Release();
+    });
+  return deferred.Promise();
+}
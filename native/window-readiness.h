@@ -0,0 +1,39 @@
+#ifndef WINDOW_READINESS_H
+#define WINDOW_READINESS_H
+
+#include <napi.h>
+#include <cstdint>
+#include <functional>
+
+constexpr uint32_t kDefaultReadyTimeoutMs = 5000;
+constexpr uint32_t kDefaultTitleStableMs = 150;
+
+struct ReadinessSignals {
+  bool shown = false;
+  bool painted = false;
+  bool inputIdle = false;
+  bool titleStable = false;
+
+  bool All() const { return shown && painted && inputIdle && titleStable; }
+};
+
+struct ReadinessResult {
+  bool windowClosed = false;
+  bool timedOut = false;
+  double elapsedMs = 0;
+  ReadinessSignals signals;
+};
+
+// Start readiness detection for a window on a dedicated thread; onDone is
+// called on that thread once every signal is seen, the window goes away, or
+// timeoutMs elapses
+void DetectWindowReadiness(uintptr_t hwnd, uint32_t processId, uint32_t timeoutMs,
+                           uint32_t titleStableMs, std::function<void(const ReadinessResult&)> onDone);
+
+// { success, error?, ready, timedOut, elapsedMs, signals }
+Napi::Object ReadinessResultToObject(Napi::Env env, const ReadinessResult& result);
+
+// Function declarations for first-paint readiness detection
+Napi::Value WaitForWindowReady(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,345 @@
+#include <napi.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fault-injection.h"
+#include "latency-stats.h"
+#include "sim-window-system.h"
+#include "window-ops.h"
+#include "window-stress.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+enum StressPhase { kPhaseEmbed, kPhaseResize, kPhaseSwitch, kPhaseClose, kPhaseCount };
+const char* const kPhaseNames[kPhaseCount] = { "embed", "resize", "tabSwitch", "close" };
+
+// Pid range for synthetic processes, away from anything a trace would contain
+constexpr uint32_t kFirstStressProcessId = 0x40000000;
+
+// Slack on top of the op timeout when waiting for a phase to drain
+constexpr uint32_t kDrainSlackMs = 1000;
+
+struct StressOptions {
+  uint32_t windows = 24;
+  uint32_t resizeStorms = 30;
+  uint32_t resizeIntervalMs = 16;  // One burst per frame, as during a window drag
+  uint32_t tabSwitches = 200;
+  uint32_t switchIntervalMs = 5;
+  uint32_t opCostUs = 200;         // Simulated cross-process round trip per call
+  uint32_t probeIntervalMs = 5;
+  uint32_t timeoutMs = kDefaultWindowOpTimeoutMs;
+};
+
+// Recorders are only touched on the JS thread; durationMs is written by the
+// driver before the report is built there
+struct PhaseStats {
+  LatencyRecorder ops;
+  LatencyRecorder lag;
+  double durationMs = 0;
+};
+
+struct StressRun {
+  explicit StressRun(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+  StressOptions options;
+  FaultInjector faults;
+  SimWindowSystem sim;
+  std::vector<uint64_t> handles;
+  Napi::Promise::Deferred deferred;
+  Napi::ThreadSafeFunction tsfn;
+  std::atomic<int> phase{kPhaseEmbed};
+  std::atomic<bool> probing{true};
+  PhaseStats phases[kPhaseCount];
+  uint64_t failedOps = 0;  // JS thread only
+  bool incomplete = false;
+  double durationMs = 0;
+
+  std::mutex mutex;
+  std::condition_variable drained;
+  uint64_t outstanding = 0;
+};
+
+using StressRunPtr = std::shared_ptr<StressRun>;
+
+struct StressOp {
+  const char* name;
+  WindowOpFn fn;
+};
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void SleepMs(uint32_t ms) {
+  if (ms > 0) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Stand-in for the time a real SetWindowPos/SetParent spends in the target
+// application's message loop
+void SimulateCallCost(const StressRunPtr& run) {
+  if (run->options.opCostUs > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(run->options.opCostUs));
+  }
+}
+
+WindowOpResult SimResult(WindowOpStatus status) {
+  WindowOpResult result;
+  result.status = status;
+  if (status != WindowOpStatus::Ok) result.error = "Simulated window is gone";
+  return result;
+}
+
+// Runs on the JS thread: queue a batch through the real window-ops queue, the
+// same path embedWindow/resizeWindow take, and time each op to its callback
+void IssueBatch(Napi::Env env, const StressRunPtr& run, std::vector<StressOp>* batch) {
+  int phase = run->phase;
+  {
+    std::lock_guard<std::mutex> lock(run->mutex);
+    run->outstanding += batch->size();
+  }
+  for (StressOp& op : *batch) {
+    Clock::time_point issuedAt = Clock::now();
+    QueueWindowOpWithCallback(env, op.name, std::move(op.fn), run->options.timeoutMs,
+      [run, phase, issuedAt](Napi::Env, const WindowOpResult& result) {
+        run->phases[phase].ops.Add(MillisecondsSince(issuedAt));
+        if (result.status != WindowOpStatus::Ok) run->failedOps++;
+        std::lock_guard<std::mutex> lock(run->mutex);
+        if (--run->outstanding == 0) run->drained.notify_all();
+      });
+  }
+}
+
+bool PostBatch(const StressRunPtr& run, std::vector<StressOp> batch) {
+  auto* data = new std::vector<StressOp>(std::move(batch));
+  napi_status status = run->tsfn.BlockingCall(data,
+    [run](Napi::Env env, Napi::Function, std::vector<StressOp>* batch) {
+      IssueBatch(env, run, batch);
+      delete batch;
+    });
+  if (status != napi_ok) {
+    delete data;
+    return false;
+  }
+  return true;
+}
+
+// Every op settles within its timeout, so a phase that has not drained by
+// then only happens while the environment is shutting down
+void WaitDrained(const StressRunPtr& run) {
+  std::unique_lock<std::mutex> lock(run->mutex);
+  bool drained = run->drained.wait_for(lock,
+    std::chrono::milliseconds(run->options.timeoutMs + kDrainSlackMs),
+    [&] { return run->outstanding == 0; });
+  if (!drained) run->incomplete = true;
+}
+
+template <typename Body>
+void RunPhase(const StressRunPtr& run, StressPhase phase, Body body) {
+  run->phase = phase;
+  Clock::time_point start = Clock::now();
+  body();
+  WaitDrained(run);
+  run->phases[phase].durationMs = MillisecondsSince(start);
+}
+
+// Measures event-loop lag as the delay between posting a no-op to the JS
+// thread and it running there, attributed to the phase in progress
+void ProbeEventLoop(StressRunPtr run) {
+  while (run->probing) {
+    SleepMs(run->options.probeIntervalMs);
+    auto* sentAt = new Clock::time_point(Clock::now());
+    napi_status status = run->tsfn.NonBlockingCall(sentAt,
+      [run](Napi::Env, Napi::Function, Clock::time_point* sentAt) {
+        run->phases[run->phase].lag.Add(MillisecondsSince(*sentAt));
+        delete sentAt;
+      });
+    if (status != napi_ok) {
+      delete sentAt;
+      break;
+    }
+  }
+}
+
+Napi::Object BuildReport(Napi::Env env, const StressRun& run) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, !run.incomplete));
+  if (run.incomplete) {
+    result.Set("error", Napi::String::New(env, "Some operations never settled"));
+  }
+  result.Set("windows", Napi::Number::New(env, run.options.windows));
+  result.Set("durationMs", Napi::Number::New(env, run.durationMs));
+  result.Set("failedOps", Napi::Number::New(env, (double)run.failedOps));
+
+  LatencyRecorder allLag;
+  Napi::Object phases = Napi::Object::New(env);
+  for (int i = 0; i < kPhaseCount; i++) {
+    const PhaseStats& stats = run.phases[i];
+    allLag.Merge(stats.lag);
+
+    Napi::Object phase = Napi::Object::New(env);
+    phase.Set("durationMs", Napi::Number::New(env, stats.durationMs));
+    phase.Set("ops", LatencySummaryToObject(env, stats.ops.Summarize()));
+    phase.Set("eventLoopLag", LatencySummaryToObject(env, stats.lag.Summarize()));
+    phases.Set(kPhaseNames[i], phase);
+  }
+  result.Set("phases", phases);
+  result.Set("eventLoopLag", LatencySummaryToObject(env, allLag.Summarize()));
+
+  SimWindowSystem::Counters counters = run.sim.GetCounters();
+  Napi::Object calls = Napi::Object::New(env);
+  calls.Set("geometry", Napi::Number::New(env, (double)counters.geometryCalls));
+  calls.Set("reparent", Napi::Number::New(env, (double)counters.reparentCalls));
+  calls.Set("show", Napi::Number::New(env, (double)counters.showCalls));
+  result.Set("calls", calls);
+  return result;
+}
+
+// Driver thread: walks the scenario, handing each burst of operations to the
+// JS thread so they are issued exactly as the window manager service would
+void DriveStress(StressRunPtr run) {
+  const StressOptions& options = run->options;
+  Clock::time_point start = Clock::now();
+  std::thread probe(ProbeEventLoop, run);
+
+  // Launch and embed every tab
+  RunPhase(run, kPhaseEmbed, [&] {
+    std::vector<StressOp> batch;
+    for (uint32_t i = 0; i < options.windows; i++) {
+      uint64_t handle = run->sim.AddWindow(kFirstStressProcessId + i, "StressWindow",
+                                           "Stress tab " + std::to_string(i + 1), true);
+      run->handles.push_back(handle);
+      batch.push_back({ "embedWindow", [run, handle]() -> WindowOpResult {
+        SimulateCallCost(run);
+        return SimResult(run->sim.Embed(handle, 1, 0, 40, 1280, 720));
+      }});
+    }
+    PostBatch(run, std::move(batch));
+  });
+
+  // Resize storm: every tab is resized once per frame while the host is dragged
+  RunPhase(run, kPhaseResize, [&] {
+    for (uint32_t storm = 0; storm < options.resizeStorms; storm++) {
+      std::vector<StressOp> batch;
+      int32_t width = 1280 + (int32_t)(storm % 64) * 4;
+      int32_t height = 720 + (int32_t)(storm % 32) * 4;
+      for (uint64_t handle : run->handles) {
+        batch.push_back({ "resizeWindow", [run, handle, width, height]() -> WindowOpResult {
+          SimulateCallCost(run);
+          return SimResult(run->sim.SetGeometry(handle, 0, 40, width, height));
+        }});
+      }
+      if (!PostBatch(run, std::move(batch))) break;
+      SleepMs(options.resizeIntervalMs);
+    }
+  });
+
+  // Rapid tab switching: hide the active tab, show the next one
+  RunPhase(run, kPhaseSwitch, [&] {
+    size_t active = 0;
+    for (uint32_t i = 0; i < options.tabSwitches; i++) {
+      size_t next = (active + 1) % run->handles.size();
+      uint64_t hide = run->handles[active];
+      uint64_t show = run->handles[next];
+      std::vector<StressOp> batch;
+      batch.push_back({ "showWindow", [run, hide]() -> WindowOpResult {
+        SimulateCallCost(run);
+        return SimResult(run->sim.Show(hide, false));
+      }});
+      batch.push_back({ "showWindow", [run, show]() -> WindowOpResult {
+        SimulateCallCost(run);
+        return SimResult(run->sim.Show(show, true));
+      }});
+      if (!PostBatch(run, std::move(batch))) break;
+      active = next;
+      SleepMs(options.switchIntervalMs);
+    }
+  });
+
+  // Mass close: unparent every tab and let its process go away
+  RunPhase(run, kPhaseClose, [&] {
+    std::vector<StressOp> batch;
+    for (uint64_t handle : run->handles) {
+      batch.push_back({ "unparentWindow", [run, handle]() -> WindowOpResult {
+        SimulateCallCost(run);
+        WindowOpStatus status = run->sim.Unparent(handle);
+        run->sim.RemoveWindow(handle);
+        return SimResult(status);
+      }});
+    }
+    PostBatch(run, std::move(batch));
+  });
+
+  run->probing = false;
+  probe.join();
+  run->durationMs = MillisecondsSince(start);
+
+  Napi::ThreadSafeFunction tsfn = run->tsfn;
+  auto* data = new StressRunPtr(run);
+  napi_status status = tsfn.BlockingCall(data, [](Napi::Env env, Napi::Function, StressRunPtr* data) {
+    StressRun& run = **data;
+    run.deferred.Resolve(BuildReport(env, run));
+    delete data;
+  });
+  if (status != napi_ok) {
+    delete data;
+  }
+  tsfn.Release();
+}
+
+uint32_t ReadOption(const Napi::Object& options, const char* name, uint32_t fallback) {
+  Napi::Value value = options.Get(name);
+  return value.IsNumber() ? value.As<Napi::Number>().Uint32Value() : fallback;
+}
+
+}  // namespace
+
+// RunWindowStress: Drive N synthetic embedded tabs on the simulated window
+// system through embed, resize-storm, tab-switch and mass-close phases, and
+// report event-loop lag, per-op latency percentiles and calls issued
+Napi::Value RunWindowStress(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() > 0 && !info[0].IsObject() && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { windows, resizeStorms, resizeIntervalMs, tabSwitches, switchIntervalMs, opCostUs, probeIntervalMs, timeoutMs, faults })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto run = std::make_shared<StressRun>(env);
+  StressOptions& options = run->options;
+  if (info.Length() > 0 && info[0].IsObject()) {
+    Napi::Object object = info[0].As<Napi::Object>();
+    options.windows = ReadOption(object, "windows", options.windows);
+    options.resizeStorms = ReadOption(object, "resizeStorms", options.resizeStorms);
+    options.resizeIntervalMs = ReadOption(object, "resizeIntervalMs", options.resizeIntervalMs);
+    options.tabSwitches = ReadOption(object, "tabSwitches", options.tabSwitches);
+    options.switchIntervalMs = ReadOption(object, "switchIntervalMs", options.switchIntervalMs);
+    options.opCostUs = ReadOption(object, "opCostUs", options.opCostUs);
+    options.probeIntervalMs = ReadOption(object, "probeIntervalMs", options.probeIntervalMs);
+    options.timeoutMs = ReadOption(object, "timeoutMs", options.timeoutMs);
+
+    std::string error;
+    if (!ReadFaultRules(object.Get("faults"), &run->faults, &error)) {
+      Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    run->sim.SetFaultInjector(&run->faults);
+  }
+  if (options.windows == 0) options.windows = 1;
+  if (options.probeIntervalMs == 0) options.probeIntervalMs = 1;
+  if (options.timeoutMs == 0) options.timeoutMs = kDefaultWindowOpTimeoutMs;
+
+  // Not unref'd: the run keeps the process alive until its report is in
+  run->tsfn = Napi::ThreadSafeFunction::New(
+    env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), "windowStress", 0, 1);
+  Napi::Promise promise = run->deferred.Promise();
+
+  std::thread(DriveStress, run).detach();
+  return promise;
+}
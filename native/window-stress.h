@@ -0,0 +1,9 @@
+#ifndef WINDOW_STRESS_H
+#define WINDOW_STRESS_H
+
+#include <napi.h>
+
+// Function declarations for the embedded-tab stress harness
+Napi::Value RunWindowStress(const Napi::CallbackInfo& info);
+
+#endif
@@ -0,0 +1,223 @@
+#include <napi.h>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include "executor.h"
+#include "sim-window-system.h"
+#include "window-model.h"
+#include "window-trace-replay.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double MicrosecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Replays a trace file on an executor worker and resolves a promise with
+// the report. Never rejects; failures resolve { success: false, error }.
+class ReplayWorker : public ExecutorWorker {
+ public:
+  ReplayWorker(Napi::Env env, std::string path, TraceReplayOptions options)
+    : ExecutorWorker(env, TaskLane::Normal),
+      deferred_(Napi::Promise::Deferred::New(env)),
+      path_(std::move(path)),
+      options_(options) {}
+
+  Napi::Promise Promise() { return deferred_.Promise(); }
+
+  void Execute(const CancellationToken&) override {
+    std::vector<TraceRecord> records;
+    if (!ReadWindowTrace(path_, &records, &error_)) return;
+    ReplayTraceRecords(records, options_, &report_);
+  }
+
+  void OnOK(Napi::Env env) override {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, error_.empty()));
+    if (!error_.empty()) {
+      result.Set("error", Napi::String::New(env, error_));
+      deferred_.Resolve(result);
+      return;
+    }
+
+    result.Set("records", Napi::Number::New(env, (double)report_.records));
+    result.Set("windowEvents", Napi::Number::New(env, (double)report_.windowEvents));
+    result.Set("traceDurationMs", Napi::Number::New(env, report_.traceDurationMs));
+    result.Set("replayWallMs", Napi::Number::New(env, report_.replayWallMs));
+
+    Napi::Object find = Napi::Object::New(env);
+    find.Set("calls", Napi::Number::New(env, (double)report_.findCalls));
+    find.Set("mismatches", Napi::Number::New(env, (double)report_.findMismatches));
+    find.Set("replayUs", Napi::Number::New(env, report_.findReplayUs));
+    find.Set("recordedUs", Napi::Number::New(env, report_.findRecordedUs));
+    result.Set("findMainWindow", find);
+
+    Napi::Object ops = Napi::Object::New(env);
+    ops.Set("calls", Napi::Number::New(env, (double)report_.windowOps));
+    ops.Set("mismatches", Napi::Number::New(env, (double)report_.windowOpMismatches));
+    ops.Set("geometryCalls", Napi::Number::New(env, (double)report_.geometryCalls));
+    result.Set("windowOps", ops);
+
+    Napi::Array processes = Napi::Array::New(env, report_.processes.size());
+    for (size_t i = 0; i < report_.processes.size(); i++) {
+      const TraceReplayProcess& process = report_.processes[i];
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("processId", Napi::Number::New(env, process.processId));
+      entry.Set("exePath", Napi::String::New(env, process.exePath));
+      entry.Set("recordedWindowMs", Napi::Number::New(env, process.recordedWindowMs));
+      entry.Set("replayedWindowMs", Napi::Number::New(env, process.replayedWindowMs));
+      processes.Set((uint32_t)i, entry);
+    }
+    result.Set("processes", processes);
+
+    deferred_.Resolve(result);
+  }
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::string path_;
+  TraceReplayOptions options_;
+  TraceReplayReport report_;
+  std::string error_;
+};
+
+}  // namespace
+
+void ReplayTraceRecords(const std::vector<TraceRecord>& records,
+                        const TraceReplayOptions& options, TraceReplayReport* report) {
+  SimWindowSystem sim;
+  std::unordered_map<uint32_t, size_t> processIndex;
+  std::unordered_map<uint32_t, uint64_t> launchTimes;
+  uint32_t iterations = options.findIterations > 0 ? options.findIterations : 1;
+  Clock::time_point wallStart = Clock::now();
+
+  for (const TraceRecord& record : records) {
+    if (options.speed > 0) {
+      std::this_thread::sleep_until(wallStart + std::chrono::microseconds(
+        (int64_t)(record.timeUs / options.speed)));
+    }
+    report->records++;
+
+    switch (record.type) {
+      case TraceEventType::Launch: {
+        processIndex[record.processId] = report->processes.size();
+        launchTimes[record.processId] = record.timeUs;
+        TraceReplayProcess process;
+        process.processId = record.processId;
+        process.exePath = record.text;
+        report->processes.push_back(process);
+        break;
+      }
+
+      case TraceEventType::FindMainWindow: {
+        report->findCalls++;
+        report->findRecordedUs += (double)record.durationUs;
+
+        uint64_t selected = 0;
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+          selected = SelectMainWindow(sim.EnumerateProcessWindows(record.processId));
+        }
+        report->findReplayUs += MicrosecondsSince(start) / iterations;
+        if (selected != record.handle) report->findMismatches++;
+
+        auto it = processIndex.find(record.processId);
+        if (it != processIndex.end()) {
+          TraceReplayProcess& process = report->processes[it->second];
+          double sinceLaunchMs = (record.timeUs - launchTimes[record.processId]) / 1000.0;
+          if (record.handle != 0 && process.recordedWindowMs < 0) {
+            process.recordedWindowMs = sinceLaunchMs;
+          }
+          if (selected != 0 && process.replayedWindowMs < 0) {
+            process.replayedWindowMs = sinceLaunchMs;
+          }
+        }
+        break;
+      }
+
+      case TraceEventType::WindowOp: {
+        report->windowOps++;
+        WindowOpStatus status = sim.ApplyOp(record);
+        if ((uint8_t)status != record.status) report->windowOpMismatches++;
+        break;
+      }
+
+      default:
+        report->windowEvents++;
+        sim.Apply(record);
+        break;
+    }
+  }
+
+  report->geometryCalls = sim.GetCounters().geometryCalls;
+  report->traceDurationMs = records.empty() ? 0 : records.back().timeUs / 1000.0;
+  report->replayWallMs = MicrosecondsSince(wallStart) / 1000.0;
+}
+
+// StartWindowTrace: Begin recording window-system events and calls to a file
+Napi::Value StartWindowTrace(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (tracePath: string)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string error;
+  bool started = TraceStart(info[0].As<Napi::String>().Utf8Value(), &error);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, started));
+  if (!started) {
+    result.Set("error", Napi::String::New(env, error));
+  }
+  return result;
+}
+
+// StopWindowTrace: Finish the current trace and report its size
+Napi::Value StopWindowTrace(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  TraceStats stats;
+  bool stopped = TraceStop(&stats);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("success", Napi::Boolean::New(env, stopped));
+  if (!stopped) {
+    result.Set("error", Napi::String::New(env, "No window trace is being recorded"));
+    return result;
+  }
+  result.Set("records", Napi::Number::New(env, (double)stats.records));
+  result.Set("bytes", Napi::Number::New(env, (double)stats.bytes));
+  result.Set("durationMs", Napi::Number::New(env, stats.durationUs / 1000.0));
+  return result;
+}
+
+// ReplayWindowTrace: Replay a trace against the simulated window system
+Napi::Value ReplayWindowTrace(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (tracePath: string, options?: { speed, findIterations })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  TraceReplayOptions options;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object object = info[1].As<Napi::Object>();
+    Napi::Value speed = object.Get("speed");
+    if (speed.IsNumber()) options.speed = speed.As<Napi::Number>().DoubleValue();
+    Napi::Value iterations = object.Get("findIterations");
+    if (iterations.IsNumber()) options.findIterations = iterations.As<Napi::Number>().Uint32Value();
+  }
+
+  auto* worker = new ReplayWorker(env, info[0].As<Napi::String>().Utf8Value(), options);
+  Napi::Promise promise = worker->Promise();
+  if (!worker->Queue()) {
+    delete worker;
+    return ExecutorBusyResult(env);
+  }
+  return promise;
+}
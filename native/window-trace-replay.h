@@ -0,0 +1,48 @@
+#ifndef WINDOW_TRACE_REPLAY_H
+#define WINDOW_TRACE_REPLAY_H
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "window-trace.h"
+
+struct TraceReplayOptions {
+  double speed = 0;              // 0 = as fast as possible, 1 = recorded timing
+  uint32_t findIterations = 1;   // Repeat each FindMainWindow to stabilise timings
+};
+
+struct TraceReplayProcess {
+  uint32_t processId = 0;
+  std::string exePath;
+  double recordedWindowMs = -1;  // Launch to first main window, -1 if never found
+  double replayedWindowMs = -1;
+};
+
+struct TraceReplayReport {
+  uint64_t records = 0;
+  uint64_t windowEvents = 0;
+  uint64_t findCalls = 0;
+  uint64_t findMismatches = 0;
+  double findReplayUs = 0;       // Total SelectMainWindow time in replay
+  double findRecordedUs = 0;     // Total FindMainWindow time when recorded
+  uint64_t windowOps = 0;
+  uint64_t windowOpMismatches = 0;
+  uint64_t geometryCalls = 0;
+  double traceDurationMs = 0;
+  double replayWallMs = 0;
+  std::vector<TraceReplayProcess> processes;
+};
+
+// Drive a SimWindowSystem through a recorded trace, re-running main-window
+// selection and window operations against it and comparing with the
+// recorded outcomes
+void ReplayTraceRecords(const std::vector<TraceRecord>& records,
+                        const TraceReplayOptions& options, TraceReplayReport* report);
+
+// Function declarations for window-system tracing and replay
+Napi::Value StartWindowTrace(const Napi::CallbackInfo& info);
+Napi::Value StopWindowTrace(const Napi::CallbackInfo& info);
+Napi::Value ReplayWindowTrace(const Napi::CallbackInfo& info);
+
+#endif
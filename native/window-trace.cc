@@ -0,0 +1,440 @@
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "window-trace.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const char kTraceMagic[4] = { 'N', 'W', 'T', 'R' };
+constexpr uint16_t kTraceVersion = 1;
+constexpr size_t kFlushThreshold = 64 * 1024;
+
+uint64_t ZigZag(int64_t value) {
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// Open a file by UTF-8 path (the narrow CRT functions use the ANSI code page
+// on Windows, which breaks profile paths with non-ASCII user names)
+FILE* OpenFileUtf8(const std::string& path, const wchar_t* wideMode, const char* mode) {
+#ifdef _WIN32
+  int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, NULL, 0);
+  std::wstring widePath(length > 0 ? length - 1 : 0, L'\0');
+  if (length > 1) {
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], length);
+  }
+  return _wfopen(widePath.c_str(), wideMode);
+#else
+  (void)wideMode;
+  return fopen(path.c_str(), mode);
+#endif
+}
+
+// Buffered record encoder. Owned by the recorder and only used with
+// g_traceMutex held.
+class TraceWriter {
+ public:
+  bool Open(const std::string& path, std::string* error) {
+    file_ = OpenFileUtf8(path, L"wb", "wb");
+    if (!file_) {
+      *error = "Failed to open trace file: " + path;
+      return false;
+    }
+    buffer_.insert(buffer_.end(), kTraceMagic, kTraceMagic + 4);
+    PutU16(kTraceVersion);
+    PutU16(0);
+    start_ = Clock::now();
+    return true;
+  }
+
+  void Close(TraceStats* stats) {
+    Flush();
+    fclose(file_);
+    file_ = nullptr;
+    if (stats) {
+      stats->records = records_;
+      stats->bytes = bytesWritten_;
+      stats->durationUs = lastUs_;
+    }
+  }
+
+  void Begin(TraceEventType type) {
+    uint64_t nowUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - start_).count();
+    if (nowUs < lastUs_) nowUs = lastUs_;
+    buffer_.push_back((uint8_t)type);
+    PutVarint(nowUs - lastUs_);
+    lastUs_ = nowUs;
+    records_++;
+  }
+
+  void End() {
+    if (buffer_.size() >= kFlushThreshold) Flush();
+  }
+
+  void PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buffer_.push_back((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    buffer_.push_back((uint8_t)value);
+  }
+
+  void PutSigned(int64_t value) { PutVarint(ZigZag(value)); }
+
+  void PutByte(uint8_t value) { buffer_.push_back(value); }
+
+  void PutString(const std::string& value) {
+    auto it = strings_.find(value);
+    if (it != strings_.end()) {
+      PutVarint(it->second);
+      return;
+    }
+    uint32_t id = (uint32_t)strings_.size() + 1;
+    strings_.emplace(value, id);
+    PutVarint(0);
+    PutVarint(value.size());
+    buffer_.insert(buffer_.end(), value.begin(), value.end());
+  }
+
+ private:
+  void PutU16(uint16_t value) {
+    buffer_.push_back((uint8_t)(value & 0xff));
+    buffer_.push_back((uint8_t)(value >> 8));
+  }
+
+  void Flush() {
+    if (!buffer_.empty()) {
+      bytesWritten_ += fwrite(buffer_.data(), 1, buffer_.size(), file_);
+      buffer_.clear();
+    }
+  }
+
+  FILE* file_ = nullptr;
+  std::vector<uint8_t> buffer_;
+  std::unordered_map<std::string, uint32_t> strings_;
+  Clock::time_point start_;
+  uint64_t lastUs_ = 0;
+  uint64_t records_ = 0;
+  uint64_t bytesWritten_ = 0;
+};
+
+std::mutex g_traceMutex;
+std::atomic<bool> g_traceActive{ false };
+std::unique_ptr<TraceWriter> g_writer;
+// Last state recorded per window handle, for snapshot diffing
+std::unordered_map<uint64_t, WindowCandidate> g_seenWindows;
+
+void WriteWindowCreate(const WindowCandidate& window) {
+  g_writer->Begin(TraceEventType::WindowCreate);
+  g_writer->PutVarint(window.handle);
+  g_writer->PutVarint(window.processId);
+  g_writer->PutByte(TraceFlagsFor(window));
+  g_writer->PutString(window.className);
+  g_writer->PutString(window.title);
+  g_writer->End();
+}
+
+void WriteHandleOnly(TraceEventType type, uint64_t handle) {
+  g_writer->Begin(type);
+  g_writer->PutVarint(handle);
+  g_writer->End();
+}
+
+// Decoder over an in-memory trace; any read past the end sets failed
+class TraceReader {
+ public:
+  TraceReader(const std::vector<uint8_t>& data, size_t offset) : data_(data), pos_(offset) {}
+
+  bool AtEnd() const { return pos_ >= data_.size(); }
+  bool Failed() const { return failed_; }
+
+  uint8_t Byte() {
+    if (pos_ >= data_.size()) {
+      failed_ = true;
+      return 0;
+    }
+    return data_[pos_++];
+  }
+
+  uint64_t Varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = Byte();
+      if (failed_) return 0;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    failed_ = true;
+    return 0;
+  }
+
+  int32_t Signed() { return (int32_t)UnZigZag(Varint()); }
+
+  std::string String() {
+    uint64_t id = Varint();
+    if (failed_) return std::string();
+    if (id != 0) {
+      if (id > strings_.size()) {
+        failed_ = true;
+        return std::string();
+      }
+      return strings_[id - 1];
+    }
+    uint64_t length = Varint();
+    if (failed_ || length > data_.size() - pos_) {
+      failed_ = true;
+      return std::string();
+    }
+    strings_.emplace_back((const char*)data_.data() + pos_, (size_t)length);
+    pos_ += (size_t)length;
+    return strings_.back();
+  }
+
+ private:
+  const std::vector<uint8_t>& data_;
+  size_t pos_;
+  bool failed_ = false;
+  std::vector<std::string> strings_;
+};
+
+}  // namespace
+
+uint8_t TraceFlagsFor(const WindowCandidate& window) {
+  return (window.visible ? kTraceVisible : 0) |
+    (window.hasParent ? kTraceHasParent : 0) |
+    (window.framed ? kTraceFramed : 0) |
+    (window.toolWindow ? kTraceToolWindow : 0);
+}
+
+void ApplyTraceFlags(uint8_t flags, WindowCandidate* window) {
+  window->visible = (flags & kTraceVisible) != 0;
+  window->hasParent = (flags & kTraceHasParent) != 0;
+  window->framed = (flags & kTraceFramed) != 0;
+  window->toolWindow = (flags & kTraceToolWindow) != 0;
+}
+
+bool TraceStart(const std::string& path, std::string* error) {
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (g_writer) {
+    *error = "A window trace is already being recorded";
+    return false;
+  }
+  auto writer = std::make_unique<TraceWriter>();
+  if (!writer->Open(path, error)) return false;
+  g_writer = std::move(writer);
+  g_seenWindows.clear();
+  g_traceActive = true;
+  return true;
+}
+
+bool TraceStop(TraceStats* stats) {
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer) return false;
+  g_traceActive = false;
+  g_writer->Close(stats);
+  g_writer.reset();
+  g_seenWindows.clear();
+  return true;
+}
+
+bool TraceActive() {
+  return g_traceActive.load(std::memory_order_relaxed);
+}
+
+void TraceLaunch(uint32_t processId, const std::string& exePath) {
+  if (!TraceActive()) return;
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer) return;
+  g_writer->Begin(TraceEventType::Launch);
+  g_writer->PutVarint(processId);
+  g_writer->PutString(exePath);
+  g_writer->End();
+}
+
+void TraceWindowSnapshot(const std::vector<WindowCandidate>& windows) {
+  if (!TraceActive()) return;
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer) return;
+
+  for (const WindowCandidate& window : windows) {
+    auto it = g_seenWindows.find(window.handle);
+    if (it == g_seenWindows.end()) {
+      WriteWindowCreate(window);
+      g_seenWindows.emplace(window.handle, window);
+      continue;
+    }
+
+    WindowCandidate& seen = it->second;
+    if (seen.title != window.title) {
+      g_writer->Begin(TraceEventType::WindowTitle);
+      g_writer->PutVarint(window.handle);
+      g_writer->PutString(window.title);
+      g_writer->End();
+    }
+    if (seen.visible != window.visible) {
+      WriteHandleOnly(window.visible ? TraceEventType::WindowShow : TraceEventType::WindowHide,
+                      window.handle);
+    }
+    if (seen.hasParent != window.hasParent || seen.framed != window.framed ||
+        seen.toolWindow != window.toolWindow) {
+      g_writer->Begin(TraceEventType::WindowStyle);
+      g_writer->PutVarint(window.handle);
+      g_writer->PutByte(TraceFlagsFor(window));
+      g_writer->End();
+    }
+    seen = window;
+  }
+}
+
+void TraceWindowReparent(uint64_t handle, uint64_t parent) {
+  if (!TraceActive()) return;
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer) return;
+  g_writer->Begin(TraceEventType::WindowReparent);
+  g_writer->PutVarint(handle);
+  g_writer->PutVarint(parent);
+  g_writer->End();
+
+  auto it = g_seenWindows.find(handle);
+  if (it != g_seenWindows.end()) it->second.hasParent = parent != 0;
+}
+
+void TraceWindowDestroy(uint64_t handle) {
+  if (!TraceActive()) return;
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer || g_seenWindows.erase(handle) == 0) return;
+  WriteHandleOnly(TraceEventType::WindowDestroy, handle);
+}
+
+void TraceFindMainWindow(uint32_t processId, uint64_t result, uint64_t durationUs) {
+  if (!TraceActive()) return;
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer) return;
+  g_writer->Begin(TraceEventType::FindMainWindow);
+  g_writer->PutVarint(processId);
+  g_writer->PutVarint(result);
+  g_writer->PutVarint(durationUs);
+  g_writer->End();
+}
+
+void TraceWindowCall(TraceWindowOp op, uint64_t handle, uint64_t parent, int32_t x, int32_t y,
+                     int32_t width, int32_t height, uint8_t status, uint64_t durationUs) {
+  if (!TraceActive()) return;
+  std::lock_guard<std::mutex> lock(g_traceMutex);
+  if (!g_writer) return;
+  g_writer->Begin(TraceEventType::WindowOp);
+  g_writer->PutByte((uint8_t)op);
+  g_writer->PutVarint(handle);
+  g_writer->PutVarint(parent);
+  g_writer->PutSigned(x);
+  g_writer->PutSigned(y);
+  g_writer->PutSigned(width);
+  g_writer->PutSigned(height);
+  g_writer->PutByte(status);
+  g_writer->PutVarint(durationUs);
+  g_writer->End();
+}
+
+bool ReadWindowTrace(const std::string& path, std::vector<TraceRecord>* records, std::string* error) {
+  FILE* file = OpenFileUtf8(path, L"rb", "rb");
+  if (!file) {
+    *error = "Failed to open trace file: " + path;
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[16384];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    data.insert(data.end(), chunk, chunk + read);
+  }
+  fclose(file);
+
+  if (data.size() < 8 || memcmp(data.data(), kTraceMagic, 4) != 0) {
+    *error = "Not a window trace file";
+    return false;
+  }
+  uint16_t version = (uint16_t)(data[4] | (data[5] << 8));
+  if (version != kTraceVersion) {
+    *error = "Unsupported window trace version " + std::to_string(version);
+    return false;
+  }
+
+  TraceReader reader(data, 8);
+  uint64_t timeUs = 0;
+  while (!reader.AtEnd()) {
+    TraceRecord record;
+    record.type = (TraceEventType)reader.Byte();
+    timeUs += reader.Varint();
+    record.timeUs = timeUs;
+
+    switch (record.type) {
+      case TraceEventType::Launch:
+        record.processId = (uint32_t)reader.Varint();
+        record.text = reader.String();
+        break;
+      case TraceEventType::WindowCreate:
+        record.handle = reader.Varint();
+        record.processId = (uint32_t)reader.Varint();
+        record.flags = reader.Byte();
+        record.className = reader.String();
+        record.text = reader.String();
+        break;
+      case TraceEventType::WindowShow:
+      case TraceEventType::WindowHide:
+      case TraceEventType::WindowDestroy:
+        record.handle = reader.Varint();
+        break;
+      case TraceEventType::WindowTitle:
+        record.handle = reader.Varint();
+        record.text = reader.String();
+        break;
+      case TraceEventType::WindowReparent:
+        record.handle = reader.Varint();
+        record.parent = reader.Varint();
+        break;
+      case TraceEventType::WindowStyle:
+        record.handle = reader.Varint();
+        record.flags = reader.Byte();
+        break;
+      case TraceEventType::FindMainWindow:
+        record.processId = (uint32_t)reader.Varint();
+        record.handle = reader.Varint();
+        record.durationUs = reader.Varint();
+        break;
+      case TraceEventType::WindowOp:
+        record.op = (TraceWindowOp)reader.Byte();
+        record.handle = reader.Varint();
+        record.parent = reader.Varint();
+        record.x = reader.Signed();
+        record.y = reader.Signed();
+        record.width = reader.Signed();
+        record.height = reader.Signed();
+        record.status = reader.Byte();
+        record.durationUs = reader.Varint();
+        break;
+      default:
+        *error = "Unknown trace record type " + std::to_string((int)record.type);
+        return false;
+    }
+
+    if (reader.Failed()) {
+      *error = "Truncated window trace";
+      return false;
+    }
+    records->push_back(std::move(record));
+  }
+  return true;
+}
@@ -0,0 +1,94 @@
+#ifndef WINDOW_TRACE_H
+#define WINDOW_TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "window-model.h"
+
+// Compact binary trace of window-system events and the calls the addon makes
+// against them, recorded during real sessions and replayed against the
+// simulated window system (sim-window-system.h).
+//
+// File layout: "NWTR", u16 version, u16 reserved, then records of
+//   u8 type, varint microseconds since the previous record, type payload
+// Integers are LEB128 varints (zigzag for signed), and strings are interned:
+// a varint id, where 0 introduces a new string (varint length + bytes) that
+// takes the next id.
+
+enum class TraceEventType : uint8_t {
+  Launch = 1,       // processId, text = exe path
+  WindowCreate,     // handle, processId, flags, className, text = title
+  WindowShow,       // handle
+  WindowHide,       // handle
+  WindowTitle,      // handle, text = title
+  WindowReparent,   // handle, parent (0 = desktop)
+  WindowStyle,      // handle, flags
+  WindowDestroy,    // handle
+  FindMainWindow,   // processId, handle = result, durationUs
+  WindowOp          // op, handle, parent, rect, status, durationUs
+};
+
+enum class TraceWindowOp : uint8_t {
+  Embed = 1,
+  Resize,
+  Move,
+  Show,
+  Hide,
+  Unparent
+};
+
+// WindowCreate / WindowStyle flag bits
+constexpr uint8_t kTraceVisible = 1 << 0;
+constexpr uint8_t kTraceHasParent = 1 << 1;
+constexpr uint8_t kTraceFramed = 1 << 2;
+constexpr uint8_t kTraceToolWindow = 1 << 3;
+
+struct TraceRecord {
+  TraceEventType type = TraceEventType::Launch;
+  uint64_t timeUs = 0;  // Since the start of the trace
+  uint64_t handle = 0;
+  uint64_t parent = 0;
+  uint32_t processId = 0;
+  uint8_t flags = 0;
+  TraceWindowOp op = TraceWindowOp::Embed;
+  uint8_t status = 0;   // WindowOpStatus of a recorded WindowOp
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t width = 0;
+  int32_t height = 0;
+  uint64_t durationUs = 0;
+  std::string className;
+  std::string text;
+};
+
+struct TraceStats {
+  uint64_t records = 0;
+  uint64_t bytes = 0;
+  uint64_t durationUs = 0;
+};
+
+// Recording. All Trace* calls are cheap no-ops unless a trace is active and
+// are safe to call from any thread.
+bool TraceStart(const std::string& path, std::string* error);
+bool TraceStop(TraceStats* stats);
+bool TraceActive();
+
+void TraceLaunch(uint32_t processId, const std::string& exePath);
+// Diff a process's current windows against what the trace has already seen
+// and emit create/show/hide/title/reparent/style records for the changes
+void TraceWindowSnapshot(const std::vector<WindowCandidate>& windows);
+void TraceWindowReparent(uint64_t handle, uint64_t parent);
+void TraceWindowDestroy(uint64_t handle);
+void TraceFindMainWindow(uint32_t processId, uint64_t result, uint64_t durationUs);
+void TraceWindowCall(TraceWindowOp op, uint64_t handle, uint64_t parent, int32_t x, int32_t y,
+                     int32_t width, int32_t height, uint8_t status, uint64_t durationUs);
+
+// Reading
+bool ReadWindowTrace(const std::string& path, std::vector<TraceRecord>* records, std::string* error);
+
+// Flag helpers shared by the recorder and the simulated window system
+uint8_t TraceFlagsFor(const WindowCandidate& window);
+void ApplyTraceFlags(uint8_t flags, WindowCandidate* window);
+
+#endif
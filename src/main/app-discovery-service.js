@@ -3,13 +3,39 @@
  * Discovers installed Windows applications via Registry and Program Files
  */
 
+const fs = require('fs');
 const path = require('path');
+const { getUserDataPath } = require('../security/secure-storage');
 
 let nativeAddon = null;
 let cachedApps = null;
 let lastScanTime = 0;
 const CACHE_DURATION = 24 * 60 * 60 * 1000; // 24 hours
 
+// Background rescans and icon/metadata enrichment run natively only while
+// the user is idle; this is how often a fresh rescan is queued
+const IDLE_RESCAN_INTERVAL = 60 * 60 * 1000; // 1 hour
+let idleRescanTimer = null;
+
+// Enrichment survives rescans: exe path -> { iconData, publisher, description,
+// version, signed, signer }
+const enrichmentByPath = new Map();
+
+// Picker filters run against a native facet index over cachedApps; row ids
+// are positions in that array, so it is rebuilt after anything reorders or
+// enriches the apps
+let facetIndexApps = null;
+
+// Launch ranking: lowercased exe path -> { count, lastUsed }. Seeded once
+// from Explorer's UserAssist history so a fresh install already puts the
+// apps the user runs first; launches from here add to it.
+const USAGE_FILE = 'app-usage.json';
+const SEED_MAX_COUNT = 10; // Seeded counts are scaled down so real launches overtake them
+const DAY = 24 * 60 * 60 * 1000;
+let usageByPath = new Map();
+let usageSeeded = false;
+let usageSeeding = false; // A seed is in flight; overlapping discoveries skip it
+
 // Load native addon
 function loadNativeAddon() {
   try {
@@ -29,83 +55,267 @@ function initialize() {
   if (!loadNativeAddon()) {
     throw new Error('Failed to load native app discovery addon');
   }
+  loadUsage();
+
+  if (!nativeAddon.startIdleScheduler(handleIdleEvent)) {
+    console.warn('Idle scheduler already running');
+  }
+  scheduleIdleRescan();
+
   console.log('App Discovery Service initialized');
 }
 
+/**
+ * Load the launch ranking; a missing file means first run, to be seeded
+ */
+function loadUsage() {
+  try {
+    const data = JSON.parse(fs.readFileSync(path.join(getUserDataPath(), USAGE_FILE), 'utf8'));
+    usageByPath = new Map(Object.entries(data.apps || {}));
+    usageSeeded = true;
+  } catch (error) {
+    if (error.code !== 'ENOENT') {
+      console.warn('Failed to read app usage, reseeding:', error.message);
+    }
+  }
+}
+
+/**
+ * Persist the launch ranking in the background
+ */
+function saveUsage() {
+  const data = { version: 1, apps: Object.fromEntries(usageByPath) };
+  fs.promises.writeFile(path.join(getUserDataPath(), USAGE_FILE), JSON.stringify(data), 'utf8')
+    .catch(error => console.warn('Failed to save app usage:', error.message));
+}
+
+/**
+ * Seed the launch ranking from UserAssist on first run
+ * @param {Array} apps - Finalized apps
+ * @returns {Promise<boolean>} True if any app was seeded
+ */
+async function seedUsage(apps) {
+  if (usageSeeded || usageSeeding) return false;
+  usageSeeding = true;
+
+  // A failed read leaves usageSeeded unset, so the next discovery retries
+  try {
+    const result = await nativeAddon.readUserAssist({ paths: apps.map(app => app.path) });
+    if (!result.success) {
+      console.warn('Failed to read UserAssist history:', result.error);
+      return false;
+    }
+    // Entries are most run first; scale so relative order survives the cap.
+    // Apps only ever focused, never started from the shell, are left out.
+    const runs = result.entries.filter(entry => entry.runCount > 0);
+    const maxRuns = runs.length > 0 ? runs[0].runCount : 0;
+    runs.forEach(entry => {
+      usageByPath.set(apps[entry.row].path.toLowerCase(), {
+        count: Math.max(1, Math.round(entry.runCount / maxRuns * SEED_MAX_COUNT)),
+        lastUsed: entry.lastRunMs
+      });
+    });
+    usageSeeded = true;
+    saveUsage();
+    return runs.length > 0;
+  } catch (error) {
+    console.warn('Failed to seed app usage:', error);
+    return false;
+  } finally {
+    usageSeeding = false;
+  }
+}
+
+/**
+ * Launch count weighted by how recently the app was last launched
+ * @param {Object} app - Finalized app
+ * @returns {number} 0 for apps never launched
+ */
+function frecency(app) {
+  const usage = usageByPath.get(app.path.toLowerCase());
+  if (!usage) return 0;
+  const age = Date.now() - usage.lastUsed;
+  const weight = age < 4 * DAY ? 100 : age < 14 * DAY ? 70 : age < 31 * DAY ? 50 : age < 90 * DAY ? 30 : 10;
+  return usage.count * weight;
+}
+
+/**
+ * Sort apps in place, most used first, then by name
+ * @param {Array} apps - Finalized apps
+ */
+function rankApps(apps) {
+  const scores = new Map(apps.map(app => [app, frecency(app)]));
+  apps.sort((a, b) => (scores.get(b) - scores.get(a)) || a.name.localeCompare(b.name));
+  if (apps === facetIndexApps) facetIndexApps = null;
+}
+
+/**
+ * Record a launch in the ranking
+ * @param {string} appPath - Application executable path
+ */
+function recordLaunch(appPath) {
+  const key = appPath.toLowerCase();
+  const usage = usageByPath.get(key) || { count: 0, lastUsed: 0 };
+  usageByPath.set(key, { count: usage.count + 1, lastUsed: Date.now() });
+  saveUsage();
+  if (cachedApps) rankApps(cachedApps);
+}
+
+/**
+ * Queue the next background rescan; the native scheduler holds it until idle
+ */
+function scheduleIdleRescan() {
+  clearTimeout(idleRescanTimer);
+  idleRescanTimer = setTimeout(() => {
+    const result = nativeAddon.scheduleIdleWork('rescan');
+    if (!result.success) {
+      console.warn('Failed to schedule idle rescan:', result.error);
+    }
+    scheduleIdleRescan();
+  }, IDLE_RESCAN_INTERVAL);
+  idleRescanTimer.unref();
+}
+
+/**
+ * Queue icon and metadata extraction for apps not enriched yet
+ * @param {Array} apps - Merged app objects
+ */
+function scheduleEnrichment(apps) {
+  const paths = apps.map(app => app.path).filter(appPath => !enrichmentByPath.has(appPath));
+  if (paths.length === 0) return;
+  // Placeholder entries keep overlapping rescans from queueing the same paths
+  paths.forEach(appPath => enrichmentByPath.set(appPath, {}));
+  nativeAddon.scheduleIdleWork('icons', paths);
+  nativeAddon.scheduleIdleWork('metadata', paths);
+  readSigners(paths);
+}
+
+/**
+ * Record who signed each exe, for the picker's publisher and signed filters.
+ * Signatures are parsed natively on the background lane and cached by file.
+ * @param {Array<string>} paths - Exe paths
+ */
+async function readSigners(paths) {
+  try {
+    const result = await nativeAddon.readSigners(paths);
+    if (!result.success) {
+      console.warn('Failed to read signers:', result.error);
+      return;
+    }
+    result.results.forEach(signer => {
+      if (!signer.state) return;
+      const enrichment = enrichmentByPath.get(signer.path) || {};
+      enrichment.signed = signer.state === 'signed';
+      if (signer.publisher) enrichment.signer = signer.publisher;
+      enrichmentByPath.set(signer.path, enrichment);
+    });
+    if (cachedApps) applyEnrichment(cachedApps);
+  } catch (error) {
+    console.warn('Failed to read signers:', error);
+  }
+}
+
+/**
+ * Copy known enrichment onto app objects
+ * @param {Array} apps - Merged app objects
+ */
+function applyEnrichment(apps) {
+  apps.forEach(app => {
+    const enrichment = enrichmentByPath.get(app.path);
+    if (enrichment) Object.assign(app, enrichment);
+  });
+  if (apps === facetIndexApps) facetIndexApps = null;
+}
+
+/**
+ * Handle events from the native idle scheduler
+ * @param {Object} event - { type, jobId, kind, ... }
+ */
+function handleIdleEvent(event) {
+  switch (event.type) {
+    case 'rescan':
+      cachedApps = finalizeApps(event.apps);
+      lastScanTime = Date.now();
+      scheduleEnrichment(cachedApps);
+      break;
+    case 'icons':
+    case 'metadata':
+      event.results.forEach(result => {
+        // Failed paths are remembered too so they are not retried every rescan
+        const enrichment = enrichmentByPath.get(result.path) || {};
+        if (result.success && event.type === 'icons') {
+          enrichment.iconData = result.icon;
+        } else if (result.success) {
+          enrichment.publisher = result.companyName;
+          enrichment.description = result.fileDescription;
+          enrichment.version = result.fileVersion;
+        }
+        enrichmentByPath.set(result.path, enrichment);
+      });
+      if (cachedApps) applyEnrichment(cachedApps);
+      break;
+    case 'error':
+      console.warn(`Idle ${event.kind} job failed:`, event.error);
+      break;
+    default:
+      // paused/resumed: nothing to do, the native side resumes on its own
+      break;
+  }
+}
+
+/**
+ * Fill in display defaults and enrichment for natively merged apps
+ * @param {Array} apps - discoverApps results, already deduplicated by path
+ *   with the most trusted source first (registry, package and store
+ *   manifests, then the filesystem walks)
+ * @returns {Array} Apps, most used first, then by name
+ */
+function finalizeApps(apps) {
+  const finalized = Array.from(apps).map(app => ({
+    id: app.id,
+    name: app.name || path.basename(app.path, '.exe'),
+    path: app.path,
+    icon: app.icon || app.path,
+    ...(app.source && { source: app.source }),
+    // PE machine and subsystem, for sources that read the exe's headers
+    ...(app.arch && { arch: app.arch }),
+    ...(app.subsystem && { subsystem: app.subsystem })
+  }));
+  rankApps(finalized);
+  applyEnrichment(finalized);
+  return finalized;
+}
+
 /**
  * Discover installed applications
+ * @param {Object} [options]
+ * @param {boolean} [options.force] - Rerun every source, ignoring freshness
  * @returns {Promise<Array>} Array of app objects
  */
-async function discoverApps() {
+async function discoverApps({ force = false } = {}) {
   if (!nativeAddon) {
     throw new Error('Native addon not loaded');
   }
   
   try {
-    // Scan registry
-    const registryApps = nativeAddon.scanRegistry();
-    const registryAppsArray = Array.from(registryApps);
-    
-    // Scan Program Files
-    const programFilesApps = nativeAddon.scanProgramFiles();
-    const programFilesAppsArray = Array.from(programFilesApps);
-    
-    // Scan System Apps (Notepad, Calculator, etc.)
-    const systemApps = nativeAddon.scanSystemApps();
-    const systemAppsArray = Array.from(systemApps);
-    
-    // Merge results
-    const appsMap = new Map();
+    // The native scheduler runs the cheap registry sources first, in
+    // parallel, and skips Program Files/profile walks whose results are
+    // still fresh
+    const result = await nativeAddon.discoverApps({ force });
+    if (!result.success) {
+      throw new Error(result.error);
+    }
     
-    // Add registry apps first (they have better metadata)
-    registryAppsArray.forEach(app => {
-      const appPath = app.path;
-      if (appPath && !appsMap.has(appPath)) {
-        appsMap.set(appPath, {
-          id: app.id || `reg_${Date.now()}_${Math.random()}`,
-          name: app.name || path.basename(appPath, '.exe'),
-          path: appPath,
-          icon: app.icon || appPath
-        });
-      }
-    });
-    
-    // Add Program Files apps (skip if already in map)
-    programFilesAppsArray.forEach(app => {
-      const appPath = app.path;
-      if (appPath && !appsMap.has(appPath)) {
-        appsMap.set(appPath, {
-          id: app.id || `pf_${Date.now()}_${Math.random()}`,
-          name: app.name || path.basename(appPath, '.exe'),
-          path: appPath,
-          icon: app.icon || appPath
-        });
-      }
-    });
-    
-    // Add System Apps (Notepad, Calculator, etc.) - prioritize these
-    systemAppsArray.forEach(app => {
-      const appPath = app.path;
-      if (appPath && !appsMap.has(appPath)) {
-        appsMap.set(appPath, {
-          id: app.id || `sys_${Date.now()}_${Math.random()}`,
-          name: app.name || path.basename(appPath, '.exe'),
-          path: appPath,
-          icon: app.icon || appPath
-        });
-      }
-    });
-    
-    // Convert map to array
-    const apps = Array.from(appsMap.values());
-    
-    // Sort by name
-    apps.sort((a, b) => a.name.localeCompare(b.name));
+    const apps = finalizeApps(result.apps);
+    if (await seedUsage(apps)) rankApps(apps);
     
     // Cache results
     cachedApps = apps;
     lastScanTime = Date.now();
     
+    // Icons and version info are filled in later, while the user is idle
+    scheduleEnrichment(apps);
+    
     return apps;
   } catch (error) {
     console.error('Error discovering apps:', error);
@@ -136,7 +346,84 @@ async function getCachedApps() {
 async function refreshApps() {
   cachedApps = null;
   lastScanTime = 0;
-  return await discoverApps();
+  return await discoverApps({ force: true });
+}
+
+/**
+ * Filter the picker's apps natively: a case-insensitive substring of the
+ * name or full path, and/or a facet filter such as
+ * { facet: 'signed', value: 'signed' } or { and: [...] }
+ * @param {Object} [query]
+ * @param {string} [query.text] - Search text
+ * @param {Object} [query.where] - Facet filter tree (see facet-index.h)
+ * @param {Array<string>} [query.counts] - Facets to count values of over the matches
+ * @returns {Promise<Object>} { apps, total, counts }, apps in ranking order
+ */
+async function queryApps({ text = '', where, counts = [] } = {}) {
+  const apps = await getCachedApps();
+  if (facetIndexApps !== apps) {
+    const built = nativeAddon.buildFacetIndex(apps.map(app => ({
+      name: app.name,
+      path: app.path,
+      source: app.source,
+      publisher: app.publisher || app.signer,
+      arch: app.arch,
+      subsystem: app.subsystem,
+      signed: app.signed
+    })));
+    if (!built.success) {
+      throw new Error(built.error);
+    }
+    facetIndexApps = apps;
+  }
+
+  const result = nativeAddon.queryFacetIndex({ text, where, counts });
+  if (!result.success) {
+    throw new Error(result.error);
+  }
+  return { apps: result.rows.map(row => apps[row]), total: result.total, counts: result.counts };
+}
+
+/**
+ * Write the current discovery results to a portable catalog file, with
+ * paths relative to well-known folders (Program Files, AppData, ...)
+ * @param {string} filePath - Destination file
+ * @returns {Promise<number>} Number of apps written
+ */
+async function exportCatalog(filePath) {
+  if (!nativeAddon) {
+    throw new Error('Native addon not loaded');
+  }
+  
+  const result = await nativeAddon.exportCatalog();
+  if (!result.success) {
+    throw new Error(result.error);
+  }
+  await fs.promises.writeFile(filePath, result.catalog, 'utf8');
+  return result.apps;
+}
+
+/**
+ * Seed discovery from a catalog exported on another machine (e.g. the golden
+ * image). Entries whose exe exists here are merged in, so the next discovery
+ * skips the filesystem walks the catalog already covers.
+ * @param {string} filePath - Catalog file
+ * @returns {Promise<Object>} { imported, missing, unresolved }
+ */
+async function importCatalog(filePath) {
+  if (!nativeAddon) {
+    throw new Error('Native addon not loaded');
+  }
+  
+  const catalog = await fs.promises.readFile(filePath, 'utf8');
+  const result = await nativeAddon.importCatalog(catalog);
+  if (!result.success) {
+    throw new Error(result.error);
+  }
+  
+  // Re-merge so the imported apps show up now rather than at the next rescan
+  await discoverApps();
+  return { imported: result.imported, missing: result.missing, unresolved: result.unresolved };
 }
 
 /**
@@ -164,7 +451,11 @@ module.exports = {
   discoverApps,
   getCachedApps,
   refreshApps,
+  exportCatalog,
+  importCatalog,
   findAppById,
-  findAppByPath
+  findAppByPath,
+  queryApps,
+  recordLaunch
 };
 
@@ -1486,10 +1486,22 @@ function registerHandlers(mainWindow, getSessionKey, setSessionKey) {
     }
   });
 
+  // Filter installed applications (text and/or facet filter)
+  ipcMain.handle('query-installed-apps', async (event, query) => {
+    try {
+      const result = await appDiscoveryService.queryApps(query);
+      return { success: true, ...result };
+    } catch (error) {
+      securityMonitor.logError(error);
+      return { success: false, error: error.message, apps: [] };
+    }
+  });
+
   // Launch application and embed
   ipcMain.handle('launch-app', async (event, appPath, tabId) => {
     try {
       const result = await windowManagerService.launchAndEmbed(appPath, tabId);
+      if (result.success) appDiscoveryService.recordLaunch(appPath);
       return result;
     } catch (error) {
       securityMonitor.logError(error);
@@ -1501,10 +1513,10 @@ function registerHandlers(mainWindow, getSessionKey, setSessionKey) {
   ipcMain.handle('switch-tab', async (event, fromTabId, toTabId) => {
     try {
       if (fromTabId) {
-        windowManagerService.hideTab(fromTabId);
+        await windowManagerService.hideTab(fromTabId);
       }
       if (toTabId) {
-        windowManagerService.showTab(toTabId);
+        await windowManagerService.showTab(toTabId);
       }
       return { success: true };
     } catch (error) {
@@ -1516,7 +1528,7 @@ function registerHandlers(mainWindow, getSessionKey, setSessionKey) {
   // Close tab
   ipcMain.handle('close-tab', async (event, tabId) => {
     try {
-      const result = windowManagerService.closeTab(tabId);
+      const result = await windowManagerService.closeTab(tabId);
       return result;
     } catch (error) {
       securityMonitor.logError(error);
@@ -1527,7 +1539,7 @@ function registerHandlers(mainWindow, getSessionKey, setSessionKey) {
   // Resize embedded window
   ipcMain.handle('resize-embedded-window', async (event, tabId, width, height) => {
     try {
-      const result = windowManagerService.resizeWindow(tabId, width, height);
+      const result = await windowManagerService.resizeWindow(tabId, width, height);
       return result;
     } catch (error) {
       securityMonitor.logError(error);
@@ -1538,7 +1550,7 @@ function registerHandlers(mainWindow, getSessionKey, setSessionKey) {
   // Move embedded window
   ipcMain.handle('move-embedded-window', async (event, tabId, x, y) => {
     try {
-      const result = windowManagerService.moveWindow(tabId, x, y);
+      const result = await windowManagerService.moveWindow(tabId, x, y);
       return result;
     } catch (error) {
       securityMonitor.logError(error);
@@ -4,11 +4,39 @@
  */
 
 const path = require('path');
+const { MessageChannelMain } = require('electron');
 
 let nativeAddon = null;
 let mainWindow = null;
 let electronWindowHandle = null;
-const embeddedWindows = new Map(); // tabId -> { hwnd, processId, appName, visible, processHandle }
+const embeddedWindows = new Map(); // tabId -> { hwnd, processId, appName, visible, processHandle, hung, slot }
+
+// Native window operations resolve with { success, status, error, elapsedMs }
+// instead of blocking; these bound how long a hung app can hold one up
+const EMBED_TIMEOUT_MS = 5000;
+const UNPARENT_TIMEOUT_MS = 1000;
+
+// Upper bound on waiting for a launched process to show its main window
+const WINDOW_WAIT_MS = 30000;
+
+// Upper bound on waiting for a launched window to become interactive
+const READY_TIMEOUT_MS = 5000;
+
+// Batched window commands from the renderer (format in
+// native/window-command-buffer.h). Each embedded window gets a numeric slot
+// the renderer addresses; results come back through the completion ring.
+const COMMAND_RING_CAPACITY = 1024;
+const COMMAND_FRAME_TIMEOUT_MS = 1000;
+const COMPLETION_RECORD_BYTES = 32;
+const COMPLETION_RING_HEADER_BYTES = 16;
+let nextCommandSlot = 1;
+let commandPort = null;
+let commandRing = null;
+let commandRingRead = 0; // Ring records consumed so far
+
+// Hidden tabs run at reduced CPU/I/O priority; set to core indices
+// (e.g. [0, 1]) to also confine them to a subset of cores
+const BACKGROUND_TAB_CORES = null;
 
 // Load native addon
 function loadNativeAddon() {
@@ -52,9 +80,68 @@ function initialize(window) {
     throw new Error('Failed to load native window manager addon');
   }
 
+  // Probe embedded windows for responsiveness on a native thread
+  nativeAddon.startHangWatchdog(handleHangEvent);
+
+  // Each page load gets a fresh command port; the old one dies with the page
+  commandRing = nativeAddon.createWindowCommandRing(COMMAND_RING_CAPACITY);
+  mainWindow.webContents.on('did-finish-load', openCommandChannel);
+
+  // Record window-system events and calls for offline replay
+  // (nativeAddon.replayWindowTrace) when a trace path is configured
+  if (process.env.WINDOW_TRACE_PATH) {
+    const traceResult = nativeAddon.startWindowTrace(process.env.WINDOW_TRACE_PATH);
+    if (!traceResult.success) {
+      console.warn('Failed to start window trace:', traceResult.error);
+    }
+  }
+
   console.log('Window Manager Service initialized');
 }
 
+/**
+ * Find the tab that owns a native window handle
+ * @param {number} hwnd - Window handle
+ * @returns {[string, Object]|null} [tabId, windowData] or null
+ */
+function findTabByHwnd(hwnd) {
+  for (const entry of embeddedWindows) {
+    if (entry[1].hwnd === hwnd) {
+      return entry;
+    }
+  }
+  return null;
+}
+
+/**
+ * Handle hung/recovered transitions reported by the native watchdog
+ * @param {Object} event - { hwnd, state: 'hung'|'recovered', durationMs }
+ */
+function handleHangEvent(event) {
+  const entry = findTabByHwnd(event.hwnd);
+  if (!entry) return;
+  const [tabId, windowData] = entry;
+
+  windowData.hung = event.state === 'hung';
+  console.warn(`[WindowManager] Tab ${tabId} ${event.state} (${Math.round(event.durationMs)} ms)`);
+
+  if (!windowData.hung && windowData.visible && windowData.width && windowData.height) {
+    // Geometry updates were skipped while hung; apply the latest one now
+    nativeAddon.resizeWindow(
+      windowData.hwnd,
+      windowData.x, windowData.y,
+      windowData.width, windowData.height
+    ).catch(() => { });
+  }
+
+  if (mainWindow && !mainWindow.isDestroyed()) {
+    mainWindow.webContents.send(windowData.hung ? 'embedded-window-hung' : 'embedded-window-recovered', {
+      tabId,
+      durationMs: event.durationMs
+    });
+  }
+}
+
 /**
  * Launch application and embed it
  * @param {string} appPath - Path to executable
@@ -70,54 +157,6 @@ async function launchAndEmbed(appPath, tabId) {
     throw new Error('Electron window handle not available');
   }
 
-  // Launch application (with timeout handled in C++)
-  const launchResult = nativeAddon.launchApplication(appPath, electronWindowHandle);
-
-  if (!launchResult.success) {
-    // Check for specific error types
-    const errorMsg = launchResult.error || 'Failed to launch application';
-    if (errorMsg.includes('Window not found')) {
-      throw new Error('Application launched but window not found. The app may have a delayed startup or requires user interaction.');
-    } else if (errorMsg.includes('Failed to launch process')) {
-      throw new Error('Failed to start the application. Check if the path is correct and you have permission to run it.');
-    }
-    throw new Error(errorMsg);
-  }
-
-  const { processId, processHandle } = launchResult;
-  let hwnd = null;
-
-  console.log(`[WindowManager] Waiting for window of process ${processId}...`);
-
-  // Poll for window (max 30 seconds)
-  for (let i = 0; i < 60; i++) {
-    await new Promise(resolve => setTimeout(resolve, 500));
-
-    try {
-      // Check if native addon has the new function
-      if (typeof nativeAddon.getMainWindow === 'function') {
-        const windowResult = nativeAddon.getMainWindow(processId);
-        if (windowResult.success && windowResult.hwnd) {
-          hwnd = windowResult.hwnd;
-          console.log(`[WindowManager] Found window: ${hwnd}`);
-          break;
-        }
-      } else {
-        // Fallback or error if function missing (shouldn't happen if rebuilt)
-        throw new Error('Native addon missing getMainWindow function');
-      }
-    } catch (e) {
-      console.warn(`[WindowManager] Error checking window: ${e.message}`);
-    }
-  }
-
-  if (!hwnd) {
-    try {
-      nativeAddon.terminateProcess(processId);
-    } catch (e) { }
-    throw new Error('Application launched but window not found within 30 seconds. The app may be minimized to tray or running in background.');
-  }
-
   // Calculate embedded window area (account for sidebar, tabs, header)
   const sidebarWidth = 300;
   const tabBarHeight = 36;
@@ -128,46 +167,40 @@ async function launchAndEmbed(appPath, tabId) {
   const width = bounds.width - sidebarWidth;
   const height = bounds.height - headerHeight - tabBarHeight;
 
-  // Longer delay to let window fully initialize before embedding
-  // Some apps need more time to stabilize
-  await new Promise(resolve => setTimeout(resolve, 1000));
-
-  // Verify window still exists and is ready before embedding
-  try {
-    const checkInfo = nativeAddon.getWindowInfo(hwnd);
-    if (!checkInfo.success) {
-      throw new Error('Window not ready for embedding');
-    }
-    console.log(`[WindowManager] Preparing to embed: ${checkInfo.title || 'Unknown'} (PID: ${processId})`);
-  } catch (e) {
-    try {
-      nativeAddon.terminateProcess(processId);
-    } catch (cleanupErr) {
-      // Ignore cleanup errors
-    }
-    throw new Error('Window disappeared before embedding. The app may have closed itself.');
-  }
-
-  // Embed window
-  console.log(`[WindowManager] Embedding window at position (${x}, ${y}) size ${width}x${height}`);
-  const embedResult = nativeAddon.embedWindow(
-    hwnd,
+  // Launch, wait for the main window, wait for evidence it is interactive
+  // (shown, painted, input-idle, stable title) and embed it, all natively;
+  // resolves with the stage that failed instead of rejecting
+  console.log(`[WindowManager] Launching ${appPath} into (${x}, ${y}) size ${width}x${height}`);
+  const result = await nativeAddon.launchAndEmbed(
+    appPath,
     electronWindowHandle,
     x, y,
-    width, height
+    width, height,
+    {
+      windowWaitMs: WINDOW_WAIT_MS,
+      readyTimeoutMs: READY_TIMEOUT_MS,
+      embedTimeoutMs: EMBED_TIMEOUT_MS
+    }
   );
 
-  if (!embedResult.success) {
-    console.error(`[WindowManager] Embed failed: ${embedResult.error}`);
-    // Cleanup on failure
-    try {
-      nativeAddon.terminateProcess(processId);
-    } catch (e) {
-      // Ignore cleanup errors
+  if (result.readiness && result.readiness.success) {
+    console.log(`[WindowManager] Window ${result.readiness.ready ? 'ready' : 'not fully ready'} after ${Math.round(result.readiness.elapsedMs)} ms`, result.readiness.signals);
+  }
+
+  if (!result.success) {
+    console.error(`[WindowManager] Launch and embed failed at ${result.stage}${result.status ? ` (${result.status})` : ''}: ${result.error}`);
+    // Cleanup on failure; the native side leaves the process running
+    if (result.processId) {
+      try {
+        nativeAddon.terminateProcess(result.processId);
+      } catch (e) {
+        // Ignore cleanup errors
+      }
     }
-    throw new Error(embedResult.error || 'Failed to embed window');
+    throw new Error(describeLaunchFailure(result));
   }
 
+  const { hwnd, processId, processHandle } = result;
   console.log(`[WindowManager] Window embedded successfully`);
 
   // Verify window still exists after embedding with multiple checks
@@ -200,27 +233,95 @@ async function launchAndEmbed(appPath, tabId) {
   const appName = windowInfo.title || path.basename(appPath, '.exe');
 
   // Store in tracking map
+  const slot = nextCommandSlot++;
   embeddedWindows.set(tabId, {
     hwnd,
     processId,
     appName,
     visible: true,
-    processHandle: processHandle || null
+    processHandle: processHandle || null,
+    hung: false,
+    slot
   });
+  nativeAddon.watchWindow(hwnd);
+  nativeAddon.bindWindowCommandSlot(slot, hwnd);
+  applyTabPriority(embeddedWindows.get(tabId), 'foreground');
 
   return {
     success: true,
     hwnd,
     processId,
-    appName
+    appName,
+    slot
   };
 }
 
+/**
+ * Map a failed native launchAndEmbed result to a user-facing message
+ * @param {Object} result - { stage, status, error }
+ * @returns {string} Error message
+ */
+function describeLaunchFailure(result) {
+  switch (result.stage) {
+    case 'launch':
+      if ((result.error || '').includes('Failed to launch process')) {
+        return 'Failed to start the application. Check if the path is correct and you have permission to run it.';
+      }
+      return result.error || 'Failed to launch application';
+    case 'window':
+      if ((result.error || '').includes('exited')) {
+        return 'The application exited before showing a window. It may hand off to an already running instance.';
+      }
+      return `Application launched but window not found within ${WINDOW_WAIT_MS / 1000} seconds. The app may be minimized to tray or running in background.`;
+    case 'ready':
+      return 'Window disappeared before embedding. The app may have closed itself.';
+    default:
+      if (result.status === 'hung' || result.status === 'timeout') {
+        return 'The application stopped responding while being embedded.';
+      }
+      return result.error || 'Failed to embed window';
+  }
+}
+
+/**
+ * Boost or demote the process tree behind a tab. Best effort: elevated
+ * or already-exited processes only produce a warning. The native side
+ * snapshots every process on a background worker, so callers don't await
+ * this; one call per tab runs at a time and a switch made meanwhile is
+ * applied when it finishes.
+ * @param {Object} windowData - Tracked window entry
+ * @param {string} mode - 'foreground' or 'background'
+ */
+async function applyTabPriority(windowData, mode) {
+  windowData.priorityMode = mode;
+  if (windowData.priorityPending) return;
+  windowData.priorityPending = true;
+
+  let applied = null;
+  try {
+    while (applied !== windowData.priorityMode) {
+      applied = windowData.priorityMode;
+      const options = applied === 'background' && BACKGROUND_TAB_CORES
+        ? { cores: BACKGROUND_TAB_CORES }
+        : undefined;
+      const result = await nativeAddon.setProcessPriority(windowData.processId, applied, options);
+      if (!result.success) {
+        console.warn(`Failed to apply ${applied} priority to process ${windowData.processId}:`, result.error);
+      }
+    }
+  } catch (error) {
+    console.warn(`Failed to apply ${applied} priority to process ${windowData.processId}:`, error);
+  } finally {
+    windowData.priorityPending = false;
+  }
+}
+
 /**
  * Show embedded window (make tab active)
  * @param {string} tabId - Tab identifier
+ * @returns {Promise<Object>} Native operation result
  */
-function showTab(tabId) {
+async function showTab(tabId) {
   const windowData = embeddedWindows.get(tabId);
   if (!windowData) {
     throw new Error(`Window not found for tab: ${tabId}`);
@@ -230,12 +331,13 @@ function showTab(tabId) {
     throw new Error('Native addon not loaded');
   }
 
-  const result = nativeAddon.showWindow(windowData.hwnd, true);
+  const result = await nativeAddon.showWindow(windowData.hwnd, true);
   if (result.success) {
     windowData.visible = true;
+    applyTabPriority(windowData, 'foreground');
     // Bring to front
     try {
-      nativeAddon.resizeWindow(
+      await nativeAddon.resizeWindow(
         windowData.hwnd,
         windowData.x || 300,
         windowData.y || 86,
@@ -253,8 +355,9 @@ function showTab(tabId) {
 /**
  * Hide embedded window (make tab inactive)
  * @param {string} tabId - Tab identifier
+ * @returns {Promise<Object>} Native operation result
  */
-function hideTab(tabId) {
+async function hideTab(tabId) {
   const windowData = embeddedWindows.get(tabId);
   if (!windowData) {
     throw new Error(`Window not found for tab: ${tabId}`);
@@ -264,9 +367,10 @@ function hideTab(tabId) {
     throw new Error('Native addon not loaded');
   }
 
-  const result = nativeAddon.showWindow(windowData.hwnd, false);
+  const result = await nativeAddon.showWindow(windowData.hwnd, false);
   if (result.success) {
     windowData.visible = false;
+    applyTabPriority(windowData, 'background');
   }
 
   return result;
@@ -275,8 +379,9 @@ function hideTab(tabId) {
 /**
  * Close tab and cleanup
  * @param {string} tabId - Tab identifier
+ * @returns {Promise<Object>} Result
  */
-function closeTab(tabId) {
+async function closeTab(tabId) {
   const windowData = embeddedWindows.get(tabId);
   if (!windowData) {
     return { success: false, error: `Window not found for tab: ${tabId}` };
@@ -286,9 +391,15 @@ function closeTab(tabId) {
     return { success: false, error: 'Native addon not loaded' };
   }
 
+  nativeAddon.unwatchWindow(windowData.hwnd);
+  nativeAddon.unbindWindowCommandSlot(windowData.slot);
+
   try {
-    // Unparent window first
-    nativeAddon.unparentWindow(windowData.hwnd);
+    // Unparent window first; a hung app only delays this by the timeout
+    const unparentResult = await nativeAddon.unparentWindow(windowData.hwnd, UNPARENT_TIMEOUT_MS);
+    if (!unparentResult.success) {
+      console.warn(`Failed to unparent window (${unparentResult.status}):`, unparentResult.error);
+    }
   } catch (e) {
     console.warn('Failed to unparent window:', e);
   }
@@ -327,20 +438,25 @@ function resizeAllWindows(width, height) {
 
   embeddedWindows.forEach((windowData, tabId) => {
     if (windowData.visible) {
-      try {
-        nativeAddon.resizeWindow(
-          windowData.hwnd,
-          x, y,
-          windowWidth, windowHeight
-        );
-        // Store dimensions
-        windowData.x = x;
-        windowData.y = y;
-        windowData.width = windowWidth;
-        windowData.height = windowHeight;
-      } catch (e) {
+      // Store dimensions up front so a later showTab uses the latest size
+      windowData.x = x;
+      windowData.y = y;
+      windowData.width = windowWidth;
+      windowData.height = windowHeight;
+      // A hung app gets the latest geometry when the watchdog reports recovery
+      if (windowData.hung) return;
+      // Not awaited: resize events fire continuously and must never wait on an app
+      nativeAddon.resizeWindow(
+        windowData.hwnd,
+        x, y,
+        windowWidth, windowHeight
+      ).then((result) => {
+        if (!result.success) {
+          console.warn(`Failed to resize window for tab ${tabId} (${result.status}):`, result.error);
+        }
+      }).catch((e) => {
         console.warn(`Failed to resize window for tab ${tabId}:`, e);
-      }
+      });
     }
   });
 }
@@ -350,8 +466,9 @@ function resizeAllWindows(width, height) {
  * @param {string} tabId - Tab identifier
  * @param {number} width - New width
  * @param {number} height - New height
+ * @returns {Promise<Object>} Native operation result
  */
-function resizeWindow(tabId, width, height) {
+async function resizeWindow(tabId, width, height) {
   const windowData = embeddedWindows.get(tabId);
   if (!windowData) {
     throw new Error(`Window not found for tab: ${tabId}`);
@@ -367,7 +484,7 @@ function resizeWindow(tabId, width, height) {
   const x = sidebarWidth;
   const y = headerHeight + tabBarHeight;
 
-  const result = nativeAddon.resizeWindow(
+  const result = await nativeAddon.resizeWindow(
     windowData.hwnd,
     x, y,
     width, height
@@ -388,8 +505,9 @@ function resizeWindow(tabId, width, height) {
  * @param {string} tabId - Tab identifier
  * @param {number} x - New x position
  * @param {number} y - New y position
+ * @returns {Promise<Object>} Native operation result
  */
-function moveWindow(tabId, x, y) {
+async function moveWindow(tabId, x, y) {
   const windowData = embeddedWindows.get(tabId);
   if (!windowData) {
     throw new Error(`Window not found for tab: ${tabId}`);
@@ -399,7 +517,7 @@ function moveWindow(tabId, x, y) {
     throw new Error('Native addon not loaded');
   }
 
-  const result = nativeAddon.moveWindow(
+  const result = await nativeAddon.moveWindow(
     windowData.hwnd,
     x, y
   );
@@ -412,6 +530,109 @@ function moveWindow(tabId, x, y) {
   return result;
 }
 
+/**
+ * Give the renderer a MessagePort for batched window commands. The renderer
+ * posts one packed frame per animation frame; completions go back over the
+ * same port as packed ring records.
+ */
+function openCommandChannel() {
+  if (commandPort) {
+    commandPort.close();
+  }
+  const { port1, port2 } = new MessageChannelMain();
+  commandPort = port1;
+  commandPort.on('message', (event) => {
+    applyCommandFrame(port1, event.data);
+  });
+  commandPort.start();
+  mainWindow.webContents.postMessage('window-command-port', null, [port2]);
+}
+
+/**
+ * Apply one packed command frame and report its completions
+ * @param {MessagePortMain} port - Port the frame arrived on
+ * @param {ArrayBuffer|Uint8Array} frame - Packed commands
+ */
+async function applyCommandFrame(port, frame) {
+  if (!(frame instanceof ArrayBuffer) && !ArrayBuffer.isView(frame)) {
+    console.warn('[WindowManager] Ignoring non-binary window command frame');
+    return;
+  }
+
+  const result = await nativeAddon.applyWindowCommands(frame, COMMAND_FRAME_TIMEOUT_MS);
+  // A frame whose commands were all dropped still reports records: 0
+  if (result.records === undefined) {
+    console.warn('[WindowManager] Window command frame rejected:', result.error);
+    return;
+  }
+
+  const records = readCompletions();
+  trackCommandGeometry(records);
+  if (port === commandPort) {
+    port.postMessage(records);
+  }
+}
+
+/**
+ * Copy the completion records written since the last read
+ * @returns {Uint8Array} Packed 32-byte records, oldest first
+ */
+function readCompletions() {
+  const header = new DataView(commandRing, 0, COMPLETION_RING_HEADER_BYTES);
+  const capacity = header.getUint32(4, true);
+  const written = header.getUint32(8, true);
+
+  // Records older than one ring's worth were overwritten before being read
+  let pending = (written - commandRingRead) >>> 0;
+  if (pending > capacity) {
+    console.warn(`[WindowManager] Dropped ${pending - capacity} window command completions`);
+    commandRingRead = (written - capacity) >>> 0;
+    pending = capacity;
+  }
+
+  const out = new Uint8Array(pending * COMPLETION_RECORD_BYTES);
+  const records = new Uint8Array(commandRing, COMPLETION_RING_HEADER_BYTES);
+  for (let i = 0; i < pending; i++) {
+    const index = ((commandRingRead + i) >>> 0) % capacity;
+    out.set(
+      records.subarray(index * COMPLETION_RECORD_BYTES, (index + 1) * COMPLETION_RECORD_BYTES),
+      i * COMPLETION_RECORD_BYTES
+    );
+  }
+  commandRingRead = written;
+  return out;
+}
+
+/**
+ * Keep tracked geometry and visibility in step with applied commands, so
+ * showTab and hang recovery restore what the renderer last set
+ * @param {Uint8Array} records - Packed completion records
+ */
+function trackCommandGeometry(records) {
+  const view = new DataView(records.buffer, records.byteOffset, records.byteLength);
+  for (let offset = 0; offset < records.byteLength; offset += COMPLETION_RECORD_BYTES) {
+    const op = view.getUint8(offset + 6);
+    const status = view.getUint8(offset + 7);
+    if (status !== 0) continue;
+
+    const slot = view.getUint32(offset + 8, true);
+    const windowData = [...embeddedWindows.values()].find((data) => data.slot === slot);
+    if (!windowData) continue;
+
+    if (op === 1 || op === 2) {
+      windowData.x = view.getInt32(offset + 16, true);
+      windowData.y = view.getInt32(offset + 20, true);
+      if (op === 2) {
+        windowData.width = view.getInt32(offset + 24, true);
+        windowData.height = view.getInt32(offset + 28, true);
+      }
+    } else if (windowData.visible !== (op === 3)) {
+      windowData.visible = op === 3;
+      applyTabPriority(windowData, windowData.visible ? 'foreground' : 'background');
+    }
+  }
+}
+
 /**
  * Get Electron window handle
  * @returns {number} Window handle
@@ -441,6 +662,7 @@ function monitorProcesses() {
       if (!windowInfo.success) {
         // Window disappeared - process likely crashed or app closed itself
         console.warn(`Window for tab ${tabId} disappeared, cleaning up`);
+        nativeAddon.unbindWindowCommandSlot(windowData.slot);
         embeddedWindows.delete(tabId);
         // Notify renderer via IPC event
         if (mainWindow && !mainWindow.isDestroyed()) {
@@ -453,6 +675,7 @@ function monitorProcesses() {
     } catch (e) {
       // Error checking window - might be closed
       console.warn(`Error checking window for tab ${tabId}:`, e);
+      nativeAddon.unbindWindowCommandSlot(windowData.slot);
       embeddedWindows.delete(tabId);
       if (mainWindow && !mainWindow.isDestroyed()) {
         mainWindow.webContents.send('embedded-window-closed', {
@@ -466,13 +689,27 @@ function monitorProcesses() {
 
 /**
  * Cleanup all embedded windows on app quit
+ * Processes are terminated directly: unparenting first would make quit wait
+ * behind the window-ops queue for any app that has stopped responding.
  */
 function cleanupAll() {
-  const tabIds = Array.from(embeddedWindows.keys());
-  tabIds.forEach(tabId => {
-    closeTab(tabId);
-  });
+  if (nativeAddon) {
+    embeddedWindows.forEach((windowData) => {
+      try {
+        nativeAddon.terminateProcess(windowData.processId);
+      } catch (e) {
+        console.warn('Error terminating process:', e);
+      }
+    });
+  }
   embeddedWindows.clear();
+
+  if (nativeAddon && process.env.WINDOW_TRACE_PATH) {
+    const traceResult = nativeAddon.stopWindowTrace();
+    if (traceResult.success) {
+      console.log(`Window trace saved: ${traceResult.records} records, ${traceResult.bytes} bytes`);
+    }
+  }
 }
 
 module.exports = {
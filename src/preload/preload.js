@@ -23,6 +23,86 @@ try {
   };
 }
 
+// Batched window commands (format in native/window-command-buffer.h).
+// Commands queued during a frame go to the main process as one packed,
+// transferred buffer over a MessagePort instead of an IPC round trip each.
+const WINDOW_COMMAND_OPS = { move: 1, setRect: 2, show: 3, hide: 4 };
+const WINDOW_COMMAND_STATUSES = ['ok', 'failed', 'invalid', 'hung', 'timeout', 'superseded', 'unknown-slot'];
+const WINDOW_COMMAND_HEADER_BYTES = 16;
+const WINDOW_COMMAND_BYTES = 24;
+const MAX_WINDOW_COMMANDS_PER_FRAME = 1024;
+
+let windowCommandPort = null;
+let pendingWindowCommands = [];
+let windowCommandFlushScheduled = false;
+let nextWindowCommandFrame = 1;
+const windowCommandListeners = new Set();
+
+ipcRenderer.on('window-command-port', (event) => {
+  windowCommandPort = event.ports[0];
+  windowCommandPort.onmessage = (message) => {
+    const completions = decodeWindowCompletions(message.data);
+    windowCommandListeners.forEach((callback) => callback(completions));
+  };
+  windowCommandPort.start();
+  if (pendingWindowCommands.length > 0) flushWindowCommands();
+});
+
+function queueWindowCommand(slot, op, x = 0, y = 0, width = 0, height = 0) {
+  pendingWindowCommands.push([slot, op, x, y, width, height]);
+  if (pendingWindowCommands.length >= MAX_WINDOW_COMMANDS_PER_FRAME) {
+    flushWindowCommands();
+  } else if (!windowCommandFlushScheduled) {
+    windowCommandFlushScheduled = true;
+    requestAnimationFrame(flushWindowCommands);
+  }
+}
+
+function flushWindowCommands() {
+  windowCommandFlushScheduled = false;
+  // Held until the port arrives after a page load
+  if (!windowCommandPort || pendingWindowCommands.length === 0) return;
+
+  const commands = pendingWindowCommands.splice(0, MAX_WINDOW_COMMANDS_PER_FRAME);
+  const buffer = new ArrayBuffer(WINDOW_COMMAND_HEADER_BYTES + commands.length * WINDOW_COMMAND_BYTES);
+  const view = new DataView(buffer);
+  view.setUint8(0, 0x57); // "WCMD"
+  view.setUint8(1, 0x43);
+  view.setUint8(2, 0x4d);
+  view.setUint8(3, 0x44);
+  view.setUint16(4, 1, true);
+  view.setUint16(6, commands.length, true);
+  view.setUint32(8, nextWindowCommandFrame++, true);
+  commands.forEach(([slot, op, x, y, width, height], i) => {
+    const offset = WINDOW_COMMAND_HEADER_BYTES + i * WINDOW_COMMAND_BYTES;
+    view.setUint32(offset, slot, true);
+    view.setUint8(offset + 4, op);
+    view.setInt32(offset + 8, x, true);
+    view.setInt32(offset + 12, y, true);
+    view.setInt32(offset + 16, width, true);
+    view.setInt32(offset + 20, height, true);
+  });
+  windowCommandPort.postMessage(buffer, [buffer]);
+
+  if (pendingWindowCommands.length > 0) flushWindowCommands();
+}
+
+function decodeWindowCompletions(records) {
+  const view = new DataView(records.buffer, records.byteOffset, records.byteLength);
+  const completions = [];
+  for (let offset = 0; offset + 32 <= records.byteLength; offset += 32) {
+    completions.push({
+      frameId: view.getUint32(offset, true),
+      index: view.getUint16(offset + 4, true),
+      op: Object.keys(WINDOW_COMMAND_OPS)[view.getUint8(offset + 6) - 1],
+      status: WINDOW_COMMAND_STATUSES[view.getUint8(offset + 7)] || 'failed',
+      slot: view.getUint32(offset + 8, true),
+      elapsedUs: view.getUint32(offset + 12, true)
+    });
+  }
+  return completions;
+}
+
 // Expose protected methods to renderer
 // Security: Only whitelisted methods are exposed
 contextBridge.exposeInMainWorld('electronAPI', {
@@ -153,16 +233,38 @@ contextBridge.exposeInMainWorld('electronAPI', {
 
   // Desktop Apps
   getInstalledApps: () => ipcRenderer.invoke('get-installed-apps'),
+  queryInstalledApps: (query) => ipcRenderer.invoke('query-installed-apps', query),
   launchApp: (appPath, tabId) => ipcRenderer.invoke('launch-app', appPath, tabId),
   switchTab: (fromTabId, toTabId) => ipcRenderer.invoke('switch-tab', fromTabId, toTabId),
   closeTab: (tabId) => ipcRenderer.invoke('close-tab', tabId),
   resizeEmbeddedWindow: (tabId, width, height) => ipcRenderer.invoke('resize-embedded-window', tabId, width, height),
   moveEmbeddedWindow: (tabId, x, y) => ipcRenderer.invoke('move-embedded-window', tabId, x, y),
 
+  // Batched window commands, addressed by the slot launchApp returns; applied
+  // once per animation frame
+  windowCommands: {
+    move: (slot, x, y) => queueWindowCommand(slot, WINDOW_COMMAND_OPS.move, x, y),
+    setRect: (slot, x, y, width, height) => queueWindowCommand(slot, WINDOW_COMMAND_OPS.setRect, x, y, width, height),
+    show: (slot) => queueWindowCommand(slot, WINDOW_COMMAND_OPS.show),
+    hide: (slot) => queueWindowCommand(slot, WINDOW_COMMAND_OPS.hide),
+    onCompletions: (callback) => {
+      windowCommandListeners.add(callback);
+      return () => windowCommandListeners.delete(callback);
+    }
+  },
+
   // Desktop Apps events
   onEmbeddedWindowClosed: (callback) => {
     ipcRenderer.on('embedded-window-closed', (event, data) => callback(data));
     return () => ipcRenderer.removeListener('embedded-window-closed', callback);
+  },
+  onEmbeddedWindowHung: (callback) => {
+    ipcRenderer.on('embedded-window-hung', (event, data) => callback(data));
+    return () => ipcRenderer.removeListener('embedded-window-hung', callback);
+  },
+  onEmbeddedWindowRecovered: (callback) => {
+    ipcRenderer.on('embedded-window-recovered', (event, data) => callback(data));
+    return () => ipcRenderer.removeListener('embedded-window-recovered', callback);
   }
 });
 
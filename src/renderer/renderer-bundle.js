@@ -3771,6 +3771,26 @@
       });
     }
 
+    // Listen for embedded apps that stop (or resume) responding
+    if (window.electronAPI && window.electronAPI.onEmbeddedWindowHung) {
+      window.electronAPI.onEmbeddedWindowHung((data) => {
+        if (desktopAppsView && data.tabId) {
+          desktopAppsView.setTabHung(data.tabId, true);
+        }
+      });
+      window.electronAPI.onEmbeddedWindowRecovered((data) => {
+        if (desktopAppsView && data.tabId) {
+          desktopAppsView.setTabHung(data.tabId, false);
+          if (window.logsPanel) {
+            window.logsPanel.addLog('warn', `Embedded app was not responding for ${Math.round(data.durationMs / 1000)}s`, null, {
+              source: 'DesktopApps',
+              tabId: data.tabId
+            });
+          }
+        }
+      });
+    }
+
     if (newChatBtn) {
       // Remove any existing listeners by cloning
       const newBtn = newChatBtn.cloneNode(true);
@@ -5198,6 +5218,23 @@
         this.filterApps();
       });
       
+      // Keep the active window fitted as the display area resizes
+      const displayContainer = container.querySelector('#desktop-apps-display');
+      this.displayObserver = new ResizeObserver(() => {
+        const activeTab = this.tabs.find(t => t.id === this.activeTabId);
+        if (activeTab && typeof activeTab.slot === 'number') this.queueWindowRect(activeTab);
+      });
+      this.displayObserver.observe(displayContainer);
+      
+      window.electronAPI.windowCommands.onCompletions(completions => {
+        completions.forEach(completion => {
+          // Superseded commands were replaced by a later one for the same window
+          if (completion.status !== 'ok' && completion.status !== 'superseded') {
+            console.warn(`Window ${completion.op} for slot ${completion.slot} ${completion.status}`);
+          }
+        });
+      });
+      
       if (typeof feather !== 'undefined') feather.replace();
       
       return container;
@@ -5235,7 +5272,7 @@
       }
     }
 
-    filterApps() {
+    async filterApps() {
       if (!this.appsContainer) return;
       
       if (!this.allApps || this.allApps.length === 0) {
@@ -5243,14 +5280,30 @@
         return;
       }
       
-      // Filter apps based on search query
-      const filteredApps = this.searchQuery
-        ? this.allApps.filter(app => {
-            const name = (app.name || '').toLowerCase();
-            const path = (app.path || '').toLowerCase();
-            return name.includes(this.searchQuery) || path.includes(this.searchQuery);
-          })
-        : this.allApps;
+      if (!this.searchQuery) {
+        this.renderApps(this.allApps);
+        return;
+      }
+      
+      // The main process answers from a native facet index over the catalog
+      const query = this.searchQuery;
+      let filteredApps = null;
+      try {
+        const result = await window.electronAPI.queryInstalledApps({ text: query });
+        if (result.success) filteredApps = result.apps;
+      } catch (error) {
+        console.warn('App query failed, filtering locally:', error);
+      }
+      // A later keystroke has already started its own query
+      if (query !== this.searchQuery) return;
+      
+      if (!filteredApps) {
+        filteredApps = this.allApps.filter(app => {
+          const name = (app.name || '').toLowerCase();
+          const path = (app.path || '').toLowerCase();
+          return name.includes(query) || path.includes(query);
+        });
+      }
       
       this.renderApps(filteredApps);
     }
@@ -5324,7 +5377,8 @@
         
         // Create tab
         const tab = this.createAppTab(tabId, appName);
-        this.tabs.push({ id: tabId, appName, appPath: appInfo.path, appInfo });
+        // The slot addresses the window in batched window commands
+        this.tabs.push({ id: tabId, appName, appPath: appInfo.path, appInfo, slot: result.slot });
         this.activeApps.set(tabId, { appInfo, appName });
         
         // Add tab to UI
@@ -5409,6 +5463,42 @@
       return tab;
     }
 
+    setTabHung(tabId, hung) {
+      const tab = this.tabs.find(t => t.id === tabId);
+      if (!tab) return;
+      
+      tab.hung = hung;
+      const tabButton = document.querySelector(`.desktop-app-tab[data-tab-id="${tabId}"]`);
+      if (tabButton) tabButton.classList.toggle('hung', hung);
+      this.updateHungPlaceholder();
+    }
+
+    updateHungPlaceholder() {
+      const displayContainer = document.getElementById('desktop-apps-display');
+      if (!displayContainer) return;
+      
+      const activeTab = this.tabs.find(t => t.id === this.activeTabId);
+      let placeholder = displayContainer.querySelector('.desktop-apps-hung-placeholder');
+      if (activeTab && activeTab.hung) {
+        if (!placeholder) {
+          placeholder = document.createElement('div');
+          placeholder.className = 'desktop-apps-hung-placeholder';
+          const icon = document.createElement('i');
+          icon.dataset.feather = 'clock';
+          icon.className = 'icon icon-large';
+          placeholder.appendChild(icon);
+          placeholder.appendChild(document.createElement('p'));
+          displayContainer.appendChild(placeholder);
+          if (typeof feather !== 'undefined') feather.replace();
+        }
+        // The name comes from the app's window title, so it is set as text,
+        // and refreshed on every call in case the active tab changed
+        placeholder.querySelector('p').textContent = `${activeTab.appName} is not responding`;
+      } else if (placeholder) {
+        placeholder.remove();
+      }
+    }
+
     switchTab(tabId) {
       const tab = this.tabs.find(t => t.id === tabId);
       if (!tab) return;
@@ -5423,20 +5513,39 @@
       const activeTabButton = document.querySelector(`.desktop-app-tab[data-tab-id="${tabId}"]`);
       if (activeTabButton) activeTabButton.classList.add('active');
       
-      // Switch windows via IPC
-      const previousTabId = this.tabs.find(t => t.id !== tabId && t.active)?.id;
-      if (previousTabId) {
-        window.electronAPI.switchTab(previousTabId, tabId).catch(err => {
-          console.error('Error switching tabs:', err);
-        });
+      // Hide the previous window and show this one, sized to the display
+      // area, in one batched command frame. Tabs without a command slot
+      // switch through IPC.
+      const previousTab = this.tabs.find(t => t.id !== tabId && t.active);
+      if (typeof tab.slot === 'number' && (!previousTab || typeof previousTab.slot === 'number')) {
+        if (previousTab) window.electronAPI.windowCommands.hide(previousTab.slot);
+        window.electronAPI.windowCommands.show(tab.slot);
+        this.queueWindowRect(tab);
       } else {
-        window.electronAPI.switchTab(null, tabId).catch(err => {
+        window.electronAPI.switchTab(previousTab ? previousTab.id : null, tabId).catch(err => {
           console.error('Error switching tabs:', err);
         });
       }
       
       // Mark tabs
       this.tabs.forEach(t => t.active = (t.id === tabId));
+      this.updateHungPlaceholder();
+    }
+
+    // Fit a tab's window to the display area; queued with the frame's other
+    // window commands
+    queueWindowRect(tab) {
+      const displayContainer = document.getElementById('desktop-apps-display');
+      if (!displayContainer) return;
+      const rect = displayContainer.getBoundingClientRect();
+      if (rect.width <= 0 || rect.height <= 0) return;
+      window.electronAPI.windowCommands.setRect(
+        tab.slot,
+        Math.round(rect.left),
+        Math.round(rect.top),
+        Math.round(rect.width),
+        Math.round(rect.height)
+      );
     }
 
     switchToPreviousTab() {
@@ -0,0 +1,99 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const fs = require('fs');
+const Module = require('module');
+const os = require('os');
+const path = require('path');
+
+const servicePath = require.resolve('../src/main/app-discovery-service');
+const apps = [
+  { id: 'a', name: 'Alpha', path: 'C:\\Apps\\alpha.exe' },
+  { id: 'b', name: 'Beta', path: 'C:\\Apps\\beta.exe' },
+  { id: 'c', name: 'Gamma', path: 'C:\\Apps\\gamma.exe' },
+  { id: 'd', name: 'Delta', path: 'C:\\Apps\\delta.exe' }
+];
+
+// electron and the addon resolve to whatever the current test set up;
+// electron is required lazily, so the stubs stay installed
+let userData = null;
+let addon = null;
+const load = Module._load;
+Module._load = function (request, ...rest) {
+  if (request === 'electron') return { app: { getPath: () => userData } };
+  if (request.endsWith('window-manager.node')) return addon;
+  return load.call(this, request, ...rest);
+};
+
+const userDataDirs = [];
+test.after(() => userDataDirs.forEach(dir => fs.rmSync(dir, { recursive: true, force: true })));
+
+// A fresh service over a stub addon, with userData in a temp directory
+function loadService(readUserAssist) {
+  userData = fs.mkdtempSync(path.join(os.tmpdir(), 'app-discovery-'));
+  userDataDirs.push(userData);
+  addon = {
+    startIdleScheduler: () => true,
+    scheduleIdleWork: () => ({ success: true }),
+    readSigners: async () => ({ success: true, results: [] }),
+    discoverApps: async () => ({ success: true, apps }),
+    // Rows index the paths the service passed in
+    readUserAssist: async ({ paths }) => {
+      const result = await readUserAssist();
+      if (result.entries) result.entries.forEach(entry => { entry.row = paths.indexOf(entry.path); });
+      return result;
+    }
+  };
+  delete require.cache[servicePath];
+  const service = require(servicePath);
+  service.initialize();
+  return service;
+}
+
+function entry(appPath, runCount, lastRunMs = Date.now()) {
+  return { path: appPath, runCount, focusCount: 0, focusMs: 0, lastRunMs };
+}
+
+test('scales seeded run counts so the most run app gets the cap', async () => {
+  const service = loadService(async () => ({
+    success: true,
+    entries: [entry('C:\\Apps\\gamma.exe', 40), entry('C:\\Apps\\beta.exe', 20), entry('C:\\Apps\\delta.exe', 1)]
+  }));
+  const ranked = await service.discoverApps();
+
+  assert.deepStrictEqual(ranked.map(app => app.name), ['Gamma', 'Beta', 'Delta', 'Alpha']);
+  // Two launches: Delta's seeded 1 becomes 3, still under Beta's 5
+  service.recordLaunch('C:\\Apps\\delta.exe');
+  service.recordLaunch('C:\\Apps\\delta.exe');
+  assert.deepStrictEqual((await service.getCachedApps()).map(app => app.name), ['Gamma', 'Beta', 'Delta', 'Alpha']);
+  // Four more reach 7 and overtake it
+  for (let i = 0; i < 4; i++) service.recordLaunch('C:\\Apps\\delta.exe');
+  assert.deepStrictEqual((await service.getCachedApps()).map(app => app.name), ['Gamma', 'Delta', 'Beta', 'Alpha']);
+});
+
+test('seeds nothing from entries that were only focused', async () => {
+  const service = loadService(async () => ({
+    success: true,
+    entries: [entry('C:\\Apps\\gamma.exe', 0), entry('C:\\Apps\\beta.exe', 0)]
+  }));
+  const ranked = await service.discoverApps();
+
+  assert.deepStrictEqual(ranked.map(app => app.name), ['Alpha', 'Beta', 'Delta', 'Gamma']);
+  // A single launch must outrank the unseeded apps rather than compare with NaN
+  service.recordLaunch('C:\\Apps\\delta.exe');
+  assert.deepStrictEqual((await service.getCachedApps()).map(app => app.name), ['Delta', 'Alpha', 'Beta', 'Gamma']);
+});
+
+test('retries the seed after a failed read', async () => {
+  let reads = 0;
+  const service = loadService(async () => {
+    reads++;
+    return reads === 1
+      ? { success: false, error: 'UserAssist read failed: timeout' }
+      : { success: true, entries: [entry('C:\\Apps\\beta.exe', 3)] };
+  });
+
+  assert.deepStrictEqual((await service.discoverApps()).map(app => app.name), ['Alpha', 'Beta', 'Delta', 'Gamma']);
+  assert.deepStrictEqual((await service.discoverApps()).map(app => app.name), ['Beta', 'Alpha', 'Delta', 'Gamma']);
+  await service.discoverApps();
+  assert.strictEqual(reads, 2);
+});
@@ -0,0 +1,82 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const fs = require('fs');
+const path = require('path');
+
+let addon = null;
+try {
+  addon = require(path.join(__dirname, '../native/build/Release/window-manager.node'));
+} catch (error) {
+  // Native module not built; the tests below are skipped
+}
+
+// DER PKCS#7 SignedData from a test CA ("Fabrikam Root CA") for a leaf
+// "Leaf Signer"; parsing names the signer without checking the signature
+const signature = fs.readFileSync(path.join(__dirname, 'fixtures/authenticode-signature.p7b'));
+
+// Minimal PE32+ image, with certificate as a WIN_CERTIFICATE in the
+// security directory when given
+function makePe(certificate) {
+  const headers = Buffer.alloc(4096 + 128);
+  headers.writeUInt16LE(0x5A4D, 0);         // MZ
+  headers.writeUInt32LE(0x80, 0x3C);        // e_lfanew
+  headers.writeUInt32LE(0x4550, 0x80);      // PE\0\0
+  headers.writeUInt16LE(0x8664, 0x84);      // x64
+  headers.writeUInt16LE(240, 0x80 + 20);    // SizeOfOptionalHeader
+  headers.writeUInt16LE(0x22, 0x80 + 22);   // Executable, large address aware
+  const optional = 0x80 + 24;
+  headers.writeUInt16LE(0x20B, optional);   // PE32+
+  headers.writeUInt16LE(2, optional + 68);  // GUI subsystem
+  headers.writeUInt32LE(16, optional + 108);  // NumberOfRvaAndSizes
+  if (!certificate) return headers;
+
+  const entry = Buffer.alloc(Math.ceil((8 + certificate.length) / 8) * 8);
+  entry.writeUInt32LE(8 + certificate.length, 0);
+  entry.writeUInt16LE(0x200, 4);  // WIN_CERT_REVISION_2_0
+  entry.writeUInt16LE(2, 6);      // WIN_CERT_TYPE_PKCS_SIGNED_DATA
+  certificate.copy(entry, 8);
+  headers.writeUInt32LE(headers.length, optional + 112 + 32);  // Security directory: file offset
+  headers.writeUInt32LE(entry.length, optional + 112 + 36);
+  return Buffer.concat([headers, entry]);
+}
+
+async function readSigners(files) {
+  const result = await addon.readSigners(files.map(file => file.path), {
+    filesystem: { files: files.map(file => Object.assign({ mtimeMs: 1000 }, file)) }
+  });
+  assert.strictEqual(result.success, true);
+  return result.results;
+}
+
+test('names the signer of a signed PE', { skip: !addon }, async () => {
+  const [signed] = await readSigners([{ path: 'C:\\App\\signed.exe', contents: makePe(signature) }]);
+
+  assert.strictEqual(signed.state, 'signed');
+  assert.strictEqual(signed.publisher, 'Leaf Signer');
+  assert.strictEqual(signed.subject, 'CN=Leaf Signer, O=Ünïcode GmbH, C=DE');
+  assert.strictEqual(signed.issuer, 'O=Fabrikam, CN=Fabrikam Root CA');
+  assert.strictEqual(signed.trust, 'unverified');
+});
+
+test('tells unsigned, tampered and missing files apart', { skip: !addon }, async () => {
+  const truncated = makePe(signature).subarray(0, 4096 + 128 + 200);
+  const corrupted = Buffer.from(signature);
+  corrupted[0] = 0x31;  // SET where the ContentInfo SEQUENCE belongs
+  const results = await readSigners([
+    { path: 'C:\\App\\plain.exe', contents: makePe(null) },
+    { path: 'C:\\App\\truncated.exe', contents: truncated },
+    { path: 'C:\\App\\corrupted.exe', contents: makePe(corrupted) },
+    { path: 'C:\\App\\notes.exe', contents: 'not a PE' }
+  ]);
+  const byName = Object.fromEntries(results.map(result => [path.win32.basename(result.path), result]));
+
+  assert.strictEqual(byName['plain.exe'].state, 'unsigned');
+  assert.strictEqual(byName['truncated.exe'].state, 'malformed');
+  assert.strictEqual(byName['corrupted.exe'].state, 'malformed');
+  assert.ok(byName['corrupted.exe'].error);
+  assert.strictEqual(byName['notes.exe'].state, 'malformed');
+
+  const [missing] = await addon.readSigners(['C:\\App\\gone.exe'], { filesystem: {} }).then(result => result.results);
+  assert.ok(missing.error);
+  assert.strictEqual(missing.state, undefined);
+});
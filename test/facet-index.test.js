@@ -0,0 +1,40 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const path = require('path');
+
+let addon = null;
+try {
+  addon = require(path.join(__dirname, '../native/build/Release/window-manager.node'));
+} catch (error) {
+  // Native module not built; the tests below are skipped
+}
+
+const rows = [
+  { name: 'Visual Studio Code', path: 'C:\\Program Files\\Microsoft VS Code\\Code.exe', source: 'uninstall', signed: true },
+  { name: 'Notepad', path: 'C:\\Windows\\System32\\notepad.exe', source: 'system', signed: true },
+  { name: 'Tool', path: 'D:\\Portable\\Utilities\\tool.exe', source: 'programfiles', signed: false }
+];
+
+test('text search matches the name or anywhere in the full path', { skip: !addon }, () => {
+  assert.strictEqual(addon.buildFacetIndex(rows).success, true);
+
+  assert.deepStrictEqual(addon.queryFacetIndex({ text: 'studio' }).rows, [0]);
+  assert.deepStrictEqual(addon.queryFacetIndex({ text: 'NOTEPAD.EXE' }).rows, [1]);
+  // Directory names, as the picker's local filter matches them
+  assert.deepStrictEqual(addon.queryFacetIndex({ text: 'system32' }).rows, [1]);
+  assert.deepStrictEqual(addon.queryFacetIndex({ text: 'portable\\util' }).rows, [2]);
+  assert.deepStrictEqual(addon.queryFacetIndex({ text: 'c:\\' }).rows, [0, 1]);
+});
+
+test('text search ANDs with the facet filter', { skip: !addon }, () => {
+  assert.strictEqual(addon.buildFacetIndex(rows).success, true);
+
+  const result = addon.queryFacetIndex({
+    text: '.exe',
+    where: { facet: 'signed', value: 'signed' },
+    counts: ['source']
+  });
+  assert.deepStrictEqual(result.rows, [0, 1]);
+  assert.strictEqual(result.total, 2);
+  assert.deepStrictEqual(result.counts.source.map(c => c.value).sort(), ['system', 'uninstall']);
+});
@@ -0,0 +1,98 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const path = require('path');
+
+let addon = null;
+try {
+  addon = require(path.join(__dirname, '../native/build/Release/window-manager.node'));
+} catch (error) {
+  // Native module not built; the tests below are skipped
+}
+
+const steamRoot = 'C:\\Steam';
+const epicManifests = 'C:\\ProgramData\\Epic\\EpicGamesLauncher\\Data\\Manifests';
+
+function appManifest(appId, name, installDir, stateFlags = 4) {
+  return `"AppState"\n{\n\t"appid"\t\t"${appId}"\n\t"name"\t\t"${name}"\n` +
+    `\t"StateFlags"\t\t"${stateFlags}"\n\t"installdir"\t\t"${installDir}"\n}\n`;
+}
+
+function epicManifest(fields) {
+  return JSON.stringify(Object.assign({
+    AppName: 'Fir',
+    DisplayName: 'Fir Game',
+    InstallLocation: 'D:\\Epic\\Fir',
+    LaunchExecutable: 'Binaries/Win64/Fir.exe'
+  }, fields));
+}
+
+function scan(files, options = {}) {
+  return addon.scanGameLibraryApps(Object.assign({
+    roots: { steam: [steamRoot], steamFromRegistry: false, epicManifests: [epicManifests], gog: false },
+    filesystem: { directories: [epicManifests], files }
+  }, options));
+}
+
+test('steam manifests resolve the game exe and skip tools and partial installs', { skip: !addon }, () => {
+  const result = scan([
+    { path: `${steamRoot}\\steamapps\\libraryfolders.vdf`,
+      contents: '"libraryfolders"\n{\n\t"0"\n\t{\n\t\t"path"\t\t"C:\\\\Steam"\n\t}\n\t"1"\n\t{\n\t\t"path"\t\t"E:\\\\Games"\n\t}\n}\n' },
+    { path: `${steamRoot}\\steamapps\\appmanifest_10.acf`, contents: appManifest('10', 'Oak Quest', 'Oak Quest') },
+    { path: `${steamRoot}\\steamapps\\common\\Oak Quest\\OakQuest.exe`, size: 50000000 },
+    { path: `${steamRoot}\\steamapps\\common\\Oak Quest\\setup.exe`, size: 90000000 },
+    { path: `${steamRoot}\\steamapps\\appmanifest_228980.acf`, contents: appManifest('228980', 'Steamworks Common Redistributables', 'Steamworks Shared') },
+    { path: `${steamRoot}\\steamapps\\common\\Steamworks Shared\\redist.exe`, size: 1000 },
+    { path: 'E:\\Games\\steamapps\\appmanifest_20.acf', contents: appManifest('20', 'Elm', 'Elm') },
+    { path: 'E:\\Games\\steamapps\\common\\Elm\\bin\\elm.exe', size: 2000000 },
+    { path: 'E:\\Games\\steamapps\\appmanifest_30.acf', contents: appManifest('30', 'Ash', 'Ash', 1026) },
+    { path: 'E:\\Games\\steamapps\\common\\Ash\\ash.exe', size: 2000000 }
+  ]);
+
+  assert.strictEqual(result.success, true);
+  assert.deepStrictEqual(result.apps.map(app => [app.id, app.name, app.path]).sort(), [
+    ['steam_10', 'Oak Quest', `${steamRoot}\\steamapps\\common\\Oak Quest\\OakQuest.exe`],
+    ['steam_20', 'Elm', 'E:\\Games\\steamapps\\common\\Elm\\bin\\elm.exe']
+  ]);
+});
+
+test('epic manifests name the exe and skip DLC and incomplete installs', { skip: !addon }, () => {
+  const result = scan([
+    { path: `${epicManifests}\\A1.item`, contents: epicManifest({}) },
+    { path: 'D:\\Epic\\Fir\\Binaries\\Win64\\Fir.exe', size: 1000 },
+    { path: `${epicManifests}\\B2.item`, contents: epicManifest({ AppName: 'FirDlc', MainGameAppName: 'Fir' }) },
+    { path: `${epicManifests}\\C3.item`,
+      contents: epicManifest({ AppName: 'Pine', DisplayName: 'Pine', InstallLocation: 'D:\\Epic\\Pine',
+                               LaunchExecutable: 'Pine.exe', bIsIncompleteInstall: true }) },
+    { path: 'D:\\Epic\\Pine\\Pine.exe', size: 1000 },
+    { path: `${epicManifests}\\D4.item`,
+      contents: epicManifest({ AppName: 'Gone', InstallLocation: 'D:\\Epic\\Gone', LaunchExecutable: 'Gone.exe' }) }
+  ]);
+
+  assert.strictEqual(result.success, true);
+  assert.deepStrictEqual(result.apps.map(app => [app.id, app.name, app.path]), [
+    ['epic_Fir', 'Fir Game', 'D:\\Epic\\Fir\\Binaries\\Win64\\Fir.exe']
+  ]);
+});
+
+test('unreadable or malformed manifests drop only their own game', { skip: !addon }, () => {
+  const result = scan([
+    { path: `${steamRoot}\\steamapps\\appmanifest_10.acf`, contents: appManifest('10', 'Oak Quest', 'Oak Quest') },
+    { path: `${steamRoot}\\steamapps\\common\\Oak Quest\\OakQuest.exe`, size: 1000 },
+    { path: `${steamRoot}\\steamapps\\appmanifest_11.acf`, contents: '"AppState"\n{\n\t"appid"\t"11"\n' },
+    { path: `${steamRoot}\\steamapps\\appmanifest_12.acf`, contents: appManifest('12', 'Birch', 'Birch') },
+    { path: `${steamRoot}\\steamapps\\common\\Birch\\Birch.exe`, size: 1000 },
+    { path: `${epicManifests}\\A1.item`, contents: '{ "AppName": "Fir", ' },
+    { path: `${epicManifests}\\B2.item`, contents: epicManifest({}) },
+    { path: 'D:\\Epic\\Fir\\Binaries\\Win64\\Fir.exe', size: 1000 }
+  ], {
+    faults: [{ match: `${steamRoot}\\steamapps\\appmanifest_12.acf`, errorRate: 1, error: 'accessDenied' }]
+  });
+
+  assert.strictEqual(result.success, true);
+  assert.deepStrictEqual(result.apps.map(app => app.id).sort(), ['epic_Fir', 'steam_10']);
+});
+
+test('rejects malformed options', { skip: !addon }, () => {
+  assert.throws(() => addon.scanGameLibraryApps({ roots: { steam: 'C:\\Steam' } }), TypeError);
+  assert.throws(() => scan([], { faults: [{ match: 'C:\\', error: 'Nope' }] }), TypeError);
+});
@@ -0,0 +1,104 @@
+const test = require('node:test');
+const assert = require('node:assert');
+const path = require('path');
+
+let addon = null;
+try {
+  addon = require(path.join(__dirname, '../native/build/Release/window-manager.node'));
+} catch (error) {
+  // Native module not built; the tests below are skipped
+}
+
+const USER_ASSIST = 'Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\UserAssist';
+const EXE_GUID = '{CEBFF5CD-ACE2-4F4F-9178-9926F41749EA}';
+const SHORTCUT_GUID = '{F4E57C4B-2036-45F0-A9AB-443BCFE33D9F}';
+const roots = { ProgramFiles: 'C:\\Program Files', SystemRoot: 'C:\\Windows' };
+
+const lastRun = Date.UTC(2026, 8, 1, 12, 0, 0);
+const laterRun = Date.UTC(2026, 9, 1, 8, 30, 0);
+
+function rot13(text) {
+  return text.replace(/[a-z]/gi, c => {
+    const base = c <= 'Z' ? 65 : 97;
+    return String.fromCharCode((c.charCodeAt(0) - base + 13) % 26 + base);
+  });
+}
+
+function fileTime(unixMs) {
+  return BigInt(unixMs) * 10000n + 116444736000000000n;
+}
+
+// Windows 7+ counter record
+function win7Record({ runCount, focusCount = 0, focusMs = 0, lastRunMs = 0 }) {
+  const data = Buffer.alloc(72);
+  data.writeUInt32LE(runCount, 4);
+  data.writeUInt32LE(focusCount, 8);
+  data.writeUInt32LE(focusMs, 12);
+  if (lastRunMs) data.writeBigUInt64LE(fileTime(lastRunMs), 60);
+  return data;
+}
+
+// XP counter record; its run count starts at 5
+function xpRecord({ runCount, lastRunMs }) {
+  const data = Buffer.alloc(16);
+  data.writeUInt32LE(runCount + 5, 4);
+  data.writeBigUInt64LE(fileTime(lastRunMs), 8);
+  return data;
+}
+
+const registry = [
+  {
+    root: 'HKCU',
+    key: `${USER_ASSIST}\\${EXE_GUID}\\Count`,
+    values: {
+      [rot13('{6D809377-6AF0-444B-8957-A3773F02200E}\\Oak\\oak.exe')]:
+        win7Record({ runCount: 12, focusCount: 3, focusMs: 5000, lastRunMs: lastRun }),
+      [rot13('C:\\Tools\\ash.exe')]: win7Record({ runCount: 0, focusCount: 4, focusMs: 900 }),
+      [rot13('C:\\Tools\\elm.exe')]: win7Record({ runCount: 0 }),
+      [rot13('Microsoft.Windows.Explorer')]: win7Record({ runCount: 9 }),
+      [rot13('UEME_CTLSESSION')]: Buffer.alloc(1612)
+    }
+  },
+  {
+    root: 'HKCU',
+    key: `${USER_ASSIST}\\${SHORTCUT_GUID}\\Count`,
+    values: {
+      [rot13('C:\\Program Files\\Oak\\oak.exe')]: xpRecord({ runCount: 3, lastRunMs: laterRun }),
+      [rot13('{1AC14E77-02E7-4E5D-B744-2EB1AE5198B7}\\notepad.exe')]: xpRecord({ runCount: 2, lastRunMs: lastRun }),
+      [rot13('{62AB5D82-FDC1-4DC3-A9DD-070D1D495D97}\\Tool\\tool.exe')]: win7Record({ runCount: 1 }),
+      [rot13('C:\\Tools\\birch.exe')]: Buffer.alloc(20)
+    }
+  }
+];
+
+test('decodes ROT13 names and both record formats, merged by path', { skip: !addon }, async () => {
+  const result = await addon.readUserAssist({ roots, registry });
+
+  assert.strictEqual(result.success, true);
+  assert.deepStrictEqual(result.entries.map(({ path, runCount, focusCount, focusMs, lastRunMs }) =>
+    ({ path, runCount, focusCount, focusMs, lastRunMs })), [
+    { path: 'C:\\Program Files\\Oak\\oak.exe', runCount: 15, focusCount: 3, focusMs: 5000, lastRunMs: laterRun },
+    { path: 'C:\\Windows\\System32\\notepad.exe', runCount: 2, focusCount: 0, focusMs: 0, lastRunMs: lastRun },
+    { path: 'C:\\Tools\\ash.exe', runCount: 0, focusCount: 4, focusMs: 900, lastRunMs: 0 }
+  ]);
+  // Never run or focused, not an exe, a folder outside roots, a short record
+  assert.strictEqual(result.skipped, 5);
+});
+
+test('reports catalog rows for matching paths', { skip: !addon }, async () => {
+  const paths = ['C:\\Windows\\System32\\notepad.exe', 'c:\\program files\\oak\\OAK.exe', 'C:\\Other\\other.exe'];
+  const result = await addon.readUserAssist({ roots, registry, paths });
+
+  assert.strictEqual(result.success, true);
+  assert.deepStrictEqual(result.entries.map(entry => [entry.path, entry.row]), [
+    ['C:\\Program Files\\Oak\\oak.exe', 1],
+    ['C:\\Windows\\System32\\notepad.exe', 0]
+  ]);
+  assert.strictEqual(result.unmatched, 1);
+});
+
+test('treats a missing UserAssist key as no history', { skip: !addon }, async () => {
+  const result = await addon.readUserAssist({ roots, registry: [] });
+  assert.strictEqual(result.success, true);
+  assert.deepStrictEqual(result.entries, []);
+});